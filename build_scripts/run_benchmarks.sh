@@ -0,0 +1,25 @@
+#!/usr/bin/env bash
+# Build and run bench_llvm_builder for every build type, results are written
+# as json to artifacts/benchmarks/<build_type>.json for comparison across upgrades
+
+set -euo pipefail
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_DIR="$(dirname "$SCRIPT_DIR")"
+OUTPUT_DIR="$PROJECT_DIR/artifacts/benchmarks"
+BUILD_TYPES="${*:-Debug RelWithDebInfo Release}"
+
+mkdir -p "$OUTPUT_DIR"
+
+for build_type in $BUILD_TYPES; do
+    build_dir="$PROJECT_DIR/build_bench_${build_type}"
+    echo "=== Benchmark build type: $build_type ==="
+    cmake -GNinja -S "$PROJECT_DIR" -B "$build_dir" \
+        -DCMAKE_BUILD_TYPE="$build_type" \
+        -DBUILD_PYTHON_BINDINGS=OFF \
+        -DBUILD_BENCHMARKS=ON
+    ninja -C "$build_dir" bench_llvm_builder
+    "$build_dir/bench_llvm_builder" \
+        --benchmark_out="$OUTPUT_DIR/${build_type}.json" \
+        --benchmark_out_format=json
+done
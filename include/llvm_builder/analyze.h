@@ -8,6 +8,8 @@
 #include "llvm_builder/defines.h"
 #include "module.h"
 
+#include <algorithm>
+#include <array>
 #include <ostream>
 #include <string_view>
 #include <vector>
@@ -102,8 +104,78 @@ enum class OpType : uint16_t {
     CAST
 };
 
+constexpr uint32_t c_num_op_types = static_cast<uint32_t>(OpType::CAST) + 1;
+
+std::string_view op_type_name(OpType t);
+
+//
+// FunctionCost
+//
+// static cost estimate of one function, per instruction latency and reciprocal
+// throughput come from the host TargetTransformInfo, which is backed by the
+// scheduling model of the host cpu. All cycle counts assume warm caches
+class FunctionCost {
+    friend class FunctionAnalysis;
+private:
+    std::string m_cpu_name;
+    std::array<uint32_t, c_num_op_types> m_op_count{};
+    uint64_t m_latency_cycles = 0;
+    uint64_t m_throughput_cycles = 0;
+    uint64_t m_critical_path_cycles = 0;
+    uint64_t m_bytes_loaded = 0;
+    uint64_t m_bytes_stored = 0;
+public:
+    explicit FunctionCost() = default;
+    ~FunctionCost() = default;
+public:
+    const std::string& cpu_name() const {
+        return m_cpu_name;
+    }
+    uint32_t op_count(OpType t) const {
+        return m_op_count[static_cast<uint32_t>(t)];
+    }
+    uint32_t num_loads() const {
+        return op_count(OpType::LOAD);
+    }
+    uint32_t num_stores() const {
+        return op_count(OpType::STORE);
+    }
+    uint32_t num_branches() const {
+        return op_count(OpType::BRANCH);
+    }
+    uint32_t num_divides() const {
+        return op_count(OpType::DIV) + op_count(OpType::REMAINDER);
+    }
+    // sum of latency of every instruction, i.e. fully serialized execution
+    uint64_t latency_cycles() const {
+        return m_latency_cycles;
+    }
+    // sum of reciprocal throughput, lower bound when nothing is on the critical path
+    uint64_t throughput_cycles() const {
+        return m_throughput_cycles;
+    }
+    // longest def-use latency chain through the function
+    uint64_t critical_path_cycles() const {
+        return m_critical_path_cycles;
+    }
+    uint64_t estimated_cycles() const {
+        return std::max(m_critical_path_cycles, m_throughput_cycles);
+    }
+    uint64_t bytes_loaded() const {
+        return m_bytes_loaded;
+    }
+    uint64_t bytes_stored() const {
+        return m_bytes_stored;
+    }
+    uint64_t bytes_touched() const {
+        return m_bytes_loaded + m_bytes_stored;
+    }
+    void print(std::ostream& os, const std::string& offset) const;
+};
+
 class Inst {
     friend class CodeBlock;
+    friend class FunctionAnalysis;
 private:
     const llvm::Instruction& m_inst;
     OpType m_type = OpType::UNDEFINED;
@@ -171,7 +243,10 @@ public:
     ~FunctionAnalysis() = default;
 public:
     int32_t num_inst() const;
+    std::string_view name() const;
+    FunctionCost cost() const;
     void analyze(std::ostream& os, const std::string& offset) const;
+    void cost_report(std::ostream& os, const std::string& offset) const;
     const std::vector<CodeBlock> &code_blocks() const {
         return m_code_blocks;
     }
@@ -191,12 +266,128 @@ public:
     ~ModuleAnalysis();
 public:
     void analyze(std::ostream& os) const;
+    void cost_report(std::ostream& os) const;
     const std::vector<FunctionAnalysis>& functions() const {
         return m_funcs;
     }
     void for_each_inst(std::ostream& os, std::function<void(const Inst&)>&& fn) const;
 };
 
+//
+// ValueAnnotation
+//
+// DSL ValueInfo which generated a range of instructions, recorded per function
+// while debug info is enabled on the cursor
+class ValueAnnotation {
+    std::string m_description;
+    TagInfo m_tags;
+    SourceLoc m_source_loc;
+public:
+    explicit ValueAnnotation();
+    explicit ValueAnnotation(const std::string& description, const TagInfo& tags, const SourceLoc& loc);
+    ~ValueAnnotation() = default;
+public:
+    bool empty() const {
+        return m_description.empty();
+    }
+    // value kind and result type, e.g. `binary:int32`
+    const std::string& description() const {
+        return m_description;
+    }
+    const TagInfo& tags() const {
+        return m_tags;
+    }
+    const SourceLoc& source_loc() const {
+        return m_source_loc;
+    }
+    void print(std::ostream& os) const;
+    friend std::ostream& operator << (std::ostream& os, const ValueAnnotation& o) {
+        o.print(os);
+        return os;
+    }
+};
+
+//
+// AsmInst
+//
+class AsmInst {
+    uint64_t m_address = 0;
+    uint32_t m_offset = 0;
+    uint32_t m_size = 0;
+    std::string m_text;
+    // host line from DWARF line table, invalid if object has no debug info
+    SourceLoc m_line;
+    ValueAnnotation m_value;
+public:
+    explicit AsmInst(uint64_t address, uint32_t offset, uint32_t size, std::string&& text,
+                     const SourceLoc& line, const ValueAnnotation& value);
+    ~AsmInst() = default;
+public:
+    uint64_t address() const {
+        return m_address;
+    }
+    // offset from function entry
+    uint32_t offset() const {
+        return m_offset;
+    }
+    uint32_t size() const {
+        return m_size;
+    }
+    const std::string& text() const {
+        return m_text;
+    }
+    const SourceLoc& line() const {
+        return m_line;
+    }
+    const ValueAnnotation& value() const {
+        return m_value;
+    }
+    void print(std::ostream& os) const;
+};
+
+//
+// Disassembly
+//
+// final machine code of one jit'ed function, as linked in memory
+class Disassembly {
+    std::string m_symbol;
+    uint64_t m_address = 0;
+    uint64_t m_code_size = 0;
+    std::vector<AsmInst> m_insts;
+public:
+    explicit Disassembly() = default;
+    explicit Disassembly(const std::string& symbol, uint64_t address, uint64_t code_size);
+    ~Disassembly() = default;
+public:
+    bool empty() const {
+        return m_insts.empty();
+    }
+    const std::string& symbol() const {
+        return m_symbol;
+    }
+    uint64_t address() const {
+        return m_address;
+    }
+    // size in bytes of the function body
+    uint64_t code_size() const {
+        return m_code_size;
+    }
+    uint32_t num_inst() const {
+        return static_cast<uint32_t>(m_insts.size());
+    }
+    const std::vector<AsmInst>& insts() const {
+        return m_insts;
+    }
+    void add_inst(AsmInst&& inst) {
+        m_insts.emplace_back(std::move(inst));
+    }
+    void print(std::ostream& os) const;
+    friend std::ostream& operator << (std::ostream& os, const Disassembly& o) {
+        o.print(os);
+        return os;
+    }
+};
+
 }
 
 LLVM_BUILDER_NS_END
@@ -109,6 +109,7 @@ namespace llvm_builder = LLVM_BUILDER_NS();
     macro(mult)                                      \
     macro(div)                                       \
     macro(remainder)                                 \
+    macro(bit_and)                                   \
 /**/
 
 #define FOR_EACH_LOGICAL_OP(macro)                   \
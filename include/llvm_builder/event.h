@@ -8,13 +8,20 @@
 #include "llvm_builder/defines.h"
 #include "llvm_builder/util/object.h"
 
+#include <memory>
+#include <string>
+#include <vector>
+
 LLVM_BUILDER_NS_BEGIN
 
 class EventImpl;
 
+// Named event of a Cursor. Context fields attached to it by Cursor::add_field() are
+// its trigger fields, a change of any of them fires the event, see runtime::EventGraph
 class Event : public _BaseObject {
     using BaseT = _BaseObject;
     friend class EventImpl;
+    friend class Cursor;
 public:
     class Impl;
 private:
@@ -25,10 +32,13 @@ public:
     ~Event();
 public:
     const std::string& name() const;
+    const std::vector<std::string>& fields() const;
     bool operator == (const Event& o) const;
 public:
     static Event from_name(const std::string& name);
     static Event null(const std::string& log = "");
+private:
+    void M_add_field(const std::string& field);
 };
 
 LLVM_BUILDER_NS_END
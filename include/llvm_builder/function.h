@@ -31,6 +31,39 @@ class FunctionContext;
 class CodeSectionImpl;
 class FunctionImpl;
 
+//
+// FieldAccess
+//
+// context fields read and written by a function, collected as its code sections are
+// sealed. A pointer field counts for everything reached through it. Calls to other
+// functions are not followed, such a function is opaque and may access any field
+class FieldAccess {
+    std::vector<std::string> m_reads;
+    std::vector<std::string> m_writes;
+    bool m_is_opaque = false;
+public:
+    explicit FieldAccess() = default;
+    ~FieldAccess() = default;
+public:
+    const std::vector<std::string>& reads() const {
+        return m_reads;
+    }
+    const std::vector<std::string>& writes() const {
+        return m_writes;
+    }
+    bool is_opaque() const {
+        return m_is_opaque;
+    }
+    bool is_read(const std::string& field) const;
+    bool is_written(const std::string& field) const;
+    void add_read(const std::string& field);
+    void add_write(const std::string& field);
+    void mark_opaque() {
+        m_is_opaque = true;
+    }
+    void merge(const FieldAccess& o);
+};
+
 class CodeSection : public _BaseObject {
     using BaseT = _BaseObject;
 public:
@@ -91,6 +124,17 @@ public:
     bool is_external() const;
     ValueInfo call_fn() const;
     void declare_fn(Module& dst_mod);
+    // generates `<name>__kernel` in current module, which runs this function once per row
+    // over column buffers in a single call, see runtime::EventFn::on_columns(). Only fields in
+    // field_access() writes of this function are written back, so call it once body is complete
+    Function mk_kernel() const;
+    // generates `name` in current module, which runs `stages` in order on the same context
+    // and stops at first non-zero result. Stages, defined in current module, are inlined
+    // and shared context fields are passed between them in registers. null function if a
+    // stage can't be inlined
+    static Function mk_fused(const std::string& name, const std::vector<Function>& stages);
+    // fields accessed by sections sealed so far, complete once the function is done
+    FieldAccess field_access() const;
     CodeSection current_section();
     bool is_current_section(CodeSection& code);
     void assert_no_context();
@@ -105,6 +149,7 @@ private:
     llvm::Value* M_eval_arg() const;
     void M_push_section(CodeSection& code);
     void M_pop_section(CodeSection& code);
+    void M_merge_field_access(const FieldAccess& access);
 };
 
 class FunctionContext {
@@ -124,6 +169,10 @@ public:
     static void set_return_value(ValueInfo value);
     static void jump_to_section(CodeSection &dst);
     static void section_break(const std::string& new_section_name);
+    // emits `body` in a new code section `name` and runs it again while the boolean it
+    // returns is true, so at least once. Like section_break(), values see state on entry
+    // to each iteration and code after the loop sees state on exit
+    static void do_while(const std::string& name, const std::function<ValueInfo()>& body);
     static Function function() {
         return s_current_fn;
     }
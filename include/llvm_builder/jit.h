@@ -7,7 +7,13 @@
 
 #include "defines.h"
 #include "module.h"
+#include "analyze.h"
 #include "llvm_builder/util/object.h"
+#include "llvm_builder/util/histogram.h"
+#include "llvm_builder/util/perf_counter.h"
+#include "llvm_builder/util/arrow_c_data.h"
+#include <functional>
+#include <limits>
 #include <memory>
 #include <vector>
 #include <string>
@@ -23,6 +29,13 @@ class Namespace;
 class Struct;
 class Field;
 class EventFn;
+class EventGraph;
+class SharedRegion;
+class Snapshot;
+class EventQueue;
+class ShardedExecutor;
+class Replay;
+class Table;
 
 enum class type_t {
     unknown,
@@ -42,12 +55,56 @@ enum class type_t {
     pointer_fn,
 };
 
+// releases an external buffer adopted by Array::wrap()/Struct::wrap()
+using buffer_deleter_t = std::function<void(void*)>;
+
+//
+// SharedRegion
+//
+// Named posix shm segment or memory mapped file. Objects and arrays allocated in it
+// are looked up by name from any process which opens the region, and used in place.
+// Region records allocations and the links between them as offsets from its base,
+// so it can be mapped at any address. Open asks for the address of its creator, pointer
+// fields an object in the region sets must point into the same region, events follow
+// them only where the region got that address
+class SharedRegion : public _BaseObject {
+    using BaseT = _BaseObject;
+    friend class Object;
+    friend class Array;
+    friend class Struct;
+    class Impl;
+    struct construct_t {};
+private:
+    std::shared_ptr<Impl> m_impl;
+public:
+    explicit SharedRegion();
+    explicit SharedRegion(std::shared_ptr<Impl>&& impl, construct_t);
+    ~SharedRegion() = default;
+public:
+    const std::string& name() const;
+    void* ref() const;
+    uint64_t size_in_bytes() const;
+    uint64_t used_bytes() const;
+    bool contains(const std::string& name) const;
+    // removes name of the shm segment/file, existing mappings stay valid
+    bool unlink() const;
+    bool operator == (const SharedRegion& rhs) const;
+    static SharedRegion null(const std::string& log = "");
+public:
+    static SharedRegion create_shm(const std::string& name, uint64_t size);
+    static SharedRegion open_shm(const std::string& name);
+    static SharedRegion create_file(const std::string& path, uint64_t size);
+    static SharedRegion open_file(const std::string& path);
+};
+
 // TODO{vibhanshu}: check if all the pointer type fields are initialized
 //                 to valid values, before this object is used in event
 class Object : public _BaseObject {
     using BaseT = _BaseObject;
     friend class Struct;
     friend class EventFn;
+    friend class Snapshot;
+    friend class Namespace;
     class Impl;
 public:
     using event_fn_t = int32_t(void*);
@@ -55,6 +112,8 @@ private:
     std::shared_ptr<Impl> m_impl;
 private:
     explicit Object(const Struct& parent);
+    // `buf` is kept alive by `owner` instead of being freed
+    explicit Object(const Struct& parent, const std::shared_ptr<void>& owner, void* buf, bool is_frozen);
 public:
     explicit Object();
     Object(const Object&);
@@ -65,7 +124,25 @@ public:
 public:
     bool is_frozen() const;
     bool freeze();
+    // events run on a shadow copy which is published at the end of the event
+    // under a seqlock, so read_consistent() on other threads never sees a half
+    // applied event. Covers fields of this object only, not linked objects/arrays
+    bool enable_double_buffer();
+    bool is_double_buffered() const;
+    // incremented by 2 for every published event
+    uint64_t version() const;
+    // lock free consistent copy into `dst`, an unfrozen object of same struct
+    bool read_consistent(const Object& dst) const;
+    // point in time view of this frozen object and everything reachable from it,
+    // see Snapshot
+    Snapshot snapshot() const;
+    // writes this frozen object and everything reachable from it to `path` with
+    // their struct layouts, see Namespace::load_checkpoint(). Buffers are read in
+    // place, so while events run checkpoint the root of a Snapshot instead
+    bool write_checkpoint(const std::string& path) const;
     std::vector<Field> null_fields() const;
+    // fields changed by last event, see Cursor::enable_changed_fields()
+    std::vector<Field> changed_fields() const;
     bool is_instance_of(const Struct &o) const;
     Struct struct_def() const;
     // TODO{vibhanshu}: remove ref() once this api is stable
@@ -88,11 +165,18 @@ public:
 // TODO{vibhanshu}: possible to merge it with Object?
 class Array : public _BaseObject {
     using BaseT = _BaseObject;
+    friend class ShardedExecutor;
+    friend class Namespace;
+    friend class Replay;
+    friend class Table;
     class Impl;
 private:
     std::shared_ptr<Impl> m_impl;
 private:
     explicit Array(type_t element_type, uint32_t size);
+    explicit Array(type_t element_type, uint32_t size, const std::shared_ptr<void>& owner, void* buf, bool is_frozen);
+    // buffers of `array` are kept alive by `owner`, which holds the imported root
+    static Array M_import_arrow(const std::shared_ptr<void>& owner, const ArrowArray& array, const ArrowSchema& schema);
 public:
     // TODO{vibhanshu}: add type info also to array
     explicit Array();
@@ -119,10 +203,83 @@ public:
     void set_object(uint32_t i, const Object& v) const;
     Array get_array(uint32_t i) const;
     void set_array(uint32_t i, const Array& v) const;
+    // arrow validity bitmap, bit i (lsb first) is clear if element i is null. Arrays
+    // have none until enable_validity(), which marks every element valid
+    bool enable_validity();
+    bool has_validity() const;
+    bool is_null(uint32_t i) const;
+    void set_null(uint32_t i, bool is_null) const;
+    uint32_t null_count() const;
+    // bitmap as a frozen uint8 array, link it to an event with set_array(), see
+    // ValueInfo::entry_or()
+    Array validity() const;
+    // arrow list layout, element i is values() [offsets()[i], offsets()[i + 1]).
+    // ref() of a list is its offsets buffer
+    bool is_list() const;
+    Array offsets() const;
+    Array values() const;
+    // elements [begin, begin + length) sharing the buffer of this scalar array, frozen
+    // if this is. Validity bitmap is shared too, so then begin must be a multiple of 8
+    Array slice(uint32_t begin, uint32_t length) const;
+    // shares buffers with the consumer of the arrow C data interface until it calls
+    // release. Only frozen arrays of non boolean scalars, or lists of them, have an
+    // arrow equivalent, booleans are bit packed in arrow
+    bool export_arrow(ArrowArray* out_array, ArrowSchema* out_schema) const;
     bool operator == (const Array& rhs) const;
     static Array null(const std::string& log = "");
 public:
     static Array from(type_t type, uint32_t size);
+    // allocated in `region` under `name`
+    static Array from(type_t type, uint32_t size, const SharedRegion& region, const std::string& name);
+    // array allocated by Array::from() in `region`, possibly by another process, returned frozen
+    static Array find(const SharedRegion& region, const std::string& name);
+    // uses `buf` in place, it must be aligned to element size. `deleter` is called
+    // once the array and everything linking it are gone, without one caller keeps
+    // `buf` alive. On error buffer stays with the caller
+    static Array wrap(type_t type, uint32_t size, void* buf, const buffer_deleter_t& deleter = {});
+    // `offsets` is a frozen int32 array of num_elements() + 1 non decreasing
+    // entries into frozen `values`
+    static Array from_list(const Array& offsets, const Array& values);
+    // moves `array` out of the caller, even on error, and uses its buffers in place
+    // until the returned array and everything linking it are gone. Fixed width,
+    // list ("+l") and utf8/binary ("u"/"z", as a list of uint8) arrays are
+    // supported, `schema` stays with the caller. Returned array is frozen
+    static Array import_arrow(ArrowArray* array, const ArrowSchema* schema);
+};
+
+//
+// Snapshot
+//
+// Object graph as it was when Object::snapshot() was called, taken between
+// events on the thread running them. snapshot() copies nothing, every node is
+// copied on write: the first event publishing into a double buffered object
+// saves its old contents, other objects and arrays are saved by the first
+// EventFn::on_event()/on_columns() whose context reaches them. Untouched nodes
+// are read back by root(). While a snapshot waits, every event walks the graph
+// of its context, so build or drop snapshots promptly.
+// NOTE{vibhanshu}: EventQueue, ShardedExecutor and Replay call events directly
+//                  and don't save pending nodes, snapshot their graphs between runs
+class Snapshot : public _BaseObject {
+    using BaseT = _BaseObject;
+    friend class Object;
+    class Impl;
+private:
+    std::shared_ptr<Impl> m_impl;
+private:
+    explicit Snapshot(const Object& root);
+public:
+    explicit Snapshot();
+    ~Snapshot() = default;
+public:
+    // objects and arrays in the graph
+    uint32_t num_nodes() const;
+    // bytes saved by events since snapshot was taken
+    uint64_t num_bytes_copied() const;
+    // private frozen copy of the graph, built on first call, may run on another
+    // thread while events continue
+    Object root() const;
+    bool operator == (const Snapshot& rhs) const;
+    static Snapshot null(const std::string& log = "");
 };
 
 class Field : public _BaseObject {
@@ -141,6 +298,7 @@ public:
     int32_t idx() const;
     int32_t offset() const;
     const std::string &name() const;
+    type_t type() const;
     bool is_bool() const;
     bool is_struct_pointer() const;
     bool is_array_pointer() const;
@@ -163,9 +321,9 @@ private:
     void log_values(std::ostream& os, void* data) const;
 };
 
-// TODO{vibhanshu}: add API to return a aggregate or some view of different set of underlying variables
-// e.g a group of ints, arg1, arg2, ... argN  can be transformed to an array view based API like int[N]
-// this is very similar to memroy view protocol
+// NOTE{vibhanshu}: events read a group of evenly spaced fields of same type, e.g arg1, arg2, ... argN
+//                  as an array through llvm_builder::ArrayView::from_fields()
+// TODO{vibhanshu}: same view over an Object at runtime, similar to memory view protocol
 class Struct : public _BaseObject {
     using BaseT = _BaseObject;
     class Impl;
@@ -185,6 +343,14 @@ public:
     int32_t num_fields() const;
     const std::vector<std::string>& field_names() const;
     Object mk_object() const;
+    // allocated in `region` under `name`
+    Object mk_object(const SharedRegion& region, const std::string& name) const;
+    // object allocated by mk_object() in `region`, possibly by another process, returned frozen.
+    // pointer fields are usable by events but not through get_object()/get_array(), an object
+    // with pointer fields is an error unless region is mapped at the address of its creator
+    Object find_object(const SharedRegion& region, const std::string& name) const;
+    // object using `buf` of size_in_bytes() in place, see Array::wrap()
+    Object wrap(void* buf, const buffer_deleter_t& deleter = {}) const;
     Field operator[] (const std::string& s) const;
     bool operator == (const Struct& rhs) const;
     static Struct null(const std::string& log = "");
@@ -194,9 +360,191 @@ private:
 
 Field operator""_field(const char* s, size_t len);
 
+//
+// Column
+//
+// buffer of `type` elements, `stride` bytes apart, mapped to the context field
+// of same name while running a kernel, see EventFn::on_columns()
+class Column {
+    std::string m_field;
+    type_t m_type = type_t::unknown;
+    void* m_data = nullptr;
+    int64_t m_stride = 0;
+public:
+    explicit Column(const std::string& field, type_t type, void* data, int64_t stride)
+      : m_field{field}, m_type{type}, m_data{data}, m_stride{stride} {
+    }
+    ~Column() = default;
+public:
+    const std::string& field() const {
+        return m_field;
+    }
+    type_t type() const {
+        return m_type;
+    }
+    void* data() const {
+        return m_data;
+    }
+    int64_t stride() const {
+        return m_stride;
+    }
+};
+
+//
+// ArrayView
+//
+// `length` elements of a scalar array, `stride` elements apart from element `offset`,
+// aliasing its buffer. Runtime side of llvm_builder::ArrayView, event reads it by
+// linking array() and building the DSL view with same offset, length and stride
+class ArrayView : public _BaseObject {
+    using BaseT = _BaseObject;
+private:
+    Array m_array;
+    uint32_t m_offset = 0;
+    uint32_t m_length = 0;
+    uint32_t m_stride = 1;
+public:
+    explicit ArrayView();
+    explicit ArrayView(const Array& array);
+    explicit ArrayView(const Array& array, uint32_t offset, uint32_t length, uint32_t stride = 1);
+    ~ArrayView() = default;
+public:
+    const Array& array() const {
+        return m_array;
+    }
+    uint32_t offset() const {
+        return m_offset;
+    }
+    uint32_t length() const {
+        return m_length;
+    }
+    uint32_t stride() const {
+        return m_stride;
+    }
+    bool is_contiguous() const {
+        return m_stride == 1;
+    }
+    template <typename T>
+    T get(uint32_t i) const {
+        if (i >= m_length) {
+            M_mark_error("view index out of range");
+            return std::numeric_limits<T>::max();
+        }
+        return m_array.get<T>(m_offset + i * m_stride);
+    }
+    template <typename T>
+    void set(uint32_t i, T v) const {
+        if (i >= m_length) {
+            M_mark_error("view index out of range");
+            return;
+        }
+        m_array.set<T>(m_offset + i * m_stride, v);
+    }
+    // elements begin, begin + step, ... of this view
+    ArrayView slice(uint32_t begin, uint32_t length, uint32_t step = 1) const;
+    // contiguous view as an array sharing the buffer, see Array::slice()
+    Array to_array() const;
+    // view mapped to context field `field` of a kernel, see EventFn::on_columns()
+    Column column(const std::string& field) const;
+    bool operator == (const ArrayView& rhs) const;
+    static ArrayView null(const std::string& log = "");
+};
+
+//
+// RingBuffer
+//
+// object of a struct built by llvm_builder::RingBuffer::mk_type(), pushed to and read
+// with the same slot arithmetic as events, so host can seed a window before the first
+// event and inspect it afterwards. Object is shared, not copied
+class RingBuffer : public _BaseObject {
+    using BaseT = _BaseObject;
+private:
+    Object m_object;
+    std::vector<std::string> m_slot_names;
+public:
+    explicit RingBuffer();
+    explicit RingBuffer(const Object& object);
+    ~RingBuffer() = default;
+public:
+    const Object& object() const {
+        return m_object;
+    }
+    uint32_t capacity() const {
+        return static_cast<uint32_t>(m_slot_names.size());
+    }
+    uint32_t size() const;
+    bool is_full() const {
+        return size() == capacity();
+    }
+    void clear() const;
+    template <typename T>
+    void push(T v) const {
+        if (has_error()) {
+            return;
+        }
+        m_object.set<T>(m_slot_names[M_head()], v);
+        M_advance();
+    }
+    // `i`th newest value, at(0) is the last pushed one
+    template <typename T>
+    T at(uint32_t i) const {
+        if (i >= size()) {
+            M_mark_error("ring buffer index out of range");
+            return std::numeric_limits<T>::max();
+        }
+        return m_object.get<T>(m_slot_names[(M_head() + capacity() - 1 - i) % capacity()]);
+    }
+    template <typename T>
+    T oldest() const {
+        return at<T>(size() - 1);
+    }
+    bool operator == (const RingBuffer& rhs) const;
+    static RingBuffer null(const std::string& log = "");
+private:
+    uint32_t M_head() const;
+    void M_advance() const;
+};
+
+//
+// Table
+//
+// Equal length frozen arrays by column name, laid out as an arrow record batch.
+// Crosses the arrow C data interface as a struct array ("+s") with one child per
+// column, without copies, and fixed width columns feed a kernel in place through
+// kernel_columns()
+class Table : public _BaseObject {
+    using BaseT = _BaseObject;
+    class Impl;
+private:
+    std::shared_ptr<Impl> m_impl;
+public:
+    explicit Table();
+    explicit Table(uint32_t num_rows);
+    ~Table() = default;
+public:
+    uint32_t num_rows() const;
+    uint32_t num_columns() const;
+    const std::vector<std::string>& column_names() const;
+    // `column` must be frozen and have num_rows() elements
+    bool add_column(const std::string& name, const Array& column);
+    Array column(const std::string& name) const;
+    // one Column per fixed width column, mapped to the context field of same name
+    // by EventFn::on_columns(). Validity bitmaps are not part of it
+    std::vector<Column> kernel_columns() const;
+    bool export_arrow(ArrowArray* out_array, ArrowSchema* out_schema) const;
+    // `array` is a struct array without nulls of its own, see Array::import_arrow()
+    static Table import_arrow(ArrowArray* array, const ArrowSchema* schema);
+    bool operator == (const Table& rhs) const;
+    static Table null(const std::string& log = "");
+};
+
 class EventFn : public _BaseObject {
     using BaseT = _BaseObject;
     friend class Namespace;
+    friend class EventQueue;
+    friend class ShardedExecutor;
+    friend class Replay;
+    friend class EventGraph;
     class Impl;
     struct construct_t{};
 public:
@@ -205,16 +553,227 @@ private:
     std::shared_ptr<Impl> m_impl;
 public:
     explicit EventFn();
-    explicit EventFn(JustInTimeRunner& runner, const std::string& name, construct_t);
+    explicit EventFn(JustInTimeRunner& runner, const std::string& name, const FieldAccess& field_access, construct_t);
     ~EventFn() = default;
 public:
+    const std::string& name() const;
     bool is_init() const;
     void init();
+    // context fields read/written by the event, see Function::field_access()
+    const FieldAccess& field_access() const;
     int32_t on_event(const Object& o) const;
+    // objects are validated once for the whole batch, result of each call is returned in order
+    std::vector<int32_t> on_event_many(const std::vector<Object>& objects) const;
+    // runs event up to `n` times on same object. stops at first call with non-zero result and
+    // returns it, `num_processed` is set to calls done before it (index of the failing call)
+    int32_t on_event_repeat(const Object& o, uint64_t n, uint64_t* num_processed = nullptr) const;
+    // only for kernels generated by Function::mk_kernel(), runs event over `num_rows` rows in one
+    // call. fields without a column are read/written in place in `state`, so they carry over rows.
+    // only columns of fields the event writes are stored to, others may be read only.
+    // stops at first row with non-zero result and returns it, `num_processed` is set to rows done
+    int32_t on_columns(const Object& state, const std::vector<Column>& columns, uint64_t num_rows, uint64_t* num_processed = nullptr) const;
+    // opt-in rdtsc latency recording of every on_event() call, off by default
+    void enable_instrumentation();
+    void disable_instrumentation();
+    bool is_instrumented() const;
+    uint64_t call_count() const;
+    LatencyHistogram latency_histogram() const;
+    // returns histogram of the interval since last reset
+    LatencyHistogram reset_latency_histogram();
+    // hardware counters (perf_event_open) of every sample_every-th on_event() call, measured on
+    // the calling thread. returns false if counters can't be opened (no PMU / perf_event_paranoid).
+    // calling it again only changes sample_every, collected counters are kept
+    bool enable_perf_counters(uint32_t sample_every = 1);
+    void disable_perf_counters();
+    bool has_perf_counters() const;
+    PerfCounters perf_counters() const;
+    // returns counters of the interval since last reset
+    PerfCounters reset_perf_counters();
     bool operator == (const EventFn& rhs) const;
     static EventFn null(const std::string& log = "");
 };
 
+//
+// EventGraph
+//
+// Incremental recomputation over events of one context struct. Event `b` depends on
+// `a` if `b` reads a field `a` writes, bind() orders events by their dependencies.
+// on_change() then runs, in that order, only the events downstream of the changed
+// fields, skipping the rest of the graph. An opaque event reads and writes every field
+class EventGraph : public _BaseObject {
+    using BaseT = _BaseObject;
+    class Impl;
+public:
+    static constexpr uint32_t c_invalid_field = std::numeric_limits<uint32_t>::max();
+private:
+    std::shared_ptr<Impl> m_impl;
+public:
+    explicit EventGraph();
+    // `ns` resolves trigger fields of on_trigger()
+    explicit EventGraph(const Namespace& ns, const Struct& context);
+    ~EventGraph() = default;
+public:
+    // events can't be added after bind()
+    bool add_event(const EventFn& fn);
+    // fails if events depend on each other in a cycle
+    bool bind();
+    bool is_bind() const;
+    uint32_t num_events() const;
+    // id of a context field for on_change(), c_invalid_field if not found
+    uint32_t field_id(const std::string& name) const;
+    // names of events run by a change of `fields`, in run order
+    std::vector<std::string> affected_events(const std::vector<std::string>& fields) const;
+    // stops at first event with non-zero result and returns it
+    int32_t on_change(const Object& o, const std::vector<uint32_t>& field_ids) const;
+    int32_t on_change(const Object& o, const std::vector<std::string>& fields) const;
+    // change of trigger fields of `event`, see Cursor::add_field()
+    int32_t on_trigger(const Object& o, const std::string& event) const;
+    bool operator == (const EventGraph& rhs) const;
+    static EventGraph null(const std::string& log = "");
+};
+
+//
+// EventQueue
+//
+// Bounded lock-free ring of event records, each an event id plus a copy of the
+// context object, published from other threads and run in publish order by a
+// single consumer: a dispatcher thread busy polling on a pinned core, or poll().
+// The payload is read only input: it is copied into the ring at publish and the
+// event runs on that copy. Context writes made by the event are dropped with
+// the slot and never reach the published Object; events that need to keep
+// state belong on a ShardedExecutor
+class EventQueue : public _BaseObject {
+    using BaseT = _BaseObject;
+    class Impl;
+public:
+    enum class producer_t : uint8_t {
+        single,
+        multi,
+    };
+private:
+    std::shared_ptr<Impl> m_impl;
+public:
+    explicit EventQueue();
+    // capacity is rounded up to power of 2
+    explicit EventQueue(const Struct& context, uint32_t capacity, producer_t producer = producer_t::multi);
+    ~EventQueue() = default;
+public:
+    uint32_t capacity() const;
+    // id to publish `fn` with, events can't be added while dispatcher is running.
+    // latency / perf counters enabled on `fn` are recorded on the dispatching thread
+    uint32_t add_event(const EventFn& fn);
+    // false if queue is full
+    bool try_publish(uint32_t event_id, const Object& payload) const;
+    // spins while queue is full and dispatcher is running, a full queue without
+    // a dispatcher (poll mode or after stop()) is an error
+    bool publish(uint32_t event_id, const Object& payload) const;
+    // runs up to `max_events` queued events on calling thread, returns number run
+    uint64_t poll(uint64_t max_events) const;
+    // spawns dispatcher thread, pinned to `cpu` if it is >= 0
+    bool start(int32_t cpu = -1);
+    // events queued before stop() are run before it returns
+    void stop();
+    bool is_running() const;
+    uint64_t num_dispatched() const;
+    // events which returned non-zero
+    uint64_t num_failed() const;
+    bool operator == (const EventQueue& rhs) const;
+    static EventQueue null(const std::string& log = "");
+};
+
+//
+// ShardedExecutor
+//
+// Runs events over per-key state on a pool of worker threads. A key is hashed
+// to one worker, which owns the key's state object, so events of a key run in
+// submit order and events of different keys run in parallel. Before a keyed
+// event runs, input fields are copied from the submitted payload into the key's
+// state; other fields belong to the state and carry over between events.
+// Stateless events run on the payload copy and may be stolen by idle workers
+class ShardedExecutor : public _BaseObject {
+    using BaseT = _BaseObject;
+    class Impl;
+private:
+    std::shared_ptr<Impl> m_impl;
+public:
+    explicit ShardedExecutor();
+    // `keys_per_worker` state objects are allocated up front for every worker,
+    // keyed events of further keys are dropped and counted in num_dropped().
+    // State struct can't have pointer fields, as nothing links them
+    explicit ShardedExecutor(const Struct& state, uint32_t num_workers, uint32_t keys_per_worker, uint32_t queue_capacity);
+    ~ShardedExecutor() = default;
+public:
+    uint32_t num_workers() const;
+    // id to submit `fn` with, events and inputs can't be added while workers are running.
+    // latency / perf counters enabled on `fn` are recorded on the worker running the event
+    uint32_t add_event(const EventFn& fn);
+    bool add_input_field(const std::string& name);
+    uint32_t worker_of(uint64_t key) const;
+    // spin while queue of the worker is full, fail if it is full and workers are stopped
+    bool submit(uint64_t key, uint32_t event_id, const Object& payload) const;
+    bool submit_stateless(uint32_t event_id, const Object& payload) const;
+    // one worker per entry of `cpus` is pinned to it
+    bool start(const std::vector<int32_t>& cpus = {});
+    // waits until every event submitted so far has run
+    void drain() const;
+    // events queued before stop() are run before it returns
+    void stop();
+    bool is_running() const;
+    // state of a key, only while workers are stopped
+    Object state(uint64_t key) const;
+    uint64_t num_keys() const;
+    uint64_t num_dispatched() const;
+    // events which returned non-zero
+    uint64_t num_failed() const;
+    // keyed events of a worker which ran out of state objects
+    uint64_t num_dropped() const;
+    // stateless events run by a worker other than the one they were queued on
+    uint64_t num_stolen() const;
+    bool operator == (const ShardedExecutor& rhs) const;
+    static ShardedExecutor null(const std::string& log = "");
+};
+
+//
+// Replay
+//
+// Memory mapped file of fixed layout records of a struct, fed to an event one
+// record at a time. With `records` layout the file is num_records() struct buffers
+// back to back, with `columns` layout it is one column of num_records() values per
+// non pointer field, in field order. Pointer fields are not read from the file,
+// they keep what is linked in the state object
+class Replay : public _BaseObject {
+    using BaseT = _BaseObject;
+    class Impl;
+public:
+    enum class layout_t : uint8_t {
+        records,
+        columns,
+    };
+private:
+    std::shared_ptr<Impl> m_impl;
+public:
+    explicit Replay();
+    explicit Replay(const Struct& record, const std::string& path, layout_t layout = layout_t::records);
+    ~Replay() = default;
+public:
+    layout_t layout() const;
+    uint64_t num_records() const;
+    // records touched ahead of the one being run, 0 disables prefetching
+    void set_prefetch_distance(uint32_t num_records);
+    // copies fields of each record in [begin, end) into `state`, a frozen object of
+    // the record struct, and runs `fn` on it. A kernel instead runs over the mapped
+    // records in one on_columns() call without copies, fields it writes are read and
+    // written in `state` and it can't both read and write a field of the file. Stops at
+    // first non-zero result and returns it, `num_processed` is set to records done
+    int32_t run(const EventFn& fn, const Object& state, uint64_t begin, uint64_t end, uint64_t* num_processed = nullptr) const;
+    // runs `fn` with its context pointing at each mapped record, only for `records`
+    // layout of a struct without pointer fields. Mapping is read only, so `fn` must
+    // not write context fields
+    int32_t run_in_place(const EventFn& fn, uint64_t begin, uint64_t end, uint64_t* num_processed = nullptr) const;
+    bool operator == (const Replay& rhs) const;
+    static Replay null(const std::string& log = "");
+};
+
 // TODO{vibhanshu}: Namespace can't have circular dependency,
 //           if a event in namespace A depends on event in namespace B
 //           then there can  be no dependency of any event in B on any event of A
@@ -240,11 +799,18 @@ public:
     void bind();
     Struct struct_info(const std::string& name) const;
     EventFn event_fn_info(const std::string& name) const;
+    // context fields which fire `event`, see Cursor::add_field()
+    std::vector<std::string> trigger_fields(const std::string& event) const;
+    // maps a file written by Object::write_checkpoint() and returns its root, frozen.
+    // Struct layouts in the file must match the structs of this namespace. Buffers
+    // are used in place from a private mapping, pages are read on first access
+    Object load_checkpoint(const std::string& path) const;
     bool operator == (const Namespace& rhs) const;
     static Namespace null(const std::string& log = "");
 private:
     void add_struct(const TypeInfo& struct_type);
-    void add_event(const std::string& e);
+    void add_event(const std::string& e, const FieldAccess& field_access);
+    void add_trigger(const std::string& event, const std::vector<std::string>& fields);
 };
 
 } // namespace runtime
@@ -273,10 +839,21 @@ public:
     void bind();
     bool is_bind() const;
     bool contains_symbol_definition(const std::string& name) const;
+    // register jit'ed objects with gdb jit interface / perf jitdump, call before add_module()
+    // pair it with Cursor::enable_debug_info() for source line mapping
+    bool enable_gdb_listener();
+    bool enable_perf_listener();
     // TODO{vibhanshu}: allow ability to customize passes based on user requirement
     bool process_module_fn(Function& fn);
     void add_module(Cursor& cursor);
     fn_t* get_fn(const std::string& symbol) const;
+    // rdtsc latency of symbol lookups done through get_fn()
+    LatencyHistogram lookup_latency() const;
+    // keep emitted objects so machine code can be disassembled, call before add_module()
+    // with Cursor::enable_debug_info() instructions are also mapped to DSL values
+    bool enable_disassembly();
+    // final machine code of a bound symbol, empty on failure
+    analysis::Disassembly disassemble(const std::string& symbol) const;
     runtime::Namespace get_namespace(const std::string& name) const;
     runtime::Namespace get_global_namespace() const;
     bool operator == (const JustInTimeRunner& o) const;
@@ -15,6 +15,7 @@
 #include <unordered_map>
 #include <memory>
 #include <functional>
+#include <vector>
 
 namespace llvm {
     class Module;
@@ -26,6 +27,7 @@ namespace llvm {
 LLVM_BUILDER_NS_BEGIN
 
 class CursorPtr;
+class DebugInfoBuilder;
 class Function;
 class Module;
 class JustInTimeRunner;
@@ -35,6 +37,9 @@ class Cursor : public _BaseObject {
     friend class CursorPtr;
 public:
     class Impl;
+    // uint64 context field added by enable_changed_fields()
+    static constexpr const char* c_changed_fields_name = "_changed_fields";
+    static constexpr uint32_t c_max_changed_fields = 63;
 public:
     CONTEXT_DECL(Cursor)
     using on_main_module_fn_t = std::function<void(Module&)>;
@@ -52,7 +57,20 @@ public:
     Module gen_module();
     void main_module_hook_fn(on_main_module_fn_t&& fn);
     bool is_bind_called();
+    // emit DWARF line info mapping generated code to CODEGEN_LINE locations,
+    // needs to be called before bind()
+    void enable_debug_info();
+    bool is_debug_info_enabled();
+    // every event sets bit i of context field c_changed_fields_name when it leaves field i
+    // with a value other than the one it had on entry, so consumers can skip unchanged
+    // fields, see runtime::Object::changed_fields(). Needs to be called before bind(),
+    // context can have at most c_max_changed_fields other fields
+    void enable_changed_fields();
+    bool is_changed_fields_enabled();
+    // `event` is fired by a change of this field, see Event::fields()
     void add_field(const std::string& name, TypeInfo type, Event event = Event::null());
+    // events created by Event::from_name() in this cursor
+    std::vector<Event> events();
     void bind(const std::string& context_name);
     void cleanup();
     void for_each_module(on_module_fn_t&& fn);
@@ -82,6 +100,7 @@ public:
     const std::vector<LinkSymbol>& public_symbols() const;
     TypeInfo struct_type(const std::string &name) const;
     llvm::Module *native_handle() const;
+    DebugInfoBuilder* debug_info_builder() const;
     std::vector<std::string> exported_symbol_names() const;
     std::vector<std::string> transformed_public_symbols(std::function<std::string(const LinkSymbol&)>&& fn) const;
     std::string public_symbol_name(const std::string& symbol) const;
@@ -0,0 +1,205 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_ROLLING_H_
+#define LLVM_BUILDER_ROLLING_H_
+
+#include "defines.h"
+#include "type.h"
+#include "value.h"
+#include "llvm_builder/util/object.h"
+
+#include <string>
+#include <vector>
+
+LLVM_BUILDER_NS_BEGIN
+
+// NOTE{vibhanshu}: rolling statistics are kept in a struct of their mk_type(), usually a
+//                  context field pointing to it, and update() is emitted inline into the
+//                  calling event with O(1) work per update. State is stored by update()
+//                  and read by accessors, which like RingBuffer see the state on entry to
+//                  the code section, use FunctionContext::section_break() to read the
+//                  updated statistic in the same event
+
+//
+// Ewma
+//
+// exponentially weighted moving average of a float, fields
+//     value, is_seeded
+// with alpha = 2 / (window + 1), first update() seeds value
+class Ewma : public _BaseObject {
+    using BaseT = _BaseObject;
+private:
+    ValueInfo m_base;
+    TypeInfo m_element_type;
+    uint32_t m_window = 0;
+public:
+    explicit Ewma();
+    explicit Ewma(const ValueInfo& base, uint32_t window);
+    ~Ewma() = default;
+public:
+    const TypeInfo& element_type() const {
+        return m_element_type;
+    }
+    uint32_t window() const {
+        return m_window;
+    }
+    double alpha() const {
+        return 2.0 / (m_window + 1.0);
+    }
+    void update(const ValueInfo& x) const;
+    [[nodiscard]]
+    ValueInfo value() const;
+public:
+    static Ewma null(const std::string& log = "");
+    static TypeInfo mk_type(const std::string& name, TypeInfo element_type);
+};
+
+//
+// RollingStats
+//
+// sum, mean and variance of last window() values, a RingBuffer of the values with fields
+//     sum, mean, m2
+// after the slots. Mean and m2 are updated with Welford's algorithm, adding the new value
+// and removing the one leaving the window in the same step, so they don't drift like a
+// running sum does. They are float64 for integer values
+class RollingStats : public _BaseObject {
+    using BaseT = _BaseObject;
+private:
+    RingBuffer m_ring;
+    TypeInfo m_stat_type;
+public:
+    explicit RollingStats();
+    explicit RollingStats(const ValueInfo& base);
+    ~RollingStats() = default;
+public:
+    const TypeInfo& element_type() const {
+        return m_ring.element_type();
+    }
+    // type of mean() and variance()
+    const TypeInfo& stat_type() const {
+        return m_stat_type;
+    }
+    uint32_t window() const {
+        return m_ring.capacity();
+    }
+    const RingBuffer& ring() const {
+        return m_ring;
+    }
+    void update(const ValueInfo& x) const;
+    // number of values in the window, uint32
+    [[nodiscard]]
+    ValueInfo count() const;
+    [[nodiscard]]
+    ValueInfo sum() const;
+    [[nodiscard]]
+    ValueInfo mean() const;
+    // sample variance, 0 for less than 2 values
+    [[nodiscard]]
+    ValueInfo variance() const;
+public:
+    static RollingStats null(const std::string& log = "");
+    static TypeInfo mk_type(const std::string& name, TypeInfo element_type, uint32_t window);
+    static TypeInfo stat_type(TypeInfo element_type);
+};
+
+//
+// RollingMinMax
+//
+// min or max of last window() values, a RingBuffer of the values with fields
+//     value, prefix, suffix_0 .. suffix_{window - 1}
+// after the slots. Stream is cut in blocks of window() values, a window is a suffix of
+// previous block and a prefix of current one, so
+//     value = best(suffix[head + 1] of previous block, prefix of current block)
+// prefix is updated per value and suffixes of a block once it is complete, which is
+// O(window) every window() values. The suffix pass is a loop, so code of update() is the
+// same for any window, while the struct holds 2 * window() values. It is the only branch,
+// update() ends the code section and value() after it reads the updated extremum
+// NOTE{vibhanshu}: usual monotonic deque pops a variable number of entries per value,
+//                  the block scheme keeps that work out of the common path
+class RollingMinMax : public _BaseObject {
+    using BaseT = _BaseObject;
+public:
+    static constexpr const char* c_suffix_prefix = "suffix_";
+    enum class kind_t : uint8_t {
+        min,
+        max,
+    };
+private:
+    RingBuffer m_ring;
+    ArrayView m_suffix;
+    kind_t m_kind = kind_t::min;
+public:
+    explicit RollingMinMax();
+    explicit RollingMinMax(const ValueInfo& base, kind_t kind);
+    ~RollingMinMax() = default;
+public:
+    const TypeInfo& element_type() const {
+        return m_ring.element_type();
+    }
+    uint32_t window() const {
+        return m_ring.capacity();
+    }
+    kind_t kind() const {
+        return m_kind;
+    }
+    const RingBuffer& ring() const {
+        return m_ring;
+    }
+    void update(const ValueInfo& x) const;
+    [[nodiscard]]
+    ValueInfo value() const;
+public:
+    static RollingMinMax null(const std::string& log = "");
+    static TypeInfo mk_type(const std::string& name, TypeInfo element_type, uint32_t window);
+private:
+    ValueInfo M_best(const ValueInfo& a, const ValueInfo& b) const;
+};
+
+//
+// Vwap
+//
+// volume weighted average price of last window() trades, a RingBuffer of price * qty with
+// fields
+//     qty_0 .. qty_{window - 1}, sum_notional, sum_qty
+// after the slots, qty_i being quantity of slot_i. Price is a float, quantity a float or an
+// integer, whose sum is then exact
+class Vwap : public _BaseObject {
+    using BaseT = _BaseObject;
+public:
+    static constexpr const char* c_qty_prefix = "qty_";
+private:
+    RingBuffer m_ring;
+    ArrayView m_qty;
+public:
+    explicit Vwap();
+    explicit Vwap(const ValueInfo& base);
+    ~Vwap() = default;
+public:
+    const TypeInfo& price_type() const {
+        return m_ring.element_type();
+    }
+    const TypeInfo& qty_type() const {
+        return m_qty.element_type();
+    }
+    uint32_t window() const {
+        return m_ring.capacity();
+    }
+    const RingBuffer& ring() const {
+        return m_ring;
+    }
+    void update(const ValueInfo& price, const ValueInfo& qty) const;
+    // 0 while window holds no quantity
+    [[nodiscard]]
+    ValueInfo value() const;
+    [[nodiscard]]
+    ValueInfo sum_qty() const;
+public:
+    static Vwap null(const std::string& log = "");
+    static TypeInfo mk_type(const std::string& name, TypeInfo price_type, TypeInfo qty_type, uint32_t window);
+};
+
+LLVM_BUILDER_NS_END
+
+#endif // LLVM_BUILDER_ROLLING_H_
@@ -0,0 +1,56 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_UTIL_ARROW_C_DATA_H_
+#define LLVM_BUILDER_UTIL_ARROW_C_DATA_H_
+
+#include <cstdint>
+
+//
+// Arrow C Data Interface
+//
+// ABI stable structs of https://arrow.apache.org/docs/format/CDataInterface.html,
+// copied as the spec asks, guarded so they can coexist with arrow's own headers.
+// A producer fills them and sets `release`, the consumer moves them out (copies
+// the struct and sets `release` of the source to nullptr) and calls `release`
+// once it no longer uses the buffers
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+extern "C" {
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+} // extern "C"
+
+#endif // ARROW_C_DATA_INTERFACE
+
+#endif // LLVM_BUILDER_UTIL_ARROW_C_DATA_H_
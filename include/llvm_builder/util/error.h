@@ -109,6 +109,9 @@ public:
     }
     static void update_top(const std::string& file_name, uint32_t line_no);
     static bool peek(SourceLoc& val);
+    // top most location which doesn't belong to llvm_builder internals,
+    // i.e the user line which triggered the current codegen call
+    static bool peek_external(SourceLoc& val);
     static SourceLoc pop();
     static std::vector<SourceLoc> pop(uint32_t pos);
     static void clear(); 
@@ -0,0 +1,71 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_UTIL_HISTOGRAM_H_
+#define LLVM_BUILDER_UTIL_HISTOGRAM_H_
+
+#include "llvm_builder/defines.h"
+
+#include <cstdint>
+#include <vector>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// LatencyHistogram
+//
+// Point-in-time copy of a latency recording, values are in rdtsc ticks.
+// Buckets are log-linear (HDR style): values below c_num_sub_buckets are exact,
+// above that every power of two is split into c_num_sub_buckets equal buckets,
+// so relative error of any reported value is bounded by 1/c_num_sub_buckets
+class LatencyHistogram {
+public:
+    enum : uint32_t {
+        c_sub_bucket_bits = 4,
+        c_num_sub_buckets = 1u << c_sub_bucket_bits,
+        c_num_buckets = (64 - c_sub_bucket_bits + 1) * c_num_sub_buckets,
+    };
+private:
+    std::vector<uint64_t> m_counts;
+    uint64_t m_count = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_min = 0;
+    uint64_t m_max = 0;
+public:
+    explicit LatencyHistogram();
+    explicit LatencyHistogram(std::vector<uint64_t>&& counts, uint64_t count, uint64_t sum, uint64_t min, uint64_t max);
+    ~LatencyHistogram() = default;
+public:
+    uint64_t count() const {
+        return m_count;
+    }
+    uint64_t sum() const {
+        return m_sum;
+    }
+    uint64_t min() const {
+        return m_min;
+    }
+    uint64_t max() const {
+        return m_max;
+    }
+    bool empty() const {
+        return m_count == 0;
+    }
+    double mean() const;
+    uint64_t percentile(double p) const;
+    uint64_t bucket_count(uint32_t idx) const;
+    void print(std::ostream& os) const;
+    friend std::ostream& operator << (std::ostream& os, const LatencyHistogram& o) {
+        o.print(os);
+        return os;
+    }
+public:
+    static uint32_t bucket_index(uint64_t value);
+    static uint64_t bucket_lower_bound(uint32_t idx);
+    static uint64_t bucket_upper_bound(uint32_t idx);
+};
+
+LLVM_BUILDER_NS_END
+
+#endif // LLVM_BUILDER_UTIL_HISTOGRAM_H_
@@ -0,0 +1,86 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_UTIL_PERF_COUNTER_H_
+#define LLVM_BUILDER_UTIL_PERF_COUNTER_H_
+
+#include "llvm_builder/defines.h"
+
+#include <array>
+#include <cstdint>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// PerfCounters
+//
+// Point-in-time copy of hardware counter deltas accumulated over sampled
+// calls. A counter which could not be opened on this host (e.g. no PMU access
+// in a VM) is reported as unavailable and reads as 0
+class PerfCounters {
+public:
+    enum class counter_t : uint32_t {
+        cycles,
+        instructions,
+        branch_misses,
+        l1d_misses,
+        llc_misses,
+    };
+    enum : uint32_t {
+        c_num_counters = 5,
+    };
+    using values_t = std::array<uint64_t, c_num_counters>;
+private:
+    values_t m_values{};
+    uint64_t m_num_calls = 0;
+    uint64_t m_num_samples = 0;
+    uint32_t m_available_mask = 0;
+public:
+    explicit PerfCounters() = default;
+    explicit PerfCounters(const values_t& values, uint64_t num_calls, uint64_t num_samples, uint32_t available_mask);
+    ~PerfCounters() = default;
+public:
+    uint64_t value(counter_t c) const {
+        return m_values[static_cast<uint32_t>(c)];
+    }
+    bool is_available(counter_t c) const {
+        return (m_available_mask & (1u << static_cast<uint32_t>(c))) != 0;
+    }
+    uint64_t cycles() const {
+        return value(counter_t::cycles);
+    }
+    uint64_t instructions() const {
+        return value(counter_t::instructions);
+    }
+    uint64_t branch_misses() const {
+        return value(counter_t::branch_misses);
+    }
+    uint64_t l1d_misses() const {
+        return value(counter_t::l1d_misses);
+    }
+    uint64_t llc_misses() const {
+        return value(counter_t::llc_misses);
+    }
+    // total on_event() calls, including the ones not sampled
+    uint64_t num_calls() const {
+        return m_num_calls;
+    }
+    uint64_t num_samples() const {
+        return m_num_samples;
+    }
+    double ipc() const;
+    // average of counter over one sampled call
+    double per_sample(counter_t c) const;
+    void print(std::ostream& os) const;
+    friend std::ostream& operator << (std::ostream& os, const PerfCounters& o) {
+        o.print(os);
+        return os;
+    }
+public:
+    static const char* counter_name(counter_t c);
+};
+
+LLVM_BUILDER_NS_END
+
+#endif // LLVM_BUILDER_UTIL_PERF_COUNTER_H_
@@ -10,6 +10,7 @@
 #include "type.h"
 #include "llvm_builder/util/object.h"
 
+#include <limits>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -27,7 +28,8 @@ class Function;
 class CodeSection;
 class ValuePtrInfo;
 
-// TODO{vibhanshu}: build this tag info infra to debug from binary to the source code
+// NOTE{vibhanshu}: binary to source mapping is done via ValueInfo::source_loc() and DWARF line info,
+//                  tags are only user defined labels on top of it
 class TagInfo {
     enum : uint8_t {
         c_delim = '|'
@@ -45,6 +47,17 @@ public:
     bool contains(std::string_view v) const;
     void add_entry(const std::string& v);
     TagInfo set_union(const TagInfo& o) const;
+    const std::vector<std::string>& values() const {
+        return m_values;
+    }
+    bool empty() const {
+        return m_values.empty();
+    }
+    void print(std::ostream& os) const;
+    friend std::ostream& operator << (std::ostream& os, const TagInfo& o) {
+        o.print(os);
+        return os;
+    }
 };
 
 // TODO{vibhanshu}: cache M_eval() output per code-section to remove redundant computation
@@ -55,8 +68,13 @@ class ValueInfo : public _BaseObject {
     friend class Function;
     struct construct_const_t{};
     struct construct_entry_t{};
+    struct construct_strided_t{};
     struct construct_binary_op_t{};
     struct construct_fn_t{};
+    enum : uint32_t {
+        c_local_field = std::numeric_limits<uint32_t>::max() - 1,
+        c_unknown_field = std::numeric_limits<uint32_t>::max()
+    };
 public:
     enum class value_type_t {
         null,
@@ -70,6 +88,8 @@ public:
         store,
         load_vector_entry,
         store_vector_entry,
+        valid_bit,
+        strided_entry,
         mk_ptr,
         fn_call,
         fn_ptr_call,
@@ -84,6 +104,8 @@ private:
                        const std::vector<ValueInfo>& parent);
     explicit ValueInfo(const TypeInfo& type_info, llvm::Value* v, construct_const_t);
     explicit ValueInfo(const ValueInfo& parent, const TypeInfo& entry_type, const ValueInfo& entry_idx, construct_entry_t);
+    explicit ValueInfo(const ValueInfo& parent, const TypeInfo& entry_type, const ValueInfo& entry_idx,
+                       uint32_t offset, uint32_t stride, construct_strided_t);
     explicit ValueInfo(const TypeInfo& res_type, const ValueInfo& v1, const ValueInfo& v2, binary_op_fn_t fn, construct_binary_op_t);
     explicit ValueInfo(llvm::Function* fn, construct_fn_t);
 public:
@@ -96,6 +118,8 @@ public:
     value_type_t value_type() const;
     TypeInfo type() const;
     const TagInfo& tag_info() const;
+    // host source line which created this value, used for DWARF line info
+    const SourceLoc& source_loc() const;
     [[nodiscard]]
     ValueInfo cast(TypeInfo target_type) const;
 #define MK_BINARY_FN(FN_NAME)                                              \
@@ -129,6 +153,10 @@ public:
         return remainder(v2);
     }
     [[nodiscard]]
+    ValueInfo operator&(const ValueInfo& v2) const {
+        return bit_and(v2);
+    }
+    [[nodiscard]]
     ValueInfo operator<(const ValueInfo& v2) const {
         return less_than(v2);
     }
@@ -158,6 +186,18 @@ public:
     ValueInfo entry(const ValueInfo& i) const;
     [[nodiscard]]
     ValueInfo field(const std::string& s) const;
+    // bit `i` (lsb first) of an arrow validity bitmap, this being a pointer to uint8
+    // array, see runtime::Array::validity()
+    [[nodiscard]]
+    ValueInfo is_valid_entry(const ValueInfo& i) const;
+    // loads entry `i`, or `fallback` if it is null in `validity`. Arrow keeps a
+    // slot for null entries too, so entry is loaded either way and there is no branch
+    [[nodiscard]]
+    ValueInfo entry_or(const ValueInfo& i, const ValueInfo& validity, const ValueInfo& fallback) const;
+    // pointer to `entry_type` at byte `offset + i * stride` of the array or struct this
+    // points to, for data laid out by the caller, see Collection and ArrayView
+    [[nodiscard]]
+    ValueInfo strided_entry(const ValueInfo& i, TypeInfo entry_type, uint32_t offset, uint32_t stride) const;
     [[nodiscard]]
     ValueInfo load_vector_entry(uint32_t i) const;
     ValueInfo store_vector_entry(uint32_t i, ValueInfo value) const;
@@ -186,6 +226,219 @@ private:
     void M_self_intern();
     bool M_is_value_sink() const;
     const std::vector<ValueInfo>& M_parents() const;
+    // index of context field this pointer is reached from, through entries and pointers
+    // loaded from fields. c_local_field for a FunctionContext::mk_ptr() variable
+    uint32_t M_context_field() const;
+};
+
+//
+// Collection
+//
+// `capacity` instances of a struct kept in one raw buffer, a pointer to uint8 array
+// of buffer_type(). With `aos` layout buffer is capacity struct records back to back,
+// with `soa` layout it is one column of capacity values per field, in field order,
+// each column aligned to c_column_alignment. entry(i).field(s) lowers to
+//     buffer + field_offset(s) + i * field_stride(s)
+// so a kernel is written once and layout is switched where collection is declared
+class Collection : public _BaseObject {
+    using BaseT = _BaseObject;
+public:
+    class Entry;
+    enum class layout_t : uint8_t {
+        aos,
+        soa,
+    };
+    enum : uint32_t {
+        c_column_alignment = 64,
+    };
+private:
+    ValueInfo m_buffer;
+    TypeInfo m_element_type;
+    uint32_t m_capacity = 0;
+    layout_t m_layout = layout_t::aos;
+    // by field idx
+    std::vector<uint32_t> m_field_offsets;
+    std::vector<uint32_t> m_field_strides;
+    uint32_t m_num_bytes = 0;
+public:
+    explicit Collection();
+    // `buffer` is a pointer to uint8 array of buffer_type(element_type, capacity, layout)
+    explicit Collection(const ValueInfo& buffer, TypeInfo element_type, uint32_t capacity, layout_t layout);
+    ~Collection() = default;
+public:
+    const ValueInfo& buffer() const {
+        return m_buffer;
+    }
+    const TypeInfo& element_type() const {
+        return m_element_type;
+    }
+    uint32_t capacity() const {
+        return m_capacity;
+    }
+    layout_t layout() const {
+        return m_layout;
+    }
+    uint32_t num_bytes() const {
+        return m_num_bytes;
+    }
+    uint32_t field_offset(const std::string& s) const;
+    uint32_t field_stride(const std::string& s) const;
+    // host side address arithmetic of entry(i).field(s), for filling the buffer at runtime
+    uint32_t byte_offset(uint32_t i, const std::string& s) const;
+    [[nodiscard]]
+    Entry entry(uint32_t i) const;
+    [[nodiscard]]
+    Entry entry(const ValueInfo& i) const;
+public:
+    static Collection null(const std::string& log = "");
+    // type of context field holding the buffer, use num_bytes() for its size at runtime
+    static TypeInfo buffer_type(TypeInfo element_type, uint32_t capacity, layout_t layout);
+    static uint32_t buffer_size(TypeInfo element_type, uint32_t capacity, layout_t layout);
+private:
+    static bool M_layout(TypeInfo element_type, uint32_t capacity, layout_t layout,
+                         std::vector<uint32_t>& offsets, std::vector<uint32_t>& strides, uint32_t& num_bytes);
+};
+
+class Collection::Entry {
+    friend class Collection;
+private:
+    Collection m_collection;
+    ValueInfo m_idx;
+private:
+    explicit Entry(const Collection& collection, const ValueInfo& idx);
+public:
+    // pointer to field `s` of the entry, same as ValueInfo::field() of a struct pointer
+    [[nodiscard]]
+    ValueInfo field(const std::string& s) const;
+};
+
+//
+// ArrayView
+//
+// `length` entries of element_type(), byte_stride() bytes apart from byte_offset()
+// of the array or struct `base` points to. entry(i) indexes through the stride in
+// place, so a window of an array or a column of a row major matrix is read without
+// copying it into a fresh array
+class ArrayView : public _BaseObject {
+    using BaseT = _BaseObject;
+private:
+    ValueInfo m_base;
+    TypeInfo m_element_type;
+    uint32_t m_byte_offset = 0;
+    uint32_t m_byte_stride = 0;
+    uint32_t m_length = 0;
+public:
+    explicit ArrayView();
+    // all entries of array `base` points to
+    explicit ArrayView(const ValueInfo& base);
+    // entries offset, offset + stride, ... of array `base` points to
+    explicit ArrayView(const ValueInfo& base, uint32_t offset, uint32_t length, uint32_t stride = 1);
+    ~ArrayView() = default;
+private:
+    explicit ArrayView(const ValueInfo& base, TypeInfo element_type, uint32_t byte_offset, uint32_t byte_stride, uint32_t length);
+public:
+    const ValueInfo& base() const {
+        return m_base;
+    }
+    const TypeInfo& element_type() const {
+        return m_element_type;
+    }
+    uint32_t byte_offset() const {
+        return m_byte_offset;
+    }
+    uint32_t byte_stride() const {
+        return m_byte_stride;
+    }
+    uint32_t length() const {
+        return m_length;
+    }
+    // pointer to entry `i`
+    [[nodiscard]]
+    ValueInfo entry(uint32_t i) const;
+    [[nodiscard]]
+    ValueInfo entry(const ValueInfo& i) const;
+    // entries begin, begin + step, ... of this view
+    [[nodiscard]]
+    ArrayView slice(uint32_t begin, uint32_t length, uint32_t step = 1) const;
+public:
+    static ArrayView null(const std::string& log = "");
+    // fields `names` of struct `base` points to, of same type and evenly spaced in
+    // given order, e.g. arg_1 .. arg_n
+    static ArrayView from_fields(const ValueInfo& base, const std::vector<std::string>& names);
+};
+
+//
+// RingBuffer
+//
+// last capacity() values pushed into a struct of mk_type(), with fields
+//     head, size, slot_0 .. slot_{capacity - 1}, extra fields ...
+// head is slot of next push and size saturates at capacity. Slots are plain fields,
+// so buffer lives inline in the object holding it and is a runtime::Object at runtime,
+// see runtime::RingBuffer. Slot index wraps with a mask when capacity is a power of
+// two and with a select otherwise, there is neither a divide nor a branch
+// NOTE{vibhanshu}: loads of a code section are emitted before its stores, so at()/size()
+//                  see the buffer as it was on entry to the section, a value pushed in
+//                  a section is read from the next one
+class RingBuffer : public _BaseObject {
+    using BaseT = _BaseObject;
+public:
+    static constexpr const char* c_head_field = "head";
+    static constexpr const char* c_size_field = "size";
+private:
+    ValueInfo m_base;
+    ArrayView m_slots;
+public:
+    explicit RingBuffer();
+    // `base` is a pointer to struct of mk_type()
+    explicit RingBuffer(const ValueInfo& base);
+    ~RingBuffer() = default;
+public:
+    const ValueInfo& base() const {
+        return m_base;
+    }
+    const TypeInfo& element_type() const {
+        return m_slots.element_type();
+    }
+    uint32_t capacity() const {
+        return m_slots.length();
+    }
+    bool is_pow2() const {
+        return (capacity() & (capacity() - 1)) == 0;
+    }
+    const ArrayView& slots() const {
+        return m_slots;
+    }
+    void push(const ValueInfo& v) const;
+    // pointer to `i`th newest value, at(0) is the last pushed one. `i` beyond size()
+    // reads a stale slot and runtime `i` beyond capacity() still stays in the buffer
+    [[nodiscard]]
+    ValueInfo at(uint32_t i) const;
+    [[nodiscard]]
+    ValueInfo at(const ValueInfo& i) const;
+    [[nodiscard]]
+    ValueInfo newest() const;
+    // pointer to the value next push() overwrites once buffer is full
+    [[nodiscard]]
+    ValueInfo oldest() const;
+    // number of values held, uint32
+    [[nodiscard]]
+    ValueInfo size() const;
+    // slot next push() writes, uint32
+    [[nodiscard]]
+    ValueInfo head() const;
+    [[nodiscard]]
+    ValueInfo oldest_slot() const;
+    [[nodiscard]]
+    ValueInfo is_full() const;
+public:
+    static RingBuffer null(const std::string& log = "");
+    // `extra_fields` follow the slots, for state kept next to the window
+    static TypeInfo mk_type(const std::string& name, TypeInfo element_type, uint32_t capacity,
+                            const std::vector<field_entry_t>& extra_fields = {});
+    static std::string slot_name(uint32_t i);
+private:
+    // slot in [0, 2 * capacity) wrapped into [0, capacity)
+    ValueInfo M_wrap(const ValueInfo& slot) const;
 };
 
 // TODO{vibhanshu}: ability to specify preferred branch to avoid 2 jumps in instruction
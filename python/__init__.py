@@ -29,7 +29,18 @@ from .llvm_builder_py import (
     # Values
     ValueInfo,
     TagInfo,
+    ArrayView,
+    RingBuffer,
+    Ewma,
+    RollingStats,
+    RollingMinMax,
+    RollingMinMaxKind,
+    Vwap,
+    Collection,
+    CollectionEntry,
+    CollectionLayout,
     # Functions
+    FieldAccess,
     Function,
     CodeSection,
     FunctionContext,
@@ -45,8 +56,24 @@ from .llvm_builder_py import (
     RuntimeStruct,
     RuntimeObject,
     RuntimeArray,
+    RuntimeArrayView,
+    RuntimeRingBuffer,
     RuntimeField,
     RuntimeEventFn,
+    QueueProducer,
+    EventGraph,
+    EventQueue,
+    ShardedExecutor,
+    ReplayLayout,
+    Replay,
+    Table,
+    SharedRegion,
+    Snapshot,
+    LatencyHistogram,
+    PerfCounter,
+    PerfCounters,
+    AsmInst,
+    Disassembly,
 )
 
 __version__ = "1.0.0"
@@ -62,8 +89,19 @@ __all__ = [
     "LinkSymbolName",
     # Values
     "ValueInfo",
+    "ArrayView",
+    "RingBuffer",
+    "Ewma",
+    "RollingStats",
+    "RollingMinMax",
+    "RollingMinMaxKind",
+    "Vwap",
+    "Collection",
+    "CollectionEntry",
+    "CollectionLayout",
     "TagInfo",
     # Functions
+    "FieldAccess",
     "Function",
     "CodeSection",
     "FunctionContext",
@@ -79,8 +117,24 @@ __all__ = [
     "RuntimeStruct",
     "RuntimeObject",
     "RuntimeArray",
+    "RuntimeArrayView",
+    "RuntimeRingBuffer",
     "RuntimeField",
     "RuntimeEventFn",
+    "QueueProducer",
+    "EventGraph",
+    "EventQueue",
+    "ShardedExecutor",
+    "ReplayLayout",
+    "Replay",
+    "Table",
+    "SharedRegion",
+    "Snapshot",
+    "LatencyHistogram",
+    "PerfCounter",
+    "PerfCounters",
+    "AsmInst",
+    "Disassembly",
     # Convenience functions
     "void",
     "bool_",
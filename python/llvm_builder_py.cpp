@@ -8,10 +8,15 @@
 #include <nanobind/stl/vector.h>
 #include <nanobind/stl/function.h>
 #include <nanobind/stl/shared_ptr.h>
+#include <nanobind/ndarray.h>
+
+#include <cstring>
+#include <sstream>
 
 #include "llvm_builder/module.h"
 #include "llvm_builder/type.h"
 #include "llvm_builder/value.h"
+#include "llvm_builder/rolling.h"
 #include "llvm_builder/function.h"
 #include "llvm_builder/jit.h"
 
@@ -166,7 +171,14 @@ void bind_values(nb::module_& m) {
         .def(nb::init<const std::string&>(), "value"_a)
         .def("contains", &TagInfo::contains, "v"_a)
         .def("add_entry", &TagInfo::add_entry, "v"_a)
-        .def("set_union", &TagInfo::set_union, "other"_a);
+        .def("set_union", &TagInfo::set_union, "other"_a)
+        .def("values", &TagInfo::values)
+        .def("empty", &TagInfo::empty)
+        .def("__repr__", [](const TagInfo& self) {
+            std::ostringstream os;
+            os << self;
+            return os.str();
+        });
 
     // ValueInfo
     nb::class_<ValueInfo>(m, "ValueInfo")
@@ -186,6 +198,7 @@ void bind_values(nb::module_& m) {
         .def("mult", &ValueInfo::mult, "v2"_a)
         .def("div", &ValueInfo::div, "v2"_a)
         .def("remainder", &ValueInfo::remainder, "v2"_a)
+        .def("bit_and", &ValueInfo::bit_and, "v2"_a)
         // Comparison operations
         .def("less_than", &ValueInfo::less_than, "v2"_a)
         .def("less_than_equal", &ValueInfo::less_than_equal, "v2"_a)
@@ -201,6 +214,7 @@ void bind_values(nb::module_& m) {
         .def("__mul__", &ValueInfo::operator*)
         .def("__truediv__", &ValueInfo::operator/)
         .def("__mod__", &ValueInfo::operator%)
+        .def("__and__", &ValueInfo::operator&)
         .def("__lt__", &ValueInfo::operator<)
         .def("__le__", &ValueInfo::operator<=)
         .def("__gt__", &ValueInfo::operator>)
@@ -212,6 +226,10 @@ void bind_values(nb::module_& m) {
         .def("entry", nb::overload_cast<uint32_t>(&ValueInfo::entry, nb::const_), "i"_a)
         .def("entry", nb::overload_cast<const ValueInfo&>(&ValueInfo::entry, nb::const_), "i"_a)
         .def("field", &ValueInfo::field, "name"_a)
+        // Arrow validity bitmaps
+        .def("is_valid_entry", &ValueInfo::is_valid_entry, "i"_a)
+        .def("entry_or", &ValueInfo::entry_or, "i"_a, "validity"_a, "fallback"_a)
+        .def("strided_entry", &ValueInfo::strided_entry, "i"_a, "entry_type"_a, "offset"_a, "stride"_a)
         // Vector operations
         .def("load_vector_entry", [](const ValueInfo& self, uint32_t i) {
             return self.load_vector_entry(i);
@@ -238,6 +256,131 @@ void bind_values(nb::module_& m) {
         .def_static("from_uint64", &ValueInfo::from_constant<uint64_t>, "v"_a)
         .def_static("from_float32", &ValueInfo::from_constant<float>, "v"_a)
         .def_static("from_float64", &ValueInfo::from_constant<double>, "v"_a);
+
+    // Collection
+    nb::enum_<Collection::layout_t>(m, "CollectionLayout")
+        .value("aos", Collection::layout_t::aos)
+        .value("soa", Collection::layout_t::soa);
+
+    // ArrayView
+    nb::class_<ArrayView>(m, "ArrayView")
+        .def(nb::init<>())
+        .def(nb::init<const ValueInfo&>(), "base"_a)
+        .def(nb::init<const ValueInfo&, uint32_t, uint32_t, uint32_t>(),
+             "base"_a, "offset"_a, "length"_a, "stride"_a = 1)
+        .def("base", &ArrayView::base)
+        .def("element_type", &ArrayView::element_type)
+        .def("byte_offset", &ArrayView::byte_offset)
+        .def("byte_stride", &ArrayView::byte_stride)
+        .def("length", &ArrayView::length)
+        .def("entry", nb::overload_cast<uint32_t>(&ArrayView::entry, nb::const_), "i"_a)
+        .def("entry", nb::overload_cast<const ValueInfo&>(&ArrayView::entry, nb::const_), "i"_a)
+        .def("slice", &ArrayView::slice, "begin"_a, "length"_a, "step"_a = 1)
+        .def_static("null", &ArrayView::null)
+        .def_static("from_fields", &ArrayView::from_fields, "base"_a, "names"_a);
+
+    // RingBuffer
+    nb::class_<RingBuffer>(m, "RingBuffer")
+        .def(nb::init<>())
+        .def(nb::init<const ValueInfo&>(), "base"_a)
+        .def("base", &RingBuffer::base)
+        .def("element_type", &RingBuffer::element_type)
+        .def("capacity", &RingBuffer::capacity)
+        .def("is_pow2", &RingBuffer::is_pow2)
+        .def("slots", &RingBuffer::slots)
+        .def("push", &RingBuffer::push, "v"_a)
+        .def("at", nb::overload_cast<uint32_t>(&RingBuffer::at, nb::const_), "i"_a)
+        .def("at", nb::overload_cast<const ValueInfo&>(&RingBuffer::at, nb::const_), "i"_a)
+        .def("newest", &RingBuffer::newest)
+        .def("oldest", &RingBuffer::oldest)
+        .def("size", &RingBuffer::size)
+        .def("head", &RingBuffer::head)
+        .def("oldest_slot", &RingBuffer::oldest_slot)
+        .def("is_full", &RingBuffer::is_full)
+        .def_static("null", &RingBuffer::null)
+        .def_static("mk_type", &RingBuffer::mk_type, "name"_a, "element_type"_a, "capacity"_a,
+                    "extra_fields"_a = std::vector<field_entry_t>{})
+        .def_static("slot_name", &RingBuffer::slot_name, "i"_a);
+
+    // Ewma
+    nb::class_<Ewma>(m, "Ewma")
+        .def(nb::init<>())
+        .def(nb::init<const ValueInfo&, uint32_t>(), "base"_a, "window"_a)
+        .def("element_type", &Ewma::element_type)
+        .def("window", &Ewma::window)
+        .def("alpha", &Ewma::alpha)
+        .def("update", &Ewma::update, "x"_a)
+        .def("value", &Ewma::value)
+        .def_static("null", &Ewma::null)
+        .def_static("mk_type", &Ewma::mk_type, "name"_a, "element_type"_a);
+
+    // RollingStats
+    nb::class_<RollingStats>(m, "RollingStats")
+        .def(nb::init<>())
+        .def(nb::init<const ValueInfo&>(), "base"_a)
+        .def("element_type", &RollingStats::element_type)
+        .def("stat_type", nb::overload_cast<>(&RollingStats::stat_type, nb::const_))
+        .def("window", &RollingStats::window)
+        .def("ring", &RollingStats::ring)
+        .def("update", &RollingStats::update, "x"_a)
+        .def("count", &RollingStats::count)
+        .def("sum", &RollingStats::sum)
+        .def("mean", &RollingStats::mean)
+        .def("variance", &RollingStats::variance)
+        .def_static("null", &RollingStats::null)
+        .def_static("mk_type", &RollingStats::mk_type, "name"_a, "element_type"_a, "window"_a);
+
+    // RollingMinMax
+    nb::enum_<RollingMinMax::kind_t>(m, "RollingMinMaxKind")
+        .value("min", RollingMinMax::kind_t::min)
+        .value("max", RollingMinMax::kind_t::max);
+
+    nb::class_<RollingMinMax>(m, "RollingMinMax")
+        .def(nb::init<>())
+        .def(nb::init<const ValueInfo&, RollingMinMax::kind_t>(), "base"_a, "kind"_a)
+        .def("element_type", &RollingMinMax::element_type)
+        .def("window", &RollingMinMax::window)
+        .def("kind", &RollingMinMax::kind)
+        .def("ring", &RollingMinMax::ring)
+        .def("update", &RollingMinMax::update, "x"_a)
+        .def("value", &RollingMinMax::value)
+        .def_static("null", &RollingMinMax::null)
+        .def_static("mk_type", &RollingMinMax::mk_type, "name"_a, "element_type"_a, "window"_a);
+
+    // Vwap
+    nb::class_<Vwap>(m, "Vwap")
+        .def(nb::init<>())
+        .def(nb::init<const ValueInfo&>(), "base"_a)
+        .def("price_type", &Vwap::price_type)
+        .def("qty_type", &Vwap::qty_type)
+        .def("window", &Vwap::window)
+        .def("ring", &Vwap::ring)
+        .def("update", &Vwap::update, "price"_a, "qty"_a)
+        .def("value", &Vwap::value)
+        .def("sum_qty", &Vwap::sum_qty)
+        .def_static("null", &Vwap::null)
+        .def_static("mk_type", &Vwap::mk_type, "name"_a, "price_type"_a, "qty_type"_a, "window"_a);
+
+    nb::class_<Collection::Entry>(m, "CollectionEntry")
+        .def("field", &Collection::Entry::field, "name"_a);
+
+    nb::class_<Collection>(m, "Collection")
+        .def(nb::init<>())
+        .def(nb::init<const ValueInfo&, TypeInfo, uint32_t, Collection::layout_t>(),
+             "buffer"_a, "element_type"_a, "capacity"_a, "layout"_a)
+        .def("buffer", &Collection::buffer)
+        .def("element_type", &Collection::element_type)
+        .def("capacity", &Collection::capacity)
+        .def("layout", &Collection::layout)
+        .def("num_bytes", &Collection::num_bytes)
+        .def("field_offset", &Collection::field_offset, "name"_a)
+        .def("field_stride", &Collection::field_stride, "name"_a)
+        .def("byte_offset", &Collection::byte_offset, "i"_a, "name"_a)
+        .def("entry", nb::overload_cast<uint32_t>(&Collection::entry, nb::const_), "i"_a)
+        .def("entry", nb::overload_cast<const ValueInfo&>(&Collection::entry, nb::const_), "i"_a)
+        .def_static("null", &Collection::null)
+        .def_static("buffer_type", &Collection::buffer_type, "element_type"_a, "capacity"_a, "layout"_a)
+        .def_static("buffer_size", &Collection::buffer_size, "element_type"_a, "capacity"_a, "layout"_a);
 }
 
 //
@@ -276,6 +419,15 @@ void bind_functions(nb::module_& m) {
         .def_static("jump_to_section", &FunctionContext::jump_to_section, "dst"_a)
         .def_static("section_break", &FunctionContext::section_break, "new_section_name"_a);
 
+    // FieldAccess
+    nb::class_<FieldAccess>(m, "FieldAccess")
+        .def(nb::init<>())
+        .def("reads", &FieldAccess::reads)
+        .def("writes", &FieldAccess::writes)
+        .def("is_opaque", &FieldAccess::is_opaque)
+        .def("is_read", &FieldAccess::is_read, "field"_a)
+        .def("is_written", &FieldAccess::is_written, "field"_a);
+
     // Function - complete the definition
     function_class
         .def(nb::init<>())
@@ -286,12 +438,15 @@ void bind_functions(nb::module_& m) {
         .def("is_external", &Function::is_external)
         .def("call_fn", &Function::call_fn)
         .def("declare_fn", &Function::declare_fn, "dst_mod"_a)
+        .def("mk_kernel", &Function::mk_kernel)
+        .def_static("mk_fused", &Function::mk_fused, "name"_a, "stages"_a)
         .def("verify", &Function::verify)
         .def("remove_from_module", &Function::remove_from_module)
         .def("write_to_ostream", &Function::write_to_ostream)
         .def("current_section", &Function::current_section)
         .def("is_current_section", &Function::is_current_section, "code"_a)
         .def("assert_no_context", &Function::assert_no_context)
+        .def("field_access", &Function::field_access)
         .def("__eq__", &Function::operator==)
         .def_static("null", &Function::null);
 
@@ -329,8 +484,19 @@ void bind_modules(nb::module_& m) {
         .def("main_module", &Cursor::main_module)
         .def("gen_module", &Cursor::gen_module)
         .def("is_bind_called", &Cursor::is_bind_called)
+        .def("enable_debug_info", &Cursor::enable_debug_info)
+        .def("is_debug_info_enabled", &Cursor::is_debug_info_enabled)
+        .def("enable_changed_fields", &Cursor::enable_changed_fields)
+        .def("is_changed_fields_enabled", &Cursor::is_changed_fields_enabled)
         .def("bind", &Cursor::bind)
         .def("cleanup", &Cursor::cleanup)
+        .def("event_names", [](Cursor& self) {
+            std::vector<std::string> l_names;
+            for (const Event& l_event : self.events()) {
+                l_names.emplace_back(l_event.name());
+            }
+            return l_names;
+        })
         .def("__eq__", &Cursor::operator==)
         .def_static("null", &Cursor::null);
 }
@@ -359,10 +525,308 @@ void bind_control_flow(nb::module_& m) {
         .def("bind", &IfElseCond::bind);
 }
 
+//
+// NumPy views
+//
+// Views alias the runtime buffer, no copy is made. Owner capsule holds a
+// reference to the runtime object so the buffer outlives every view of it
+namespace {
+
+using ndarray_t = nb::ndarray<nb::numpy>;
+using ndarray_in_t = nb::ndarray<nb::ndim<1>, nb::c_contig, nb::device::cpu>;
+using ndarray_col_t = nb::ndarray<nb::ndim<1>, nb::device::cpu>;
+
+nb::dlpack::dtype runtime_dtype(runtime::type_t type) {
+    switch (type) {
+    case runtime::type_t::boolean: return nb::dtype<bool>();
+    case runtime::type_t::int8:    return nb::dtype<int8_t>();
+    case runtime::type_t::int16:   return nb::dtype<int16_t>();
+    case runtime::type_t::int32:   return nb::dtype<int32_t>();
+    case runtime::type_t::int64:   return nb::dtype<int64_t>();
+    case runtime::type_t::uint8:   return nb::dtype<uint8_t>();
+    case runtime::type_t::uint16:  return nb::dtype<uint16_t>();
+    case runtime::type_t::uint32:  return nb::dtype<uint32_t>();
+    case runtime::type_t::uint64:  return nb::dtype<uint64_t>();
+    case runtime::type_t::float32: return nb::dtype<float>();
+    case runtime::type_t::float64: return nb::dtype<double>();
+    default:
+        throw nb::type_error("only scalar types can be viewed as ndarray");
+    }
+}
+
+runtime::type_t runtime_type(nb::dlpack::dtype dtype) {
+    for (runtime::type_t t : {runtime::type_t::boolean,
+                              runtime::type_t::int8, runtime::type_t::int16,
+                              runtime::type_t::int32, runtime::type_t::int64,
+                              runtime::type_t::uint8, runtime::type_t::uint16,
+                              runtime::type_t::uint32, runtime::type_t::uint64,
+                              runtime::type_t::float32, runtime::type_t::float64}) {
+        if (runtime_dtype(t) == dtype) {
+            return t;
+        }
+    }
+    throw nb::type_error("ndarray dtype has no runtime type equivalent");
+}
+
+template <typename T>
+nb::capsule mk_owner(const T& obj) {
+    return nb::capsule(new T{obj}, [](void* p) noexcept {
+        delete static_cast<T*>(p);
+    });
+}
+
+ndarray_t array_view(const runtime::Array& self) {
+    if (self.has_error()) {
+        throw nb::value_error("invalid array can't be viewed");
+    }
+    const nb::dlpack::dtype l_dtype = runtime_dtype(self.element_type());
+    const size_t l_shape[1] = {self.num_elements()};
+    return ndarray_t(self.ref(), 1, l_shape, mk_owner(self), nullptr, l_dtype);
+}
+
+// strided, aliases the array of the view
+ndarray_t array_view_numpy(const runtime::ArrayView& self) {
+    if (self.has_error()) {
+        throw nb::value_error("invalid view can't be viewed");
+    }
+    const runtime::Array& l_array = self.array();
+    const nb::dlpack::dtype l_dtype = runtime_dtype(l_array.element_type());
+    const size_t l_shape[1] = {self.length()};
+    const int64_t l_strides[1] = {self.stride()};
+    uint8_t* l_data = static_cast<uint8_t*>(l_array.ref()) + static_cast<uint64_t>(self.offset()) * l_array.element_size();
+    return ndarray_t(l_data, 1, l_shape, mk_owner(l_array), l_strides, l_dtype);
+}
+
+runtime::Array array_from_numpy(const ndarray_in_t& arr) {
+    const runtime::type_t l_type = runtime_type(arr.dtype());
+    if (arr.shape(0) == 0 or arr.shape(0) > std::numeric_limits<uint32_t>::max()) {
+        throw nb::value_error("array size must be in [1, 2^32)");
+    }
+    runtime::Array l_res = runtime::Array::from(l_type, static_cast<uint32_t>(arr.shape(0)));
+    if (l_res.has_error()) {
+        throw nb::value_error("array can't be created");
+    }
+    std::memcpy(l_res.ref(), arr.data(), arr.nbytes());
+    return l_res;
+}
+
+// array uses ndarray memory in place, the ndarray is kept alive by the array
+runtime::Array array_wrap_numpy(const ndarray_in_t& arr) {
+    const runtime::type_t l_type = runtime_type(arr.dtype());
+    if (arr.shape(0) == 0 or arr.shape(0) > std::numeric_limits<uint32_t>::max()) {
+        throw nb::value_error("array size must be in [1, 2^32)");
+    }
+    ndarray_in_t* l_keep_alive = new ndarray_in_t{arr};
+    runtime::Array l_res = runtime::Array::wrap(l_type, static_cast<uint32_t>(arr.shape(0)), arr.data(),
+                                                [l_keep_alive](void*) {
+        // last reference may be dropped on a thread not holding the gil
+        nb::gil_scoped_acquire l_gil;
+        delete l_keep_alive;
+    });
+    if (l_res.has_error()) {
+        delete l_keep_alive;
+        throw nb::value_error("ndarray can't be wrapped, it must be aligned to its element size");
+    }
+    return l_res;
+}
+
+// single element view, index it as v[0]
+ndarray_t field_view(const runtime::Object& self, const runtime::Field& field) {
+    const nb::dlpack::dtype l_dtype = runtime_dtype(field.type());
+    const size_t l_shape[1] = {1};
+    uint8_t* l_data = static_cast<uint8_t*>(self.ref()) + field.offset();
+    return ndarray_t(l_data, 1, l_shape, mk_owner(self), nullptr, l_dtype);
+}
+
+ndarray_t object_field_view(const runtime::Object& self, const std::string& name) {
+    if (self.has_error()) {
+        throw nb::value_error("invalid object can't be viewed");
+    }
+    const runtime::Field l_field = self.struct_def()[name];
+    if (l_field.has_error()) {
+        throw nb::key_error(name.c_str());
+    }
+    return field_view(self, l_field);
+}
+
+nb::dict object_field_views(const runtime::Object& self) {
+    if (self.has_error()) {
+        throw nb::value_error("invalid object can't be viewed");
+    }
+    nb::dict l_res;
+    const runtime::Struct l_struct = self.struct_def();
+    for (const std::string& l_name : l_struct.field_names()) {
+        const runtime::Field l_field = l_struct[l_name];
+        if (l_field.is_struct_pointer() or l_field.is_array_pointer() or l_field.is_fn_pointer()) {
+            continue;
+        }
+        l_res[l_name.c_str()] = field_view(self, l_field);
+    }
+    return l_res;
+}
+
+// runs a kernel (Function.mk_kernel()) over numpy columns, mapped to context fields
+// by name, in one native call. columns may be strided, columns of fields the
+// event writes must be writable and are written back after each row
+nb::tuple event_on_columns(const runtime::EventFn& self, const runtime::Object& state, const nb::dict& columns) {
+    std::vector<ndarray_col_t> l_arrays;
+    std::vector<runtime::Column> l_columns;
+    size_t l_num_rows = 0;
+    for (auto [l_key, l_value] : columns) {
+        const std::string l_name = nb::cast<std::string>(l_key);
+        const ndarray_col_t& l_arr = l_arrays.emplace_back(nb::cast<ndarray_col_t>(l_value));
+        if (l_arrays.size() == 1) {
+            l_num_rows = l_arr.shape(0);
+        } else if (l_arr.shape(0) != l_num_rows) {
+            throw nb::value_error("all columns must have same number of rows");
+        }
+        const int64_t l_item_size = l_arr.dtype().bits / 8;
+        l_columns.emplace_back(l_name, runtime_type(l_arr.dtype()), l_arr.data(), l_arr.stride(0) * l_item_size);
+    }
+    uint64_t l_num_processed = 0;
+    int32_t l_result = 0;
+    {
+        nb::gil_scoped_release l_release;
+        l_result = self.on_columns(state, l_columns, l_num_rows, &l_num_processed);
+    }
+    return nb::make_tuple(l_result, l_num_processed);
+}
+
+// returns (result of first failing call or 0, number of calls done before it)
+nb::tuple event_on_event_repeat(const runtime::EventFn& self, const runtime::Object& o, uint64_t n) {
+    uint64_t l_num_processed = 0;
+    int32_t l_result = 0;
+    {
+        nb::gil_scoped_release l_release;
+        l_result = self.on_event_repeat(o, n, &l_num_processed);
+    }
+    return nb::make_tuple(l_result, l_num_processed);
+}
+
+//
+// Arrow PyCapsule interface
+//
+// __arrow_c_array__() returns (schema, array) capsules, a capsule releases its
+// struct unless the consumer moved it out. from_arrow() takes any object with
+// __arrow_c_array__(), e.g. a pyarrow array or record batch, without copies
+template <typename T>
+nb::capsule mk_arrow_capsule(T* arrow_struct, const char* name) {
+    return nb::capsule(arrow_struct, name, [](void* p) noexcept {
+        T* l_struct = static_cast<T*>(p);
+        if (l_struct->release != nullptr) {
+            l_struct->release(l_struct);
+        }
+        delete l_struct;
+    });
+}
+
+template <typename T>
+nb::tuple arrow_c_array(const T& self, nb::handle requested_schema) {
+    // only the native layout is produced, there is nothing to cast to
+    (void)requested_schema;
+    ArrowSchema* l_schema = new ArrowSchema{};
+    ArrowArray* l_array = new ArrowArray{};
+    if (not self.export_arrow(l_array, l_schema)) {
+        delete l_schema;
+        delete l_array;
+        throw nb::value_error("can't be exported to arrow, it must be frozen and of non boolean scalar type");
+    }
+    return nb::make_tuple(mk_arrow_capsule(l_schema, "arrow_schema"), mk_arrow_capsule(l_array, "arrow_array"));
+}
+
+template <typename T>
+T from_arrow(nb::handle obj) {
+    nb::tuple l_capsules = nb::cast<nb::tuple>(obj.attr("__arrow_c_array__")());
+    ArrowSchema* l_schema = static_cast<ArrowSchema*>(PyCapsule_GetPointer(l_capsules[0].ptr(), "arrow_schema"));
+    ArrowArray* l_array = static_cast<ArrowArray*>(PyCapsule_GetPointer(l_capsules[1].ptr(), "arrow_array"));
+    if (l_schema == nullptr or l_array == nullptr) {
+        throw nb::python_error();
+    }
+    T l_res = T::import_arrow(l_array, l_schema);
+    if (l_res.has_error()) {
+        throw nb::value_error("arrow array can't be imported");
+    }
+    return l_res;
+}
+
+nb::tuple replay_run(const runtime::Replay& self, const runtime::EventFn& fn, const runtime::Object& state, uint64_t begin, uint64_t end) {
+    uint64_t l_num_processed = 0;
+    int32_t l_result = 0;
+    {
+        nb::gil_scoped_release l_release;
+        l_result = self.run(fn, state, begin, end, &l_num_processed);
+    }
+    return nb::make_tuple(l_result, l_num_processed);
+}
+
+nb::tuple replay_run_in_place(const runtime::Replay& self, const runtime::EventFn& fn, uint64_t begin, uint64_t end) {
+    uint64_t l_num_processed = 0;
+    int32_t l_result = 0;
+    {
+        nb::gil_scoped_release l_release;
+        l_result = self.run_in_place(fn, begin, end, &l_num_processed);
+    }
+    return nb::make_tuple(l_result, l_num_processed);
+}
+
+} // namespace
+
 //
 // JIT bindings
 //
 void bind_jit(nb::module_& m) {
+    // LatencyHistogram
+    nb::class_<LatencyHistogram>(m, "LatencyHistogram")
+        .def(nb::init<>())
+        .def("count", &LatencyHistogram::count)
+        .def("sum", &LatencyHistogram::sum)
+        .def("min", &LatencyHistogram::min)
+        .def("max", &LatencyHistogram::max)
+        .def("empty", &LatencyHistogram::empty)
+        .def("mean", &LatencyHistogram::mean)
+        .def("percentile", &LatencyHistogram::percentile, "p"_a)
+        .def("bucket_count", &LatencyHistogram::bucket_count, "idx"_a)
+        .def("__repr__", [](const LatencyHistogram& self) {
+            std::ostringstream os;
+            os << self;
+            return os.str();
+        })
+        .def_static("bucket_index", &LatencyHistogram::bucket_index, "value"_a)
+        .def_static("bucket_lower_bound", &LatencyHistogram::bucket_lower_bound, "idx"_a)
+        .def_static("bucket_upper_bound", &LatencyHistogram::bucket_upper_bound, "idx"_a)
+        .def_prop_ro_static("num_buckets", [](nb::handle) { return uint32_t{LatencyHistogram::c_num_buckets}; });
+
+    // analysis::AsmInst
+    nb::class_<analysis::AsmInst>(m, "AsmInst")
+        .def("address", &analysis::AsmInst::address)
+        .def("offset", &analysis::AsmInst::offset)
+        .def("size", &analysis::AsmInst::size)
+        .def("text", &analysis::AsmInst::text)
+        .def("file_name", [](const analysis::AsmInst& self) { return self.line().file_name(); })
+        .def("line_num", [](const analysis::AsmInst& self) { return self.line().line_num(); })
+        .def("value_description", [](const analysis::AsmInst& self) { return self.value().description(); })
+        .def("tags", [](const analysis::AsmInst& self) { return self.value().tags(); })
+        .def("__repr__", [](const analysis::AsmInst& self) {
+            std::ostringstream os;
+            self.print(os);
+            return os.str();
+        });
+
+    // analysis::Disassembly
+    nb::class_<analysis::Disassembly>(m, "Disassembly")
+        .def(nb::init<>())
+        .def("empty", &analysis::Disassembly::empty)
+        .def("symbol", &analysis::Disassembly::symbol)
+        .def("address", &analysis::Disassembly::address)
+        .def("code_size", &analysis::Disassembly::code_size)
+        .def("num_inst", &analysis::Disassembly::num_inst)
+        .def("insts", &analysis::Disassembly::insts)
+        .def("__repr__", [](const analysis::Disassembly& self) {
+            std::ostringstream os;
+            os << self;
+            return os.str();
+        });
+
     // runtime::Field
     nb::class_<runtime::Field>(m, "RuntimeField")
         .def(nb::init<>())
@@ -370,6 +834,7 @@ void bind_jit(nb::module_& m) {
         .def("idx", &runtime::Field::idx)
         .def("offset", &runtime::Field::offset)
         .def("name", &runtime::Field::name)
+        .def("type", &runtime::Field::type)
         .def("is_bool", &runtime::Field::is_bool)
         .def("is_struct_pointer", &runtime::Field::is_struct_pointer)
         .def("is_array_pointer", &runtime::Field::is_array_pointer)
@@ -388,6 +853,32 @@ void bind_jit(nb::module_& m) {
         .def_static("get_type", &runtime::Field::get_type, "type"_a)
         .def_static("get_raw_size", &runtime::Field::get_raw_size, "type"_a);
 
+    // runtime::SharedRegion
+    nb::class_<runtime::SharedRegion>(m, "SharedRegion")
+        .def(nb::init<>())
+        .def("name", &runtime::SharedRegion::name)
+        .def("size_in_bytes", &runtime::SharedRegion::size_in_bytes)
+        .def("used_bytes", &runtime::SharedRegion::used_bytes)
+        .def("contains", &runtime::SharedRegion::contains, "name"_a)
+        .def("unlink", &runtime::SharedRegion::unlink)
+        .def("__eq__", &runtime::SharedRegion::operator==)
+        .def_static("null", &runtime::SharedRegion::null, nb::rv_policy::reference)
+        .def_static("create_shm", &runtime::SharedRegion::create_shm, "name"_a, "size"_a)
+        .def_static("open_shm", &runtime::SharedRegion::open_shm, "name"_a)
+        .def_static("create_file", &runtime::SharedRegion::create_file, "path"_a, "size"_a)
+        .def_static("open_file", &runtime::SharedRegion::open_file, "path"_a);
+
+    // runtime::Snapshot
+    nb::class_<runtime::Snapshot>(m, "Snapshot")
+        .def(nb::init<>())
+        .def("num_nodes", &runtime::Snapshot::num_nodes)
+        .def("num_bytes_copied", &runtime::Snapshot::num_bytes_copied)
+        // copies the graph on first call, events may keep running meanwhile
+        .def("root", &runtime::Snapshot::root,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("__eq__", &runtime::Snapshot::operator==)
+        .def_static("null", &runtime::Snapshot::null, nb::rv_policy::reference);
+
     // runtime::Struct
     nb::class_<runtime::Struct>(m, "RuntimeStruct")
         .def(nb::init<>())
@@ -395,13 +886,15 @@ void bind_jit(nb::module_& m) {
         .def("size_in_bytes", &runtime::Struct::size_in_bytes)
         .def("num_fields", &runtime::Struct::num_fields)
         .def("field_names", &runtime::Struct::field_names)
-        .def("mk_object", &runtime::Struct::mk_object)
+        .def("mk_object", nb::overload_cast<>(&runtime::Struct::mk_object, nb::const_))
+        .def("mk_object", nb::overload_cast<const runtime::SharedRegion&, const std::string&>(&runtime::Struct::mk_object, nb::const_),
+             "region"_a, "name"_a)
+        .def("find_object", &runtime::Struct::find_object, "region"_a, "name"_a)
         .def("__getitem__", &runtime::Struct::operator[], "name"_a)
         .def("__eq__", &runtime::Struct::operator==)
         .def_static("null", &runtime::Struct::null, nb::rv_policy::reference);
 
     // runtime::Array
-    // Note: bool and float types are not instantiated in the library for arrays
     nb::class_<runtime::Array>(m, "RuntimeArray")
         .def(nb::init<>())
         .def("is_scalar", &runtime::Array::is_scalar)
@@ -411,7 +904,8 @@ void bind_jit(nb::module_& m) {
         .def("num_elements", &runtime::Array::num_elements)
         .def("element_type", &runtime::Array::element_type)
         .def("element_size", &runtime::Array::element_size)
-        // Template specializations for get/set (only types instantiated in library)
+        // Template specializations for get/set
+        .def("get_bool", &runtime::Array::get<bool>, "i"_a)
         .def("get_int8", &runtime::Array::get<int8_t>, "i"_a)
         .def("get_int16", &runtime::Array::get<int16_t>, "i"_a)
         .def("get_int32", &runtime::Array::get<int32_t>, "i"_a)
@@ -420,6 +914,9 @@ void bind_jit(nb::module_& m) {
         .def("get_uint16", &runtime::Array::get<uint16_t>, "i"_a)
         .def("get_uint32", &runtime::Array::get<uint32_t>, "i"_a)
         .def("get_uint64", &runtime::Array::get<uint64_t>, "i"_a)
+        .def("get_float32", &runtime::Array::get<float>, "i"_a)
+        .def("get_float64", &runtime::Array::get<double>, "i"_a)
+        .def("set_bool", &runtime::Array::set<bool>, "i"_a, "v"_a)
         .def("set_int8", &runtime::Array::set<int8_t>, "i"_a, "v"_a)
         .def("set_int16", &runtime::Array::set<int16_t>, "i"_a, "v"_a)
         .def("set_int32", &runtime::Array::set<int32_t>, "i"_a, "v"_a)
@@ -428,20 +925,155 @@ void bind_jit(nb::module_& m) {
         .def("set_uint16", &runtime::Array::set<uint16_t>, "i"_a, "v"_a)
         .def("set_uint32", &runtime::Array::set<uint32_t>, "i"_a, "v"_a)
         .def("set_uint64", &runtime::Array::set<uint64_t>, "i"_a, "v"_a)
+        .def("set_float32", &runtime::Array::set<float>, "i"_a, "v"_a)
+        .def("set_float64", &runtime::Array::set<double>, "i"_a, "v"_a)
+        // zero-copy, writes through the view are visible to jit'ed code
+        .def("numpy", &array_view)
         .def("get_object", &runtime::Array::get_object, "i"_a)
         .def("set_object", &runtime::Array::set_object, "i"_a, "v"_a)
         .def("get_array", &runtime::Array::get_array, "i"_a)
         .def("set_array", &runtime::Array::set_array, "i"_a, "v"_a)
+        // Arrow layout
+        .def("enable_validity", &runtime::Array::enable_validity)
+        .def("has_validity", &runtime::Array::has_validity)
+        .def("is_null", &runtime::Array::is_null, "i"_a)
+        .def("set_null", &runtime::Array::set_null, "i"_a, "is_null"_a)
+        .def("null_count", &runtime::Array::null_count)
+        .def("validity", &runtime::Array::validity)
+        .def("is_list", &runtime::Array::is_list)
+        .def("offsets", &runtime::Array::offsets)
+        .def("values", &runtime::Array::values)
+        .def("slice", &runtime::Array::slice, "begin"_a, "length"_a)
+        .def("__arrow_c_array__", &arrow_c_array<runtime::Array>, "requested_schema"_a = nb::none())
         .def("__eq__", &runtime::Array::operator==)
         .def_static("null", &runtime::Array::null, nb::rv_policy::reference)
-        .def_static("from", &runtime::Array::from, "type"_a, "size"_a);
+        .def_static("from", nb::overload_cast<runtime::type_t, uint32_t>(&runtime::Array::from), "type"_a, "size"_a)
+        .def_static("from", nb::overload_cast<runtime::type_t, uint32_t, const runtime::SharedRegion&, const std::string&>(&runtime::Array::from),
+                    "type"_a, "size"_a, "region"_a, "name"_a)
+        .def_static("find", &runtime::Array::find, "region"_a, "name"_a)
+        // copies the 1-d contiguous ndarray into a new runtime array
+        .def_static("from_numpy", &array_from_numpy, "arr"_a)
+        // zero-copy, array uses memory of the 1-d contiguous ndarray and keeps it alive
+        .def_static("wrap_numpy", &array_wrap_numpy, "arr"_a)
+        .def_static("from_list", &runtime::Array::from_list, "offsets"_a, "values"_a)
+        // zero-copy, imports any object implementing __arrow_c_array__()
+        .def_static("from_arrow", &from_arrow<runtime::Array>, "obj"_a);
+
+    // runtime::ArrayView
+    nb::class_<runtime::ArrayView>(m, "RuntimeArrayView")
+        .def(nb::init<>())
+        .def(nb::init<const runtime::Array&>(), "array"_a)
+        .def(nb::init<const runtime::Array&, uint32_t, uint32_t, uint32_t>(),
+             "array"_a, "offset"_a, "length"_a, "stride"_a = 1)
+        .def("array", &runtime::ArrayView::array)
+        .def("offset", &runtime::ArrayView::offset)
+        .def("length", &runtime::ArrayView::length)
+        .def("stride", &runtime::ArrayView::stride)
+        .def("is_contiguous", &runtime::ArrayView::is_contiguous)
+        .def("get_bool", &runtime::ArrayView::get<bool>, "i"_a)
+        .def("get_int8", &runtime::ArrayView::get<int8_t>, "i"_a)
+        .def("get_int16", &runtime::ArrayView::get<int16_t>, "i"_a)
+        .def("get_int32", &runtime::ArrayView::get<int32_t>, "i"_a)
+        .def("get_int64", &runtime::ArrayView::get<int64_t>, "i"_a)
+        .def("get_uint8", &runtime::ArrayView::get<uint8_t>, "i"_a)
+        .def("get_uint16", &runtime::ArrayView::get<uint16_t>, "i"_a)
+        .def("get_uint32", &runtime::ArrayView::get<uint32_t>, "i"_a)
+        .def("get_uint64", &runtime::ArrayView::get<uint64_t>, "i"_a)
+        .def("get_float32", &runtime::ArrayView::get<float>, "i"_a)
+        .def("get_float64", &runtime::ArrayView::get<double>, "i"_a)
+        .def("set_bool", &runtime::ArrayView::set<bool>, "i"_a, "v"_a)
+        .def("set_int8", &runtime::ArrayView::set<int8_t>, "i"_a, "v"_a)
+        .def("set_int16", &runtime::ArrayView::set<int16_t>, "i"_a, "v"_a)
+        .def("set_int32", &runtime::ArrayView::set<int32_t>, "i"_a, "v"_a)
+        .def("set_int64", &runtime::ArrayView::set<int64_t>, "i"_a, "v"_a)
+        .def("set_uint8", &runtime::ArrayView::set<uint8_t>, "i"_a, "v"_a)
+        .def("set_uint16", &runtime::ArrayView::set<uint16_t>, "i"_a, "v"_a)
+        .def("set_uint32", &runtime::ArrayView::set<uint32_t>, "i"_a, "v"_a)
+        .def("set_uint64", &runtime::ArrayView::set<uint64_t>, "i"_a, "v"_a)
+        .def("set_float32", &runtime::ArrayView::set<float>, "i"_a, "v"_a)
+        .def("set_float64", &runtime::ArrayView::set<double>, "i"_a, "v"_a)
+        // zero-copy strided ndarray over the array buffer
+        .def("numpy", &array_view_numpy)
+        .def("slice", &runtime::ArrayView::slice, "begin"_a, "length"_a, "step"_a = 1)
+        .def("to_array", &runtime::ArrayView::to_array)
+        .def("__eq__", &runtime::ArrayView::operator==)
+        .def_static("null", &runtime::ArrayView::null, nb::rv_policy::reference);
+
+    // runtime::RingBuffer
+    nb::class_<runtime::RingBuffer>(m, "RuntimeRingBuffer")
+        .def(nb::init<>())
+        .def(nb::init<const runtime::Object&>(), "object"_a)
+        .def("object", &runtime::RingBuffer::object)
+        .def("capacity", &runtime::RingBuffer::capacity)
+        .def("size", &runtime::RingBuffer::size)
+        .def("is_full", &runtime::RingBuffer::is_full)
+        .def("clear", &runtime::RingBuffer::clear)
+        .def("push_bool", &runtime::RingBuffer::push<bool>, "v"_a)
+        .def("push_int8", &runtime::RingBuffer::push<int8_t>, "v"_a)
+        .def("push_int16", &runtime::RingBuffer::push<int16_t>, "v"_a)
+        .def("push_int32", &runtime::RingBuffer::push<int32_t>, "v"_a)
+        .def("push_int64", &runtime::RingBuffer::push<int64_t>, "v"_a)
+        .def("push_uint8", &runtime::RingBuffer::push<uint8_t>, "v"_a)
+        .def("push_uint16", &runtime::RingBuffer::push<uint16_t>, "v"_a)
+        .def("push_uint32", &runtime::RingBuffer::push<uint32_t>, "v"_a)
+        .def("push_uint64", &runtime::RingBuffer::push<uint64_t>, "v"_a)
+        .def("push_float32", &runtime::RingBuffer::push<float>, "v"_a)
+        .def("push_float64", &runtime::RingBuffer::push<double>, "v"_a)
+        .def("at_bool", &runtime::RingBuffer::at<bool>, "i"_a)
+        .def("at_int8", &runtime::RingBuffer::at<int8_t>, "i"_a)
+        .def("at_int16", &runtime::RingBuffer::at<int16_t>, "i"_a)
+        .def("at_int32", &runtime::RingBuffer::at<int32_t>, "i"_a)
+        .def("at_int64", &runtime::RingBuffer::at<int64_t>, "i"_a)
+        .def("at_uint8", &runtime::RingBuffer::at<uint8_t>, "i"_a)
+        .def("at_uint16", &runtime::RingBuffer::at<uint16_t>, "i"_a)
+        .def("at_uint32", &runtime::RingBuffer::at<uint32_t>, "i"_a)
+        .def("at_uint64", &runtime::RingBuffer::at<uint64_t>, "i"_a)
+        .def("at_float32", &runtime::RingBuffer::at<float>, "i"_a)
+        .def("at_float64", &runtime::RingBuffer::at<double>, "i"_a)
+        .def("oldest_bool", &runtime::RingBuffer::oldest<bool>)
+        .def("oldest_int8", &runtime::RingBuffer::oldest<int8_t>)
+        .def("oldest_int16", &runtime::RingBuffer::oldest<int16_t>)
+        .def("oldest_int32", &runtime::RingBuffer::oldest<int32_t>)
+        .def("oldest_int64", &runtime::RingBuffer::oldest<int64_t>)
+        .def("oldest_uint8", &runtime::RingBuffer::oldest<uint8_t>)
+        .def("oldest_uint16", &runtime::RingBuffer::oldest<uint16_t>)
+        .def("oldest_uint32", &runtime::RingBuffer::oldest<uint32_t>)
+        .def("oldest_uint64", &runtime::RingBuffer::oldest<uint64_t>)
+        .def("oldest_float32", &runtime::RingBuffer::oldest<float>)
+        .def("oldest_float64", &runtime::RingBuffer::oldest<double>)
+        .def("__eq__", &runtime::RingBuffer::operator==)
+        .def_static("null", &runtime::RingBuffer::null, nb::rv_policy::reference);
+
+    // runtime::Table
+    nb::class_<runtime::Table>(m, "Table")
+        .def(nb::init<>())
+        .def(nb::init<uint32_t>(), "num_rows"_a)
+        .def("num_rows", &runtime::Table::num_rows)
+        .def("num_columns", &runtime::Table::num_columns)
+        .def("column_names", &runtime::Table::column_names)
+        .def("add_column", &runtime::Table::add_column, "name"_a, "column"_a)
+        .def("column", &runtime::Table::column, "name"_a)
+        .def("__arrow_c_array__", &arrow_c_array<runtime::Table>, "requested_schema"_a = nb::none())
+        .def("__eq__", &runtime::Table::operator==)
+        .def_static("null", &runtime::Table::null, nb::rv_policy::reference)
+        // zero-copy, imports a struct array such as a pyarrow record batch
+        .def_static("from_arrow", &from_arrow<runtime::Table>, "obj"_a);
 
     // runtime::Object
     nb::class_<runtime::Object>(m, "RuntimeObject")
         .def(nb::init<>())
         .def("is_frozen", &runtime::Object::is_frozen)
         .def("freeze", &runtime::Object::freeze)
+        .def("enable_double_buffer", &runtime::Object::enable_double_buffer)
+        .def("is_double_buffered", &runtime::Object::is_double_buffered)
+        .def("version", &runtime::Object::version)
+        .def("read_consistent", &runtime::Object::read_consistent, "dst"_a,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("snapshot", &runtime::Object::snapshot)
+        .def("write_checkpoint", &runtime::Object::write_checkpoint, "path"_a,
+             nb::call_guard<nb::gil_scoped_release>())
         .def("null_fields", &runtime::Object::null_fields)
+        .def("changed_fields", &runtime::Object::changed_fields)
         .def("is_instance_of", &runtime::Object::is_instance_of, "o"_a)
         .def("struct_def", &runtime::Object::struct_def, nb::rv_policy::reference)
         // Template specializations for get/set
@@ -471,18 +1103,159 @@ void bind_jit(nb::module_& m) {
         .def("set_object", &runtime::Object::set_object, "name"_a, "v"_a)
         .def("get_array", &runtime::Object::get_array, "name"_a)
         .def("set_array", &runtime::Object::set_array, "name"_a, "v"_a)
+        // zero-copy single element view of a scalar field
+        .def("field_view", &object_field_view, "name"_a)
+        // {name: view} of every scalar field
+        .def("field_views", &object_field_views)
         .def("__eq__", &runtime::Object::operator==)
         .def_static("null", &runtime::Object::null, nb::rv_policy::reference);
 
+    // PerfCounters
+    nb::enum_<PerfCounters::counter_t>(m, "PerfCounter")
+        .value("cycles", PerfCounters::counter_t::cycles)
+        .value("instructions", PerfCounters::counter_t::instructions)
+        .value("branch_misses", PerfCounters::counter_t::branch_misses)
+        .value("l1d_misses", PerfCounters::counter_t::l1d_misses)
+        .value("llc_misses", PerfCounters::counter_t::llc_misses);
+
+    nb::class_<PerfCounters>(m, "PerfCounters")
+        .def(nb::init<>())
+        .def("value", &PerfCounters::value, "c"_a)
+        .def("is_available", &PerfCounters::is_available, "c"_a)
+        .def("cycles", &PerfCounters::cycles)
+        .def("instructions", &PerfCounters::instructions)
+        .def("branch_misses", &PerfCounters::branch_misses)
+        .def("l1d_misses", &PerfCounters::l1d_misses)
+        .def("llc_misses", &PerfCounters::llc_misses)
+        .def("num_calls", &PerfCounters::num_calls)
+        .def("num_samples", &PerfCounters::num_samples)
+        .def("ipc", &PerfCounters::ipc)
+        .def("per_sample", &PerfCounters::per_sample, "c"_a)
+        .def("__repr__", [](const PerfCounters& self) {
+            std::ostringstream os;
+            os << self;
+            return os.str();
+        });
+
     // runtime::EventFn
     nb::class_<runtime::EventFn>(m, "RuntimeEventFn")
         .def(nb::init<>())
+        .def("name", &runtime::EventFn::name)
         .def("is_init", &runtime::EventFn::is_init)
         .def("init", &runtime::EventFn::init)
-        .def("on_event", &runtime::EventFn::on_event, "o"_a)
+        .def("field_access", &runtime::EventFn::field_access)
+        // GIL is released while jit'ed code runs, so events can be driven from several python threads
+        .def("on_event", &runtime::EventFn::on_event, "o"_a,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("on_event_many", &runtime::EventFn::on_event_many, "objects"_a,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("on_event_repeat", &event_on_event_repeat, "o"_a, "n"_a)
+        .def("on_columns", &event_on_columns, "state"_a, "columns"_a)
+        .def("enable_instrumentation", &runtime::EventFn::enable_instrumentation)
+        .def("disable_instrumentation", &runtime::EventFn::disable_instrumentation)
+        .def("is_instrumented", &runtime::EventFn::is_instrumented)
+        .def("call_count", &runtime::EventFn::call_count)
+        .def("latency_histogram", &runtime::EventFn::latency_histogram)
+        .def("reset_latency_histogram", &runtime::EventFn::reset_latency_histogram)
+        .def("enable_perf_counters", &runtime::EventFn::enable_perf_counters, "sample_every"_a = 1)
+        .def("disable_perf_counters", &runtime::EventFn::disable_perf_counters)
+        .def("has_perf_counters", &runtime::EventFn::has_perf_counters)
+        .def("perf_counters", &runtime::EventFn::perf_counters)
+        .def("reset_perf_counters", &runtime::EventFn::reset_perf_counters)
         .def("__eq__", &runtime::EventFn::operator==)
         .def_static("null", &runtime::EventFn::null, nb::rv_policy::reference);
 
+    // runtime::EventGraph
+    nb::class_<runtime::EventGraph>(m, "EventGraph")
+        .def(nb::init<>())
+        .def(nb::init<const runtime::Namespace&, const runtime::Struct&>(), "ns"_a, "context"_a)
+        .def("add_event", &runtime::EventGraph::add_event, "fn"_a)
+        .def("bind", &runtime::EventGraph::bind)
+        .def("is_bind", &runtime::EventGraph::is_bind)
+        .def("num_events", &runtime::EventGraph::num_events)
+        .def("field_id", &runtime::EventGraph::field_id, "name"_a)
+        .def("affected_events", &runtime::EventGraph::affected_events, "fields"_a)
+        .def("on_change", nb::overload_cast<const runtime::Object&, const std::vector<uint32_t>&>(&runtime::EventGraph::on_change, nb::const_),
+             "o"_a, "field_ids"_a, nb::call_guard<nb::gil_scoped_release>())
+        .def("on_change", nb::overload_cast<const runtime::Object&, const std::vector<std::string>&>(&runtime::EventGraph::on_change, nb::const_),
+             "o"_a, "fields"_a, nb::call_guard<nb::gil_scoped_release>())
+        .def("on_trigger", &runtime::EventGraph::on_trigger, "o"_a, "event"_a,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("__eq__", &runtime::EventGraph::operator==)
+        .def_static("null", &runtime::EventGraph::null, nb::rv_policy::reference);
+
+    // runtime::EventQueue
+    nb::enum_<runtime::EventQueue::producer_t>(m, "QueueProducer")
+        .value("single", runtime::EventQueue::producer_t::single)
+        .value("multi", runtime::EventQueue::producer_t::multi);
+
+    // dispatcher thread never takes the GIL, calls which may spin or join release it
+    nb::class_<runtime::EventQueue>(m, "EventQueue")
+        .def(nb::init<>())
+        .def(nb::init<const runtime::Struct&, uint32_t, runtime::EventQueue::producer_t>(),
+             "context"_a, "capacity"_a, "producer"_a = runtime::EventQueue::producer_t::multi)
+        .def("capacity", &runtime::EventQueue::capacity)
+        .def("add_event", &runtime::EventQueue::add_event, "fn"_a)
+        .def("try_publish", &runtime::EventQueue::try_publish, "event_id"_a, "payload"_a)
+        .def("publish", &runtime::EventQueue::publish, "event_id"_a, "payload"_a,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("poll", &runtime::EventQueue::poll, "max_events"_a,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("start", &runtime::EventQueue::start, "cpu"_a = -1)
+        .def("stop", &runtime::EventQueue::stop,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("is_running", &runtime::EventQueue::is_running)
+        .def("num_dispatched", &runtime::EventQueue::num_dispatched)
+        .def("num_failed", &runtime::EventQueue::num_failed)
+        .def("__eq__", &runtime::EventQueue::operator==)
+        .def_static("null", &runtime::EventQueue::null, nb::rv_policy::reference);
+
+    // runtime::ShardedExecutor
+    nb::class_<runtime::ShardedExecutor>(m, "ShardedExecutor")
+        .def(nb::init<>())
+        .def(nb::init<const runtime::Struct&, uint32_t, uint32_t, uint32_t>(),
+             "state"_a, "num_workers"_a, "keys_per_worker"_a, "queue_capacity"_a)
+        .def("num_workers", &runtime::ShardedExecutor::num_workers)
+        .def("add_event", &runtime::ShardedExecutor::add_event, "fn"_a)
+        .def("add_input_field", &runtime::ShardedExecutor::add_input_field, "name"_a)
+        .def("worker_of", &runtime::ShardedExecutor::worker_of, "key"_a)
+        .def("submit", &runtime::ShardedExecutor::submit, "key"_a, "event_id"_a, "payload"_a,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("submit_stateless", &runtime::ShardedExecutor::submit_stateless, "event_id"_a, "payload"_a,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("start", &runtime::ShardedExecutor::start, "cpus"_a = std::vector<int32_t>{})
+        .def("drain", &runtime::ShardedExecutor::drain,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("stop", &runtime::ShardedExecutor::stop,
+             nb::call_guard<nb::gil_scoped_release>())
+        .def("is_running", &runtime::ShardedExecutor::is_running)
+        .def("state", &runtime::ShardedExecutor::state, "key"_a)
+        .def("num_keys", &runtime::ShardedExecutor::num_keys)
+        .def("num_dispatched", &runtime::ShardedExecutor::num_dispatched)
+        .def("num_failed", &runtime::ShardedExecutor::num_failed)
+        .def("num_dropped", &runtime::ShardedExecutor::num_dropped)
+        .def("num_stolen", &runtime::ShardedExecutor::num_stolen)
+        .def("__eq__", &runtime::ShardedExecutor::operator==)
+        .def_static("null", &runtime::ShardedExecutor::null, nb::rv_policy::reference);
+
+    // runtime::Replay
+    nb::enum_<runtime::Replay::layout_t>(m, "ReplayLayout")
+        .value("records", runtime::Replay::layout_t::records)
+        .value("columns", runtime::Replay::layout_t::columns);
+
+    nb::class_<runtime::Replay>(m, "Replay")
+        .def(nb::init<>())
+        .def(nb::init<const runtime::Struct&, const std::string&, runtime::Replay::layout_t>(),
+             "record"_a, "path"_a, "layout"_a = runtime::Replay::layout_t::records)
+        .def("layout", &runtime::Replay::layout)
+        .def("num_records", &runtime::Replay::num_records)
+        .def("set_prefetch_distance", &runtime::Replay::set_prefetch_distance, "num_records"_a)
+        // both return (result, num_processed)
+        .def("run", &replay_run, "fn"_a, "state"_a, "begin"_a, "end"_a)
+        .def("run_in_place", &replay_run_in_place, "fn"_a, "begin"_a, "end"_a)
+        .def("__eq__", &runtime::Replay::operator==)
+        .def_static("null", &runtime::Replay::null, nb::rv_policy::reference);
+
     // runtime::Namespace
     nb::class_<runtime::Namespace>(m, "RuntimeNamespace")
         .def(nb::init<>())
@@ -492,6 +1265,8 @@ void bind_jit(nb::module_& m) {
         .def("bind", &runtime::Namespace::bind)
         .def("struct_info", &runtime::Namespace::struct_info, "name"_a)
         .def("event_fn_info", &runtime::Namespace::event_fn_info, "name"_a)
+        .def("trigger_fields", &runtime::Namespace::trigger_fields, "event"_a)
+        .def("load_checkpoint", &runtime::Namespace::load_checkpoint, "path"_a)
         .def("__eq__", &runtime::Namespace::operator==)
         .def_static("null", &runtime::Namespace::null, nb::rv_policy::reference);
 
@@ -501,6 +1276,11 @@ void bind_jit(nb::module_& m) {
         .def("bind", &JustInTimeRunner::bind)
         .def("is_bind", &JustInTimeRunner::is_bind)
         .def("contains_symbol_definition", &JustInTimeRunner::contains_symbol_definition, "name"_a)
+        .def("lookup_latency", &JustInTimeRunner::lookup_latency)
+        .def("enable_disassembly", &JustInTimeRunner::enable_disassembly)
+        .def("disassemble", &JustInTimeRunner::disassemble, "symbol"_a)
+        .def("enable_gdb_listener", &JustInTimeRunner::enable_gdb_listener)
+        .def("enable_perf_listener", &JustInTimeRunner::enable_perf_listener)
         .def("process_module_fn", &JustInTimeRunner::process_module_fn, "fn"_a)
         .def("add_module", &JustInTimeRunner::add_module, "cursor"_a)
         .def("get_namespace", &JustInTimeRunner::get_namespace, "name"_a)
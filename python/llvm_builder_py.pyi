@@ -1,7 +1,8 @@
 """Type stubs for llvm_builder_py Python bindings."""
 
-from typing import List, Callable, Optional
+from typing import Any, Dict, List, Callable, Optional, Tuple, overload
 from enum import IntEnum
+import numpy as np
 
 # Enums
 class RuntimeType(IntEnum):
@@ -158,6 +159,8 @@ class TagInfo:
     def contains(self, v: str) -> bool: ...
     def add_entry(self, v: str) -> None: ...
     def set_union(self, other: TagInfo) -> TagInfo: ...
+    def values(self) -> list[str]: ...
+    def empty(self) -> bool: ...
 
 class ValueInfo:
     def __init__(self) -> None: ...
@@ -177,6 +180,7 @@ class ValueInfo:
     def mult(self, v2: ValueInfo) -> ValueInfo: ...
     def div(self, v2: ValueInfo) -> ValueInfo: ...
     def remainder(self, v2: ValueInfo) -> ValueInfo: ...
+    def bit_and(self, v2: ValueInfo) -> ValueInfo: ...
     # Comparison operations
     def less_than(self, v2: ValueInfo) -> ValueInfo: ...
     def less_than_equal(self, v2: ValueInfo) -> ValueInfo: ...
@@ -192,6 +196,7 @@ class ValueInfo:
     def __mul__(self, v2: ValueInfo) -> ValueInfo: ...
     def __truediv__(self, v2: ValueInfo) -> ValueInfo: ...
     def __mod__(self, v2: ValueInfo) -> ValueInfo: ...
+    def __and__(self, v2: ValueInfo) -> ValueInfo: ...
     def __lt__(self, v2: ValueInfo) -> ValueInfo: ...
     def __le__(self, v2: ValueInfo) -> ValueInfo: ...
     def __gt__(self, v2: ValueInfo) -> ValueInfo: ...
@@ -203,6 +208,10 @@ class ValueInfo:
     def entry(self, i: int) -> ValueInfo: ...
     def entry(self, i: ValueInfo) -> ValueInfo: ...
     def field(self, name: str) -> ValueInfo: ...
+    # Arrow validity bitmaps
+    def is_valid_entry(self, i: ValueInfo) -> ValueInfo: ...
+    def entry_or(self, i: ValueInfo, validity: ValueInfo, fallback: ValueInfo) -> ValueInfo: ...
+    def strided_entry(self, i: ValueInfo, entry_type: TypeInfo, offset: int, stride: int) -> ValueInfo: ...
     # Vector operations
     def load_vector_entry(self, i: int) -> ValueInfo: ...
     def store_vector_entry(self, i: int, value: ValueInfo) -> ValueInfo: ...
@@ -240,6 +249,158 @@ class ValueInfo:
     @staticmethod
     def from_float64(v: float) -> ValueInfo: ...
 
+class ArrayView:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, base: ValueInfo) -> None: ...
+    @overload
+    def __init__(self, base: ValueInfo, offset: int, length: int, stride: int = 1) -> None: ...
+    def base(self) -> ValueInfo: ...
+    def element_type(self) -> TypeInfo: ...
+    def byte_offset(self) -> int: ...
+    def byte_stride(self) -> int: ...
+    def length(self) -> int: ...
+    @overload
+    def entry(self, i: int) -> ValueInfo: ...
+    @overload
+    def entry(self, i: ValueInfo) -> ValueInfo: ...
+    def slice(self, begin: int, length: int, step: int = 1) -> ArrayView: ...
+    @staticmethod
+    def null() -> ArrayView: ...
+    @staticmethod
+    def from_fields(base: ValueInfo, names: List[str]) -> ArrayView: ...
+
+class RingBuffer:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, base: ValueInfo) -> None: ...
+    def base(self) -> ValueInfo: ...
+    def element_type(self) -> TypeInfo: ...
+    def capacity(self) -> int: ...
+    def is_pow2(self) -> bool: ...
+    def slots(self) -> ArrayView: ...
+    def push(self, v: ValueInfo) -> None: ...
+    @overload
+    def at(self, i: int) -> ValueInfo: ...
+    @overload
+    def at(self, i: ValueInfo) -> ValueInfo: ...
+    def newest(self) -> ValueInfo: ...
+    def oldest(self) -> ValueInfo: ...
+    def size(self) -> ValueInfo: ...
+    def head(self) -> ValueInfo: ...
+    def oldest_slot(self) -> ValueInfo: ...
+    def is_full(self) -> ValueInfo: ...
+    @staticmethod
+    def null() -> RingBuffer: ...
+    @staticmethod
+    def mk_type(name: str, element_type: TypeInfo, capacity: int, extra_fields: List[FieldEntry] = []) -> TypeInfo: ...
+    @staticmethod
+    def slot_name(i: int) -> str: ...
+
+class Ewma:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, base: ValueInfo, window: int) -> None: ...
+    def element_type(self) -> TypeInfo: ...
+    def window(self) -> int: ...
+    def alpha(self) -> float: ...
+    def update(self, x: ValueInfo) -> None: ...
+    def value(self) -> ValueInfo: ...
+    @staticmethod
+    def null() -> Ewma: ...
+    @staticmethod
+    def mk_type(name: str, element_type: TypeInfo) -> TypeInfo: ...
+
+class RollingStats:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, base: ValueInfo) -> None: ...
+    def element_type(self) -> TypeInfo: ...
+    def stat_type(self) -> TypeInfo: ...
+    def window(self) -> int: ...
+    def ring(self) -> RingBuffer: ...
+    def update(self, x: ValueInfo) -> None: ...
+    def count(self) -> ValueInfo: ...
+    def sum(self) -> ValueInfo: ...
+    def mean(self) -> ValueInfo: ...
+    def variance(self) -> ValueInfo: ...
+    @staticmethod
+    def null() -> RollingStats: ...
+    @staticmethod
+    def mk_type(name: str, element_type: TypeInfo, window: int) -> TypeInfo: ...
+
+class RollingMinMaxKind(IntEnum):
+    min: int
+    max: int
+
+class RollingMinMax:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, base: ValueInfo, kind: RollingMinMaxKind) -> None: ...
+    def element_type(self) -> TypeInfo: ...
+    def window(self) -> int: ...
+    def kind(self) -> RollingMinMaxKind: ...
+    def ring(self) -> RingBuffer: ...
+    def update(self, x: ValueInfo) -> None: ...
+    def value(self) -> ValueInfo: ...
+    @staticmethod
+    def null() -> RollingMinMax: ...
+    @staticmethod
+    def mk_type(name: str, element_type: TypeInfo, window: int) -> TypeInfo: ...
+
+class Vwap:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, base: ValueInfo) -> None: ...
+    def price_type(self) -> TypeInfo: ...
+    def qty_type(self) -> TypeInfo: ...
+    def window(self) -> int: ...
+    def ring(self) -> RingBuffer: ...
+    def update(self, price: ValueInfo, qty: ValueInfo) -> None: ...
+    def value(self) -> ValueInfo: ...
+    def sum_qty(self) -> ValueInfo: ...
+    @staticmethod
+    def null() -> Vwap: ...
+    @staticmethod
+    def mk_type(name: str, price_type: TypeInfo, qty_type: TypeInfo, window: int) -> TypeInfo: ...
+
+class CollectionLayout(IntEnum):
+    aos: int
+    soa: int
+
+class CollectionEntry:
+    def field(self, name: str) -> ValueInfo: ...
+
+class Collection:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, buffer: ValueInfo, element_type: TypeInfo, capacity: int, layout: CollectionLayout) -> None: ...
+    def buffer(self) -> ValueInfo: ...
+    def element_type(self) -> TypeInfo: ...
+    def capacity(self) -> int: ...
+    def layout(self) -> CollectionLayout: ...
+    def num_bytes(self) -> int: ...
+    def field_offset(self, name: str) -> int: ...
+    def field_stride(self, name: str) -> int: ...
+    def byte_offset(self, i: int, name: str) -> int: ...
+    @overload
+    def entry(self, i: int) -> CollectionEntry: ...
+    @overload
+    def entry(self, i: ValueInfo) -> CollectionEntry: ...
+    @staticmethod
+    def null() -> Collection: ...
+    @staticmethod
+    def buffer_type(element_type: TypeInfo, capacity: int, layout: CollectionLayout) -> TypeInfo: ...
+    @staticmethod
+    def buffer_size(element_type: TypeInfo, capacity: int, layout: CollectionLayout) -> int: ...
+
 # Function classes
 class CodeSection:
     def __init__(self) -> None: ...
@@ -280,6 +441,14 @@ class FunctionContext:
     @staticmethod
     def section_break(new_section_name: str) -> None: ...
 
+class FieldAccess:
+    def __init__(self) -> None: ...
+    def reads(self) -> List[str]: ...
+    def writes(self) -> List[str]: ...
+    def is_opaque(self) -> bool: ...
+    def is_read(self, field: str) -> bool: ...
+    def is_written(self, field: str) -> bool: ...
+
 class Function:
     def __init__(self) -> None: ...
     def __init__(self, name: str, is_external: bool = False) -> None: ...
@@ -289,12 +458,16 @@ class Function:
     def is_external(self) -> bool: ...
     def call_fn(self) -> ValueInfo: ...
     def declare_fn(self, dst_mod: Module) -> None: ...
+    def mk_kernel(self) -> Function: ...
+    @staticmethod
+    def mk_fused(name: str, stages: List[Function]) -> Function: ...
     def verify(self) -> None: ...
     def remove_from_module(self) -> None: ...
     def write_to_ostream(self) -> None: ...
     def current_section(self) -> CodeSection: ...
     def is_current_section(self, code: CodeSection) -> bool: ...
     def assert_no_context(self) -> None: ...
+    def field_access(self) -> FieldAccess: ...
     def __eq__(self, other: Function) -> bool: ...
     @staticmethod
     def null() -> Function: ...
@@ -328,8 +501,13 @@ class Cursor:
     def main_module(self) -> Module: ...
     def gen_module(self) -> Module: ...
     def is_bind_called(self) -> bool: ...
+    def enable_debug_info(self) -> None: ...
+    def is_debug_info_enabled(self) -> bool: ...
+    def enable_changed_fields(self) -> None: ...
+    def is_changed_fields_enabled(self) -> bool: ...
     def bind(self) -> None: ...
     def cleanup(self) -> None: ...
+    def event_names(self) -> List[str]: ...
     def __eq__(self, other: Cursor) -> bool: ...
     @staticmethod
     def null() -> Cursor: ...
@@ -359,6 +537,7 @@ class RuntimeField:
     def idx(self) -> int: ...
     def offset(self) -> int: ...
     def name(self) -> str: ...
+    def type(self) -> RuntimeType: ...
     def is_bool(self) -> bool: ...
     def is_struct_pointer(self) -> bool: ...
     def is_array_pointer(self) -> bool: ...
@@ -380,13 +559,45 @@ class RuntimeField:
     @staticmethod
     def get_raw_size(type: TypeInfo) -> int: ...
 
+class SharedRegion:
+    def __init__(self) -> None: ...
+    def name(self) -> str: ...
+    def size_in_bytes(self) -> int: ...
+    def used_bytes(self) -> int: ...
+    def contains(self, name: str) -> bool: ...
+    def unlink(self) -> bool: ...
+    def __eq__(self, other: SharedRegion) -> bool: ...
+    @staticmethod
+    def null() -> SharedRegion: ...
+    @staticmethod
+    def create_shm(name: str, size: int) -> SharedRegion: ...
+    @staticmethod
+    def open_shm(name: str) -> SharedRegion: ...
+    @staticmethod
+    def create_file(path: str, size: int) -> SharedRegion: ...
+    @staticmethod
+    def open_file(path: str) -> SharedRegion: ...
+
+class Snapshot:
+    def __init__(self) -> None: ...
+    def num_nodes(self) -> int: ...
+    def num_bytes_copied(self) -> int: ...
+    def root(self) -> RuntimeObject: ...
+    def __eq__(self, other: Snapshot) -> bool: ...
+    @staticmethod
+    def null() -> Snapshot: ...
+
 class RuntimeStruct:
     def __init__(self) -> None: ...
     def name(self) -> str: ...
     def size_in_bytes(self) -> int: ...
     def num_fields(self) -> int: ...
     def field_names(self) -> List[str]: ...
+    @overload
     def mk_object(self) -> RuntimeObject: ...
+    @overload
+    def mk_object(self, region: SharedRegion, name: str) -> RuntimeObject: ...
+    def find_object(self, region: SharedRegion, name: str) -> RuntimeObject: ...
     def __getitem__(self, name: str) -> RuntimeField: ...
     def __eq__(self, other: RuntimeStruct) -> bool: ...
     @staticmethod
@@ -424,21 +635,164 @@ class RuntimeArray:
     def set_uint64(self, i: int, v: int) -> None: ...
     def set_float32(self, i: int, v: float) -> None: ...
     def set_float64(self, i: int, v: float) -> None: ...
+    # zero-copy view over the array buffer
+    def numpy(self) -> np.ndarray: ...
     def get_object(self, i: int) -> RuntimeObject: ...
     def set_object(self, i: int, v: RuntimeObject) -> None: ...
     def get_array(self, i: int) -> RuntimeArray: ...
     def set_array(self, i: int, v: RuntimeArray) -> None: ...
+    # Arrow layout
+    def enable_validity(self) -> bool: ...
+    def has_validity(self) -> bool: ...
+    def is_null(self, i: int) -> bool: ...
+    def set_null(self, i: int, is_null: bool) -> None: ...
+    def null_count(self) -> int: ...
+    def validity(self) -> RuntimeArray: ...
+    def is_list(self) -> bool: ...
+    def offsets(self) -> RuntimeArray: ...
+    def values(self) -> RuntimeArray: ...
+    def slice(self, begin: int, length: int) -> RuntimeArray: ...
+    def __arrow_c_array__(self, requested_schema: Any = None) -> Tuple[Any, Any]: ...
     def __eq__(self, other: RuntimeArray) -> bool: ...
     @staticmethod
     def null() -> RuntimeArray: ...
+    @overload
     @staticmethod
     def from(type: RuntimeType, size: int) -> RuntimeArray: ...
+    @overload
+    @staticmethod
+    def from(type: RuntimeType, size: int, region: SharedRegion, name: str) -> RuntimeArray: ...
+    @staticmethod
+    def find(region: SharedRegion, name: str) -> RuntimeArray: ...
+    @staticmethod
+    def from_numpy(arr: np.ndarray) -> RuntimeArray: ...
+    @staticmethod
+    def wrap_numpy(arr: np.ndarray) -> RuntimeArray: ...
+    @staticmethod
+    def from_list(offsets: RuntimeArray, values: RuntimeArray) -> RuntimeArray: ...
+    @staticmethod
+    def from_arrow(obj: Any) -> RuntimeArray: ...
+
+class RuntimeArrayView:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, array: RuntimeArray) -> None: ...
+    @overload
+    def __init__(self, array: RuntimeArray, offset: int, length: int, stride: int = 1) -> None: ...
+    def array(self) -> RuntimeArray: ...
+    def offset(self) -> int: ...
+    def length(self) -> int: ...
+    def stride(self) -> int: ...
+    def is_contiguous(self) -> bool: ...
+    # Typed getters/setters
+    def get_bool(self, i: int) -> bool: ...
+    def get_int8(self, i: int) -> int: ...
+    def get_int16(self, i: int) -> int: ...
+    def get_int32(self, i: int) -> int: ...
+    def get_int64(self, i: int) -> int: ...
+    def get_uint8(self, i: int) -> int: ...
+    def get_uint16(self, i: int) -> int: ...
+    def get_uint32(self, i: int) -> int: ...
+    def get_uint64(self, i: int) -> int: ...
+    def get_float32(self, i: int) -> float: ...
+    def get_float64(self, i: int) -> float: ...
+    def set_bool(self, i: int, v: bool) -> None: ...
+    def set_int8(self, i: int, v: int) -> None: ...
+    def set_int16(self, i: int, v: int) -> None: ...
+    def set_int32(self, i: int, v: int) -> None: ...
+    def set_int64(self, i: int, v: int) -> None: ...
+    def set_uint8(self, i: int, v: int) -> None: ...
+    def set_uint16(self, i: int, v: int) -> None: ...
+    def set_uint32(self, i: int, v: int) -> None: ...
+    def set_uint64(self, i: int, v: int) -> None: ...
+    def set_float32(self, i: int, v: float) -> None: ...
+    def set_float64(self, i: int, v: float) -> None: ...
+    # zero-copy strided view over the array buffer
+    def numpy(self) -> np.ndarray: ...
+    def slice(self, begin: int, length: int, step: int = 1) -> RuntimeArrayView: ...
+    def to_array(self) -> RuntimeArray: ...
+    def __eq__(self, other: RuntimeArrayView) -> bool: ...
+    @staticmethod
+    def null() -> RuntimeArrayView: ...
+
+class RuntimeRingBuffer:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, object: RuntimeObject) -> None: ...
+    def object(self) -> RuntimeObject: ...
+    def capacity(self) -> int: ...
+    def size(self) -> int: ...
+    def is_full(self) -> bool: ...
+    def clear(self) -> None: ...
+    # Typed push/read, at(0) is the newest value
+    def push_bool(self, v: bool) -> None: ...
+    def push_int8(self, v: int) -> None: ...
+    def push_int16(self, v: int) -> None: ...
+    def push_int32(self, v: int) -> None: ...
+    def push_int64(self, v: int) -> None: ...
+    def push_uint8(self, v: int) -> None: ...
+    def push_uint16(self, v: int) -> None: ...
+    def push_uint32(self, v: int) -> None: ...
+    def push_uint64(self, v: int) -> None: ...
+    def push_float32(self, v: float) -> None: ...
+    def push_float64(self, v: float) -> None: ...
+    def at_bool(self, i: int) -> bool: ...
+    def at_int8(self, i: int) -> int: ...
+    def at_int16(self, i: int) -> int: ...
+    def at_int32(self, i: int) -> int: ...
+    def at_int64(self, i: int) -> int: ...
+    def at_uint8(self, i: int) -> int: ...
+    def at_uint16(self, i: int) -> int: ...
+    def at_uint32(self, i: int) -> int: ...
+    def at_uint64(self, i: int) -> int: ...
+    def at_float32(self, i: int) -> float: ...
+    def at_float64(self, i: int) -> float: ...
+    def oldest_bool(self) -> bool: ...
+    def oldest_int8(self) -> int: ...
+    def oldest_int16(self) -> int: ...
+    def oldest_int32(self) -> int: ...
+    def oldest_int64(self) -> int: ...
+    def oldest_uint8(self) -> int: ...
+    def oldest_uint16(self) -> int: ...
+    def oldest_uint32(self) -> int: ...
+    def oldest_uint64(self) -> int: ...
+    def oldest_float32(self) -> float: ...
+    def oldest_float64(self) -> float: ...
+    def __eq__(self, other: RuntimeRingBuffer) -> bool: ...
+    @staticmethod
+    def null() -> RuntimeRingBuffer: ...
+
+class Table:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, num_rows: int) -> None: ...
+    def num_rows(self) -> int: ...
+    def num_columns(self) -> int: ...
+    def column_names(self) -> List[str]: ...
+    def add_column(self, name: str, column: RuntimeArray) -> bool: ...
+    def column(self, name: str) -> RuntimeArray: ...
+    def __arrow_c_array__(self, requested_schema: Any = None) -> Tuple[Any, Any]: ...
+    def __eq__(self, other: Table) -> bool: ...
+    @staticmethod
+    def null() -> Table: ...
+    @staticmethod
+    def from_arrow(obj: Any) -> Table: ...
 
 class RuntimeObject:
     def __init__(self) -> None: ...
     def is_frozen(self) -> bool: ...
     def freeze(self) -> bool: ...
+    def enable_double_buffer(self) -> bool: ...
+    def is_double_buffered(self) -> bool: ...
+    def version(self) -> int: ...
+    def read_consistent(self, dst: RuntimeObject) -> bool: ...
+    def snapshot(self) -> Snapshot: ...
+    def write_checkpoint(self, path: str) -> bool: ...
     def null_fields(self) -> List[RuntimeField]: ...
+    def changed_fields(self) -> List[RuntimeField]: ...
     def is_instance_of(self, o: RuntimeStruct) -> bool: ...
     def struct_def(self) -> RuntimeStruct: ...
     # Typed getters/setters
@@ -468,19 +822,182 @@ class RuntimeObject:
     def set_object(self, name: str, v: RuntimeObject) -> None: ...
     def get_array(self, name: str) -> RuntimeArray: ...
     def set_array(self, name: str, v: RuntimeArray) -> None: ...
+    # zero-copy single element view of a scalar field
+    def field_view(self, name: str) -> np.ndarray: ...
+    def field_views(self) -> Dict[str, np.ndarray]: ...
     def __eq__(self, other: RuntimeObject) -> bool: ...
     @staticmethod
     def null() -> RuntimeObject: ...
 
+class LatencyHistogram:
+    num_buckets: int
+    def __init__(self) -> None: ...
+    def count(self) -> int: ...
+    def sum(self) -> int: ...
+    def min(self) -> int: ...
+    def max(self) -> int: ...
+    def empty(self) -> bool: ...
+    def mean(self) -> float: ...
+    def percentile(self, p: float) -> int: ...
+    def bucket_count(self, idx: int) -> int: ...
+    @staticmethod
+    def bucket_index(value: int) -> int: ...
+    @staticmethod
+    def bucket_lower_bound(idx: int) -> int: ...
+    @staticmethod
+    def bucket_upper_bound(idx: int) -> int: ...
+
+class AsmInst:
+    def address(self) -> int: ...
+    def offset(self) -> int: ...
+    def size(self) -> int: ...
+    def text(self) -> str: ...
+    def file_name(self) -> str: ...
+    def line_num(self) -> int: ...
+    def value_description(self) -> str: ...
+    def tags(self) -> TagInfo: ...
+
+class Disassembly:
+    def __init__(self) -> None: ...
+    def empty(self) -> bool: ...
+    def symbol(self) -> str: ...
+    def address(self) -> int: ...
+    def code_size(self) -> int: ...
+    def num_inst(self) -> int: ...
+    def insts(self) -> list[AsmInst]: ...
+
+class PerfCounter(IntEnum):
+    cycles: int
+    instructions: int
+    branch_misses: int
+    l1d_misses: int
+    llc_misses: int
+
+class PerfCounters:
+    def __init__(self) -> None: ...
+    def value(self, c: PerfCounter) -> int: ...
+    def is_available(self, c: PerfCounter) -> bool: ...
+    def cycles(self) -> int: ...
+    def instructions(self) -> int: ...
+    def branch_misses(self) -> int: ...
+    def l1d_misses(self) -> int: ...
+    def llc_misses(self) -> int: ...
+    def num_calls(self) -> int: ...
+    def num_samples(self) -> int: ...
+    def ipc(self) -> float: ...
+    def per_sample(self, c: PerfCounter) -> float: ...
+
 class RuntimeEventFn:
     def __init__(self) -> None: ...
+    def name(self) -> str: ...
     def is_init(self) -> bool: ...
     def init(self) -> None: ...
+    def field_access(self) -> FieldAccess: ...
     def on_event(self, o: RuntimeObject) -> int: ...
+    def on_event_many(self, objects: List[RuntimeObject]) -> List[int]: ...
+    def on_event_repeat(self, o: RuntimeObject, n: int) -> Tuple[int, int]: ...
+    def on_columns(self, state: RuntimeObject, columns: Dict[str, np.ndarray]) -> Tuple[int, int]: ...
+    def enable_instrumentation(self) -> None: ...
+    def disable_instrumentation(self) -> None: ...
+    def is_instrumented(self) -> bool: ...
+    def call_count(self) -> int: ...
+    def latency_histogram(self) -> LatencyHistogram: ...
+    def reset_latency_histogram(self) -> LatencyHistogram: ...
+    def enable_perf_counters(self, sample_every: int = 1) -> bool: ...
+    def disable_perf_counters(self) -> None: ...
+    def has_perf_counters(self) -> bool: ...
+    def perf_counters(self) -> PerfCounters: ...
+    def reset_perf_counters(self) -> PerfCounters: ...
     def __eq__(self, other: RuntimeEventFn) -> bool: ...
     @staticmethod
     def null() -> RuntimeEventFn: ...
 
+class EventGraph:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, ns: RuntimeNamespace, context: RuntimeStruct) -> None: ...
+    def add_event(self, fn: RuntimeEventFn) -> bool: ...
+    def bind(self) -> bool: ...
+    def is_bind(self) -> bool: ...
+    def num_events(self) -> int: ...
+    def field_id(self, name: str) -> int: ...
+    def affected_events(self, fields: List[str]) -> List[str]: ...
+    @overload
+    def on_change(self, o: RuntimeObject, field_ids: List[int]) -> int: ...
+    @overload
+    def on_change(self, o: RuntimeObject, fields: List[str]) -> int: ...
+    def on_trigger(self, o: RuntimeObject, event: str) -> int: ...
+    def __eq__(self, other: EventGraph) -> bool: ...
+    @staticmethod
+    def null() -> EventGraph: ...
+
+class QueueProducer(IntEnum):
+    single: int
+    multi: int
+
+class EventQueue:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, context: RuntimeStruct, capacity: int, producer: QueueProducer = ...) -> None: ...
+    def capacity(self) -> int: ...
+    def add_event(self, fn: RuntimeEventFn) -> int: ...
+    def try_publish(self, event_id: int, payload: RuntimeObject) -> bool: ...
+    def publish(self, event_id: int, payload: RuntimeObject) -> bool: ...
+    def poll(self, max_events: int) -> int: ...
+    def start(self, cpu: int = -1) -> bool: ...
+    def stop(self) -> None: ...
+    def is_running(self) -> bool: ...
+    def num_dispatched(self) -> int: ...
+    def num_failed(self) -> int: ...
+    def __eq__(self, other: EventQueue) -> bool: ...
+    @staticmethod
+    def null() -> EventQueue: ...
+
+class ShardedExecutor:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, state: RuntimeStruct, num_workers: int, keys_per_worker: int, queue_capacity: int) -> None: ...
+    def num_workers(self) -> int: ...
+    def add_event(self, fn: RuntimeEventFn) -> int: ...
+    def add_input_field(self, name: str) -> bool: ...
+    def worker_of(self, key: int) -> int: ...
+    def submit(self, key: int, event_id: int, payload: RuntimeObject) -> bool: ...
+    def submit_stateless(self, event_id: int, payload: RuntimeObject) -> bool: ...
+    def start(self, cpus: List[int] = ...) -> bool: ...
+    def drain(self) -> None: ...
+    def stop(self) -> None: ...
+    def is_running(self) -> bool: ...
+    def state(self, key: int) -> RuntimeObject: ...
+    def num_keys(self) -> int: ...
+    def num_dispatched(self) -> int: ...
+    def num_failed(self) -> int: ...
+    def num_dropped(self) -> int: ...
+    def num_stolen(self) -> int: ...
+    def __eq__(self, other: ShardedExecutor) -> bool: ...
+    @staticmethod
+    def null() -> ShardedExecutor: ...
+
+class ReplayLayout(IntEnum):
+    records: int
+    columns: int
+
+class Replay:
+    @overload
+    def __init__(self) -> None: ...
+    @overload
+    def __init__(self, record: RuntimeStruct, path: str, layout: ReplayLayout = ...) -> None: ...
+    def layout(self) -> ReplayLayout: ...
+    def num_records(self) -> int: ...
+    def set_prefetch_distance(self, num_records: int) -> None: ...
+    def run(self, fn: RuntimeEventFn, state: RuntimeObject, begin: int, end: int) -> Tuple[int, int]: ...
+    def run_in_place(self, fn: RuntimeEventFn, begin: int, end: int) -> Tuple[int, int]: ...
+    def __eq__(self, other: Replay) -> bool: ...
+    @staticmethod
+    def null() -> Replay: ...
+
 class RuntimeNamespace:
     def __init__(self) -> None: ...
     def name(self) -> str: ...
@@ -489,6 +1006,8 @@ class RuntimeNamespace:
     def bind(self) -> None: ...
     def struct_info(self, name: str) -> RuntimeStruct: ...
     def event_fn_info(self, name: str) -> RuntimeEventFn: ...
+    def trigger_fields(self, event: str) -> List[str]: ...
+    def load_checkpoint(self, path: str) -> RuntimeObject: ...
     def __eq__(self, other: RuntimeNamespace) -> bool: ...
     @staticmethod
     def null() -> RuntimeNamespace: ...
@@ -498,6 +1017,11 @@ class JustInTimeRunner:
     def bind(self) -> None: ...
     def is_bind(self) -> bool: ...
     def contains_symbol_definition(self, name: str) -> bool: ...
+    def lookup_latency(self) -> LatencyHistogram: ...
+    def enable_disassembly(self) -> bool: ...
+    def disassemble(self, symbol: str) -> Disassembly: ...
+    def enable_gdb_listener(self) -> bool: ...
+    def enable_perf_listener(self) -> bool: ...
     def process_module_fn(self, fn: Function) -> bool: ...
     def add_module(self, cursor: Cursor) -> None: ...
     def get_namespace(self, name: str) -> RuntimeNamespace: ...
@@ -0,0 +1,279 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#include "benchmark/benchmark.h"
+#include <cstdint>
+#include <string>
+#include "util/debug.h"
+#include "llvm_builder/defines.h"
+
+#include "llvm_builder/module.h"
+#include "llvm_builder/type.h"
+#include "llvm_builder/jit.h"
+#include "llvm_builder/function.h"
+
+using namespace llvm_builder;
+
+// NOTE{vibhanshu}: every benchmark arg list ends with `optimize`, 0 means event is
+//                  jit'ed as generated, 1 means it is first run through process_module_fn()
+namespace {
+
+enum : int64_t {
+    c_no_opt = 0,
+    c_opt = 1,
+};
+
+std::string field_name(uint32_t i) {
+    return LLVM_BUILDER_CONCAT << "field_" << i;
+}
+
+std::string unique_name(const std::string& prefix) {
+    static uint32_t s_counter = 0;
+    return LLVM_BUILDER_CONCAT << prefix << "_" << s_counter++;
+}
+
+void add_fields(Cursor& cursor, uint32_t num_fields) {
+    TypeInfo int32_type = TypeInfo::mk_int32();
+    for (uint32_t i = 0; i != num_fields; ++i) {
+        cursor.add_field(field_name(i), int32_type);
+    }
+}
+
+// chain of `num_ops` additions over the context fields, result stored in last field
+void gen_event_body(uint32_t num_fields, uint32_t num_ops) {
+    ValueInfo ctx = ValueInfo::from_context();
+    ValueInfo l_acc = ctx.field(field_name(0)).load();
+    for (uint32_t i = 0; i != num_ops; ++i) {
+        l_acc = l_acc + ctx.field(field_name(i % num_fields)).load();
+    }
+    ctx.field(field_name(num_fields - 1)).store(l_acc);
+    FunctionContext::set_return_value(ValueInfo::from_constant(0));
+}
+
+//
+// BenchEvent
+//
+// one cursor with a single event `bench_fn`, used by the runtime benchmarks
+class BenchEvent {
+    Cursor m_cursor;
+    JustInTimeRunner m_jit;
+    runtime::Struct m_struct;
+    runtime::EventFn m_event_fn;
+public:
+    explicit BenchEvent(uint32_t num_fields, uint32_t num_ops, bool optimize)
+      : m_cursor{unique_name("bench_event")} {
+        Cursor::Context l_cursor_ctx{m_cursor};
+        add_fields(m_cursor, num_fields);
+        m_cursor.bind("bench_args");
+        Module l_module = m_cursor.main_module();
+        Module::Context l_module_ctx{l_module};
+        {
+            Function fn("bench_fn");
+            {
+                FunctionContext l_fn_ctx{fn};
+                gen_event_body(num_fields, num_ops);
+            }
+            if (optimize) {
+                m_jit.process_module_fn(fn);
+            }
+        }
+        m_jit.add_module(m_cursor);
+        m_jit.bind();
+        const runtime::Namespace l_ns = m_jit.get_global_namespace();
+        m_struct = l_ns.struct_info("bench_args");
+        m_event_fn = l_ns.event_fn_info("bench_fn");
+    }
+public:
+    JustInTimeRunner& jit() {
+        return m_jit;
+    }
+    const runtime::Struct& struct_def() const {
+        return m_struct;
+    }
+    const runtime::EventFn& event_fn() const {
+        return m_event_fn;
+    }
+};
+
+bool check_error(benchmark::State& state) {
+    if (ErrorContext::has_error()) {
+        state.SkipWithError("llvm_builder error, see ErrorContext");
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+//
+// codegen
+//
+static void BM_codegen_value_graph(benchmark::State& state) {
+    const uint32_t l_num_ops = static_cast<uint32_t>(state.range(0));
+    constexpr uint32_t c_num_fields = 16;
+    for (auto _ : state) {
+        state.PauseTiming();
+        {
+            Cursor l_cursor{unique_name("bench_codegen")};
+            Cursor::Context l_cursor_ctx{l_cursor};
+            add_fields(l_cursor, c_num_fields);
+            l_cursor.bind("bench_args");
+            Module l_module = l_cursor.main_module();
+            Module::Context l_module_ctx{l_module};
+            state.ResumeTiming();
+            {
+                Function fn("bench_fn");
+                FunctionContext l_fn_ctx{fn};
+                gen_event_body(c_num_fields, l_num_ops);
+            }
+            state.PauseTiming();
+        }
+        // teardown of cursor is not part of measurement
+        state.ResumeTiming();
+    }
+    check_error(state);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * l_num_ops);
+}
+BENCHMARK(BM_codegen_value_graph)->RangeMultiplier(8)->Range(8, 4096)->Unit(benchmark::kMicrosecond);
+
+static void BM_cursor_bind(benchmark::State& state) {
+    const uint32_t l_num_fields = static_cast<uint32_t>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        {
+            Cursor l_cursor{unique_name("bench_bind")};
+            Cursor::Context l_cursor_ctx{l_cursor};
+            add_fields(l_cursor, l_num_fields);
+            state.ResumeTiming();
+            l_cursor.bind("bench_args");
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+    check_error(state);
+}
+BENCHMARK(BM_cursor_bind)->RangeMultiplier(8)->Range(1, 512)->Unit(benchmark::kMicrosecond);
+
+//
+// compile
+//
+static void BM_jit_compile(benchmark::State& state) {
+    const uint32_t l_num_ops = static_cast<uint32_t>(state.range(0));
+    const bool l_optimize = state.range(1) == c_opt;
+    constexpr uint32_t c_num_fields = 16;
+    for (auto _ : state) {
+        state.PauseTiming();
+        {
+            Cursor l_cursor{unique_name("bench_compile")};
+            JustInTimeRunner l_jit;
+            Cursor::Context l_cursor_ctx{l_cursor};
+            add_fields(l_cursor, c_num_fields);
+            l_cursor.bind("bench_args");
+            Module l_module = l_cursor.main_module();
+            Module::Context l_module_ctx{l_module};
+            {
+                Function fn("bench_fn");
+                {
+                    FunctionContext l_fn_ctx{fn};
+                    gen_event_body(c_num_fields, l_num_ops);
+                }
+                state.ResumeTiming();
+                if (l_optimize) {
+                    l_jit.process_module_fn(fn);
+                }
+            }
+            l_jit.add_module(l_cursor);
+            l_jit.bind();
+            state.PauseTiming();
+        }
+        const bool l_has_error = check_error(state);
+        state.ResumeTiming();
+        if (l_has_error) {
+            break;
+        }
+    }
+}
+BENCHMARK(BM_jit_compile)
+    ->ArgsProduct({{8, 64, 512, 4096}, {c_no_opt, c_opt}})
+    ->ArgNames({"ops", "optimize"})
+    ->Unit(benchmark::kMillisecond);
+
+//
+// lookup
+//
+static void BM_jit_get_fn(benchmark::State& state) {
+    BenchEvent l_event{2, 1, false};
+    if (check_error(state)) {
+        return;
+    }
+    const std::string l_symbol{"bench_fn"};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(l_event.jit().get_fn(l_symbol));
+    }
+    check_error(state);
+}
+BENCHMARK(BM_jit_get_fn);
+
+//
+// runtime object
+//
+static void BM_object_set_by_name(benchmark::State& state) {
+    BenchEvent l_event{16, 1, false};
+    if (check_error(state)) {
+        return;
+    }
+    runtime::Object l_obj = l_event.struct_def().mk_object();
+    const std::string l_name = field_name(7);
+    int32_t l_value = 0;
+    for (auto _ : state) {
+        l_obj.set<int32_t>(l_name, l_value++);
+    }
+    check_error(state);
+}
+BENCHMARK(BM_object_set_by_name);
+
+static void BM_object_get_by_name(benchmark::State& state) {
+    BenchEvent l_event{16, 1, false};
+    if (check_error(state)) {
+        return;
+    }
+    runtime::Object l_obj = l_event.struct_def().mk_object();
+    const std::string l_name = field_name(7);
+    l_obj.set<int32_t>(l_name, 42);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(l_obj.get<int32_t>(l_name));
+    }
+    check_error(state);
+}
+BENCHMARK(BM_object_get_by_name);
+
+//
+// event
+//
+static void BM_on_event(benchmark::State& state) {
+    const uint32_t l_num_fields = static_cast<uint32_t>(state.range(0));
+    const uint32_t l_num_ops = static_cast<uint32_t>(state.range(1));
+    const bool l_optimize = state.range(2) == c_opt;
+    BenchEvent l_event{l_num_fields, l_num_ops, l_optimize};
+    if (check_error(state)) {
+        return;
+    }
+    runtime::Object l_obj = l_event.struct_def().mk_object();
+    for (uint32_t i = 0; i != l_num_fields; ++i) {
+        l_obj.set<int32_t>(field_name(i), static_cast<int32_t>(i));
+    }
+    l_obj.freeze();
+    const runtime::EventFn& l_event_fn = l_event.event_fn();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(l_event_fn.on_event(l_obj));
+    }
+    check_error(state);
+}
+// tiny: 2 fields, 1 op; large: 256 fields, 1024 ops
+BENCHMARK(BM_on_event)
+    ->ArgsProduct({{2}, {1}, {c_no_opt, c_opt}})
+    ->ArgsProduct({{256}, {1024}, {c_no_opt, c_opt}})
+    ->ArgNames({"fields", "ops", "optimize"});
+
+BENCHMARK_MAIN();
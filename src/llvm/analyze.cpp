@@ -11,6 +11,8 @@
 #include <cstdio>
 #include <iostream>
 #include <iomanip>
+#include <type_traits>
+#include <unordered_map>
 
 LLVM_BUILDER_NS_BEGIN
 
@@ -41,6 +43,98 @@ Counter& Counter::singleton() {
 
 namespace analysis {
 
+namespace {
+
+// NOTE{vibhanshu}: cost model only needs the target description, so a standalone
+//                  host TargetMachine is used instead of the one owned by jit
+llvm::TargetMachine* host_target_machine() {
+    static std::unique_ptr<llvm::TargetMachine> s_tm = []() -> std::unique_ptr<llvm::TargetMachine> {
+        llvm::InitializeNativeTarget();
+        llvm::Expected<llvm::orc::JITTargetMachineBuilder> l_jtmb = llvm::orc::JITTargetMachineBuilder::detectHost();
+        if (not l_jtmb) {
+            llvm::consumeError(l_jtmb.takeError());
+            return nullptr;
+        }
+        llvm::Expected<std::unique_ptr<llvm::TargetMachine>> l_tm = l_jtmb->createTargetMachine();
+        if (not l_tm) {
+            llvm::consumeError(l_tm.takeError());
+            return nullptr;
+        }
+        return std::move(*l_tm);
+    }();
+    return s_tm.get();
+}
+
+uint64_t instruction_cost(const llvm::TargetTransformInfo& tti,
+                          const llvm::Instruction& inst,
+                          llvm::TargetTransformInfo::TargetCostKind kind) {
+    const llvm::InstructionCost l_cost = tti.getInstructionCost(&inst, kind);
+    if (not l_cost.isValid()) {
+        // no model for this instruction, assume single cycle
+        return 1;
+    }
+    // getValue() returns optional in older llvm, plain value in newer
+    const auto l_raw = l_cost.getValue();
+    int64_t l_value = 0;
+    if constexpr (std::is_integral_v<std::remove_cvref_t<decltype(l_raw)>>) {
+        l_value = l_raw;
+    } else {
+        l_value = *l_raw;
+    }
+    return l_value < 0 ? 0 : static_cast<uint64_t>(l_value);
+}
+
+}
+
+std::string_view op_type_name(OpType t) {
+    switch (t) {
+    case OpType::UNDEFINED:   return "undefined";
+    case OpType::FN_CALL:     return "fn_call";
+    case OpType::NEG:         return "neg";
+    case OpType::ADD:         return "add";
+    case OpType::SUB:         return "sub";
+    case OpType::MULT:        return "mult";
+    case OpType::DIV:         return "div";
+    case OpType::REMAINDER:   return "remainder";
+    case OpType::RETURN:      return "return";
+    case OpType::BRANCH:      return "branch";
+    case OpType::LSHIFT:      return "lshift";
+    case OpType::RSHIFT:      return "rshift";
+    case OpType::AND:         return "and";
+    case OpType::OR:          return "or";
+    case OpType::XOR:         return "xor";
+    case OpType::CMP:         return "cmp";
+    case OpType::ALLOC:       return "alloc";
+    case OpType::LOAD:        return "load";
+    case OpType::STORE:       return "store";
+    case OpType::EXTRACT_VEC: return "extract_vec";
+    case OpType::INSERT_VEC:  return "insert_vec";
+    case OpType::GEP:         return "gep";
+    case OpType::CAST:        return "cast";
+    }
+    return "unknown";
+}
+
+//
+// FunctionCost
+//
+void FunctionCost::print(std::ostream& os, const std::string& offset) const {
+    os << offset << "Cost: BEGIN" << std::endl
+       << offset << "   cpu:" << m_cpu_name << std::endl
+       << offset << "   estimated_cycles:" << estimated_cycles() << std::endl
+       << offset << "   critical_path_cycles:" << m_critical_path_cycles << std::endl
+       << offset << "   throughput_cycles:" << m_throughput_cycles << std::endl
+       << offset << "   latency_cycles:" << m_latency_cycles << std::endl
+       << offset << "   bytes_loaded:" << m_bytes_loaded << std::endl
+       << offset << "   bytes_stored:" << m_bytes_stored << std::endl;
+    for (uint32_t i = 0; i != c_num_op_types; ++i) {
+        if (m_op_count[i] != 0) {
+            os << offset << "   op[" << op_type_name(static_cast<OpType>(i)) << "]:" << m_op_count[i] << std::endl;
+        }
+    }
+    os << offset << "Cost: END" << std::endl;
+}
+
 //
 // Inst
 //
@@ -245,6 +339,56 @@ int32_t FunctionAnalysis::num_inst() const {
     return m_func.getInstructionCount();
 }
 
+std::string_view FunctionAnalysis::name() const {
+    return m_func.getName();
+}
+
+FunctionCost FunctionAnalysis::cost() const {
+    using tti_t = llvm::TargetTransformInfo;
+    FunctionCost l_cost;
+    if (m_func.isDeclaration()) {
+        return l_cost;
+    }
+    const llvm::DataLayout& l_layout = m_func.getParent()->getDataLayout();
+    llvm::TargetMachine* l_tm = host_target_machine();
+    const tti_t l_tti = l_tm != nullptr ? l_tm->getTargetTransformInfo(m_func) : tti_t{l_layout};
+    l_cost.m_cpu_name = l_tm != nullptr ? l_tm->getTargetCPU().str() : std::string{"generic"};
+    // cycle at which result of each instruction is available, blocks are visited in
+    // layout order so values flowing over back-edges (phi) are not part of the chain
+    // TODO{vibhanshu}: add store -> load dependency through memory, context fields
+    //                  written and read back in same event are not on critical path now
+    std::unordered_map<const llvm::Instruction*, uint64_t> l_ready_at;
+    for (const CodeBlock& l_block : m_code_blocks) {
+        for (const Inst& l_inst : l_block.m_insts) {
+            const llvm::Instruction& l_raw = l_inst.m_inst;
+            if (l_raw.isDebugOrPseudoInst()) {
+                continue;
+            }
+            ++l_cost.m_op_count[static_cast<uint32_t>(l_inst.op_code())];
+            const uint64_t l_latency = instruction_cost(l_tti, l_raw, tti_t::TCK_Latency);
+            l_cost.m_latency_cycles += l_latency;
+            l_cost.m_throughput_cycles += instruction_cost(l_tti, l_raw, tti_t::TCK_RecipThroughput);
+            uint64_t l_start = 0;
+            for (const llvm::Use& l_use : l_raw.operands()) {
+                if (const auto* l_def = llvm::dyn_cast<llvm::Instruction>(l_use.get())) {
+                    auto it = l_ready_at.find(l_def);
+                    if (it != l_ready_at.end()) {
+                        l_start = std::max(l_start, it->second);
+                    }
+                }
+            }
+            l_ready_at[&l_raw] = l_start + l_latency;
+            l_cost.m_critical_path_cycles = std::max(l_cost.m_critical_path_cycles, l_start + l_latency);
+            if (const auto* l_load = llvm::dyn_cast<llvm::LoadInst>(&l_raw)) {
+                l_cost.m_bytes_loaded += l_layout.getTypeStoreSize(l_load->getType()).getFixedValue();
+            } else if (const auto* l_store = llvm::dyn_cast<llvm::StoreInst>(&l_raw)) {
+                l_cost.m_bytes_stored += l_layout.getTypeStoreSize(l_store->getValueOperand()->getType()).getFixedValue();
+            }
+        }
+    }
+    return l_cost;
+}
+
 void FunctionAnalysis::analyze(std::ostream& os, const std::string& offset) const {
     os << offset << "Function: BEGIN" << std::endl
         << offset << "   num_instruction:" << m_func.getInstructionCount() << std::endl
@@ -258,6 +402,11 @@ void FunctionAnalysis::analyze(std::ostream& os, const std::string& offset) cons
     os << offset << "Function: END" << std::endl;
 }
 
+void FunctionAnalysis::cost_report(std::ostream& os, const std::string& offset) const {
+    os << offset << "Function: " << name() << std::endl;
+    cost().print(os, LLVM_BUILDER_CONCAT << offset << "    ");
+}
+
 void FunctionAnalysis::for_each_inst(std::ostream& os, std::function<void(const Inst &)> &&fn) const {
     os << "Function: BEGIN" << std::endl
         << "   num_instruction:" << m_func.getInstructionCount() << std::endl
@@ -293,6 +442,16 @@ void ModuleAnalysis::analyze(std::ostream& os) const {
     os << " DEBUG MODULE END" << std::endl;
 }
 
+void ModuleAnalysis::cost_report(std::ostream& os) const {
+    os << " COST REPORT BEGIN " << std::endl;
+    for (const FunctionAnalysis &fn : m_funcs) {
+        if (not fn.m_func.isDeclaration()) {
+            fn.cost_report(os, "    ");
+        }
+    }
+    os << " COST REPORT END" << std::endl;
+}
+
 void ModuleAnalysis::for_each_inst(std::ostream &os, std::function<void(const Inst &)> &&fn) const {
     os << " DEBUG MODULE BEGIN " << std::endl;
     for (const FunctionAnalysis &l_fn : m_funcs) {
@@ -301,6 +460,68 @@ void ModuleAnalysis::for_each_inst(std::ostream &os, std::function<void(const In
     os << " DEBUG MODULE END" << std::endl;
 }
 
+//
+// ValueAnnotation
+//
+ValueAnnotation::ValueAnnotation() = default;
+
+ValueAnnotation::ValueAnnotation(const std::string& description, const TagInfo& tags, const SourceLoc& loc)
+  : m_description{description}, m_tags{tags}, m_source_loc{loc} {
+}
+
+void ValueAnnotation::print(std::ostream& os) const {
+    os << m_description;
+    if (not m_tags.empty()) {
+        os << " tags:" << m_tags;
+    }
+    if (m_source_loc.is_valid()) {
+        os << " " << m_source_loc;
+    }
+}
+
+//
+// AsmInst
+//
+AsmInst::AsmInst(uint64_t address, uint32_t offset, uint32_t size, std::string&& text,
+                 const SourceLoc& line, const ValueAnnotation& value)
+  : m_address{address}, m_offset{offset}, m_size{size}, m_text{std::move(text)}, m_line{line}, m_value{value} {
+}
+
+void AsmInst::print(std::ostream& os) const {
+    char l_offset[16];
+    std::snprintf(l_offset, sizeof(l_offset), "+0x%04x", m_offset);
+    os << l_offset << ":  " << std::left << std::setw(40) << m_text << std::right;
+    if (m_line.is_valid() or not m_value.empty()) {
+        os << " ;";
+        if (m_line.is_valid()) {
+            os << " " << m_line.file_name() << ":" << m_line.line_num();
+        }
+        if (not m_value.empty()) {
+            os << " " << m_value.description();
+            if (not m_value.tags().empty()) {
+                os << " tags:" << m_value.tags();
+            }
+        }
+    }
+}
+
+//
+// Disassembly
+//
+Disassembly::Disassembly(const std::string& symbol, uint64_t address, uint64_t code_size)
+  : m_symbol{symbol}, m_address{address}, m_code_size{code_size} {
+}
+
+void Disassembly::print(std::ostream& os) const {
+    os << m_symbol << " @0x" << std::hex << m_address << std::dec
+       << " code_size:" << m_code_size << " bytes, num_inst:" << m_insts.size() << std::endl;
+    for (const AsmInst& l_inst : m_insts) {
+        os << "    ";
+        l_inst.print(os);
+        os << std::endl;
+    }
+}
+
 }
 
 LLVM_BUILDER_NS_END
@@ -0,0 +1,95 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_LLVM_CHECKPOINT_H_
+#define LLVM_BUILDER_LLVM_CHECKPOINT_H_
+
+#include "llvm_builder/defines.h"
+
+#include <cstdint>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// Checkpoint
+//
+// File written by Object::write_checkpoint(), little endian and laid out as
+//     [ Header | Struct x num_structs | Field x num_fields | Node x num_nodes
+//       | Link x num_links | node data, each c_alignment aligned ... ]
+// Node 0 is the root object. Node data is the raw object/array buffer, pointer
+// fields/elements in it are stale and are patched on load from the links of the
+// node. Struct layouts are checked against the loading namespace, so a file is
+// only loaded by code with the same struct definitions
+namespace checkpoint {
+
+enum : uint32_t {
+    c_version = 1,
+    c_max_name = 64,
+    c_alignment = 64,
+};
+static constexpr uint64_t c_magic = 0x314b50434d564c4c; // "LLVMCPK1"
+
+enum : uint32_t {
+    c_kind_object = 1,
+    c_kind_array = 2,
+};
+
+struct Header {
+    uint64_t m_magic;
+    uint32_t m_version;
+    uint32_t m_num_structs;
+    uint32_t m_num_fields;
+    uint32_t m_num_nodes;
+    uint32_t m_num_links;
+    uint32_t m_reserved;
+    uint64_t m_data_offset;
+    uint64_t m_file_size;
+};
+
+struct Struct {
+    char m_name[c_max_name];
+    uint32_t m_size;
+    uint32_t m_first_field;
+    uint32_t m_num_fields;
+    uint32_t m_reserved;
+};
+
+struct Field {
+    char m_name[c_max_name];
+    uint32_t m_offset;
+    // runtime::type_t
+    uint32_t m_type;
+};
+
+struct Node {
+    uint32_t m_kind;
+    // struct idx for objects, runtime::type_t of elements for arrays
+    uint32_t m_type;
+    uint32_t m_num_elements;
+    uint32_t m_first_link;
+    uint32_t m_num_links;
+    uint32_t m_reserved;
+    uint64_t m_offset;
+    uint64_t m_size;
+};
+
+struct Link {
+    // field idx within struct for objects, element idx for arrays
+    uint32_t m_slot;
+    uint32_t m_child;
+};
+
+inline uint64_t table_size(const Header& h) {
+    return sizeof(Header)
+           + sizeof(Struct) * h.m_num_structs
+           + sizeof(Field) * h.m_num_fields
+           + sizeof(Node) * h.m_num_nodes
+           + sizeof(Link) * h.m_num_links;
+}
+
+} // namespace checkpoint
+
+LLVM_BUILDER_NS_END
+
+#endif // LLVM_BUILDER_LLVM_CHECKPOINT_H_
@@ -47,6 +47,7 @@ FOR_EACH_LLVM_TYPE(DECL_MK_TYPE)
     TypeInfo mk_type_struct(const std::string& name, const std::vector<field_entry_t>& element_list, bool is_packed);
     void main_module_hook_fn(on_main_module_fn_t &&fn);
     bool is_bind_called() const;
+    bool is_debug_info_enabled() const;
     void for_each_module(on_module_fn_t&& fn);
 public:
     // TODO{vibhanshu}: make these private
@@ -0,0 +1,168 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#include "llvm/debug_info.h"
+#include "llvm/context_impl.h"
+#include "util/debug.h"
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// DebugInfoBuilder
+//
+DebugInfoBuilder::DebugInfoBuilder(llvm::Module& module)
+  : m_module{module}, m_builder{module} {
+    m_module.addModuleFlag(llvm::Module::Warning, "Debug Info Version", llvm::DEBUG_METADATA_VERSION);
+    m_module.addModuleFlag(llvm::Module::Warning, "Dwarf Version", 4);
+    llvm::DIFile* l_file = M_file(m_module.getName().str());
+    m_compile_unit = m_builder.createCompileUnit(llvm::dwarf::DW_LANG_C_plus_plus,
+                                                 l_file,
+                                                 "llvm_builder",
+                                                 false, "", 0);
+    m_fn_type = m_builder.createSubroutineType(m_builder.getOrCreateTypeArray({}));
+}
+
+DebugInfoBuilder::~DebugInfoBuilder() {
+    // NOTE{vibhanshu}: finalize is required before the module is emitted, if module was
+    //                  never handed over to jit, still finalize to release temporary nodes
+    finalize();
+}
+
+llvm::DIFile* DebugInfoBuilder::M_file(const std::string& path) {
+    auto it = m_files.find(path);
+    if (it != m_files.end()) {
+        return it->second;
+    }
+    llvm::StringRef l_name = llvm::sys::path::filename(path);
+    llvm::StringRef l_dir = llvm::sys::path::parent_path(path);
+    llvm::DIFile* l_file = m_builder.createFile(l_name, l_dir);
+    m_files.emplace(path, l_file);
+    return l_file;
+}
+
+void DebugInfoBuilder::add_subprogram(llvm::Function* fn, const SourceLoc& loc) {
+    LLVM_BUILDER_ASSERT(fn != nullptr);
+    LLVM_BUILDER_ASSERT(not m_is_finalized);
+    if (fn->getSubprogram() != nullptr) {
+        return;
+    }
+    llvm::DIFile* l_file = loc.is_valid() ? M_file(loc.file_name()) : m_compile_unit->getFile();
+    const uint32_t l_line = loc.is_valid() ? loc.line_num() : 0;
+    llvm::DISubprogram* l_sp = m_builder.createFunction(l_file,
+                                                        fn->getName(),
+                                                        fn->getName(),
+                                                        l_file,
+                                                        l_line,
+                                                        m_fn_type,
+                                                        l_line,
+                                                        llvm::DINode::FlagPrototyped,
+                                                        llvm::DISubprogram::SPFlagDefinition);
+    fn->setSubprogram(l_sp);
+}
+
+const llvm::DILocation* DebugInfoBuilder::location(llvm::Function* fn, const SourceLoc& loc, uint32_t discriminator) {
+    LLVM_BUILDER_ASSERT(fn != nullptr);
+    llvm::DISubprogram* l_sp = fn->getSubprogram();
+    if (l_sp == nullptr) {
+        return nullptr;
+    }
+    llvm::LLVMContext& l_ctx = m_module.getContext();
+    if (not loc.is_valid()) {
+        return llvm::DILocation::get(l_ctx, l_sp->getLine(), 0, l_sp)->cloneWithDiscriminator(discriminator);
+    }
+    llvm::DIFile* l_file = M_file(loc.file_name());
+    llvm::DIScope* l_scope = l_sp;
+    if (l_file != l_sp->getFile()) {
+        // value created in a different host file than the function definition
+        const lexical_key_t l_key{l_sp, l_file};
+        auto it = m_lexical_blocks.find(l_key);
+        if (it == m_lexical_blocks.end()) {
+            it = m_lexical_blocks.emplace(l_key, m_builder.createLexicalBlockFile(l_sp, l_file)).first;
+        }
+        l_scope = it->second;
+    }
+    return llvm::DILocation::get(l_ctx, loc.line_num(), 0, l_scope)->cloneWithDiscriminator(discriminator);
+}
+
+uint32_t DebugInfoBuilder::add_annotation(llvm::Function* fn, analysis::ValueAnnotation&& annotation) {
+    LLVM_BUILDER_ASSERT(fn != nullptr);
+    if (m_is_finalized) {
+        return 0;
+    }
+    annotation_list_t& l_list = m_annotations[fn->getName().str()];
+    l_list.emplace_back(std::move(annotation));
+    return static_cast<uint32_t>(l_list.size());
+}
+
+const analysis::ValueAnnotation* DebugInfoBuilder::find_annotation(const annotation_map_t& annotations,
+                                                                   const std::string& fn_name,
+                                                                   uint32_t discriminator) {
+    if (discriminator == 0) {
+        return nullptr;
+    }
+    auto it = annotations.find(fn_name);
+    if (it == annotations.end() or discriminator > it->second.size()) {
+        return nullptr;
+    }
+    return &it->second[discriminator - 1];
+}
+
+void DebugInfoBuilder::finalize() {
+    if (m_is_finalized) {
+        return;
+    }
+    m_builder.finalize();
+    m_is_finalized = true;
+}
+
+//
+// DebugLocGuard
+//
+DebugLocGuard::DebugLocGuard(DebugInfoBuilder* debug_info, llvm::Function* fn, const SourceLoc& loc, uint32_t discriminator) {
+    if (debug_info == nullptr or fn == nullptr or debug_info->is_finalized()) {
+        return;
+    }
+    if (not CursorContextImpl::has_value()) {
+        return;
+    }
+    if (const llvm::DILocation* l_loc = debug_info->location(fn, loc, discriminator)) {
+        m_builder = &CursorContextImpl::builder();
+        m_prev_loc = m_builder->getCurrentDebugLocation();
+        m_builder->SetCurrentDebugLocation(l_loc);
+    }
+}
+
+DebugLocGuard::~DebugLocGuard() {
+    if (m_builder != nullptr) {
+        m_builder->SetCurrentDebugLocation(m_prev_loc);
+    }
+}
+
+//
+// ValueAnnotationWriter
+//
+ValueAnnotationWriter::ValueAnnotationWriter(const DebugInfoBuilder& debug_info)
+  : m_debug_info{debug_info} {
+}
+
+void ValueAnnotationWriter::printInfoComment(const llvm::Value& value, llvm::formatted_raw_ostream& os) {
+    const llvm::Instruction* l_inst = llvm::dyn_cast<llvm::Instruction>(&value);
+    if (l_inst == nullptr) {
+        return;
+    }
+    const llvm::DebugLoc& l_loc = l_inst->getDebugLoc();
+    if (not l_loc) {
+        return;
+    }
+    const analysis::ValueAnnotation* l_annotation = DebugInfoBuilder::find_annotation(
+        m_debug_info.annotations(), l_inst->getFunction()->getName().str(), l_loc->getDiscriminator());
+    if (l_annotation == nullptr) {
+        return;
+    }
+    std::ostringstream l_os;
+    l_annotation->print(l_os);
+    os << "  ; " << l_os.str();
+}
+
+LLVM_BUILDER_NS_END
@@ -0,0 +1,96 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_LLVM_DEBUG_INFO_H_
+#define LLVM_BUILDER_LLVM_DEBUG_INFO_H_
+
+#include "llvm_builder/defines.h"
+#include "llvm_builder/util/error.h"
+#include "llvm_builder/analyze.h"
+#include "meta/noncopyable.h"
+#include "ext_include.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// DebugInfoBuilder
+//
+// Emits DWARF metadata for one llvm::Module, each instruction is tagged with
+// the host (C++/python) source line which created the ValueInfo it came from.
+// DILocation discriminator is 1 + index of the ValueAnnotation of that ValueInfo
+// within the function, so machine code can be mapped back to DSL values after
+// codegen. Column is left 0 (unknown), host source locations carry no column
+class DebugInfoBuilder : meta::noncopyable {
+    using lexical_key_t = std::pair<llvm::DISubprogram*, llvm::DIFile*>;
+public:
+    using annotation_list_t = std::vector<analysis::ValueAnnotation>;
+    using annotation_map_t = std::unordered_map<std::string, annotation_list_t>;
+private:
+    llvm::Module& m_module;
+    llvm::DIBuilder m_builder;
+    llvm::DICompileUnit* m_compile_unit = nullptr;
+    llvm::DISubroutineType* m_fn_type = nullptr;
+    std::unordered_map<std::string, llvm::DIFile*> m_files;
+    std::map<lexical_key_t, llvm::DILexicalBlockFile*> m_lexical_blocks;
+    annotation_map_t m_annotations;
+    bool m_is_finalized = false;
+public:
+    explicit DebugInfoBuilder(llvm::Module& module);
+    ~DebugInfoBuilder();
+public:
+    bool is_finalized() const {
+        return m_is_finalized;
+    }
+    // `fn` must get a body, DISubprogram is a definition
+    void add_subprogram(llvm::Function* fn, const SourceLoc& loc);
+    const llvm::DILocation* location(llvm::Function* fn, const SourceLoc& loc, uint32_t discriminator);
+    // returns discriminator to use for instructions generated by the value, 0 if none
+    uint32_t add_annotation(llvm::Function* fn, analysis::ValueAnnotation&& annotation);
+    const annotation_map_t& annotations() const {
+        return m_annotations;
+    }
+    void finalize();
+public:
+    static const analysis::ValueAnnotation* find_annotation(const annotation_map_t& annotations,
+                                                            const std::string& fn_name,
+                                                            uint32_t discriminator);
+private:
+    llvm::DIFile* M_file(const std::string& path);
+};
+
+//
+// DebugLocGuard
+//
+// sets debug location of cursor IRBuilder for the lifetime of the guard,
+// no-op if the module has debug info disabled
+class DebugLocGuard : meta::noncopyable {
+    llvm::IRBuilder<>* m_builder = nullptr;
+    llvm::DebugLoc m_prev_loc;
+public:
+    explicit DebugLocGuard(DebugInfoBuilder* debug_info, llvm::Function* fn, const SourceLoc& loc, uint32_t discriminator);
+    ~DebugLocGuard();
+};
+
+//
+// ValueAnnotationWriter
+//
+// IR printer hook, appends the DSL value behind each instruction as a comment
+class ValueAnnotationWriter : public llvm::AssemblyAnnotationWriter {
+    const DebugInfoBuilder& m_debug_info;
+public:
+    explicit ValueAnnotationWriter(const DebugInfoBuilder& debug_info);
+    ~ValueAnnotationWriter() override = default;
+public:
+    void printInfoComment(const llvm::Value& value, llvm::formatted_raw_ostream& os) override;
+};
+
+LLVM_BUILDER_NS_END
+
+#endif // LLVM_BUILDER_LLVM_DEBUG_INFO_H_
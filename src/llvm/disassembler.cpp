@@ -0,0 +1,88 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#include "llvm/disassembler.h"
+#include "util/debug.h"
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// HostDisassembler
+//
+HostDisassembler::HostDisassembler() : m_triple{llvm::sys::getProcessTriple()} {
+    static const bool s_init = [] () {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetDisassembler();
+        return true;
+    } ();
+    (void)s_init;
+    const llvm::Target* l_target = llvm::TargetRegistry::lookupTarget(m_triple, m_error);
+    if (l_target == nullptr) {
+        return;
+    }
+    m_reg_info.reset(l_target->createMCRegInfo(m_triple));
+    if (not m_reg_info) {
+        m_error = "no register info for target:" + m_triple;
+        return;
+    }
+    llvm::MCTargetOptions l_options;
+    m_asm_info.reset(l_target->createMCAsmInfo(*m_reg_info, m_triple, l_options));
+    m_subtarget_info.reset(l_target->createMCSubtargetInfo(m_triple, llvm::sys::getHostCPUName(), ""));
+    m_instr_info.reset(l_target->createMCInstrInfo());
+    if (not m_asm_info or not m_subtarget_info or not m_instr_info) {
+        m_error = "incomplete MC layer for target:" + m_triple;
+        return;
+    }
+    const llvm::Triple l_triple{m_triple};
+    m_context = std::make_unique<llvm::MCContext>(l_triple, m_asm_info.get(), m_reg_info.get(), m_subtarget_info.get());
+    m_disassembler.reset(l_target->createMCDisassembler(*m_subtarget_info, *m_context));
+    if (not m_disassembler) {
+        m_error = "no disassembler for target:" + m_triple;
+        return;
+    }
+    m_printer.reset(l_target->createMCInstPrinter(l_triple,
+                                                  m_asm_info->getAssemblerDialect(),
+                                                  *m_asm_info,
+                                                  *m_instr_info,
+                                                  *m_reg_info));
+    if (not m_printer) {
+        m_error = "no instruction printer for target:" + m_triple;
+        return;
+    }
+    m_printer->setPrintImmHex(true);
+}
+
+HostDisassembler::~HostDisassembler() = default;
+
+uint32_t HostDisassembler::decode(llvm::ArrayRef<uint8_t> bytes, uint64_t address, std::string& text) {
+    LLVM_BUILDER_ASSERT(is_valid());
+    llvm::MCInst l_inst;
+    uint64_t l_size = 0;
+    const llvm::MCDisassembler::DecodeStatus l_status =
+        m_disassembler->getInstruction(l_inst, l_size, bytes, address, llvm::nulls());
+    if (l_status != llvm::MCDisassembler::Success or l_size == 0) {
+        return 0;
+    }
+    llvm::raw_string_ostream l_os{text};
+    m_printer->printInst(&l_inst, address, "", *m_subtarget_info, l_os);
+    l_os.flush();
+    // printer indents with a tab
+    const size_t l_begin = text.find_first_not_of(" \t");
+    if (l_begin != std::string::npos and l_begin != 0) {
+        text.erase(0, l_begin);
+    }
+    for (char& c : text) {
+        if (c == '\t') {
+            c = ' ';
+        }
+    }
+    return static_cast<uint32_t>(l_size);
+}
+
+HostDisassembler& HostDisassembler::thread_instance() {
+    static thread_local HostDisassembler s_instance;
+    return s_instance;
+}
+
+LLVM_BUILDER_NS_END
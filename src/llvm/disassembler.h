@@ -0,0 +1,51 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_LLVM_DISASSEMBLER_H_
+#define LLVM_BUILDER_LLVM_DISASSEMBLER_H_
+
+#include "llvm_builder/defines.h"
+#include "meta/noncopyable.h"
+#include "ext_include.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// HostDisassembler
+//
+// MC layer disassembler for the host triple/cpu, i.e. the target the jit
+// emits code for. MCInstPrinter is not thread safe, use thread_instance()
+class HostDisassembler : meta::noncopyable {
+    std::string m_triple;
+    std::string m_error;
+    std::unique_ptr<const llvm::MCRegisterInfo> m_reg_info;
+    std::unique_ptr<const llvm::MCAsmInfo> m_asm_info;
+    std::unique_ptr<const llvm::MCSubtargetInfo> m_subtarget_info;
+    std::unique_ptr<const llvm::MCInstrInfo> m_instr_info;
+    std::unique_ptr<llvm::MCContext> m_context;
+    std::unique_ptr<const llvm::MCDisassembler> m_disassembler;
+    std::unique_ptr<llvm::MCInstPrinter> m_printer;
+public:
+    explicit HostDisassembler();
+    ~HostDisassembler();
+public:
+    bool is_valid() const {
+        return static_cast<bool>(m_printer);
+    }
+    const std::string& error() const {
+        return m_error;
+    }
+    // decodes one instruction located at `address`, returns its size in bytes,
+    // 0 if bytes are not a valid instruction
+    uint32_t decode(llvm::ArrayRef<uint8_t> bytes, uint64_t address, std::string& text);
+    static HostDisassembler& thread_instance();
+};
+
+LLVM_BUILDER_NS_END
+
+#endif // LLVM_BUILDER_LLVM_DISASSEMBLER_H_
@@ -8,6 +8,8 @@
 #include "util/debug.h"
 #include "util/string_util.h"
 
+#include <algorithm>
+
 LLVM_BUILDER_NS_BEGIN
 
 //
@@ -16,6 +18,7 @@ LLVM_BUILDER_NS_BEGIN
 class Event::Impl : meta::noncopyable {
 private:
     const std::string m_name;
+    std::vector<std::string> m_fields;
 public:
     explicit Impl(const std::string& name) : m_name{name} {
     }
@@ -24,6 +27,14 @@ public:
     const std::string& name() const {
         return m_name;
     }
+    const std::vector<std::string>& fields() const {
+        return m_fields;
+    }
+    void add_field(const std::string& field) {
+        if (std::find(m_fields.begin(), m_fields.end(), field) == m_fields.end()) {
+            m_fields.emplace_back(field);
+        }
+    }
     bool operator == (const Impl& o) const {
         return m_name == o.m_name;
     }
@@ -66,6 +77,31 @@ auto Event::name() const -> const std::string& {
     }
 }
 
+auto Event::fields() const -> const std::vector<std::string>& {
+    static const std::vector<std::string> s_empty;
+    CODEGEN_FN
+    if (has_error()) {
+        return s_empty;
+    }
+    if (std::shared_ptr<Impl> ptr = m_impl.lock()) {
+        return ptr->fields();
+    } else {
+        M_mark_error();
+        return s_empty;
+    }
+}
+
+void Event::M_add_field(const std::string& field) {
+    if (has_error()) {
+        return;
+    }
+    if (std::shared_ptr<Impl> ptr = m_impl.lock()) {
+        ptr->add_field(field);
+    } else {
+        M_mark_error();
+    }
+}
+
 auto Event::null(const std::string& log) -> Event {
     static Event s_null_event{};
     LLVM_BUILDER_ASSERT(s_null_event.has_error());
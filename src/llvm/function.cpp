@@ -10,9 +10,13 @@
 #include "util/cstring.h"
 #include "llvm_builder/module.h"
 #include "llvm/context_impl.h"
+#include "llvm/debug_info.h"
+#include "llvm/kernel.h"
 #include "llvm/ext_include.h"
 
+#include <algorithm>
 #include <iostream>
+#include <optional>
 
 LLVM_BUILDER_NS_BEGIN
 
@@ -176,6 +180,57 @@ public:
     }
 };
 
+//
+// FieldAccess
+//
+namespace {
+
+void add_sorted(std::vector<std::string>& dst, const std::string& field) {
+    auto it = std::lower_bound(dst.begin(), dst.end(), field);
+    if (it == dst.end() or *it != field) {
+        dst.insert(it, field);
+    }
+}
+
+// index of Cursor::c_changed_fields_name in context, if Cursor::enable_changed_fields() was called
+std::optional<uint32_t> changed_fields_idx() {
+    const TypeInfo l_ctx_type = CursorContextImpl::context_type().base_type();
+    for (uint32_t i = 0; i != l_ctx_type.num_elements(); ++i) {
+        if (l_ctx_type[i].name() == Cursor::c_changed_fields_name) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+bool FieldAccess::is_read(const std::string& field) const {
+    return m_is_opaque or std::binary_search(m_reads.begin(), m_reads.end(), field);
+}
+
+bool FieldAccess::is_written(const std::string& field) const {
+    return m_is_opaque or std::binary_search(m_writes.begin(), m_writes.end(), field);
+}
+
+void FieldAccess::add_read(const std::string& field) {
+    add_sorted(m_reads, field);
+}
+
+void FieldAccess::add_write(const std::string& field) {
+    add_sorted(m_writes, field);
+}
+
+void FieldAccess::merge(const FieldAccess& o) {
+    for (const std::string& l_field : o.m_reads) {
+        add_read(l_field);
+    }
+    for (const std::string& l_field : o.m_writes) {
+        add_write(l_field);
+    }
+    m_is_opaque = m_is_opaque or o.m_is_opaque;
+}
+
 //
 // Function::Impl
 //
@@ -189,6 +244,7 @@ class Function::Impl : meta::noncopyable {
     LinkSymbol m_link_symbol;
     std::vector<CodeSectionImpl> m_section_list;
     std::vector<CodeSection> m_section_stack;
+    FieldAccess m_field_access;
 public:
     explicit Impl(const LinkSymbolName& symbol_name
                   , const std::string& fn_name
@@ -233,6 +289,10 @@ public:
     }
     ValueInfo call_fn() const {
         CODEGEN_FN
+        return ValueInfo{M_callee(), typename ValueInfo::construct_fn_t{}};
+    }
+    // function to call from current module, declared there if it lives in another module
+    llvm::Function* M_callee() const {
         LLVM_BUILDER_ASSERT(is_valid());
         LLVM_BUILDER_ASSERT(Module::Context::has_value());
         Module& l_current_module = Module::Context::value();
@@ -248,7 +308,7 @@ public:
             }
             l_fn_to_call = l_existing;
         }
-        return ValueInfo{l_fn_to_call, typename ValueInfo::construct_fn_t{}};
+        return l_fn_to_call;
     }
     void declare_fn(const Module& dst_mod) const {
         LLVM_BUILDER_ASSERT(is_valid());
@@ -271,8 +331,12 @@ public:
     }
     void write_to_ostream() const {
         LLVM_BUILDER_ASSERT(is_valid());
-        // TODO{vibhanshu}: add assembly annotation for debugging
-        m_fn->print(llvm::errs(), nullptr);
+        if (const DebugInfoBuilder* l_debug_info = m_parent.debug_info_builder()) {
+            ValueAnnotationWriter l_writer{*l_debug_info};
+            m_fn->print(llvm::errs(), &l_writer);
+        } else {
+            m_fn->print(llvm::errs(), nullptr);
+        }
     }
     llvm::Value* M_eval_arg() const {
         LLVM_BUILDER_ASSERT(m_fn->arg_size() == 1);
@@ -281,6 +345,177 @@ public:
     const LinkSymbol& link_symbol() const {
         return m_link_symbol;
     }
+    // only for functions which get a body, DISubprogram is emitted as a definition
+    void add_subprogram() {
+        LLVM_BUILDER_ASSERT(is_valid());
+        if (DebugInfoBuilder* l_debug_info = m_parent.debug_info_builder()) {
+            SourceLoc l_loc;
+            SourceContext::peek_external(l_loc);
+            l_debug_info->add_subprogram(m_fn, l_loc);
+        }
+    }
+    const FieldAccess& field_access() const {
+        return m_field_access;
+    }
+    void merge_field_access(const FieldAccess& access) {
+        m_field_access.merge(access);
+    }
+    // body of kernel generated from `event`:
+    //     for (i = 0; i != num_rows; ++i) {
+    //         row.field = column[field][i]   (for every field)
+    //         r = event(&row)
+    //         column[field][i] = row.field   (for fields event writes)
+    //         if (r != 0) return r
+    //     }
+    void gen_kernel(const Impl& event) {
+        CODEGEN_FN
+        LLVM_BUILDER_ASSERT(is_valid());
+        LLVM_BUILDER_ASSERT(event.is_valid());
+        LLVM_BUILDER_ASSERT(m_section_list.empty());
+        // every field is copied into the row, only what event writes is copied back, so
+        // read only columns are never stored to and kernel accesses what event does
+        const FieldAccess& l_event_access = event.field_access();
+        m_field_access.merge(l_event_access);
+        const std::optional<uint32_t> l_mask_idx = changed_fields_idx();
+        llvm::LLVMContext& l_ctx = CursorContextImpl::ctx();
+        TypeInfo l_row_type = CursorContextImpl::context_type().base_type();
+        LLVM_BUILDER_ASSERT(l_row_type.is_struct());
+        llvm::StructType* l_row = llvm::cast<llvm::StructType>(l_row_type.native_value());
+        llvm::Function* l_event_fn = event.M_callee();
+        // own builder, so insert point of cursor builder is untouched
+        llvm::IRBuilder<> l_builder{l_ctx};
+        if (DebugInfoBuilder* l_debug_info = m_parent.debug_info_builder()) {
+            SourceLoc l_loc;
+            SourceContext::peek_external(l_loc);
+            l_builder.SetCurrentDebugLocation(l_debug_info->location(m_fn, l_loc, 0));
+        }
+        llvm::StructType* l_args_type = M_mk_kernel_args_type(l_ctx);
+        llvm::Type* l_ptr_type = l_args_type->getElementType(KernelArgs::c_columns_idx);
+        llvm::Type* l_i64_type = l_args_type->getElementType(KernelArgs::c_num_rows_idx);
+        llvm::BasicBlock* l_entry = llvm::BasicBlock::Create(l_ctx, "entry", m_fn);
+        llvm::BasicBlock* l_loop = llvm::BasicBlock::Create(l_ctx, "loop", m_fn);
+        llvm::BasicBlock* l_body = llvm::BasicBlock::Create(l_ctx, "body", m_fn);
+        llvm::BasicBlock* l_next = llvm::BasicBlock::Create(l_ctx, "next", m_fn);
+        llvm::BasicBlock* l_done = llvm::BasicBlock::Create(l_ctx, "done", m_fn);
+        llvm::BasicBlock* l_fail = llvm::BasicBlock::Create(l_ctx, "fail", m_fn);
+        // column pointers and strides are loop invariant, loaded once
+        l_builder.SetInsertPoint(l_entry);
+        llvm::Value* l_args = M_eval_arg();
+        llvm::Value* l_columns = l_builder.CreateLoad(l_ptr_type, l_builder.CreateStructGEP(l_args_type, l_args, KernelArgs::c_columns_idx), "columns");
+        llvm::Value* l_strides = l_builder.CreateLoad(l_ptr_type, l_builder.CreateStructGEP(l_args_type, l_args, KernelArgs::c_strides_idx), "strides");
+        llvm::Value* l_num_rows = l_builder.CreateLoad(l_i64_type, l_builder.CreateStructGEP(l_args_type, l_args, KernelArgs::c_num_rows_idx), "num_rows");
+        llvm::Value* l_row_ptr = l_builder.CreateAlloca(l_row, nullptr, "row");
+        const uint32_t l_num_fields = l_row->getNumElements();
+        std::vector<llvm::Value*> l_field_base(l_num_fields);
+        std::vector<llvm::Value*> l_field_stride(l_num_fields);
+        for (uint32_t i = 0; i != l_num_fields; ++i) {
+            l_field_base[i] = l_builder.CreateLoad(l_ptr_type, l_builder.CreateConstInBoundsGEP1_64(l_ptr_type, l_columns, i));
+            l_field_stride[i] = l_builder.CreateLoad(l_i64_type, l_builder.CreateConstInBoundsGEP1_64(l_i64_type, l_strides, i));
+        }
+        l_builder.CreateBr(l_loop);
+        l_builder.SetInsertPoint(l_loop);
+        llvm::PHINode* l_idx = l_builder.CreatePHI(l_i64_type, 2, "i");
+        l_idx->addIncoming(l_builder.getInt64(0), l_entry);
+        l_builder.CreateCondBr(l_builder.CreateICmpULT(l_idx, l_num_rows), l_body, l_done);
+        // columns may be strided/unaligned (packed struct, numpy slice), so access is align 1
+        l_builder.SetInsertPoint(l_body);
+        std::vector<llvm::Value*> l_field_ptr(l_num_fields);
+        for (uint32_t i = 0; i != l_num_fields; ++i) {
+            llvm::Type* l_field_type = l_row->getElementType(i);
+            llvm::Value* l_offset = l_builder.CreateMul(l_idx, l_field_stride[i]);
+            l_field_ptr[i] = l_builder.CreateInBoundsGEP(l_builder.getInt8Ty(), l_field_base[i], l_offset);
+            llvm::Value* l_value = l_builder.CreateAlignedLoad(l_field_type, l_field_ptr[i], llvm::Align(1));
+            l_builder.CreateStore(l_value, l_builder.CreateStructGEP(l_row, l_row_ptr, i));
+        }
+        llvm::Value* l_result = l_builder.CreateCall(l_event_fn->getFunctionType(), l_event_fn, {l_row_ptr}, "result");
+        for (uint32_t i = 0; i != l_num_fields; ++i) {
+            if (not l_event_access.is_written(l_row_type[i].name()) and l_mask_idx != i) {
+                continue;
+            }
+            llvm::Type* l_field_type = l_row->getElementType(i);
+            llvm::Value* l_value = l_builder.CreateLoad(l_field_type, l_builder.CreateStructGEP(l_row, l_row_ptr, i));
+            l_builder.CreateAlignedStore(l_value, l_field_ptr[i], llvm::Align(1));
+        }
+        l_builder.CreateCondBr(l_builder.CreateICmpEQ(l_result, l_builder.getInt32(0)), l_next, l_fail);
+        l_builder.SetInsertPoint(l_next);
+        llvm::Value* l_idx_next = l_builder.CreateAdd(l_idx, l_builder.getInt64(1), "i.next", true, true);
+        l_idx->addIncoming(l_idx_next, l_next);
+        l_builder.CreateBr(l_loop);
+        llvm::Value* l_num_processed = l_builder.CreateStructGEP(l_args_type, l_args, KernelArgs::c_num_processed_idx);
+        l_builder.SetInsertPoint(l_done);
+        l_builder.CreateStore(l_num_rows, l_num_processed);
+        l_builder.CreateRet(l_builder.getInt32(0));
+        l_builder.SetInsertPoint(l_fail);
+        l_builder.CreateStore(l_idx, l_num_processed);
+        l_builder.CreateRet(l_result);
+    }
+    // body of function fused from `stages`:
+    //     r = stage_0(ctx); if (r != 0) return r
+    //     ...
+    //     return 0
+    // stages are inlined, then stores of a stage are forwarded to loads of later stages
+    // and stores overwritten by later stages are dropped. Event sees context only at its
+    // entry and exit, so intermediate values of shared fields need not reach memory.
+    // false if a stage can't be inlined
+    bool gen_fused(const std::vector<std::shared_ptr<Impl>>& stages) {
+        CODEGEN_FN
+        LLVM_BUILDER_ASSERT(is_valid());
+        LLVM_BUILDER_ASSERT(not stages.empty());
+        LLVM_BUILDER_ASSERT(m_section_list.empty());
+        llvm::LLVMContext& l_ctx = CursorContextImpl::ctx();
+        llvm::IRBuilder<> l_builder{l_ctx};
+        if (DebugInfoBuilder* l_debug_info = m_parent.debug_info_builder()) {
+            SourceLoc l_loc;
+            SourceContext::peek_external(l_loc);
+            l_builder.SetCurrentDebugLocation(l_debug_info->location(m_fn, l_loc, 0));
+        }
+        llvm::Value* l_context = M_eval_arg();
+        std::vector<llvm::CallInst*> l_calls;
+        llvm::BasicBlock* l_block = llvm::BasicBlock::Create(l_ctx, "entry", m_fn);
+        // every stage resets changed fields on entry, so they are accumulated across stages
+        const std::optional<uint32_t> l_mask_idx = changed_fields_idx();
+        llvm::Value* l_mask_ptr = nullptr;
+        llvm::Value* l_mask = l_builder.getInt64(0);
+        if (l_mask_idx) {
+            l_builder.SetInsertPoint(l_block);
+            llvm::Type* l_ctx_type = CursorContextImpl::context_type().base_type().native_value();
+            l_mask_ptr = l_builder.CreateStructGEP(l_ctx_type, l_context, *l_mask_idx, "changed_fields_ptr");
+        }
+        auto store_mask = [&] () {
+            if (l_mask_ptr != nullptr) {
+                l_builder.CreateStore(l_mask, l_mask_ptr);
+            }
+        };
+        for (const std::shared_ptr<Impl>& l_stage : stages) {
+            m_field_access.merge(l_stage->field_access());
+            l_builder.SetInsertPoint(l_block);
+            llvm::Function* l_stage_fn = l_stage->native_handle();
+            llvm::CallInst* l_result = l_builder.CreateCall(l_stage_fn->getFunctionType(), l_stage_fn, {l_context}, "result");
+            l_calls.emplace_back(l_result);
+            if (l_mask_ptr != nullptr) {
+                l_mask = l_builder.CreateOr(l_mask, l_builder.CreateLoad(l_builder.getInt64Ty(), l_mask_ptr, "changed_fields"));
+            }
+            llvm::BasicBlock* l_fail = llvm::BasicBlock::Create(l_ctx, "fail", m_fn);
+            l_block = llvm::BasicBlock::Create(l_ctx, "stage", m_fn);
+            l_builder.CreateCondBr(l_builder.CreateICmpEQ(l_result, l_builder.getInt32(0)), l_block, l_fail);
+            l_builder.SetInsertPoint(l_fail);
+            store_mask();
+            l_builder.CreateRet(l_result);
+        }
+        l_builder.SetInsertPoint(l_block);
+        store_mask();
+        l_builder.CreateRet(l_builder.getInt32(0));
+        for (llvm::CallInst* l_call : l_calls) {
+            llvm::InlineFunctionInfo l_info;
+            llvm::InlineResult l_result = llvm::InlineFunction(*l_call, l_info);
+            if (not l_result.isSuccess()) {
+                CODEGEN_PUSH_ERROR(FUNCTION, "failed to inline stage of fused function:" << m_fn_name << ": " << l_result.getFailureReason());
+                return false;
+            }
+        }
+        M_optimize_fused();
+        return true;
+    }
     CodeSection mk_section(const std::string& name, const Function& fn) {
         LLVM_BUILDER_ASSERT(not name.empty());
         LLVM_BUILDER_ASSERT(not fn.has_error());
@@ -354,6 +589,30 @@ private:
         LLVM_BUILDER_ASSERT(l_fn_type != nullptr);
         return l_fn_type;
     }
+    void M_optimize_fused() {
+        llvm::LoopAnalysisManager l_lam;
+        llvm::FunctionAnalysisManager l_fam;
+        llvm::CGSCCAnalysisManager l_cgam;
+        llvm::ModuleAnalysisManager l_mam;
+        llvm::PassBuilder l_pb;
+        l_pb.registerModuleAnalyses(l_mam);
+        l_pb.registerCGSCCAnalyses(l_cgam);
+        l_pb.registerFunctionAnalyses(l_fam);
+        l_pb.registerLoopAnalyses(l_lam);
+        l_pb.crossRegisterProxies(l_lam, l_fam, l_cgam, l_mam);
+        llvm::FunctionPassManager l_fpm;
+        l_fpm.addPass(llvm::InstCombinePass());
+        l_fpm.addPass(llvm::GVNPass());
+        l_fpm.addPass(llvm::DSEPass());
+        l_fpm.addPass(llvm::SimplifyCFGPass());
+        l_fpm.run(*m_fn, l_fam);
+    }
+    // mirrors KernelArgs
+    static llvm::StructType* M_mk_kernel_args_type(llvm::LLVMContext& ctx) {
+        llvm::Type* l_ptr_type = llvm::PointerType::getUnqual(ctx);
+        llvm::Type* l_i64_type = llvm::Type::getInt64Ty(ctx);
+        return llvm::StructType::get(ctx, {l_ptr_type, l_ptr_type, l_i64_type, l_i64_type});
+    }
     llvm::Function* M_mk_fn(Module dest_mod) const {
         CODEGEN_FN
         if (is_external()) {
@@ -481,6 +740,85 @@ ValueInfo Function::call_fn() const {
     }
 }
 
+Function Function::mk_kernel() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return Function::null();
+    }
+    std::shared_ptr<Impl> ptr = m_impl.lock();
+    if (not ptr) {
+        M_mark_error();
+        return Function::null();
+    }
+    if (is_kernel_name(ptr->name())) {
+        return Function::null("kernel can't be generated from a kernel");
+    }
+    if (not Module::Context::has_value()) {
+        return Function::null("no active module found");
+    }
+    Function l_kernel{kernel_name(ptr->name())};
+    if (l_kernel.has_error()) {
+        return Function::null();
+    }
+    std::shared_ptr<Impl> l_kernel_ptr = l_kernel.m_impl.lock();
+    LLVM_BUILDER_ASSERT(l_kernel_ptr);
+    l_kernel_ptr->gen_kernel(*ptr);
+    return l_kernel;
+}
+
+Function Function::mk_fused(const std::string& name, const std::vector<Function>& stages) {
+    CODEGEN_FN
+    if (name.empty()) {
+        return Function::null("fused function name can't be empty");
+    }
+    if (stages.empty()) {
+        return Function::null("fused function needs at least one stage");
+    }
+    if (not Module::Context::has_value()) {
+        return Function::null("no active module found");
+    }
+    std::vector<std::shared_ptr<Impl>> l_stages;
+    for (const Function& l_stage : stages) {
+        if (l_stage.has_error()) {
+            return Function::null();
+        }
+        std::shared_ptr<Impl> ptr = l_stage.m_impl.lock();
+        if (not ptr) {
+            return Function::null();
+        }
+        if (is_kernel_name(ptr->name())) {
+            return Function::null(LLVM_BUILDER_CONCAT << "kernel can't be a stage of fused function:" << ptr->name());
+        }
+        // stage body is inlined, so it must be complete and in the same module
+        if (ptr->parent_module() != Module::Context::value() or ptr->native_handle()->isDeclaration()) {
+            return Function::null(LLVM_BUILDER_CONCAT << "stage of fused function must be defined in current module:" << ptr->name());
+        }
+        l_stages.emplace_back(std::move(ptr));
+    }
+    Function l_fused{name};
+    if (l_fused.has_error()) {
+        return Function::null();
+    }
+    std::shared_ptr<Impl> l_fused_ptr = l_fused.m_impl.lock();
+    LLVM_BUILDER_ASSERT(l_fused_ptr);
+    if (not l_fused_ptr->gen_fused(l_stages)) {
+        return Function::null();
+    }
+    return l_fused;
+}
+
+FieldAccess Function::field_access() const {
+    if (has_error()) {
+        return FieldAccess{};
+    }
+    if (std::shared_ptr<Impl> ptr = m_impl.lock()) {
+        return ptr->field_access();
+    } else {
+        M_mark_error();
+        return FieldAccess{};
+    }
+}
+
 void Function::declare_fn(Module& dst_mod) {
     CODEGEN_FN
     if (has_error()) {
@@ -665,6 +1003,17 @@ void Function::M_pop_section(CodeSection& code) {
     }
 }
 
+void Function::M_merge_field_access(const FieldAccess& access) {
+    if (has_error()) {
+        return;
+    }
+    if (std::shared_ptr<Impl> ptr = m_impl.lock()) {
+        ptr->merge_field_access(access);
+    } else {
+        M_mark_error();
+    }
+}
+
 struct ValueHash {
     size_t operator() (const ValueInfo& /*o*/) const {
         // TODO{vibhanshu}: fix the hash function to avoid collision
@@ -725,17 +1074,118 @@ private:
             m_store_loads.emplace(sink, std::move(loads));
         }
     }
+    // records context field behind `ptr` in `access`
+    static void M_add_field_access(const ValueInfo& ptr, bool is_write, FieldAccess& access) {
+        const uint32_t l_idx = ptr.M_context_field();
+        if (l_idx == ValueInfo::c_local_field) {
+            return;
+        }
+        const TypeInfo l_ctx_type = CursorContextImpl::context_type().base_type();
+        if (l_idx == ValueInfo::c_unknown_field or l_idx >= l_ctx_type.num_elements()) {
+            access.mark_opaque();
+            return;
+        }
+        const std::string l_field = l_ctx_type[l_idx].name();
+        if (is_write) {
+            access.add_write(l_field);
+        } else {
+            access.add_read(l_field);
+        }
+    }
+    static void M_add_loads_access(const std::vector<ValueInfo>& loads, FieldAccess& access) {
+        for (const ValueInfo& l_load : loads) {
+            LLVM_BUILDER_ASSERT(l_load.M_parents().size() == 1);
+            M_add_field_access(l_load.M_parents()[0], false, access);
+        }
+    }
+    void M_build_field_access() {
+        FieldAccess l_access;
+        for (const auto& [l_sink, l_loads] : m_store_loads) {
+            if (l_sink.value_type() == ValueInfo::value_type_t::store) {
+                M_add_field_access(l_sink.M_parents()[0], true, l_access);
+            } else if (l_sink.M_is_value_sink()) {
+                // call to another function
+                l_access.mark_opaque();
+            }
+            M_add_loads_access(l_loads, l_access);
+        }
+        m_fn.M_merge_field_access(l_access);
+    }
+    struct changed_field_t {
+        uint32_t idx;
+        llvm::Value* old_value;
+        ValueInfo new_value;
+    };
+    // values on section entry of context fields stored by this section, must be called
+    // before any store of the section is emitted
+    std::vector<changed_field_t> M_load_changed_fields(uint32_t mask_idx) {
+        std::vector<changed_field_t> l_result;
+        for (const ValueInfo& l_sink : m_sink_values) {
+            if (l_sink.value_type() != ValueInfo::value_type_t::store) {
+                continue;
+            }
+            ValueInfo l_ptr = l_sink.M_parents()[0];
+            const uint32_t l_idx = l_ptr.M_context_field();
+            if (l_idx >= mask_idx) {
+                continue;
+            }
+            llvm::Value* l_raw_ptr = l_ptr.M_eval();
+            llvm::Type* l_type = l_sink.M_parents()[1].type().native_value();
+            llvm::Value* l_old = m_cursor_impl.builder().CreateLoad(l_type, l_raw_ptr, "old_value");
+            l_result.emplace_back(changed_field_t{l_idx, l_old, l_sink.M_parents()[1]});
+        }
+        return l_result;
+    }
+    // ORs bits of fields whose stored value differs from `changed` old value into mask
+    // field, mask starts from 0 in entry section of the function
+    void M_store_changed_fields(uint32_t mask_idx, std::vector<changed_field_t>& changed) {
+        const bool l_is_entry = m_basic_block == &m_basic_block->getParent()->getEntryBlock();
+        if (changed.empty() and not l_is_entry) {
+            return;
+        }
+        llvm::IRBuilder<>& l_builder = m_cursor_impl.builder();
+        llvm::Type* l_ctx_type = CursorContextImpl::context_type().base_type().native_value();
+        llvm::Value* l_mask_ptr = l_builder.CreateStructGEP(l_ctx_type, m_fn.M_eval_arg(), mask_idx, "changed_fields_ptr");
+        llvm::Value* l_mask = l_builder.getInt64(0);
+        if (not l_is_entry) {
+            l_mask = l_builder.CreateLoad(l_builder.getInt64Ty(), l_mask_ptr, "changed_fields");
+        }
+        for (changed_field_t& l_field : changed) {
+            llvm::Value* l_new = l_field.new_value.M_eval();
+            llvm::Value* l_is_changed = nullptr;
+            if (l_new->getType()->isFloatingPointTy()) {
+                l_is_changed = l_builder.CreateFCmpUNE(l_field.old_value, l_new);
+            } else if (l_new->getType()->isIntegerTy() or l_new->getType()->isPointerTy()) {
+                l_is_changed = l_builder.CreateICmpNE(l_field.old_value, l_new);
+            } else {
+                // vectors and aggregates are marked changed whenever stored
+                l_is_changed = l_builder.getTrue();
+            }
+            llvm::Value* l_bit = l_builder.CreateShl(l_builder.CreateZExt(l_is_changed, l_builder.getInt64Ty()), l_field.idx);
+            l_mask = l_builder.CreateOr(l_mask, l_bit);
+        }
+        l_builder.CreateStore(l_mask, l_mask_ptr);
+    }
     void M_force_seal() {
         m_is_sealed = true;
         M_build_sink_loads();
+        M_build_field_access();
         for (auto &kv : m_store_loads) {
             for (ValueInfo& l_load_value : kv.second) {
                 l_load_value.M_eval();
             }
         }
+        const std::optional<uint32_t> l_mask_idx = changed_fields_idx();
+        std::vector<changed_field_t> l_changed;
+        if (l_mask_idx) {
+            l_changed = M_load_changed_fields(*l_mask_idx);
+        }
         for (ValueInfo& v : m_sink_values) {
             v.M_eval();
         }
+        if (l_mask_idx) {
+            M_store_changed_fields(*l_mask_idx, l_changed);
+        }
     }
 public:
     const std::string& name() const {
@@ -787,6 +1237,14 @@ public:
         LLVM_BUILDER_ASSERT(not is_sealed());
         LLVM_BUILDER_ASSERT(not value.has_error());
         M_force_seal();
+        {
+            std::vector<ValueInfo> l_loads;
+            std::unordered_set<ValueInfo, ValueHash> l_visited;
+            M_collect_loads(value, l_loads, l_visited);
+            FieldAccess l_access;
+            M_add_loads_access(l_loads, l_access);
+            m_fn.M_merge_field_access(l_access);
+        }
         m_cursor_impl.builder().CreateCondBr(value.M_eval(),
                                   then_dst.native_handle(),
                                   else_dst.native_handle());
@@ -1223,6 +1681,30 @@ void FunctionContext::section_break(const std::string &new_section_name) {
     l_section.enter();
 }
 
+void FunctionContext::do_while(const std::string& name, const std::function<ValueInfo()>& body) {
+    CODEGEN_FN
+    if (name.empty()) {
+        CODEGEN_PUSH_ERROR(CODE_SECTION, "Can't make loop with empty name");
+        return;
+    }
+    if (not body) {
+        CODEGEN_PUSH_ERROR(CODE_SECTION, "Loop body not correctly specified:" << name);
+        return;
+    }
+    CodeSection l_body = function().mk_section(name);
+    CodeSection l_post = function().mk_section(LLVM_BUILDER_CONCAT << name << ".post");
+    function().current_section().jump_to_section(l_body);
+    l_body.enter();
+    const ValueInfo l_cond = body();
+    if (l_cond.has_error() or not l_cond.type().is_boolean()) {
+        CODEGEN_PUSH_ERROR(CODE_SECTION, "Loop can only repeat over boolean type value:" << name);
+        return;
+    }
+    // body may have branched, back edge leaves from the section it ended in
+    function().current_section().conditional_jump(l_cond, l_body, l_post);
+    l_post.enter();
+}
+
 //
 // CodeSectionImpl
 //
@@ -1271,6 +1753,7 @@ FunctionImpl::FunctionImpl(const std::string& fn_name, bool is_external, c_const
         return;
     }
     if (not is_external) {
+        m_impl->add_subprogram();
         m_impl->mk_section("fn_begin_section", Function{*this}).enter();
         LLVM_BUILDER_ASSERT(Module::Context::has_value())
         Module::Context::value().register_symbol(m_impl->link_symbol());
@@ -3,17 +3,36 @@
 //
 
 #include "util/debug.h"
+#include "util/histogram_recorder.h"
 #include "llvm_builder/jit.h"
 #include "llvm_builder/module.h"
 #include "llvm/context_impl.h"
+#include "llvm/debug_info.h"
+#include "llvm/disassembler.h"
 #include "util/string_util.h"
 #include "ext_include.h"
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
 
 LLVM_BUILDER_NS_BEGIN
 
+namespace {
+
+// NOTE{vibhanshu}: newer llvm returns std::optional from getLineInfoForAddress()
+const llvm::DILineInfo* line_info_ptr(const llvm::DILineInfo& info) {
+    return &info;
+}
+
+const llvm::DILineInfo* line_info_ptr(const std::optional<llvm::DILineInfo>& info) {
+    return info ? &*info : nullptr;
+}
+
+} // namespace
+
 //
 // JustInTimeRunner::Impl
 //
@@ -31,7 +50,15 @@ class JustInTimeRunner::Impl {
     std::unique_ptr<llvm::CGSCCAnalysisManager> m_cgam;
     std::unique_ptr<llvm::PassInstrumentationCallbacks> m_pic;
     std::unique_ptr<llvm::StandardInstrumentations> m_si;
+    mutable LatencyRecorder m_lookup_latency;
+    // relocatable objects as emitted by codegen, kept for disassembly
+    mutable std::mutex m_objects_mutex;
+    std::vector<std::unique_ptr<llvm::MemoryBuffer>> m_objects;
+    DebugInfoBuilder::annotation_map_t m_annotations;
     bool m_is_bind = false;
+    bool m_has_gdb_listener = false;
+    bool m_has_perf_listener = false;
+    bool m_keep_objects = false;
     static inline bool s_llvm_init = false;
 public:
     explicit Impl(JustInTimeRunner& parent) : m_parent{parent} {
@@ -117,6 +144,191 @@ public:
     bool is_init() const {
         return static_cast<bool>(m_handle);
     }
+    bool enable_gdb_listener(JustInTimeRunner& parent) {
+        CODEGEN_FN
+        LLVM_BUILDER_ASSERT(not parent.has_error());
+        if (m_has_gdb_listener) {
+            return true;
+        }
+        llvm::orc::ObjectLinkingLayer* l_layer = M_object_linking_layer(parent);
+        if (l_layer == nullptr) {
+            return false;
+        }
+        llvm::orc::ExecutionSession& l_session = m_handle->getExecutionSession();
+        // NOTE{vibhanshu}: registration fn is in-process, pass the address directly instead of
+        //                  depending on it being exported from the host executable
+        auto l_registrar = std::make_unique<llvm::orc::EPCDebugObjectRegistrar>(
+            l_session, llvm::orc::ExecutorAddr::fromPtr(&llvm_orc_registerJITLoaderGDBWrapper));
+        l_layer->addPlugin(std::make_unique<llvm::orc::DebugObjectManagerPlugin>(
+            l_session, std::move(l_registrar), false, true));
+        m_has_gdb_listener = true;
+        return true;
+    }
+    bool enable_perf_listener(JustInTimeRunner& parent) {
+        CODEGEN_FN
+        LLVM_BUILDER_ASSERT(not parent.has_error());
+        if (m_has_perf_listener) {
+            return true;
+        }
+        llvm::orc::ObjectLinkingLayer* l_layer = M_object_linking_layer(parent);
+        if (l_layer == nullptr) {
+            return false;
+        }
+        auto l_debug_preserve = llvm::orc::DebugInfoPreservationPlugin::Create();
+        if (not l_debug_preserve) {
+            CODEGEN_PUSH_ERROR(JIT, "Failed to create debug info preservation plugin: " << llvm::toString(l_debug_preserve.takeError()));
+            parent.M_mark_error();
+            return false;
+        }
+        l_layer->addPlugin(std::move(*l_debug_preserve));
+        llvm::orc::ExecutorProcessControl& l_epc = m_handle->getExecutionSession().getExecutorProcessControl();
+        l_layer->addPlugin(std::make_unique<llvm::orc::PerfSupportPlugin>(
+            l_epc,
+            llvm::orc::ExecutorAddr::fromPtr(&llvm_orc_registerJITLoaderPerfStart),
+            llvm::orc::ExecutorAddr::fromPtr(&llvm_orc_registerJITLoaderPerfEnd),
+            llvm::orc::ExecutorAddr::fromPtr(&llvm_orc_registerJITLoaderPerfImpl),
+            true, true));
+        m_has_perf_listener = true;
+        return true;
+    }
+    bool enable_disassembly(JustInTimeRunner& parent) {
+        CODEGEN_FN
+        LLVM_BUILDER_ASSERT(not parent.has_error());
+        if (m_keep_objects) {
+            return true;
+        }
+        if (not is_init()) {
+            CODEGEN_PUSH_ERROR(JIT, "JIT not yet init");
+            parent.M_mark_error();
+            return false;
+        }
+        if (is_bind() or not m_namespace_seq.empty()) {
+            CODEGEN_PUSH_ERROR(JIT, "disassembly must be enabled before any module is added");
+            parent.M_mark_error();
+            return false;
+        }
+        // NOTE{vibhanshu}: transform runs before linking, symbol table and DWARF of the
+        //                  copy are used to locate functions in the linked in-memory code
+        m_handle->getObjTransformLayer().setTransform(
+            [this] (std::unique_ptr<llvm::MemoryBuffer> obj) -> llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> {
+                std::lock_guard<std::mutex> l_lock{m_objects_mutex};
+                m_objects.emplace_back(llvm::MemoryBuffer::getMemBufferCopy(obj->getBuffer(), obj->getBufferIdentifier()));
+                return std::move(obj);
+            });
+        m_keep_objects = true;
+        return true;
+    }
+    analysis::Disassembly disassemble(const JustInTimeRunner& parent, const std::string& symbol) const {
+        CODEGEN_FN
+        if (not m_keep_objects) {
+            CODEGEN_PUSH_ERROR(JIT, "disassembly not enabled, call enable_disassembly() before add_module():" << symbol);
+            return analysis::Disassembly{};
+        }
+        const uint64_t l_address = M_get_symbol_address(parent, symbol);
+        if (l_address == 0) {
+            return analysis::Disassembly{};
+        }
+        HostDisassembler& l_disassembler = HostDisassembler::thread_instance();
+        if (not l_disassembler.is_valid()) {
+            CODEGEN_PUSH_ERROR(JIT, "host disassembler not available: " << l_disassembler.error());
+            return analysis::Disassembly{};
+        }
+        std::lock_guard<std::mutex> l_lock{m_objects_mutex};
+        for (const std::unique_ptr<llvm::MemoryBuffer>& l_buffer : m_objects) {
+            llvm::Expected<std::unique_ptr<llvm::object::ObjectFile>> l_obj =
+                llvm::object::ObjectFile::createObjectFile(l_buffer->getMemBufferRef());
+            if (not l_obj) {
+                llvm::consumeError(l_obj.takeError());
+                continue;
+            }
+            for (const auto& [l_sym, l_size] : llvm::object::computeSymbolSizes(**l_obj)) {
+                llvm::Expected<llvm::StringRef> l_name = l_sym.getName();
+                if (not l_name) {
+                    llvm::consumeError(l_name.takeError());
+                    continue;
+                }
+                if (*l_name != symbol) {
+                    continue;
+                }
+                llvm::Expected<llvm::object::section_iterator> l_section = l_sym.getSection();
+                llvm::Expected<uint64_t> l_value = l_sym.getValue();
+                if (not l_section or not l_value) {
+                    llvm::consumeError(l_section.takeError());
+                    llvm::consumeError(l_value.takeError());
+                    continue;
+                }
+                if (*l_section == (*l_obj)->section_end()) {
+                    continue;
+                }
+                return M_disassemble(l_disassembler, symbol, l_address, l_size,
+                                     **l_obj, (*l_section)->getIndex(), *l_value);
+            }
+        }
+        CODEGEN_PUSH_ERROR(JIT, "machine code not found for symbol:" << symbol);
+        return analysis::Disassembly{};
+    }
+    // `obj_address` is the address of the function in the relocatable object,
+    // the one DWARF line table refers to
+    analysis::Disassembly M_disassemble(HostDisassembler& disassembler,
+                                        const std::string& symbol,
+                                        uint64_t address,
+                                        uint64_t code_size,
+                                        const llvm::object::ObjectFile& obj,
+                                        uint64_t section_index,
+                                        uint64_t obj_address) const {
+        std::unique_ptr<llvm::DWARFContext> l_dwarf = llvm::DWARFContext::create(obj);
+        const llvm::DILineInfoSpecifier l_spec{llvm::DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath,
+                                               llvm::DILineInfoSpecifier::FunctionNameKind::LinkageName};
+        const uint8_t* l_code = reinterpret_cast<const uint8_t*>(address);
+        analysis::Disassembly l_res{symbol, address, code_size};
+        uint64_t l_offset = 0;
+        while (l_offset < code_size) {
+            std::string l_text;
+            uint32_t l_inst_size = disassembler.decode(llvm::ArrayRef<uint8_t>{l_code + l_offset, code_size - l_offset},
+                                                       address + l_offset, l_text);
+            if (l_inst_size == 0) {
+                // padding or data within code, skip a byte at a time
+                l_text = "<unknown>";
+                l_inst_size = 1;
+            }
+            SourceLoc l_line;
+            analysis::ValueAnnotation l_value;
+            const auto l_info = l_dwarf->getLineInfoForAddress({obj_address + l_offset, section_index}, l_spec);
+            if (const llvm::DILineInfo* l_line_info = line_info_ptr(l_info); l_line_info != nullptr and l_line_info->Line != 0) {
+                l_line = SourceLoc{l_line_info->FileName, l_line_info->Line};
+                // for inlined code the line info is of the innermost frame, whose
+                // discriminator indexes the annotations of the inlined function, not of `symbol`
+                const bool l_has_fn_name = l_line_info->FunctionName != llvm::DILineInfo::BadString;
+                const std::string& l_fn_name = l_has_fn_name ? l_line_info->FunctionName : symbol;
+                if (const analysis::ValueAnnotation* l_annotation =
+                        DebugInfoBuilder::find_annotation(m_annotations, l_fn_name, l_line_info->Discriminator)) {
+                    l_value = *l_annotation;
+                }
+            }
+            l_res.add_inst(analysis::AsmInst{address + l_offset, static_cast<uint32_t>(l_offset), l_inst_size,
+                                             std::move(l_text), l_line, l_value});
+            l_offset += l_inst_size;
+        }
+        return l_res;
+    }
+    llvm::orc::ObjectLinkingLayer* M_object_linking_layer(JustInTimeRunner& parent) {
+        if (not is_init()) {
+            CODEGEN_PUSH_ERROR(JIT, "JIT not yet init");
+            parent.M_mark_error();
+            return nullptr;
+        }
+        if (is_bind()) {
+            CODEGEN_PUSH_ERROR(JIT, "JIT already bound, listener can't be added");
+            parent.M_mark_error();
+            return nullptr;
+        }
+        auto* l_layer = llvm::dyn_cast<llvm::orc::ObjectLinkingLayer>(&m_handle->getObjLinkingLayer());
+        if (l_layer == nullptr) {
+            CODEGEN_PUSH_ERROR(JIT, "debug listeners are supported only with JITLink object linking layer");
+            parent.M_mark_error();
+        }
+        return l_layer;
+    }
     bool is_bind() const {
         return m_is_bind;
     }
@@ -187,20 +399,47 @@ public:
             parent.M_mark_error();
             return;
         }
-        cursor.for_each_module([this, &parent] (Module module) {
+        std::vector<std::string> l_event_namespaces;
+        cursor.for_each_module([this, &parent, &l_event_namespaces] (Module module) {
             CODEGEN_FN
             LLVM_BUILDER_ASSERT(module.is_init());
-            M_add_module(parent, module);
+            M_add_module(parent, module, l_event_namespaces);
         });
+        // triggers are declared on the cursor and fire its event functions, so they are
+        // registered in every namespace those were added to
+        if (l_event_namespaces.empty()) {
+            l_event_namespaces.emplace_back("");
+        }
+        for (const std::string& l_namespace_name : l_event_namespaces) {
+            auto it = m_namespace_map.try_emplace(l_namespace_name, m_parent, l_namespace_name, runtime::Namespace::construct_t{});
+            if (it.second) {
+                m_namespace_seq.emplace_back(l_namespace_name);
+            }
+            for (const Event& l_event : cursor.events()) {
+                if (not l_event.fields().empty()) {
+                    it.first->second.add_trigger(l_event.name(), l_event.fields());
+                }
+            }
+        }
         cursor.cleanup();
     }
-    void M_add_module(JustInTimeRunner& parent, Module& module) {
+    // `event_namespaces` collects namespaces event functions of `module` are added to
+    void M_add_module(JustInTimeRunner& parent, Module& module, std::vector<std::string>& event_namespaces) {
         CODEGEN_FN
         if (module.has_error() or not module.is_init()) {
             CODEGEN_PUSH_ERROR(JIT, "Invalid module can't be added");
             parent.M_mark_error();
             return;
         }
+        if (m_keep_objects) {
+            // copied now, cursor cleanup after add_module() releases the debug info builder.
+            // keyed by the IR symbol name, the linkage name DWARF reports for each frame
+            if (const DebugInfoBuilder* l_debug_info = module.debug_info_builder()) {
+                for (const auto& [l_fn_name, l_annotations] : l_debug_info->annotations()) {
+                    m_annotations[l_fn_name] = l_annotations;
+                }
+            }
+        }
         auto tsm = module.take_thread_safe_module();
         if (not tsm) {
             CODEGEN_PUSH_ERROR(JIT, "Failed to take thread safe module:" << module.name());
@@ -252,7 +491,15 @@ public:
                 const TypeInfo& l_struct_type = module.struct_type(l_sym_name.short_name());
                 l_namespace.add_struct(l_struct_type);
             } else if (l_symbol.is_function()) {
-                l_namespace.add_event(l_sym_name.short_name());
+                const Function l_fn = module.get_function(l_sym_name.short_name());
+                FieldAccess l_field_access = l_fn.field_access();
+                if (l_fn.has_error()) {
+                    l_field_access.mark_opaque();
+                }
+                l_namespace.add_event(l_sym_name.short_name(), l_field_access);
+                if (std::find(event_namespaces.begin(), event_namespaces.end(), l_namespace_name) == event_namespaces.end()) {
+                    event_namespaces.emplace_back(l_namespace_name);
+                }
             } else {
                 // TODO{vibhanshu}: decide what to do with such symbols
             }
@@ -284,8 +531,9 @@ public:
             object.M_mark_error();
             return 0;
         }
-        // TODO{vibhanshu}: collect lookup metric
+        const uint64_t l_start = Debug::rdtsc();
         llvm::Expected<llvm::orc::ExecutorAddr> lookup_result = m_handle->lookup(symbol);
+        m_lookup_latency.record(Debug::rdtsc() - l_start);
 
         if (not lookup_result) {
             llvm::Error err = lookup_result.takeError();
@@ -306,6 +554,9 @@ public:
         }
         return r;
     }
+    LatencyHistogram lookup_latency() const {
+        return m_lookup_latency.snapshot();
+    }
     runtime::Namespace get_namespace(const std::string &name) const {
         CODEGEN_FN
         if (is_bind()) {
@@ -365,6 +616,24 @@ bool JustInTimeRunner::contains_symbol_definition(const std::string& name) const
     return m_impl->contains_symbol_definition(name);
 }
 
+bool JustInTimeRunner::enable_gdb_listener() {
+    CODEGEN_FN
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->enable_gdb_listener(*this);
+}
+
+bool JustInTimeRunner::enable_perf_listener() {
+    CODEGEN_FN
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->enable_perf_listener(*this);
+}
+
 bool JustInTimeRunner::process_module_fn(Function& fn) {
     CODEGEN_FN
     if (has_error() or fn.has_error()) {
@@ -403,6 +672,32 @@ auto JustInTimeRunner::get_fn(const std::string& symbol) const -> fn_t* {
     }
 }
 
+LatencyHistogram JustInTimeRunner::lookup_latency() const {
+    if (has_error()) {
+        return LatencyHistogram{};
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->lookup_latency();
+}
+
+bool JustInTimeRunner::enable_disassembly() {
+    CODEGEN_FN
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->enable_disassembly(*this);
+}
+
+analysis::Disassembly JustInTimeRunner::disassemble(const std::string& symbol) const {
+    CODEGEN_FN
+    if (has_error()) {
+        return analysis::Disassembly{};
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->disassemble(*this, symbol);
+}
+
 runtime::Namespace JustInTimeRunner::get_namespace(const std::string &name) const {
     CODEGEN_FN
     if (has_error()) {
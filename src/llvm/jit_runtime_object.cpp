@@ -3,21 +3,364 @@
 //
 
 #include "util/debug.h"
+#include "util/histogram_recorder.h"
+#include "util/perf_counter_group.h"
+#include "util/mapped_file.h"
+#include "util/shared_memory.h"
 #include "meta/noncopyable.h"
 #include "llvm_builder/jit.h"
 #include "llvm_builder/module.h"
 #include "ds/fixed_string.h"
+#include "llvm/checkpoint.h"
 #include "llvm/context_impl.h"
+#include "llvm/kernel.h"
 #include "util/string_util.h"
 #include "ext_include.h"
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 
 LLVM_BUILDER_NS_BEGIN
 
 namespace runtime {
 
+//
+// SharedRegion::Impl
+//
+class SharedRegion::Impl : meta::noncopyable {
+    using backing_t = SharedMemory::backing_t;
+    using registry_t = std::unordered_map<std::string, std::weak_ptr<Impl>>;
+public:
+    enum : uint32_t {
+        c_kind_object = 1,
+        c_kind_array = 2,
+    };
+private:
+    SharedMemory m_memory;
+public:
+    explicit Impl(backing_t backing, const std::string& name, uint64_t size)
+        : m_memory{backing, name, size} {
+    }
+    explicit Impl(backing_t backing, const std::string& name)
+        : m_memory{backing, name} {
+    }
+    ~Impl() = default;
+public:
+    bool is_valid() const {
+        return m_memory.is_valid();
+    }
+    const std::string& error() const {
+        return m_memory.error();
+    }
+    const std::string& name() const {
+        return m_memory.name();
+    }
+    void* ref() const {
+        return m_memory.base();
+    }
+    uint64_t size_in_bytes() const {
+        return m_memory.size();
+    }
+    uint64_t used_bytes() const {
+        return m_memory.used();
+    }
+    void* allocate(const std::string& name, const std::string& type_name, uint64_t size, uint32_t kind, uint32_t type, uint32_t num_elements) {
+        return m_memory.allocate(name, type_name, size, kind, type, num_elements);
+    }
+    const SharedMemory::Entry* find(const std::string& name) const {
+        return m_memory.find(name);
+    }
+    void* at(uint64_t offset) const {
+        return m_memory.at(offset);
+    }
+    bool is_at_creator_base() const {
+        return m_memory.is_at_creator_base();
+    }
+    bool contains(const void* ptr, uint64_t size) const {
+        return m_memory.contains(ptr, size);
+    }
+    bool add_link(const void* field, const void* target) {
+        return m_memory.add_link(field, target);
+    }
+    bool has_links(const SharedMemory::Entry& entry) const {
+        return m_memory.has_links(entry.m_offset, entry.m_size);
+    }
+    bool unlink() {
+        return m_memory.unlink();
+    }
+public:
+    // a region is mapped once per process, so every handle sees its allocations at the same address
+    static SharedRegion open(backing_t backing, const std::string& name, const uint64_t* size) {
+        static std::mutex s_mutex;
+        static registry_t s_registry;
+        const std::string l_key = LLVM_BUILDER_CONCAT << (backing == backing_t::shm ? "shm:" : "file:") << name;
+        std::lock_guard<std::mutex> l_lock{s_mutex};
+        if (size == nullptr) {
+            auto it = s_registry.find(l_key);
+            if (it != s_registry.end()) {
+                if (std::shared_ptr<Impl> l_existing = it->second.lock()) {
+                    return SharedRegion{std::move(l_existing), construct_t{}};
+                }
+            }
+        }
+        std::shared_ptr<Impl> l_impl = size == nullptr ? std::make_shared<Impl>(backing, name)
+                                                       : std::make_shared<Impl>(backing, name, *size);
+        if (not l_impl->is_valid()) {
+            return SharedRegion::null(l_impl->error());
+        }
+        s_registry[l_key] = l_impl;
+        return SharedRegion{std::move(l_impl), construct_t{}};
+    }
+};
+
+//
+// SharedRegion
+//
+SharedRegion::SharedRegion() : BaseT{State::ERROR} {
+}
+
+SharedRegion::SharedRegion(std::shared_ptr<Impl>&& impl, construct_t)
+    : BaseT{State::VALID}, m_impl{std::move(impl)} {
+    LLVM_BUILDER_ASSERT(m_impl);
+}
+
+const std::string& SharedRegion::name() const {
+    if (has_error()) {
+        return StringManager::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->name();
+}
+
+void* SharedRegion::ref() const {
+    if (has_error()) {
+        return nullptr;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->ref();
+}
+
+uint64_t SharedRegion::size_in_bytes() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->size_in_bytes();
+}
+
+uint64_t SharedRegion::used_bytes() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->used_bytes();
+}
+
+bool SharedRegion::contains(const std::string& name) const {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->find(name) != nullptr;
+}
+
+bool SharedRegion::unlink() const {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->unlink();
+}
+
+bool SharedRegion::operator == (const SharedRegion& rhs) const {
+    if (has_error() and rhs.has_error()) {
+        return true;
+    }
+    return m_impl.get() == rhs.m_impl.get();
+}
+
+SharedRegion SharedRegion::null(const std::string& log) {
+    static SharedRegion s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    SharedRegion result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+SharedRegion SharedRegion::create_shm(const std::string& name, uint64_t size) {
+    if (name.empty()) {
+        return SharedRegion::null("shared region name can't be empty");
+    }
+    return Impl::open(SharedMemory::backing_t::shm, name, &size);
+}
+
+SharedRegion SharedRegion::open_shm(const std::string& name) {
+    if (name.empty()) {
+        return SharedRegion::null("shared region name can't be empty");
+    }
+    return Impl::open(SharedMemory::backing_t::shm, name, nullptr);
+}
+
+SharedRegion SharedRegion::create_file(const std::string& path, uint64_t size) {
+    if (path.empty()) {
+        return SharedRegion::null("shared region path can't be empty");
+    }
+    return Impl::open(SharedMemory::backing_t::file, path, &size);
+}
+
+SharedRegion SharedRegion::open_file(const std::string& path) {
+    if (path.empty()) {
+        return SharedRegion::null("shared region path can't be empty");
+    }
+    return Impl::open(SharedMemory::backing_t::file, path, nullptr);
+}
+
+namespace {
+
+// keeps an adopted buffer alive, without a deleter it is left to the caller
+std::shared_ptr<void> mk_external_owner(void* ptr, const buffer_deleter_t& deleter) {
+    if (deleter) {
+        return std::shared_ptr<void>{ptr, deleter};
+    }
+    return std::shared_ptr<void>{ptr, [](void*) {}};
+}
+
+} // namespace
+
+//
+// SnapshotCapture
+//
+// contents of an object/array at snapshot time. A double buffered object saves
+// it when the first event after the snapshot publishes into it, readers tell
+// by version. Objects/arrays written in place are saved by the first event able
+// to reach them, which claims m_state before it writes anything
+struct SnapshotCapture : meta::noncopyable {
+    enum : uint8_t {
+        c_pending = 0,
+        c_capturing = 1,
+        c_captured = 2,
+    };
+    const uint64_t m_version;
+    std::atomic<void*> m_data{nullptr};
+    std::atomic<uint8_t> m_state{c_pending};
+public:
+    explicit SnapshotCapture(uint64_t version)
+        : m_version{version} {
+    }
+    ~SnapshotCapture() {
+        std::free(m_data.load(std::memory_order_relaxed));
+    }
+public:
+    // saves `size` bytes at `src` unless a writer got here first
+    void capture(const void* src, uint32_t size) {
+        uint8_t l_state = c_pending;
+        if (not m_state.compare_exchange_strong(l_state, c_capturing, std::memory_order_acq_rel)) {
+            return;
+        }
+        // orders the claim before the writes of the event that follows
+        std::atomic_thread_fence(std::memory_order_release);
+        void* l_data = std::malloc(size);
+        std::memcpy(l_data, src, size);
+        m_data.store(l_data, std::memory_order_release);
+        m_state.store(c_captured, std::memory_order_release);
+    }
+    // copy of an in place buffer as of the snapshot, `live` is used while no
+    // event claimed the capture. Same validation as a seqlock reader: the writer
+    // claims m_state and fences before its event writes `live`
+    void read_in_place(const void* live, void* dst, uint32_t size) const {
+        if (m_state.load(std::memory_order_acquire) == c_pending) {
+            std::memcpy(dst, live, size);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_state.load(std::memory_order_relaxed) == c_pending) {
+                return;
+            }
+        }
+        while (m_state.load(std::memory_order_acquire) != c_captured) {
+            Debug::cpu_relax();
+        }
+        std::memcpy(dst, m_data.load(std::memory_order_acquire), size);
+    }
+};
+
+namespace {
+
+//
+// InPlaceCaptures
+//
+// pending captures of snapshotted objects/arrays which events write in place,
+// keyed by buffer. Events check is_empty() with a single load and only walk
+// their context graph while a snapshot is waiting
+class InPlaceCaptures : meta::noncopyable {
+    struct Entry {
+        uint32_t m_size;
+        std::weak_ptr<SnapshotCapture> m_capture;
+    };
+private:
+    std::mutex m_mutex;
+    std::unordered_map<const void*, std::vector<Entry>> m_entries;
+    std::atomic<uint64_t> m_num_entries{0};
+public:
+    static InPlaceCaptures& instance() {
+        static InPlaceCaptures s_instance;
+        return s_instance;
+    }
+    bool is_empty() const {
+        return m_num_entries.load(std::memory_order_acquire) == 0;
+    }
+    void add(const void* buf, uint32_t size, const std::shared_ptr<SnapshotCapture>& capture) {
+        std::lock_guard<std::mutex> l_lock{m_mutex};
+        m_entries[buf].emplace_back(Entry{size, capture});
+        m_num_entries.fetch_add(1, std::memory_order_release);
+    }
+    // drops `capture` once its snapshot no longer needs it
+    void remove(const void* buf, const SnapshotCapture* capture) {
+        std::lock_guard<std::mutex> l_lock{m_mutex};
+        auto l_it = m_entries.find(buf);
+        if (l_it == m_entries.end()) {
+            return;
+        }
+        std::vector<Entry>& l_list = l_it->second;
+        const uint64_t l_size = l_list.size();
+        std::erase_if(l_list, [capture](const Entry& e) {
+            const std::shared_ptr<SnapshotCapture> l_capture = e.m_capture.lock();
+            return not l_capture or l_capture.get() == capture;
+        });
+        m_num_entries.fetch_sub(l_size - l_list.size(), std::memory_order_release);
+        if (l_list.empty()) {
+            m_entries.erase(l_it);
+        }
+    }
+    // saves `buf` into every capture waiting on it, called before an event may write it
+    void capture(const void* buf) {
+        std::lock_guard<std::mutex> l_lock{m_mutex};
+        auto l_it = m_entries.find(buf);
+        if (l_it == m_entries.end()) {
+            return;
+        }
+        for (const Entry& l_entry : l_it->second) {
+            if (std::shared_ptr<SnapshotCapture> l_capture = l_entry.m_capture.lock()) {
+                l_capture->capture(buf, l_entry.m_size);
+            }
+        }
+        m_num_entries.fetch_sub(l_it->second.size(), std::memory_order_release);
+        m_entries.erase(l_it);
+    }
+};
+
+} // namespace
+
 //
 // Object::Impl
 //
@@ -34,9 +377,21 @@ private:
     const Struct& m_parent;
     void* m_buf = nullptr;
     uint32_t m_size = 0;
+    // set if m_buf is not owned, keeps the shared region/checkpoint mapping it lives in alive
+    std::shared_ptr<void> m_owner;
+    // set if m_buf is allocated in a shared region, kept alive by m_owner
+    SharedRegion::Impl* m_region = nullptr;
     std::unordered_map<std::string, ObjectInfo> m_linked_objects;
     std::unordered_map<std::string, ArrayInfo> m_linked_arrays;
     bool m_is_frozen = false;
+    // double buffered mode, events run on m_shadow which is published into m_buf
+    // under a seqlock, odd m_version means a publish is in progress
+    void* m_shadow = nullptr;
+    std::atomic<uint64_t> m_version{0};
+    // snapshots still waiting for the next publish
+    std::mutex m_snapshot_mutex;
+    std::vector<std::weak_ptr<SnapshotCapture>> m_snapshots;
+    std::atomic<uint32_t> m_num_snapshots{0};
 public:
     explicit Impl(const Struct &parent)
         : m_parent{parent} {
@@ -46,15 +401,110 @@ public:
         std::memset(m_buf, 0, size);
         m_size = size;
     }
+    explicit Impl(const Struct &parent, const std::shared_ptr<void>& owner, void* buf, bool is_frozen)
+        : m_parent{parent}
+        , m_buf{buf}
+        , m_size{static_cast<uint32_t>(parent.size_in_bytes())}
+        , m_owner{owner}
+        , m_is_frozen{is_frozen} {
+        LLVM_BUILDER_ASSERT(not m_parent.has_error());
+        LLVM_BUILDER_ASSERT(m_owner);
+        LLVM_BUILDER_ASSERT(m_buf != nullptr);
+    }
     ~Impl() {
         LLVM_BUILDER_ASSERT(m_buf != nullptr);
-        std::free(m_buf);
+        if (not m_owner) {
+            std::free(m_buf);
+        }
         m_buf = nullptr;
+        std::free(m_shadow);
+        m_shadow = nullptr;
     }
 public:
     bool is_frozen() const {
         return m_is_frozen;
     }
+    bool is_double_buffered() const {
+        return m_shadow != nullptr;
+    }
+    void enable_double_buffer() {
+        LLVM_BUILDER_ASSERT(not is_double_buffered());
+        m_shadow = std::malloc(m_size);
+    }
+    uint64_t version() const {
+        return m_version.load(std::memory_order_acquire);
+    }
+    // buffer an event should write into
+    void* begin_event() {
+        if (m_shadow == nullptr) {
+            return m_buf;
+        }
+        // host may have written m_buf through set() or a field view since last event
+        std::memcpy(m_shadow, m_buf, m_size);
+        return m_shadow;
+    }
+    void end_event() {
+        if (m_shadow == nullptr) {
+            return;
+        }
+        if (m_num_snapshots.load(std::memory_order_acquire) != 0) {
+            M_capture_snapshots();
+        }
+        // single writer, plain load is enough
+        const uint64_t l_version = m_version.load(std::memory_order_relaxed);
+        m_version.store(l_version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(m_buf, m_shadow, m_size);
+        m_version.store(l_version + 2, std::memory_order_release);
+    }
+    uint32_t size() const {
+        return m_size;
+    }
+    // `capture` is filled by next publish
+    void add_snapshot(const std::shared_ptr<SnapshotCapture>& capture) {
+        LLVM_BUILDER_ASSERT(is_double_buffered());
+        std::lock_guard<std::mutex> l_lock{m_snapshot_mutex};
+        m_snapshots.emplace_back(capture);
+        m_num_snapshots.store(static_cast<uint32_t>(m_snapshots.size()), std::memory_order_release);
+    }
+    // published buffer as of `capture`
+    // NOTE{vibhanshu}: publish saves the capture before bumping version, so once
+    //                  version moved past snapshot the capture is there
+    void read_snapshot(const SnapshotCapture& capture, void* dst) const {
+        if (m_version.load(std::memory_order_acquire) == capture.m_version) {
+            std::memcpy(dst, m_buf, m_size);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_version.load(std::memory_order_relaxed) == capture.m_version) {
+                return;
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        const void* l_data = capture.m_data.load(std::memory_order_acquire);
+        LLVM_BUILDER_ASSERT(l_data != nullptr);
+        std::memcpy(dst, l_data, m_size);
+    }
+    // retries while a publish overlaps the copy
+    void read_consistent(Impl& dst) const {
+        LLVM_BUILDER_ASSERT(is_double_buffered());
+        LLVM_BUILDER_ASSERT(dst.m_size == m_size);
+        while (true) {
+            const uint64_t l_version = m_version.load(std::memory_order_acquire);
+            if ((l_version & 1) == 0) {
+                std::memcpy(dst.m_buf, m_buf, m_size);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_version.load(std::memory_order_relaxed) == l_version) {
+                    break;
+                }
+            }
+            Debug::cpu_relax();
+        }
+        // pointer fields of the copy refer to the same linked objects/arrays,
+        // links are fixed once frozen so they are safe to read here
+        if (not m_linked_objects.empty() or not m_linked_arrays.empty()) {
+            dst.m_linked_objects = m_linked_objects;
+            dst.m_linked_arrays = m_linked_arrays;
+        }
+    }
     bool freeze() {
         LLVM_BUILDER_ASSERT(not is_frozen());
         for (const std::string& fname : m_parent.field_names()) {
@@ -102,6 +552,22 @@ public:
         }
         return l_result;
     }
+    bool has_changed_fields() const {
+        const std::vector<std::string>& l_names = m_parent.field_names();
+        return std::find(l_names.begin(), l_names.end(), Cursor::c_changed_fields_name) != l_names.end();
+    }
+    std::vector<Field> changed_fields() const {
+        LLVM_BUILDER_ASSERT(has_changed_fields());
+        const uint64_t l_mask = *get_field_location<uint64_t>(m_parent[Cursor::c_changed_fields_name]);
+        std::vector<Field> l_result;
+        for (const std::string& fname : m_parent.field_names()) {
+            const Field l_field = m_parent[fname];
+            if (l_field.idx() < 64 and (l_mask >> l_field.idx()) & 1) {
+                l_result.emplace_back(l_field);
+            }
+        }
+        return l_result;
+    }
     bool is_instance_of(const Struct& o) const {
         LLVM_BUILDER_ASSERT(not o.has_error());
         return m_parent == o;
@@ -122,6 +588,15 @@ public:
         LLVM_BUILDER_ASSERT(l_field_ptr  != nullptr);
         return reinterpret_cast<T*>(l_field_ptr);
     }
+    void set_region(SharedRegion::Impl* region) {
+        LLVM_BUILDER_ASSERT(m_owner);
+        m_region = region;
+    }
+    // pointer stored in a shared region has to point into the same region,
+    // region records it as an offset
+    bool add_region_link(const void* field_addr, const void* target) {
+        return m_region == nullptr or m_region->add_link(field_addr, target);
+    }
     void add_object(const std::string& field_name, uint64_t field_addr, const Object& o) {
         LLVM_BUILDER_ASSERT(field_addr != 0);
         LLVM_BUILDER_ASSERT(not o.has_error());
@@ -156,6 +631,18 @@ private:
             return nullptr;
         }
     }
+    void M_capture_snapshots() {
+        std::lock_guard<std::mutex> l_lock{m_snapshot_mutex};
+        for (const std::weak_ptr<SnapshotCapture>& l_weak : m_snapshots) {
+            if (std::shared_ptr<SnapshotCapture> l_capture = l_weak.lock()) {
+                l_capture->capture(m_buf, m_size);
+            }
+        }
+        m_snapshots.clear();
+        m_num_snapshots.store(0, std::memory_order_relaxed);
+        // capture is visible to anyone who sees the version bump that follows
+        std::atomic_thread_fence(std::memory_order_release);
+    }
 };
 
 //
@@ -173,6 +660,15 @@ Object::Object(const Struct& parent)
     }
 }
 
+Object::Object(const Struct& parent, const std::shared_ptr<void>& owner, void* buf, bool is_frozen)
+    : BaseT{State::VALID} {
+    if (parent.has_error() or not owner) {
+        M_mark_error();
+    } else {
+        m_impl = std::make_shared<Impl>(parent, owner, buf, is_frozen);
+    }
+}
+
 Object::Object(const Object&) = default;
 
 Object::Object(Object&&) = default;
@@ -202,6 +698,68 @@ bool Object::freeze() {
     return m_impl->freeze();
 }
 
+bool Object::enable_double_buffer() {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->is_double_buffered()) {
+        return true;
+    }
+    if (m_impl->is_frozen()) {
+        // an event may already be running on it
+        M_mark_error("double buffer must be enabled before object is frozen");
+        return false;
+    }
+    m_impl->enable_double_buffer();
+    return true;
+}
+
+bool Object::is_double_buffered() const {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->is_double_buffered();
+}
+
+uint64_t Object::version() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->version();
+}
+
+bool Object::read_consistent(const Object& dst) const {
+    if (has_error() or dst.has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    LLVM_BUILDER_ASSERT(dst.m_impl);
+    if (not m_impl->is_double_buffered()) {
+        M_mark_error("consistent reads need a double buffered object");
+        return false;
+    }
+    if (dst.m_impl == m_impl or dst.is_frozen() or not dst.is_instance_of(struct_def())) {
+        M_mark_error("destination must be another unfrozen object of same struct");
+        return false;
+    }
+    m_impl->read_consistent(*dst.m_impl);
+    return true;
+}
+
+Snapshot Object::snapshot() const {
+    if (has_error()) {
+        return Snapshot::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->is_frozen()) {
+        return Snapshot::null("only a frozen object can be snapshot");
+    }
+    return Snapshot{*this};
+}
+
 auto Object::null_fields() const -> std::vector<Field> {
     if (has_error()) {
         return std::vector<Field>{};
@@ -210,6 +768,18 @@ auto Object::null_fields() const -> std::vector<Field> {
     return m_impl->null_fields();
 }
 
+auto Object::changed_fields() const -> std::vector<Field> {
+    if (has_error()) {
+        return std::vector<Field>{};
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->has_changed_fields()) {
+        M_mark_error("struct has no changed fields, see Cursor::enable_changed_fields()");
+        return std::vector<Field>{};
+    }
+    return m_impl->changed_fields();
+}
+
 bool Object::is_instance_of(const Struct &o) const {
     if (has_error() or o.has_error()) {
         return false;
@@ -270,6 +840,10 @@ void Object::set_object(const std::string& name, const Object& v) const {
     if (l_field.is_struct_pointer()) {
         uint64_t* l_ptr = m_impl->get_field_location<uint64_t>(l_field);
         LLVM_BUILDER_ASSERT(v.ref() != nullptr);
+        if (not m_impl->add_region_link(l_ptr, v.ref())) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "object in shared region can only link allocations of the same region:" << name);
+            return;
+        }
         *l_ptr = (uint64_t)v.ref();
         m_impl->add_object(name, (uint64_t)l_ptr, v);
     } else {
@@ -313,6 +887,10 @@ void Object::set_array(const std::string& name, const Array& v) const {
     if (l_field.is_array_pointer()) {
         uint64_t* l_ptr = m_impl->get_field_location<uint64_t>(l_field);
         LLVM_BUILDER_ASSERT(v.ref() != nullptr);
+        if (not m_impl->add_region_link(l_ptr, v.ref())) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "object in shared region can only link allocations of the same region:" << name);
+            return;
+        }
         *l_ptr = (uint64_t)v.ref();
         m_impl->add_array(name, (uint64_t)l_ptr, v);
     } else {
@@ -428,13 +1006,28 @@ Object Object::null(const std::string& log) {
 // Array::Impl
 //
 class Array::Impl : meta::noncopyable {
+public:
+    enum : uint32_t {
+        // above the 64 bytes arrow asks for, sizes are padded to it as arrow
+        // recommends and aligned_alloc() requires
+        c_alignment = 128,
+    };
+private:
     const uint32_t m_size = 0;
     const type_t m_element_type = type_t::unknown;
     const uint32_t m_element_size = 0;
     void* m_buf = nullptr;
+    // set if m_buf is not owned, keeps the shared region/checkpoint mapping it lives in alive
+    std::shared_ptr<void> m_owner;
     // TODO{vibhanshu}: v1 assuming, black-box pointers, add meta-info about types maybe ?
     Object* m_array_objects = nullptr;
     Array* m_array2_objects = nullptr;
+    // arrow validity bitmap, nullptr if every element is valid
+    uint8_t* m_validity = nullptr;
+    bool m_owns_validity = false;
+    // set for a list, m_buf is then the buffer of m_offsets
+    Array m_offsets;
+    Array m_values;
     bool m_is_frozen = false;
 public:
     explicit Impl(type_t element_type, uint32_t size)
@@ -443,20 +1036,33 @@ public:
         , m_element_size{M_element_size(m_element_type)} {
         LLVM_BUILDER_ASSERT(m_size > 0);
         LLVM_BUILDER_ASSERT(m_element_size != std::numeric_limits<uint32_t>::max())
-        m_buf = std::aligned_alloc(128, m_size * m_element_size);
-        std::memset(m_buf, 0, m_size * m_element_size);
-        if (is_pointer()) {
-            if (m_element_type == type_t::pointer_struct) {
-                m_array_objects = new Object[m_size];
-            } else {
-                LLVM_BUILDER_ASSERT(m_element_type == type_t::pointer_array);
-                m_array2_objects = new Array[m_size];
-            }
-        }
+        const uint64_t l_num_bytes = padded_size(uint64_t{m_size} * m_element_size);
+        m_buf = std::aligned_alloc(c_alignment, l_num_bytes);
+        std::memset(m_buf, 0, l_num_bytes);
+        M_init_pointer_elements();
+    }
+    explicit Impl(type_t element_type, uint32_t size, const std::shared_ptr<void>& owner, void* buf, bool is_frozen)
+        : m_size{size}
+        , m_element_type{element_type}
+        , m_element_size{M_element_size(m_element_type)}
+        , m_buf{buf}
+        , m_owner{owner}
+        , m_is_frozen{is_frozen} {
+        LLVM_BUILDER_ASSERT(m_size > 0);
+        LLVM_BUILDER_ASSERT(m_element_size != std::numeric_limits<uint32_t>::max())
+        LLVM_BUILDER_ASSERT(m_owner);
+        LLVM_BUILDER_ASSERT(m_buf != nullptr);
+        M_init_pointer_elements();
     }
     ~Impl() {
-        std::free(m_buf);
+        if (not m_owner) {
+            std::free(m_buf);
+        }
         m_buf = nullptr;
+        if (m_owns_validity) {
+            std::free(m_validity);
+        }
+        m_validity = nullptr;
         if (m_array_objects) {
             delete[] m_array_objects;
         }
@@ -532,10 +1138,76 @@ public:
         LLVM_BUILDER_ASSERT(i < m_size);
         return m_array2_objects[i];
     }
-    void log_values(std::ostream &os) const {
-#define LOG_CASE(type)  case type_t::type:  M_print_type<type##_t>(os); break;
-        switch(m_element_type) {
-            case type_t::boolean: M_print_type<bool>(os);     break;
+    bool has_validity() const {
+        return m_validity != nullptr;
+    }
+    void enable_validity() {
+        LLVM_BUILDER_ASSERT(not has_validity());
+        const uint64_t l_num_bytes = padded_size(validity_size());
+        m_validity = static_cast<uint8_t*>(std::aligned_alloc(c_alignment, l_num_bytes));
+        std::memset(m_validity, 0xff, l_num_bytes);
+        m_owns_validity = true;
+    }
+    // bitmap of an imported array, kept alive by m_owner
+    void set_external_validity(const uint8_t* validity) {
+        LLVM_BUILDER_ASSERT(not has_validity());
+        LLVM_BUILDER_ASSERT(m_owner);
+        m_validity = const_cast<uint8_t*>(validity);
+    }
+    uint8_t* validity() const {
+        return m_validity;
+    }
+    uint32_t validity_size() const {
+        return (m_size + 7) / 8;
+    }
+    bool is_null(uint32_t i) const {
+        LLVM_BUILDER_ASSERT(i < m_size);
+        return m_validity != nullptr and ((m_validity[i / 8] >> (i % 8)) & 1) == 0;
+    }
+    void set_null(uint32_t i, bool is_null) {
+        LLVM_BUILDER_ASSERT(has_validity());
+        LLVM_BUILDER_ASSERT(i < m_size);
+        const uint8_t l_bit = static_cast<uint8_t>(1u << (i % 8));
+        if (is_null) {
+            m_validity[i / 8] &= static_cast<uint8_t>(~l_bit);
+        } else {
+            m_validity[i / 8] |= l_bit;
+        }
+    }
+    uint32_t null_count() const {
+        if (m_validity == nullptr) {
+            return 0;
+        }
+        uint32_t l_num_valid = 0;
+        for (uint32_t i = 0; i != m_size / 8; ++i) {
+            l_num_valid += static_cast<uint32_t>(std::popcount(m_validity[i]));
+        }
+        if (m_size % 8 != 0) {
+            // bits past the last element are not defined
+            const uint32_t l_mask = (1u << (m_size % 8)) - 1;
+            l_num_valid += static_cast<uint32_t>(std::popcount(m_validity[m_size / 8] & l_mask));
+        }
+        return m_size - l_num_valid;
+    }
+    bool is_list() const {
+        return m_values.m_impl != nullptr;
+    }
+    void set_list(const Array& offsets, const Array& values) {
+        LLVM_BUILDER_ASSERT(m_element_type == type_t::int32);
+        LLVM_BUILDER_ASSERT(offsets.ref() == m_buf);
+        m_offsets = offsets;
+        m_values = values;
+    }
+    const Array& offsets() const {
+        return m_offsets;
+    }
+    const Array& values() const {
+        return m_values;
+    }
+    void log_values(std::ostream &os) const {
+#define LOG_CASE(type)  case type_t::type:  M_print_type<type##_t>(os); break;
+        switch(m_element_type) {
+            case type_t::boolean: M_print_type<bool>(os);     break;
             LOG_CASE(int8)
             LOG_CASE(int16)
             LOG_CASE(int32)
@@ -569,7 +1241,23 @@ public:
         }
 #undef LOG_CASE
     }
+    static uint32_t size_of(type_t type) {
+        return M_element_size(type);
+    }
+    static uint64_t padded_size(uint64_t num_bytes) {
+        return (num_bytes + c_alignment - 1) / c_alignment * c_alignment;
+    }
 private:
+    void M_init_pointer_elements() {
+        if (is_pointer()) {
+            if (m_element_type == type_t::pointer_struct) {
+                m_array_objects = new Object[m_size];
+            } else {
+                LLVM_BUILDER_ASSERT(m_element_type == type_t::pointer_array);
+                m_array2_objects = new Array[m_size];
+            }
+        }
+    }
     template <typename T>
     void M_print_type(std::ostream& os) const {
         const T* l_ref = reinterpret_cast<const T*>(ref());
@@ -619,6 +1307,15 @@ Array::Array(type_t element_type, uint32_t size)
     }
 }
 
+Array::Array(type_t element_type, uint32_t size, const std::shared_ptr<void>& owner, void* buf, bool is_frozen)
+    : BaseT{State::VALID} {
+    if (not owner) {
+        M_mark_error();
+    } else {
+        m_impl = std::make_shared<Impl>(element_type, size, owner, buf, is_frozen);
+    }
+}
+
 Array::Array(const Array&) = default;
 Array::Array(Array&&) = default;
 Array& Array::operator = (const Array&) = default;
@@ -693,7 +1390,7 @@ void* Array::ref() const {
     return m_impl->ref();
 }
 
-#define DEF_ARRAY_FN(type)                                                              \
+#define DEF_ARRAY_FN(type, enum_type)                                                   \
 template <>                                                                             \
 type##_t Array::get(uint32_t i) const {                                                 \
     if (has_error()) {                                                                  \
@@ -703,7 +1400,7 @@ type##_t Array::get(uint32_t i) const {
         M_mark_error(LLVM_BUILDER_CONCAT << "array index out of range:" << i);          \
         return std::numeric_limits<type##_t>::max();                                    \
     }                                                                                   \
-    if (element_type() == type_t::type) {                                               \
+    if (element_type() == type_t::enum_type) {                                          \
         const type##_t* l_arr = reinterpret_cast<const type##_t*>(ref());               \
         LLVM_BUILDER_ASSERT(l_arr != nullptr);                                          \
         return l_arr[i];                                                                \
@@ -721,7 +1418,7 @@ void Array::set(uint32_t i, type##_t v) const {
         M_mark_error(LLVM_BUILDER_CONCAT << "array index out of range:" << i);          \
         return;                                                                         \
     }                                                                                   \
-    if (element_type() == type_t::type) {                                               \
+    if (element_type() == type_t::enum_type) {                                          \
         type##_t* l_arr = reinterpret_cast<type##_t*>(ref());                           \
         LLVM_BUILDER_ASSERT(l_arr != nullptr);                                          \
         l_arr[i] = v;                                                                   \
@@ -732,15 +1429,17 @@ void Array::set(uint32_t i, type##_t v) const {
 }                                                                                       \
 /**/
 
-// DEF_ARRAY_FN(bool)
-DEF_ARRAY_FN(int8)
-DEF_ARRAY_FN(int16)
-DEF_ARRAY_FN(int32)
-DEF_ARRAY_FN(int64)
-DEF_ARRAY_FN(uint8)
-DEF_ARRAY_FN(uint16)
-DEF_ARRAY_FN(uint32)
-DEF_ARRAY_FN(uint64)
+DEF_ARRAY_FN(bool, boolean)
+DEF_ARRAY_FN(int8, int8)
+DEF_ARRAY_FN(int16, int16)
+DEF_ARRAY_FN(int32, int32)
+DEF_ARRAY_FN(int64, int64)
+DEF_ARRAY_FN(uint8, uint8)
+DEF_ARRAY_FN(uint16, uint16)
+DEF_ARRAY_FN(uint32, uint32)
+DEF_ARRAY_FN(uint64, uint64)
+DEF_ARRAY_FN(float32, float32)
+DEF_ARRAY_FN(float64, float64)
 
 #undef DEF_ARRAY_FN
 
@@ -828,6 +1527,134 @@ void Array::set_array(uint32_t i, const Array& v) const {
     }
 }
 
+bool Array::enable_validity() {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->has_validity()) {
+        return true;
+    }
+    if (is_frozen()) {
+        M_mark_error("array already frozen, can't add validity bitmap");
+        return false;
+    }
+    if (is_pointer()) {
+        M_mark_error("array of pointers can't have validity bitmap");
+        return false;
+    }
+    m_impl->enable_validity();
+    return true;
+}
+
+bool Array::has_validity() const {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->has_validity();
+}
+
+bool Array::is_null(uint32_t i) const {
+    if (has_error()) {
+        return false;
+    }
+    if (i >= num_elements()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "array index out of range:" << i);
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->is_null(i);
+}
+
+void Array::set_null(uint32_t i, bool is_null) const {
+    if (has_error()) {
+        return;
+    }
+    if (i >= num_elements()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "array index out of range:" << i);
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->has_validity()) {
+        M_mark_error("array has no validity bitmap, call enable_validity()");
+        return;
+    }
+    m_impl->set_null(i, is_null);
+}
+
+uint32_t Array::null_count() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->null_count();
+}
+
+Array Array::validity() const {
+    if (has_error()) {
+        return Array::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->has_validity()) {
+        return Array::null("array has no validity bitmap");
+    }
+    return Array{type_t::uint8, m_impl->validity_size(), m_impl, m_impl->validity(), true};
+}
+
+bool Array::is_list() const {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->is_list();
+}
+
+Array Array::offsets() const {
+    if (has_error()) {
+        return Array::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->is_list()) {
+        return Array::null("array is not a list");
+    }
+    return m_impl->offsets();
+}
+
+Array Array::values() const {
+    if (has_error()) {
+        return Array::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->is_list()) {
+        return Array::null("array is not a list");
+    }
+    return m_impl->values();
+}
+
+Array Array::slice(uint32_t begin, uint32_t length) const {
+    if (has_error()) {
+        return Array::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->is_scalar() or m_impl->is_list()) {
+        return Array::null("only arrays of scalars can be sliced");
+    }
+    if (length == 0 or static_cast<uint64_t>(begin) + length > m_impl->num_elements()) {
+        return Array::null(LLVM_BUILDER_CONCAT << "slice [" << begin << ", " << begin + length
+                           << ") out of array of size:" << m_impl->num_elements());
+    }
+    if (m_impl->has_validity() and begin % 8 != 0) {
+        return Array::null("slice of an array with validity bitmap should begin at a multiple of 8");
+    }
+    char* l_buf = static_cast<char*>(m_impl->ref()) + static_cast<uint64_t>(begin) * m_impl->element_size();
+    Array l_res{m_impl->element_type(), length, m_impl, l_buf, m_impl->is_frozen()};
+    if (m_impl->has_validity()) {
+        l_res.m_impl->set_external_validity(m_impl->validity() + begin / 8);
+    }
+    return l_res;
+}
+
 bool Array::operator == (const Array& rhs) const {
     if (has_error() and rhs.has_error()) {
         return true;
@@ -853,545 +1680,3710 @@ auto Array::from(type_t type, uint32_t size) -> Array {
     return Array{type, size};
 }
 
-//
-// Field::Impl
-//
-class Field::Impl : meta::noncopyable {
-    const Struct& m_parent;
-    const int32_t m_idx;
-    const int32_t m_offset;
-    const std::string m_name;
-    const type_t m_type = type_t::unknown;
-    Struct m_underlying_struct;
-public:
-    Impl(const Struct& parent,
-            int32_t idx, int32_t offset,
-            const std::string &name,
-            const TypeInfo& type)
-        : m_parent{parent}
-        , m_idx{idx}
-        , m_offset{offset}
-        , m_name{name}
-        , m_type{get_type(type)} {
-        LLVM_BUILDER_ASSERT(not m_parent.has_error())
-        LLVM_BUILDER_ASSERT(m_idx != std::numeric_limits<int32_t>::max())
-        LLVM_BUILDER_ASSERT(m_offset != std::numeric_limits<int32_t>::max())
-        LLVM_BUILDER_ASSERT(not m_name.empty());
-        if (is_struct_pointer()) {
-            LLVM_BUILDER_ASSERT(type.is_pointer());
-            LLVM_BUILDER_ASSERT(type.base_type().is_struct());
-            m_underlying_struct = Struct{type.base_type(), Struct::construct_t{}};
-        } else if (is_array_pointer()) {
-            // TODO{vibhanshu}: do`we need to go deep and extract more info about internals of array`
-        }
-    }
-    ~Impl() = default;
-public:
-    const Struct& struct_def() const {
-        return m_parent;
-    }
-    type_t type() const {
-        return m_type;
-    }
-    bool is_bool() const {
-        return m_type == type_t::boolean;
-    }
-    bool is_struct_pointer() const {
-        return m_type == type_t::pointer_struct;
-    }
-    bool is_array_pointer() const {
-        return m_type == type_t::pointer_array;
+auto Array::from(type_t type, uint32_t size, const SharedRegion& region, const std::string& name) -> Array {
+    if (region.has_error()) {
+        return Array::null();
     }
-    bool is_fn_pointer() const {
-        return m_type == type_t::pointer_fn;
+    if (type == type_t::unknown or type == type_t::pointer_fn) {
+        return Array::null("Can't create array of unknown type");
     }
-    bool is_pointer() const {
-        return is_struct_pointer() or is_array_pointer() or is_fn_pointer();
+    if (size == 0 or size == std::numeric_limits<uint32_t>::max()) {
+        return Array::null("Can't create array of invalid size");
     }
-    bool is_int8() const {
-        return m_type == type_t::int8;
+    LLVM_BUILDER_ASSERT(region.m_impl);
+    const uint64_t l_num_bytes = uint64_t{size} * Impl::size_of(type);
+    void* l_buf = region.m_impl->allocate(name, "", l_num_bytes, SharedRegion::Impl::c_kind_array, static_cast<uint32_t>(type), size);
+    if (l_buf == nullptr) {
+        return Array::null(LLVM_BUILDER_CONCAT << "can't allocate array in shared region:" << name);
     }
-    bool is_int16() const {
-        return m_type == type_t::int16;
+    return Array{type, size, region.m_impl, l_buf, false};
+}
+
+auto Array::find(const SharedRegion& region, const std::string& name) -> Array {
+    if (region.has_error()) {
+        return Array::null();
     }
-    bool is_int32() const {
-        return m_type == type_t::int32;
+    LLVM_BUILDER_ASSERT(region.m_impl);
+    const SharedMemory::Entry* l_entry = region.m_impl->find(name);
+    if (l_entry == nullptr) {
+        return Array::null(LLVM_BUILDER_CONCAT << "array not found in shared region:" << name);
     }
-    bool is_int64() const {
-        return m_type == type_t::int64;
+    if (l_entry->m_kind != SharedRegion::Impl::c_kind_array) {
+        return Array::null(LLVM_BUILDER_CONCAT << "not an array in shared region:" << name);
     }
-    bool is_uint8() const {
-        return m_type == type_t::uint8;
+    return Array{static_cast<type_t>(l_entry->m_type), l_entry->m_num_elements, region.m_impl, region.m_impl->at(l_entry->m_offset), true};
+}
+
+auto Array::wrap(type_t type, uint32_t size, void* buf, const buffer_deleter_t& deleter) -> Array {
+    if (size == 0) {
+        return Array::null("Can't define array of length 0");
     }
-    bool is_uint16() const {
-        return m_type == type_t::uint16;
+    if (buf == nullptr) {
+        return Array::null("can't wrap a null buffer");
     }
-    bool is_uint32() const {
-        return m_type == type_t::uint32;
+    const uint32_t l_element_size = Impl::size_of(type);
+    if (l_element_size == std::numeric_limits<uint32_t>::max()) {
+        return Array::null("Can't define array of invalid type");
     }
-    bool is_uint64() const {
-        return m_type == type_t::uint64;
+    // element sizes are powers of 2, so natural alignment of an element is its size
+    if (reinterpret_cast<uintptr_t>(buf) % l_element_size != 0) {
+        return Array::null(LLVM_BUILDER_CONCAT << "buffer is not aligned to element size:" << l_element_size);
     }
-    bool is_float32() const {
-        return m_type == type_t::float32;
+    return Array{type, size, mk_external_owner(buf, deleter), buf, false};
+}
+
+auto Array::from_list(const Array& offsets, const Array& values) -> Array {
+    if (offsets.has_error() or values.has_error()) {
+        return Array::null();
     }
-    bool is_float64() const {
-        return m_type == type_t::float64;
+    if (offsets.element_type() != type_t::int32 or offsets.num_elements() < 2) {
+        return Array::null("list offsets must be an int32 array of at least 2 elements");
     }
-    int32_t idx() const {
-        return m_idx;
+    if (not offsets.is_frozen() or not values.is_frozen()) {
+        return Array::null("list offsets and values should be frozen");
     }
-    int32_t offset() const {
-        return m_offset;
+    if (values.is_pointer()) {
+        return Array::null("list values can't be pointers");
     }
-    const std::string &name() const {
-        return m_name;
+    const int32_t* l_offsets = static_cast<const int32_t*>(offsets.ref());
+    const uint32_t l_num_lists = offsets.num_elements() - 1;
+    if (l_offsets[0] < 0 or static_cast<uint32_t>(l_offsets[l_num_lists]) > values.num_elements()) {
+        return Array::null("list offsets out of range of values");
     }
-    void log_values(std::ostream& os, void* data) const {
-        if (data != nullptr) {
-            switch (m_type) {
-            case type_t::unknown:  os << "<unknown type>"; break;
-            case type_t::boolean:  os << *((bool*)data); break;
-            case type_t::int8:     os << *((int8_t*)data); break;
-            case type_t::int16:    os << *((int16_t*)data); break;
-            case type_t::int32:    os << *((int32_t*)data); break;
-            case type_t::int64:    os << *((int64_t*)data); break;
-            case type_t::uint8:    os << *((uint8_t*)data); break;
-            case type_t::uint16:   os << *((uint16_t*)data); break;
-            case type_t::uint32:   os << *((uint32_t*)data); break;
-            case type_t::uint64:   os << *((uint64_t*)data); break;
-            case type_t::float32:  os << *((float32_t*)data); break;
-            case type_t::float64:  os << *((float64_t*)data); break;
-            case type_t::pointer_struct: {
-                            os << "{<pointer>" << *((uint64_t *)data);
-                            LLVM_BUILDER_ASSERT(not m_underlying_struct.has_error());
-                            m_underlying_struct.log_values(os, (void*)*((uint64_t*)data), m_underlying_struct.size_in_bytes());
-                            os << "}";
-                            break;
-                        }
-            case type_t::pointer_array: {
-                            os << "<pointer>" << *((uint64_t*)data);
-                            // TODO{vibhanshu}: log underlying array
-                            break;
-                        }
-            case type_t::pointer_fn: {
-                            os << "<fn_pointer>" << *((uint64_t*)data);
-                            break;
-                        }
-            }
-        } else {
-            os << "<invalid_buffer>";
+    for (uint32_t i = 0; i != l_num_lists; ++i) {
+        if (l_offsets[i + 1] < l_offsets[i]) {
+            return Array::null(LLVM_BUILDER_CONCAT << "list offsets should be non decreasing, at:" << i);
         }
     }
-};
-
+    Array l_res{type_t::int32, l_num_lists, offsets.m_impl, offsets.ref(), true};
+    l_res.m_impl->set_list(offsets, values);
+    return l_res;
+}
 
 //
-// Field
+// Arrow C Data Interface
 //
-Field::Field() : BaseT{State::ERROR} {
+// Exported arrays and schemas own their private data and children, and are
+// released independently of each other. An imported array is moved into an
+// ArrowImport shared by every runtime array using its buffers
+namespace {
+
+const char* arrow_format(type_t type) {
+    switch (type) {
+    case type_t::int8:    return "c";
+    case type_t::int16:   return "s";
+    case type_t::int32:   return "i";
+    case type_t::int64:   return "l";
+    case type_t::uint8:   return "C";
+    case type_t::uint16:  return "S";
+    case type_t::uint32:  return "I";
+    case type_t::uint64:  return "L";
+    case type_t::float32: return "f";
+    case type_t::float64: return "g";
+    default:              return nullptr;
+    }
 }
 
-Field::Field(const Struct& parent,
-                           int32_t idx, int32_t offset,
-                           const std::string &name,
-                           const TypeInfo& type, construct_t)
-    : BaseT{State::VALID} {
-    m_impl = std::make_shared<Impl>(parent, idx, offset, name, type);
+type_t arrow_type(std::string_view format) {
+    for (type_t l_type : {type_t::int8, type_t::int16, type_t::int32, type_t::int64,
+                          type_t::uint8, type_t::uint16, type_t::uint32, type_t::uint64,
+                          type_t::float32, type_t::float64}) {
+        if (format == arrow_format(l_type)) {
+            return l_type;
+        }
+    }
+    return type_t::unknown;
 }
 
-Field::~Field() = default;
+bool is_arrow_exportable(const Array& array) {
+    if (not array.is_frozen()) {
+        return false;
+    }
+    if (array.is_list()) {
+        return is_arrow_exportable(array.values());
+    }
+    return arrow_format(array.element_type()) != nullptr;
+}
 
-Struct Field::struct_def() const {
-    if (has_error()) {
-        return Struct::null();
+struct ArrowArrayExport {
+    // keeps exported buffers alive
+    Array m_array;
+    const void* m_buffers[2] = {nullptr, nullptr};
+    std::vector<ArrowArray> m_children;
+    std::vector<ArrowArray*> m_child_ptrs;
+};
+
+struct ArrowSchemaExport {
+    std::string m_format;
+    std::string m_name;
+    std::vector<ArrowSchema> m_children;
+    std::vector<ArrowSchema*> m_child_ptrs;
+};
+
+void release_arrow_array(ArrowArray* array) {
+    ArrowArrayExport* l_export = static_cast<ArrowArrayExport*>(array->private_data);
+    // children moved out by the consumer are already released
+    for (ArrowArray& l_child : l_export->m_children) {
+        if (l_child.release != nullptr) {
+            l_child.release(&l_child);
+        }
     }
-    LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->struct_def();
+    delete l_export;
+    array->release = nullptr;
 }
 
-int32_t Field::idx() const {
-    if (has_error()) {
-        return std::numeric_limits<int32_t>::max();
+void release_arrow_schema(ArrowSchema* schema) {
+    ArrowSchemaExport* l_export = static_cast<ArrowSchemaExport*>(schema->private_data);
+    for (ArrowSchema& l_child : l_export->m_children) {
+        if (l_child.release != nullptr) {
+            l_child.release(&l_child);
+        }
     }
-    LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->idx();
+    delete l_export;
+    schema->release = nullptr;
 }
 
-int32_t Field::offset() const {
-    if (has_error()) {
-        return std::numeric_limits<int32_t>::max();
+// children of `array_export` are filled in by the caller
+void init_arrow_array(ArrowArray* out, ArrowArrayExport* array_export, int64_t length, int64_t null_count, int64_t num_buffers) {
+    for (ArrowArray& l_child : array_export->m_children) {
+        array_export->m_child_ptrs.push_back(&l_child);
+    }
+    out->length = length;
+    out->null_count = null_count;
+    out->offset = 0;
+    out->n_buffers = num_buffers;
+    out->n_children = static_cast<int64_t>(array_export->m_child_ptrs.size());
+    out->buffers = array_export->m_buffers;
+    out->children = array_export->m_child_ptrs.empty() ? nullptr : array_export->m_child_ptrs.data();
+    out->dictionary = nullptr;
+    out->release = &release_arrow_array;
+    out->private_data = array_export;
+}
+
+void init_arrow_schema(ArrowSchema* out, ArrowSchemaExport* schema_export, int64_t flags) {
+    for (ArrowSchema& l_child : schema_export->m_children) {
+        schema_export->m_child_ptrs.push_back(&l_child);
+    }
+    out->format = schema_export->m_format.c_str();
+    out->name = schema_export->m_name.c_str();
+    out->metadata = nullptr;
+    out->flags = flags;
+    out->n_children = static_cast<int64_t>(schema_export->m_child_ptrs.size());
+    out->children = schema_export->m_child_ptrs.empty() ? nullptr : schema_export->m_child_ptrs.data();
+    out->dictionary = nullptr;
+    out->release = &release_arrow_schema;
+    out->private_data = schema_export;
+}
+
+// `array` should be exportable, see is_arrow_exportable()
+void export_arrow_node(const Array& array, const std::string& name, ArrowArray* out_array, ArrowSchema* out_schema) {
+    ArrowArrayExport* l_array = new ArrowArrayExport{};
+    ArrowSchemaExport* l_schema = new ArrowSchemaExport{};
+    l_array->m_array = array;
+    l_array->m_buffers[0] = array.has_validity() ? array.validity().ref() : nullptr;
+    l_array->m_buffers[1] = array.ref();
+    l_schema->m_name = name;
+    if (array.is_list()) {
+        l_schema->m_format = "+l";
+        l_array->m_children.resize(1);
+        l_schema->m_children.resize(1);
+        export_arrow_node(array.values(), "item", &l_array->m_children[0], &l_schema->m_children[0]);
+    } else {
+        l_schema->m_format = arrow_format(array.element_type());
     }
-    LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->offset();
+    init_arrow_array(out_array, l_array, array.num_elements(), array.null_count(), 2);
+    init_arrow_schema(out_schema, l_schema, array.has_validity() ? ARROW_FLAG_NULLABLE : 0);
 }
 
-const std::string& Field::name() const {
+class ArrowImport : meta::noncopyable {
+    ArrowArray m_array;
+public:
+    explicit ArrowImport(ArrowArray* array)
+      : m_array{*array} {
+        array->release = nullptr;
+    }
+    ~ArrowImport() {
+        if (m_array.release != nullptr) {
+            m_array.release(&m_array);
+        }
+    }
+public:
+    const ArrowArray& array() const {
+        return m_array;
+    }
+};
+
+} // namespace
+
+bool Array::export_arrow(ArrowArray* out_array, ArrowSchema* out_schema) const {
     if (has_error()) {
-        return StringManager::null();
+        return false;
     }
-    LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->name();
+    if (out_array == nullptr or out_schema == nullptr) {
+        M_mark_error("can't export arrow array into null struct");
+        return false;
+    }
+    if (not is_arrow_exportable(*this)) {
+        M_mark_error("array has no arrow equivalent, it should be frozen and of non boolean scalar type or a list of one");
+        return false;
+    }
+    export_arrow_node(*this, "", out_array, out_schema);
+    return true;
 }
 
-#define IS_TYPE_FWD(type)                          \
-    bool Field::is_##type() const {                \
-        if (has_error()) {                         \
-            return false;                          \
-        }                                          \
-        LLVM_BUILDER_ASSERT(m_impl);                       \
-        return m_impl->is_##type();                \
-    }                                              \
-/**/                                               \
+auto Array::import_arrow(ArrowArray* array, const ArrowSchema* schema) -> Array {
+    if (array == nullptr or array->release == nullptr) {
+        return Array::null("arrow array is already released");
+    }
+    std::shared_ptr<ArrowImport> l_import = std::make_shared<ArrowImport>(array);
+    if (schema == nullptr or schema->release == nullptr) {
+        return Array::null("arrow schema is already released");
+    }
+    return M_import_arrow(l_import, l_import->array(), *schema);
+}
 
-IS_TYPE_FWD(bool)
-IS_TYPE_FWD(struct_pointer)
-IS_TYPE_FWD(array_pointer)
-IS_TYPE_FWD(fn_pointer)
-IS_TYPE_FWD(int8)
-IS_TYPE_FWD(int16)
-IS_TYPE_FWD(int32)
-IS_TYPE_FWD(int64)
-IS_TYPE_FWD(uint8)
-IS_TYPE_FWD(uint16)
-IS_TYPE_FWD(uint32)
-IS_TYPE_FWD(uint64)
-IS_TYPE_FWD(float32)
-IS_TYPE_FWD(float64)
+auto Array::M_import_arrow(const std::shared_ptr<void>& owner, const ArrowArray& array, const ArrowSchema& schema) -> Array {
+    if (schema.format == nullptr) {
+        return Array::null("arrow schema has no format");
+    }
+    const std::string_view l_format{schema.format};
+    if (schema.dictionary != nullptr or array.dictionary != nullptr) {
+        return Array::null("dictionary encoded arrow arrays are not supported");
+    }
+    if (array.length <= 0 or array.length >= std::numeric_limits<uint32_t>::max() or array.offset < 0) {
+        return Array::null(LLVM_BUILDER_CONCAT << "arrow array length should be in [1, 2^32):" << array.length);
+    }
+    const uint32_t l_length = static_cast<uint32_t>(array.length);
+    // bitmap may be left out when there are no nulls
+    const uint8_t* l_validity = nullptr;
+    if (array.null_count != 0 and array.n_buffers > 0 and array.buffers[0] != nullptr) {
+        if (array.offset % 8 != 0) {
+            return Array::null("nullable arrow array should start at a multiple of 8 elements");
+        }
+        l_validity = static_cast<const uint8_t*>(array.buffers[0]) + array.offset / 8;
+    }
+    Array l_res;
+    if (l_format == "+l" or l_format == "u" or l_format == "z") {
+        const bool l_is_list = l_format == "+l";
+        if (array.n_buffers != (l_is_list ? 2 : 3) or array.buffers[1] == nullptr
+            or (l_is_list and (array.n_children != 1 or schema.n_children != 1))) {
+            return Array::null(LLVM_BUILDER_CONCAT << "malformed arrow array of format:" << l_format);
+        }
+        int32_t* l_offsets = static_cast<int32_t*>(const_cast<void*>(array.buffers[1])) + array.offset;
+        Array l_values;
+        if (l_is_list) {
+            l_values = M_import_arrow(owner, *array.children[0], *schema.children[0]);
+            if (l_values.has_error()) {
+                return l_values;
+            }
+        } else {
+            // offsets index the data buffer from its start, whatever the array offset is
+            if (l_offsets[l_length] <= 0 or array.buffers[2] == nullptr) {
+                return Array::null("arrow binary array without data is not supported");
+            }
+            l_values = Array{type_t::uint8, static_cast<uint32_t>(l_offsets[l_length]), owner, const_cast<void*>(array.buffers[2]), true};
+        }
+        l_res = from_list(Array{type_t::int32, l_length + 1, owner, l_offsets, true}, l_values);
+    } else {
+        const type_t l_type = arrow_type(l_format);
+        if (l_type == type_t::unknown) {
+            return Array::null(LLVM_BUILDER_CONCAT << "arrow format has no runtime type:" << l_format);
+        }
+        if (array.n_buffers != 2 or array.buffers[1] == nullptr) {
+            return Array::null(LLVM_BUILDER_CONCAT << "malformed arrow array of format:" << l_format);
+        }
+        const uint32_t l_element_size = Impl::size_of(l_type);
+        uint8_t* l_data = static_cast<uint8_t*>(const_cast<void*>(array.buffers[1])) + array.offset * l_element_size;
+        if (reinterpret_cast<uintptr_t>(l_data) % l_element_size != 0) {
+            return Array::null(LLVM_BUILDER_CONCAT << "arrow buffer is not aligned to element size:" << l_element_size);
+        }
+        l_res = Array{l_type, l_length, owner, l_data, true};
+    }
+    if (l_res.has_error()) {
+        return l_res;
+    }
+    if (l_validity != nullptr) {
+        l_res.m_impl->set_external_validity(l_validity);
+    }
+    return l_res;
+}
 
-#undef IS_TYPE_FWD
+//
+// ArrayView
+//
+ArrayView::ArrayView() : BaseT{State::ERROR} {
+}
 
-void Field::log_values(std::ostream& os, void* data) const {
+ArrayView::ArrayView(const Array& array)
+    : ArrayView{array, 0, array.num_elements(), 1} {
+}
+
+ArrayView::ArrayView(const Array& array, uint32_t offset, uint32_t length, uint32_t stride)
+    : BaseT{State::VALID}
+    , m_array{array}
+    , m_offset{offset}
+    , m_length{length}
+    , m_stride{stride} {
+    if (array.has_error()) {
+        M_mark_error("can't build view of invalid array");
+    } else if (not array.is_scalar() or array.is_list()) {
+        M_mark_error("view can be built only over an array of scalars");
+    } else if (length == 0 or stride == 0) {
+        M_mark_error("view can't be empty or of stride 0");
+    } else if (offset + static_cast<uint64_t>(length - 1) * stride >= array.num_elements()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "view out of array of size:" << array.num_elements());
+    }
+}
+
+ArrayView ArrayView::slice(uint32_t begin, uint32_t length, uint32_t step) const {
     if (has_error()) {
-        return;
+        return ArrayView::null();
     }
-    LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->log_values(os, data);
+    if (length == 0 or step == 0) {
+        return ArrayView::null("view can't be empty or of stride 0");
+    }
+    if (begin + static_cast<uint64_t>(length - 1) * step >= m_length) {
+        return ArrayView::null(LLVM_BUILDER_CONCAT << "slice out of view of length:" << m_length);
+    }
+    return ArrayView{m_array, m_offset + begin * m_stride, length, m_stride * step};
 }
 
-bool Field::operator == (const Field& rhs) const {
+Array ArrayView::to_array() const {
+    if (has_error()) {
+        return Array::null();
+    }
+    if (not is_contiguous()) {
+        return Array::null("only a contiguous view can be used as an array");
+    }
+    return m_array.slice(m_offset, m_length);
+}
+
+Column ArrayView::column(const std::string& field) const {
+    if (has_error()) {
+        return Column{field, type_t::unknown, nullptr, 0};
+    }
+    char* l_data = static_cast<char*>(m_array.ref()) + static_cast<uint64_t>(m_offset) * m_array.element_size();
+    const int64_t l_stride = static_cast<int64_t>(m_stride) * m_array.element_size();
+    return Column{field, m_array.element_type(), l_data, l_stride};
+}
+
+bool ArrayView::operator == (const ArrayView& rhs) const {
     if (has_error() and rhs.has_error()) {
         return true;
     }
-    return m_impl.get() == rhs.m_impl.get();
+    if (has_error() or rhs.has_error()) {
+        return false;
+    }
+    return m_array == rhs.m_array and m_offset == rhs.m_offset
+        and m_length == rhs.m_length and m_stride == rhs.m_stride;
 }
 
-Field Field::null(const std::string& log) {
-    static Field s_null{};
+ArrayView ArrayView::null(const std::string& log) {
+    static ArrayView s_null{};
     LLVM_BUILDER_ASSERT(s_null.has_error());
-    Field result = s_null;
+    ArrayView result = s_null;
     result.M_mark_error(log);
     return result;
 }
 
-type_t Field::get_type(const TypeInfo& type) {
-    if (type.has_error()) {
-        return type_t::unknown;
+//
+// RingBuffer
+//
+RingBuffer::RingBuffer() : BaseT{State::ERROR} {
+}
+
+RingBuffer::RingBuffer(const Object& object)
+    : BaseT{State::VALID}
+    , m_object{object} {
+    if (object.has_error()) {
+        M_mark_error("can't build ring buffer over invalid object");
+        return;
     }
-    const uint32_t l_size = type.size_in_bytes();
-    if (type.is_boolean()) {
-        return type_t::boolean;
-    } else if (type.is_pointer()) {
-        const TypeInfo& base_type = type.base_type();
-        if (base_type.is_struct()) {
-            return type_t::pointer_struct;
-        } else if (base_type.is_array() or base_type.is_vector()) {
-            return type_t::pointer_array;
-        } else if (base_type.is_function()) {
-            return type_t::pointer_fn;
-        }
-    } else if (type.is_float()) {
-        if (l_size == 4) {
-            return type_t::float32;
-        } else if (l_size == 8) {
-            return type_t::float64;
-        }
-    } else if (type.is_integer()) {
-        if (type.is_signed_integer()) {
-            if (l_size == 8) {
-                return type_t::int64;
-            } else if (l_size == 4) {
-                return type_t::int32;
-            } else if (l_size == 2) {
-                return type_t::int16;
-            } else if (l_size == 1) {
-                return type_t::int8;
-            }
-        } else {
-            LLVM_BUILDER_ASSERT(type.is_unsigned_integer());
-            if (l_size == 8) {
-                return type_t::uint64;
-            } else if (l_size == 4) {
-                return type_t::uint32;
-            } else if (l_size == 2) {
-                return type_t::uint16;
-            } else if (l_size == 1) {
-                return type_t::uint8;
-            }
+    const Struct l_struct = object.struct_def();
+    const std::vector<std::string>& l_names = l_struct.field_names();
+    if (l_names.size() < 3 or l_names[0] != ::llvm_builder::RingBuffer::c_head_field or l_names[1] != ::llvm_builder::RingBuffer::c_size_field
+          or not l_struct[l_names[0]].is_uint32() or not l_struct[l_names[1]].is_uint32()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "struct:" << l_struct.name() << " not built by RingBuffer::mk_type()");
+        return;
+    }
+    const type_t l_type = l_struct[l_names[2]].type();
+    for (uint32_t i = 2; i != l_names.size() and l_names[i] == ::llvm_builder::RingBuffer::slot_name(i - 2); ++i) {
+        if (l_struct[l_names[i]].type() != l_type) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "slot:" << l_names[i] << " of struct:" << l_struct.name() << " is of different type");
+            return;
         }
+        m_slot_names.emplace_back(l_names[i]);
+    }
+    if (m_slot_names.empty()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "struct:" << l_struct.name() << " has no slots");
     }
-    return type_t::unknown;
 }
 
-uint32_t Field::get_raw_size(const TypeInfo& type) {
-    if (type.has_error()) {
-        return std::numeric_limits<uint32_t>::max();
+uint32_t RingBuffer::size() const {
+    if (has_error()) {
+        return 0;
     }
-    const uint32_t l_size = type.size_in_bytes();
-    if (type.is_pointer()) {
-        return sizeof(int*);
-    } else if (type.is_scalar()) {
-        return l_size;
-    } else {
-        return std::numeric_limits<uint32_t>::max();
+    return m_object.get<uint32_t>(::llvm_builder::RingBuffer::c_size_field);
+}
+
+void RingBuffer::clear() const {
+    if (has_error()) {
+        return;
+    }
+    m_object.set<uint32_t>(::llvm_builder::RingBuffer::c_head_field, 0);
+    m_object.set<uint32_t>(::llvm_builder::RingBuffer::c_size_field, 0);
+}
+
+uint32_t RingBuffer::M_head() const {
+    return m_object.get<uint32_t>(::llvm_builder::RingBuffer::c_head_field);
+}
+
+void RingBuffer::M_advance() const {
+    const uint32_t l_head = M_head() + 1;
+    m_object.set<uint32_t>(::llvm_builder::RingBuffer::c_head_field, l_head == capacity() ? 0 : l_head);
+    m_object.set<uint32_t>(::llvm_builder::RingBuffer::c_size_field, std::min(size() + 1, capacity()));
+}
+
+bool RingBuffer::operator == (const RingBuffer& rhs) const {
+    if (has_error() and rhs.has_error()) {
+        return true;
     }
+    if (has_error() or rhs.has_error()) {
+        return false;
+    }
+    return m_object == rhs.m_object;
+}
+
+RingBuffer RingBuffer::null(const std::string& log) {
+    static RingBuffer s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    RingBuffer result = s_null;
+    result.M_mark_error(log);
+    return result;
 }
 
 //
-// Struct::Impl
+// Table::Impl
 //
-class Struct::Impl : meta::noncopyable {
-    const std::string m_name;
-    const int32_t m_size = 0;
-    std::unordered_map<std::string, Field> m_fields;
-    std::vector<std::string> m_field_names;
+class Table::Impl : meta::noncopyable {
+    const uint32_t m_num_rows = 0;
+    std::vector<std::string> m_names;
+    std::vector<Array> m_columns;
 public:
-    explicit Impl(const Struct& parent, const TypeInfo &type)
-        : m_name{type.struct_name()}, m_size{(int32_t)type.struct_size_bytes()} {
-        LLVM_BUILDER_ASSERT(type.is_struct());
-        const uint32_t l_num_fields = type.num_elements();
-        for (uint32_t i = 0; i != l_num_fields; ++i) {
-            field_entry_t l_field = type[i];
-            const std::string field_name = l_field.name();
-            LLVM_BUILDER_ASSERT(l_field.idx() == i);
-            LLVM_BUILDER_DEBUG(auto it = ) m_fields.try_emplace(field_name, parent, l_field.idx(), l_field.offset(), field_name, l_field.type(), Field::construct_t{});
-            LLVM_BUILDER_ASSERT(it.second);
-            m_field_names.emplace_back(field_name);
-        }
-        LLVM_BUILDER_ASSERT(num_fields() == (int32_t)type.num_elements());
+    explicit Impl(uint32_t num_rows)
+      : m_num_rows{num_rows} {
+        LLVM_BUILDER_ASSERT(m_num_rows > 0);
     }
-    ~Impl() = default;
 public:
-    const std::string &name() const {
-        return m_name;
+    uint32_t num_rows() const {
+        return m_num_rows;
     }
-    Object mk_object(const Struct& parent) const {
-        Object l_object{parent};
-        LLVM_BUILDER_ASSERT(l_object.m_impl);
-        LLVM_BUILDER_ASSERT(not l_object.has_error());
-        return l_object;
+    const std::vector<std::string>& names() const {
+        return m_names;
     }
-    int32_t size_in_bytes() const {
-        return m_size;
+    const std::vector<Array>& columns() const {
+        return m_columns;
     }
-    int32_t num_fields() const {
-        return (int32_t)m_fields.size();
+    const Array* find(const std::string& name) const {
+        for (uint32_t i = 0; i != m_names.size(); ++i) {
+            if (m_names[i] == name) {
+                return &m_columns[i];
+            }
+        }
+        return nullptr;
     }
-    const std::vector<std::string>& field_names() const {
-        return m_field_names;
+    void add_column(const std::string& name, const Array& column) {
+        LLVM_BUILDER_ASSERT(find(name) == nullptr);
+        m_names.emplace_back(name);
+        m_columns.emplace_back(column);
     }
-    Field operator[](const std::string &s) const {
-        if (m_fields.contains(s)) {
-            return m_fields.at(s);
-        } else {
-            return Field::null();
+};
+
+//
+// Table
+//
+Table::Table() : BaseT{State::ERROR} {
+}
+
+Table::Table(uint32_t num_rows)
+  : BaseT{State::VALID} {
+    if (num_rows == 0) {
+        M_mark_error("Can't define table of 0 rows");
+    } else {
+        m_impl = std::make_shared<Impl>(num_rows);
+    }
+}
+
+uint32_t Table::num_rows() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->num_rows();
+}
+
+uint32_t Table::num_columns() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return static_cast<uint32_t>(m_impl->columns().size());
+}
+
+const std::vector<std::string>& Table::column_names() const {
+    static const std::vector<std::string> s_empty;
+    if (has_error()) {
+        return s_empty;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->names();
+}
+
+bool Table::add_column(const std::string& name, const Array& column) {
+    if (has_error() or column.has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (name.empty() or m_impl->find(name) != nullptr) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "invalid or duplicate column name:" << name);
+        return false;
+    }
+    if (not column.is_frozen()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "column should be frozen:" << name);
+        return false;
+    }
+    if (column.num_elements() != m_impl->num_rows()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "column should have " << m_impl->num_rows() << " rows:" << name);
+        return false;
+    }
+    m_impl->add_column(name, column);
+    return true;
+}
+
+Array Table::column(const std::string& name) const {
+    if (has_error()) {
+        return Array::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    const Array* l_column = m_impl->find(name);
+    if (l_column == nullptr) {
+        return Array::null(LLVM_BUILDER_CONCAT << "can't find column:" << name);
+    }
+    return *l_column;
+}
+
+std::vector<Column> Table::kernel_columns() const {
+    std::vector<Column> l_res;
+    if (has_error()) {
+        return l_res;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    const std::vector<std::string>& l_names = m_impl->names();
+    const std::vector<Array>& l_columns = m_impl->columns();
+    for (uint32_t i = 0; i != l_columns.size(); ++i) {
+        const Array& l_column = l_columns[i];
+        if (l_column.is_list() or l_column.is_pointer()) {
+            continue;
         }
+        l_res.emplace_back(l_names[i], l_column.element_type(), l_column.ref(), l_column.element_size());
     }
-    void log_values(std::ostream& os, void* data, uint32_t size) const {
-        if (data != nullptr) {
-            os << "\n";
-            for (const std::string& fname : m_field_names) {
-                os << fname << ":";
-                const Field& l_field = m_fields.at(fname);
-                if (l_field.offset() < (int32_t)size) {
-                    l_field.log_values(os, (char*)data + l_field.offset());
+    return l_res;
+}
+
+bool Table::export_arrow(ArrowArray* out_array, ArrowSchema* out_schema) const {
+    if (has_error()) {
+        return false;
+    }
+    if (out_array == nullptr or out_schema == nullptr) {
+        M_mark_error("can't export arrow array into null struct");
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    const std::vector<std::string>& l_names = m_impl->names();
+    const std::vector<Array>& l_columns = m_impl->columns();
+    for (uint32_t i = 0; i != l_columns.size(); ++i) {
+        if (not is_arrow_exportable(l_columns[i])) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "column has no arrow equivalent:" << l_names[i]);
+            return false;
+        }
+    }
+    ArrowArrayExport* l_array = new ArrowArrayExport{};
+    ArrowSchemaExport* l_schema = new ArrowSchemaExport{};
+    l_schema->m_format = "+s";
+    l_array->m_children.resize(l_columns.size());
+    l_schema->m_children.resize(l_columns.size());
+    for (uint32_t i = 0; i != l_columns.size(); ++i) {
+        export_arrow_node(l_columns[i], l_names[i], &l_array->m_children[i], &l_schema->m_children[i]);
+    }
+    init_arrow_array(out_array, l_array, m_impl->num_rows(), 0, 1);
+    init_arrow_schema(out_schema, l_schema, 0);
+    return true;
+}
+
+auto Table::import_arrow(ArrowArray* array, const ArrowSchema* schema) -> Table {
+    if (array == nullptr or array->release == nullptr) {
+        return Table::null("arrow array is already released");
+    }
+    std::shared_ptr<ArrowImport> l_import = std::make_shared<ArrowImport>(array);
+    if (schema == nullptr or schema->release == nullptr) {
+        return Table::null("arrow schema is already released");
+    }
+    const ArrowArray& l_array = l_import->array();
+    if (schema->format == nullptr or std::string_view{schema->format} != "+s") {
+        return Table::null("arrow array is not a struct array");
+    }
+    if (l_array.n_children != schema->n_children) {
+        return Table::null("arrow array and schema have different number of children");
+    }
+    if (l_array.null_count != 0 and l_array.n_buffers > 0 and l_array.buffers[0] != nullptr) {
+        return Table::null("arrow struct array with nulls is not supported");
+    }
+    if (l_array.offset != 0) {
+        return Table::null("sliced arrow struct array is not supported");
+    }
+    if (l_array.length <= 0 or l_array.length >= std::numeric_limits<uint32_t>::max()) {
+        return Table::null(LLVM_BUILDER_CONCAT << "arrow array length should be in [1, 2^32):" << l_array.length);
+    }
+    Table l_res{static_cast<uint32_t>(l_array.length)};
+    for (int64_t i = 0; i != l_array.n_children; ++i) {
+        const ArrowSchema& l_child_schema = *schema->children[i];
+        if (l_child_schema.name == nullptr) {
+            return Table::null("arrow struct child has no name");
+        }
+        Array l_column = Array::M_import_arrow(l_import, *l_array.children[i], l_child_schema);
+        if (l_column.has_error()) {
+            return Table::null(l_column.error_log());
+        }
+        if (not l_res.add_column(l_child_schema.name, l_column)) {
+            return l_res;
+        }
+    }
+    return l_res;
+}
+
+bool Table::operator == (const Table& rhs) const {
+    if (has_error() and rhs.has_error()) {
+        return true;
+    }
+    return m_impl.get() == rhs.m_impl.get();
+}
+
+Table Table::null(const std::string& log) {
+    static Table s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    Table result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+//
+// ObjectGraph
+//
+// objects and arrays reachable from a root object, in depth first order with the
+// root as node 0. Objects/arrays linked from several places are one node
+namespace {
+
+class ObjectGraph {
+public:
+    struct Link {
+        // field name for object nodes, element idx for array nodes
+        std::string m_field;
+        uint32_t m_idx = 0;
+        uint32_t m_child = 0;
+    };
+    struct Node {
+        bool m_is_object = false;
+        Object m_obj;
+        Array m_arr;
+        uint32_t m_size = 0;
+        std::vector<Link> m_links;
+    };
+private:
+    std::vector<Node> m_nodes;
+    // live buffer -> node idx
+    std::unordered_map<const void*, uint32_t> m_visited;
+public:
+    explicit ObjectGraph(const Object& root) {
+        M_add_object(root);
+    }
+    ~ObjectGraph() = default;
+public:
+    uint32_t num_nodes() const {
+        return static_cast<uint32_t>(m_nodes.size());
+    }
+    const Node& operator[](uint32_t idx) const {
+        return m_nodes[idx];
+    }
+    const std::vector<Node>& nodes() const {
+        return m_nodes;
+    }
+private:
+    uint32_t M_add_object(const Object& o) {
+        auto l_it = m_visited.find(o.ref());
+        if (l_it != m_visited.end()) {
+            return l_it->second;
+        }
+        const uint32_t l_idx = num_nodes();
+        m_visited.emplace(o.ref(), l_idx);
+        const Struct l_struct = o.struct_def();
+        Node& l_node = m_nodes.emplace_back();
+        l_node.m_is_object = true;
+        l_node.m_obj = o;
+        l_node.m_size = static_cast<uint32_t>(l_struct.size_in_bytes());
+        for (const std::string& l_name : l_struct.field_names()) {
+            const Field l_field = l_struct[l_name];
+            uint32_t l_child = 0;
+            if (l_field.is_struct_pointer()) {
+                const Object l_obj = o.get_object(l_name);
+                if (l_obj.has_error()) {
+                    continue;
+                }
+                l_child = M_add_object(l_obj);
+            } else if (l_field.is_array_pointer()) {
+                const Array l_arr = o.get_array(l_name);
+                if (l_arr.has_error()) {
+                    continue;
+                }
+                l_child = M_add_array(l_arr);
+            } else {
+                continue;
+            }
+            // m_nodes may have grown
+            m_nodes[l_idx].m_links.emplace_back(Link{l_name, 0, l_child});
+        }
+        return l_idx;
+    }
+    uint32_t M_add_array(const Array& a) {
+        auto l_it = m_visited.find(a.ref());
+        if (l_it != m_visited.end()) {
+            return l_it->second;
+        }
+        const uint32_t l_idx = num_nodes();
+        m_visited.emplace(a.ref(), l_idx);
+        Node& l_node = m_nodes.emplace_back();
+        l_node.m_arr = a;
+        l_node.m_size = a.num_elements() * a.element_size();
+        if (not a.is_pointer()) {
+            return l_idx;
+        }
+        for (uint32_t i = 0; i != a.num_elements(); ++i) {
+            uint32_t l_child = 0;
+            if (a.element_type() == type_t::pointer_struct) {
+                const Object l_obj = a.get_object(i);
+                if (l_obj.has_error()) {
+                    continue;
+                }
+                l_child = M_add_object(l_obj);
+            } else {
+                const Array l_arr = a.get_array(i);
+                if (l_arr.has_error()) {
+                    continue;
+                }
+                l_child = M_add_array(l_arr);
+            }
+            m_nodes[l_idx].m_links.emplace_back(Link{"", i, l_child});
+        }
+        return l_idx;
+    }
+};
+
+// saves in place objects/arrays reachable from `context` which a snapshot is
+// still waiting on, before an event on `context` can write them
+void capture_in_place(const Object& context) {
+    InPlaceCaptures& l_captures = InPlaceCaptures::instance();
+    if (l_captures.is_empty()) {
+        return;
+    }
+    const ObjectGraph l_graph{context};
+    for (const ObjectGraph::Node& l_node : l_graph.nodes()) {
+        l_captures.capture(l_node.m_is_object ? l_node.m_obj.ref() : l_node.m_arr.ref());
+    }
+}
+
+} // namespace
+
+//
+// Snapshot::Impl
+//
+class Snapshot::Impl : meta::noncopyable {
+    using Link = ObjectGraph::Link;
+    using Node = ObjectGraph::Node;
+    struct Copy {
+        // saved by next publish for double buffered objects, by next event
+        // reaching the node otherwise
+        std::shared_ptr<SnapshotCapture> m_capture;
+    };
+    enum : uint8_t {
+        c_not_built = 0,
+        c_in_progress = 1,
+        c_built = 2,
+    };
+private:
+    const ObjectGraph m_graph;
+    // by node idx
+    std::vector<Copy> m_copies;
+    uint64_t m_num_bytes_copied = 0;
+    mutable std::mutex m_mutex;
+    bool m_is_built = false;
+    Object m_root;
+public:
+    explicit Impl(const Object& root)
+        : m_graph{root}
+        , m_copies(m_graph.num_nodes()) {
+        for (uint32_t i = 0; i != m_graph.num_nodes(); ++i) {
+            const Node& l_node = m_graph[i];
+            Copy& l_copy = m_copies[i];
+            if (M_is_double_buffered(l_node)) {
+                l_copy.m_capture = std::make_shared<SnapshotCapture>(l_node.m_obj.m_impl->version());
+                l_node.m_obj.m_impl->add_snapshot(l_copy.m_capture);
+            } else {
+                l_copy.m_capture = std::make_shared<SnapshotCapture>(0);
+                InPlaceCaptures::instance().add(M_live(l_node), l_node.m_size, l_copy.m_capture);
+            }
+        }
+    }
+    ~Impl() {
+        M_release();
+    }
+public:
+    uint32_t num_nodes() const {
+        return m_graph.num_nodes();
+    }
+    uint64_t num_bytes_copied() const {
+        std::lock_guard<std::mutex> l_lock{m_mutex};
+        return m_num_bytes_copied + M_num_bytes_captured();
+    }
+    // null object if graph could not be rebuilt
+    Object root() {
+        std::lock_guard<std::mutex> l_lock{m_mutex};
+        if (not m_is_built) {
+            m_is_built = true;
+            std::vector<Object> l_objects(num_nodes());
+            std::vector<Array> l_arrays(num_nodes());
+            std::vector<uint8_t> l_state(num_nodes(), c_not_built);
+            if (M_build(0, l_objects, l_arrays, l_state)) {
+                m_root = l_objects[0];
+            }
+            // counted before buffers are released
+            m_num_bytes_copied += M_num_bytes_captured();
+            M_release();
+        }
+        return m_root;
+    }
+private:
+    static bool M_is_double_buffered(const Node& node) {
+        return node.m_is_object and node.m_obj.m_impl->is_double_buffered();
+    }
+    static const void* M_live(const Node& node) {
+        return node.m_is_object ? node.m_obj.ref() : node.m_arr.ref();
+    }
+    // copy of node as of the snapshot into `dst`
+    void M_read(uint32_t idx, void* dst) const {
+        const Node& l_node = m_graph[idx];
+        const SnapshotCapture& l_capture = *m_copies[idx].m_capture;
+        if (M_is_double_buffered(l_node)) {
+            l_node.m_obj.m_impl->read_snapshot(l_capture, dst);
+        } else {
+            l_capture.read_in_place(M_live(l_node), dst, l_node.m_size);
+        }
+    }
+    uint64_t M_num_bytes_captured() const {
+        uint64_t l_result = 0;
+        for (uint32_t i = 0; i != num_nodes(); ++i) {
+            const std::shared_ptr<SnapshotCapture>& l_capture = m_copies[i].m_capture;
+            if (l_capture and l_capture->m_data.load(std::memory_order_acquire) != nullptr) {
+                l_result += m_graph[i].m_size;
+            }
+        }
+        return l_result;
+    }
+    // children are built first, as only frozen objects/arrays can be linked
+    bool M_build(uint32_t idx, std::vector<Object>& objects, std::vector<Array>& arrays, std::vector<uint8_t>& state) const {
+        if (state[idx] == c_built) {
+            return true;
+        }
+        if (state[idx] == c_in_progress) {
+            return false;
+        }
+        state[idx] = c_in_progress;
+        const Node& l_node = m_graph[idx];
+        for (const Link& l_link : l_node.m_links) {
+            if (not M_build(l_link.m_child, objects, arrays, state)) {
+                return false;
+            }
+        }
+        if (l_node.m_is_object) {
+            Object l_copy = l_node.m_obj.struct_def().mk_object();
+            M_read(idx, l_copy.ref());
+            for (const Link& l_link : l_node.m_links) {
+                if (m_graph[l_link.m_child].m_is_object) {
+                    l_copy.set_object(l_link.m_field, objects[l_link.m_child]);
                 } else {
-                    os << "<NULL>";
+                    l_copy.set_array(l_link.m_field, arrays[l_link.m_child]);
                 }
-                os << ";\n";
             }
+            if (not l_copy.freeze()) {
+                return false;
+            }
+            objects[idx] = l_copy;
         } else {
-            os << "<INVALID_BUFFER>";
+            Array l_copy = Array::from(l_node.m_arr.element_type(), l_node.m_arr.num_elements());
+            M_read(idx, l_copy.ref());
+            for (const Link& l_link : l_node.m_links) {
+                if (m_graph[l_link.m_child].m_is_object) {
+                    l_copy.set_object(l_link.m_idx, objects[l_link.m_child]);
+                } else {
+                    l_copy.set_array(l_link.m_idx, arrays[l_link.m_child]);
+                }
+            }
+            if (not l_copy.freeze()) {
+                return false;
+            }
+            arrays[idx] = l_copy;
+        }
+        state[idx] = c_built;
+        return true;
+    }
+    // drops copies, pending captures are skipped by publish once released
+    void M_release() {
+        for (uint32_t i = 0; i != num_nodes(); ++i) {
+            Copy& l_copy = m_copies[i];
+            if (l_copy.m_capture and not M_is_double_buffered(m_graph[i])) {
+                InPlaceCaptures::instance().remove(M_live(m_graph[i]), l_copy.m_capture.get());
+            }
+            l_copy.m_capture.reset();
+        }
+    }
+};
+
+//
+// Snapshot
+//
+Snapshot::Snapshot() : BaseT{State::ERROR} {
+}
+
+Snapshot::Snapshot(const Object& root)
+    : BaseT{State::VALID} {
+    if (root.has_error()) {
+        M_mark_error();
+    } else {
+        m_impl = std::make_shared<Impl>(root);
+    }
+}
+
+uint32_t Snapshot::num_nodes() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->num_nodes();
+}
+
+uint64_t Snapshot::num_bytes_copied() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->num_bytes_copied();
+}
+
+Object Snapshot::root() const {
+    if (has_error()) {
+        return Object::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    Object l_root = m_impl->root();
+    if (l_root.has_error()) {
+        return Object::null("snapshot graph can't be rebuilt, a pointer field is not linked");
+    }
+    return l_root;
+}
+
+bool Snapshot::operator == (const Snapshot& rhs) const {
+    if (has_error() and rhs.has_error()) {
+        return true;
+    }
+    return m_impl.get() == rhs.m_impl.get();
+}
+
+Snapshot Snapshot::null(const std::string& log) {
+    static Snapshot s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    Snapshot result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+//
+// CheckpointWriter
+//
+// lays out struct tables and node buffers of a graph as described in
+// checkpoint.h and streams them to a file
+namespace {
+
+class CheckpointWriter {
+    const ObjectGraph& m_graph;
+    std::vector<checkpoint::Struct> m_structs;
+    std::vector<checkpoint::Field> m_fields;
+    std::vector<checkpoint::Node> m_nodes;
+    std::vector<checkpoint::Link> m_links;
+    std::unordered_map<std::string, uint32_t> m_struct_idx;
+    checkpoint::Header m_header{};
+    std::string m_error;
+public:
+    explicit CheckpointWriter(const ObjectGraph& graph)
+        : m_graph{graph} {
+    }
+    ~CheckpointWriter() = default;
+public:
+    const std::string& error() const {
+        return m_error;
+    }
+    bool write(const std::string& path) {
+        if (not M_layout()) {
+            return false;
+        }
+        FileWriter l_file{path};
+        if (not l_file.is_valid()) {
+            m_error = l_file.error();
+            return false;
+        }
+        bool l_ok = l_file.write(&m_header, sizeof(m_header))
+                    and l_file.write(m_structs.data(), sizeof(checkpoint::Struct) * m_structs.size())
+                    and l_file.write(m_fields.data(), sizeof(checkpoint::Field) * m_fields.size())
+                    and l_file.write(m_nodes.data(), sizeof(checkpoint::Node) * m_nodes.size())
+                    and l_file.write(m_links.data(), sizeof(checkpoint::Link) * m_links.size());
+        for (uint32_t i = 0; l_ok and i != m_graph.num_nodes(); ++i) {
+            const ObjectGraph::Node& l_node = m_graph[i];
+            LLVM_BUILDER_ASSERT(l_file.offset() <= m_nodes[i].m_offset);
+            l_ok = l_file.pad(checkpoint::c_alignment)
+                   and l_file.write(l_node.m_is_object ? l_node.m_obj.ref() : l_node.m_arr.ref(), l_node.m_size);
+        }
+        if (not l_ok or not l_file.commit()) {
+            m_error = l_file.error();
+            return false;
+        }
+        return true;
+    }
+private:
+    static uint64_t M_align(uint64_t v) {
+        return (v + checkpoint::c_alignment - 1) / checkpoint::c_alignment * checkpoint::c_alignment;
+    }
+    static bool M_copy_name(char (&dst)[checkpoint::c_max_name], const std::string& src) {
+        if (src.size() >= checkpoint::c_max_name) {
+            return false;
+        }
+        std::memset(dst, 0, sizeof(dst));
+        std::memcpy(dst, src.data(), src.size());
+        return true;
+    }
+    bool M_layout() {
+        for (uint32_t i = 0; i != m_graph.num_nodes(); ++i) {
+            const ObjectGraph::Node& l_node = m_graph[i];
+            checkpoint::Node& l_entry = m_nodes.emplace_back();
+            if (l_node.m_is_object) {
+                l_entry.m_kind = checkpoint::c_kind_object;
+                if (not M_add_struct(l_node.m_obj.struct_def(), l_entry.m_type)) {
+                    return false;
+                }
+                l_entry.m_num_elements = 1;
+            } else {
+                l_entry.m_kind = checkpoint::c_kind_array;
+                l_entry.m_type = static_cast<uint32_t>(l_node.m_arr.element_type());
+                l_entry.m_num_elements = l_node.m_arr.num_elements();
+            }
+            l_entry.m_size = l_node.m_size;
+            l_entry.m_first_link = static_cast<uint32_t>(m_links.size());
+            l_entry.m_num_links = static_cast<uint32_t>(l_node.m_links.size());
+            for (const ObjectGraph::Link& l_link : l_node.m_links) {
+                const uint32_t l_slot = l_node.m_is_object ? static_cast<uint32_t>(l_node.m_obj.struct_def()[l_link.m_field].idx())
+                                                           : l_link.m_idx;
+                m_links.emplace_back(checkpoint::Link{l_slot, l_link.m_child});
+            }
+        }
+        m_header.m_magic = checkpoint::c_magic;
+        m_header.m_version = checkpoint::c_version;
+        m_header.m_num_structs = static_cast<uint32_t>(m_structs.size());
+        m_header.m_num_fields = static_cast<uint32_t>(m_fields.size());
+        m_header.m_num_nodes = static_cast<uint32_t>(m_nodes.size());
+        m_header.m_num_links = static_cast<uint32_t>(m_links.size());
+        m_header.m_data_offset = M_align(checkpoint::table_size(m_header));
+        uint64_t l_offset = m_header.m_data_offset;
+        for (checkpoint::Node& l_entry : m_nodes) {
+            l_offset = M_align(l_offset);
+            l_entry.m_offset = l_offset;
+            l_offset += l_entry.m_size;
+        }
+        m_header.m_file_size = l_offset;
+        return true;
+    }
+    bool M_add_struct(const Struct& s, uint32_t& idx) {
+        auto l_it = m_struct_idx.find(s.name());
+        if (l_it != m_struct_idx.end()) {
+            idx = l_it->second;
+            return true;
+        }
+        idx = static_cast<uint32_t>(m_structs.size());
+        checkpoint::Struct& l_entry = m_structs.emplace_back();
+        if (not M_copy_name(l_entry.m_name, s.name())) {
+            m_error = LLVM_BUILDER_CONCAT << "struct name too long for checkpoint:" << s.name();
+            return false;
         }
+        l_entry.m_size = static_cast<uint32_t>(s.size_in_bytes());
+        l_entry.m_first_field = static_cast<uint32_t>(m_fields.size());
+        l_entry.m_num_fields = static_cast<uint32_t>(s.num_fields());
+        for (const std::string& l_name : s.field_names()) {
+            const Field l_field = s[l_name];
+            if (l_field.is_fn_pointer()) {
+                // code addresses don't survive a restart
+                m_error = LLVM_BUILDER_CONCAT << "fn pointer field can't be checkpointed:" << s.name() << "." << l_name;
+                return false;
+            }
+            checkpoint::Field& l_field_entry = m_fields.emplace_back();
+            if (not M_copy_name(l_field_entry.m_name, l_name)) {
+                m_error = LLVM_BUILDER_CONCAT << "field name too long for checkpoint:" << s.name() << "." << l_name;
+                return false;
+            }
+            l_field_entry.m_offset = static_cast<uint32_t>(l_field.offset());
+            l_field_entry.m_type = static_cast<uint32_t>(l_field.type());
+        }
+        m_struct_idx.emplace(s.name(), idx);
+        return true;
+    }
+};
+
+} // namespace
+
+bool Object::write_checkpoint(const std::string& path) const {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->is_frozen()) {
+        M_mark_error("only a frozen object can be checkpointed");
+        return false;
+    }
+    const ObjectGraph l_graph{*this};
+    CheckpointWriter l_writer{l_graph};
+    if (not l_writer.write(path)) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "can't write checkpoint " << path << ":" << l_writer.error());
+        return false;
+    }
+    return true;
+}
+
+//
+// Field::Impl
+//
+class Field::Impl : meta::noncopyable {
+    const Struct& m_parent;
+    const int32_t m_idx;
+    const int32_t m_offset;
+    const std::string m_name;
+    const type_t m_type = type_t::unknown;
+    Struct m_underlying_struct;
+public:
+    Impl(const Struct& parent,
+            int32_t idx, int32_t offset,
+            const std::string &name,
+            const TypeInfo& type)
+        : m_parent{parent}
+        , m_idx{idx}
+        , m_offset{offset}
+        , m_name{name}
+        , m_type{get_type(type)} {
+        LLVM_BUILDER_ASSERT(not m_parent.has_error())
+        LLVM_BUILDER_ASSERT(m_idx != std::numeric_limits<int32_t>::max())
+        LLVM_BUILDER_ASSERT(m_offset != std::numeric_limits<int32_t>::max())
+        LLVM_BUILDER_ASSERT(not m_name.empty());
+        if (is_struct_pointer()) {
+            LLVM_BUILDER_ASSERT(type.is_pointer());
+            LLVM_BUILDER_ASSERT(type.base_type().is_struct());
+            m_underlying_struct = Struct{type.base_type(), Struct::construct_t{}};
+        } else if (is_array_pointer()) {
+            // TODO{vibhanshu}: do`we need to go deep and extract more info about internals of array`
+        }
+    }
+    ~Impl() = default;
+public:
+    const Struct& struct_def() const {
+        return m_parent;
+    }
+    type_t type() const {
+        return m_type;
+    }
+    bool is_bool() const {
+        return m_type == type_t::boolean;
+    }
+    bool is_struct_pointer() const {
+        return m_type == type_t::pointer_struct;
+    }
+    bool is_array_pointer() const {
+        return m_type == type_t::pointer_array;
+    }
+    bool is_fn_pointer() const {
+        return m_type == type_t::pointer_fn;
+    }
+    bool is_pointer() const {
+        return is_struct_pointer() or is_array_pointer() or is_fn_pointer();
+    }
+    bool is_int8() const {
+        return m_type == type_t::int8;
+    }
+    bool is_int16() const {
+        return m_type == type_t::int16;
+    }
+    bool is_int32() const {
+        return m_type == type_t::int32;
+    }
+    bool is_int64() const {
+        return m_type == type_t::int64;
+    }
+    bool is_uint8() const {
+        return m_type == type_t::uint8;
+    }
+    bool is_uint16() const {
+        return m_type == type_t::uint16;
+    }
+    bool is_uint32() const {
+        return m_type == type_t::uint32;
+    }
+    bool is_uint64() const {
+        return m_type == type_t::uint64;
+    }
+    bool is_float32() const {
+        return m_type == type_t::float32;
+    }
+    bool is_float64() const {
+        return m_type == type_t::float64;
+    }
+    int32_t idx() const {
+        return m_idx;
+    }
+    int32_t offset() const {
+        return m_offset;
+    }
+    const std::string &name() const {
+        return m_name;
+    }
+    void log_values(std::ostream& os, void* data) const {
+        if (data != nullptr) {
+            switch (m_type) {
+            case type_t::unknown:  os << "<unknown type>"; break;
+            case type_t::boolean:  os << *((bool*)data); break;
+            case type_t::int8:     os << *((int8_t*)data); break;
+            case type_t::int16:    os << *((int16_t*)data); break;
+            case type_t::int32:    os << *((int32_t*)data); break;
+            case type_t::int64:    os << *((int64_t*)data); break;
+            case type_t::uint8:    os << *((uint8_t*)data); break;
+            case type_t::uint16:   os << *((uint16_t*)data); break;
+            case type_t::uint32:   os << *((uint32_t*)data); break;
+            case type_t::uint64:   os << *((uint64_t*)data); break;
+            case type_t::float32:  os << *((float32_t*)data); break;
+            case type_t::float64:  os << *((float64_t*)data); break;
+            case type_t::pointer_struct: {
+                            os << "{<pointer>" << *((uint64_t *)data);
+                            LLVM_BUILDER_ASSERT(not m_underlying_struct.has_error());
+                            m_underlying_struct.log_values(os, (void*)*((uint64_t*)data), m_underlying_struct.size_in_bytes());
+                            os << "}";
+                            break;
+                        }
+            case type_t::pointer_array: {
+                            os << "<pointer>" << *((uint64_t*)data);
+                            // TODO{vibhanshu}: log underlying array
+                            break;
+                        }
+            case type_t::pointer_fn: {
+                            os << "<fn_pointer>" << *((uint64_t*)data);
+                            break;
+                        }
+            }
+        } else {
+            os << "<invalid_buffer>";
+        }
+    }
+};
+
+
+//
+// Field
+//
+Field::Field() : BaseT{State::ERROR} {
+}
+
+Field::Field(const Struct& parent,
+                           int32_t idx, int32_t offset,
+                           const std::string &name,
+                           const TypeInfo& type, construct_t)
+    : BaseT{State::VALID} {
+    m_impl = std::make_shared<Impl>(parent, idx, offset, name, type);
+}
+
+Field::~Field() = default;
+
+Struct Field::struct_def() const {
+    if (has_error()) {
+        return Struct::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->struct_def();
+}
+
+int32_t Field::idx() const {
+    if (has_error()) {
+        return std::numeric_limits<int32_t>::max();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->idx();
+}
+
+type_t Field::type() const {
+    if (has_error()) {
+        return type_t::unknown;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->type();
+}
+
+int32_t Field::offset() const {
+    if (has_error()) {
+        return std::numeric_limits<int32_t>::max();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->offset();
+}
+
+const std::string& Field::name() const {
+    if (has_error()) {
+        return StringManager::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->name();
+}
+
+#define IS_TYPE_FWD(type)                          \
+    bool Field::is_##type() const {                \
+        if (has_error()) {                         \
+            return false;                          \
+        }                                          \
+        LLVM_BUILDER_ASSERT(m_impl);                       \
+        return m_impl->is_##type();                \
+    }                                              \
+/**/                                               \
+
+IS_TYPE_FWD(bool)
+IS_TYPE_FWD(struct_pointer)
+IS_TYPE_FWD(array_pointer)
+IS_TYPE_FWD(fn_pointer)
+IS_TYPE_FWD(int8)
+IS_TYPE_FWD(int16)
+IS_TYPE_FWD(int32)
+IS_TYPE_FWD(int64)
+IS_TYPE_FWD(uint8)
+IS_TYPE_FWD(uint16)
+IS_TYPE_FWD(uint32)
+IS_TYPE_FWD(uint64)
+IS_TYPE_FWD(float32)
+IS_TYPE_FWD(float64)
+
+#undef IS_TYPE_FWD
+
+void Field::log_values(std::ostream& os, void* data) const {
+    if (has_error()) {
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->log_values(os, data);
+}
+
+bool Field::operator == (const Field& rhs) const {
+    if (has_error() and rhs.has_error()) {
+        return true;
+    }
+    return m_impl.get() == rhs.m_impl.get();
+}
+
+Field Field::null(const std::string& log) {
+    static Field s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    Field result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+type_t Field::get_type(const TypeInfo& type) {
+    if (type.has_error()) {
+        return type_t::unknown;
+    }
+    const uint32_t l_size = type.size_in_bytes();
+    if (type.is_boolean()) {
+        return type_t::boolean;
+    } else if (type.is_pointer()) {
+        const TypeInfo& base_type = type.base_type();
+        if (base_type.is_struct()) {
+            return type_t::pointer_struct;
+        } else if (base_type.is_array() or base_type.is_vector()) {
+            return type_t::pointer_array;
+        } else if (base_type.is_function()) {
+            return type_t::pointer_fn;
+        }
+    } else if (type.is_float()) {
+        if (l_size == 4) {
+            return type_t::float32;
+        } else if (l_size == 8) {
+            return type_t::float64;
+        }
+    } else if (type.is_integer()) {
+        if (type.is_signed_integer()) {
+            if (l_size == 8) {
+                return type_t::int64;
+            } else if (l_size == 4) {
+                return type_t::int32;
+            } else if (l_size == 2) {
+                return type_t::int16;
+            } else if (l_size == 1) {
+                return type_t::int8;
+            }
+        } else {
+            LLVM_BUILDER_ASSERT(type.is_unsigned_integer());
+            if (l_size == 8) {
+                return type_t::uint64;
+            } else if (l_size == 4) {
+                return type_t::uint32;
+            } else if (l_size == 2) {
+                return type_t::uint16;
+            } else if (l_size == 1) {
+                return type_t::uint8;
+            }
+        }
+    }
+    return type_t::unknown;
+}
+
+uint32_t Field::get_raw_size(const TypeInfo& type) {
+    if (type.has_error()) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    const uint32_t l_size = type.size_in_bytes();
+    if (type.is_pointer()) {
+        return sizeof(int*);
+    } else if (type.is_scalar()) {
+        return l_size;
+    } else {
+        return std::numeric_limits<uint32_t>::max();
+    }
+}
+
+//
+// Struct::Impl
+//
+class Struct::Impl : meta::noncopyable {
+    const std::string m_name;
+    const int32_t m_size = 0;
+    // largest natural alignment of a field
+    uint32_t m_alignment = 1;
+    std::unordered_map<std::string, Field> m_fields;
+    std::vector<std::string> m_field_names;
+public:
+    explicit Impl(const Struct& parent, const TypeInfo &type)
+        : m_name{type.struct_name()}, m_size{(int32_t)type.struct_size_bytes()} {
+        LLVM_BUILDER_ASSERT(type.is_struct());
+        const uint32_t l_num_fields = type.num_elements();
+        for (uint32_t i = 0; i != l_num_fields; ++i) {
+            field_entry_t l_field = type[i];
+            const std::string field_name = l_field.name();
+            LLVM_BUILDER_ASSERT(l_field.idx() == i);
+            LLVM_BUILDER_DEBUG(auto it = ) m_fields.try_emplace(field_name, parent, l_field.idx(), l_field.offset(), field_name, l_field.type(), Field::construct_t{});
+            LLVM_BUILDER_ASSERT(it.second);
+            m_field_names.emplace_back(field_name);
+            // nested aggregates are made of scalars of at most 8 bytes
+            const uint32_t l_raw_size = Field::get_raw_size(l_field.type());
+            m_alignment = std::max(m_alignment, l_raw_size == std::numeric_limits<uint32_t>::max() ? static_cast<uint32_t>(alignof(uint64_t)) : l_raw_size);
+        }
+        LLVM_BUILDER_ASSERT(num_fields() == (int32_t)type.num_elements());
+    }
+    ~Impl() = default;
+public:
+    const std::string &name() const {
+        return m_name;
+    }
+    Object mk_object(const Struct& parent) const {
+        Object l_object{parent};
+        LLVM_BUILDER_ASSERT(l_object.m_impl);
+        LLVM_BUILDER_ASSERT(not l_object.has_error());
+        return l_object;
+    }
+    int32_t size_in_bytes() const {
+        return m_size;
+    }
+    uint32_t alignment() const {
+        return m_alignment;
+    }
+    int32_t num_fields() const {
+        return (int32_t)m_fields.size();
+    }
+    const std::vector<std::string>& field_names() const {
+        return m_field_names;
+    }
+    Field operator[](const std::string &s) const {
+        if (m_fields.contains(s)) {
+            return m_fields.at(s);
+        } else {
+            return Field::null();
+        }
+    }
+    void log_values(std::ostream& os, void* data, uint32_t size) const {
+        if (data != nullptr) {
+            os << "\n";
+            for (const std::string& fname : m_field_names) {
+                os << fname << ":";
+                const Field& l_field = m_fields.at(fname);
+                if (l_field.offset() < (int32_t)size) {
+                    l_field.log_values(os, (char*)data + l_field.offset());
+                } else {
+                    os << "<NULL>";
+                }
+                os << ";\n";
+            }
+        } else {
+            os << "<INVALID_BUFFER>";
+        }
+    }
+};
+
+//
+// Struct
+//
+Struct::Struct() : BaseT{State::ERROR} {
+}
+
+Struct::Struct(const TypeInfo& type, construct_t)
+  : BaseT{State::VALID} {
+    if (not type.is_struct()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "Type not a struct:" << type.short_name());
+    } else {
+        m_impl = std::make_shared<Impl>(*this, type);
+    }
+}
+
+const std::string& Struct::name() const {
+    if (has_error()) {
+        return StringManager::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->name();
+}
+
+int32_t Struct::size_in_bytes() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->size_in_bytes();
+}
+
+int32_t Struct::num_fields() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->num_fields();
+}
+
+const std::vector<std::string>& Struct::field_names() const {
+    if (has_error()) {
+        static const std::vector<std::string> l_null_vec{};
+        return l_null_vec;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->field_names();
+}
+
+void Struct::log_values(std::ostream& os, void* data, uint32_t size) const {
+    if (has_error()) {
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    m_impl->log_values(os, data, size);
+}
+
+
+Object Struct::mk_object() const {
+    if (has_error()) {
+        return Object::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->mk_object(*this);
+}
+
+Object Struct::mk_object(const SharedRegion& region, const std::string& name) const {
+    if (has_error() or region.has_error()) {
+        return Object::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    LLVM_BUILDER_ASSERT(region.m_impl);
+    const uint64_t l_size = static_cast<uint64_t>(size_in_bytes());
+    void* l_buf = region.m_impl->allocate(name, this->name(), l_size, SharedRegion::Impl::c_kind_object, 0, 0);
+    if (l_buf == nullptr) {
+        return Object::null(LLVM_BUILDER_CONCAT << "can't allocate object in shared region:" << name);
+    }
+    Object l_object{*this, region.m_impl, l_buf, false};
+    l_object.m_impl->set_region(region.m_impl.get());
+    return l_object;
+}
+
+Object Struct::find_object(const SharedRegion& region, const std::string& name) const {
+    if (has_error() or region.has_error()) {
+        return Object::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    LLVM_BUILDER_ASSERT(region.m_impl);
+    const SharedMemory::Entry* l_entry = region.m_impl->find(name);
+    if (l_entry == nullptr) {
+        return Object::null(LLVM_BUILDER_CONCAT << "object not found in shared region:" << name);
+    }
+    if (l_entry->m_kind != SharedRegion::Impl::c_kind_object
+          or l_entry->m_size != static_cast<uint64_t>(size_in_bytes())
+          or this->name() != l_entry->m_type_name) {
+        return Object::null(LLVM_BUILDER_CONCAT << "object in shared region is not instance of struct " << this->name() << ":" << name);
+    }
+    // links are stored as creator's pointers for events to follow, they are valid
+    // only where the region is mapped at the creator's address
+    if (not region.m_impl->is_at_creator_base() and region.m_impl->has_links(*l_entry)) {
+        return Object::null(LLVM_BUILDER_CONCAT << "object in shared region links other allocations and region isn't mapped at its creator's address:" << name);
+    }
+    Object l_object{*this, region.m_impl, region.m_impl->at(l_entry->m_offset), true};
+    l_object.m_impl->set_region(region.m_impl.get());
+    return l_object;
+}
+
+Object Struct::wrap(void* buf, const buffer_deleter_t& deleter) const {
+    if (has_error()) {
+        return Object::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (buf == nullptr) {
+        return Object::null("can't wrap a null buffer");
+    }
+    if (reinterpret_cast<uintptr_t>(buf) % m_impl->alignment() != 0) {
+        return Object::null(LLVM_BUILDER_CONCAT << "buffer is not aligned for struct " << name() << ":" << m_impl->alignment());
+    }
+    return Object{*this, mk_external_owner(buf, deleter), buf, false};
+}
+
+Field Struct::operator[] (const std::string& s) const {
+    if (has_error()) {
+        return Field::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->operator[](s);
+}
+
+bool Struct::operator == (const Struct& rhs) const {
+    if (has_error() and rhs.has_error()) {
+        return true;
+    }
+    return m_impl.get() == rhs.m_impl.get();
+}
+
+Struct Struct::null(const std::string& log) {
+    static Struct s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    Struct result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+//
+// EventFn::Impl
+//
+class EventFn::Impl : meta::noncopyable {
+    JustInTimeRunner& m_runner;
+    const std::string m_name;
+    const FieldAccess m_field_access;
+    event_fn_t* m_event_fn = nullptr;
+    // created up front, so the event thread never sees a recorder being replaced
+    mutable LatencyRecorder m_latency;
+    mutable PerfCounterRecorder m_perf{1};
+    const bool m_is_kernel = false;
+    bool m_is_init = false;
+    std::atomic<bool> m_is_instrumented{false};
+    std::atomic<bool> m_has_perf_counters{false};
+public:
+    explicit Impl(JustInTimeRunner& runner, const std::string& name, const FieldAccess& field_access)
+        : m_runner{runner}, m_name{name}, m_field_access{field_access}, m_is_kernel{is_kernel_name(name)} {
+    }
+    ~Impl() = default;
+public:
+    const std::string& name() const {
+        return m_name;
+    }
+    const FieldAccess& field_access() const {
+        return m_field_access;
+    }
+    bool is_init() const {
+        return m_is_init;
+    }
+    bool is_kernel() const {
+        return m_is_kernel;
+    }
+    event_fn_t* fn_ptr() const {
+        LLVM_BUILDER_ASSERT(is_init());
+        return m_event_fn;
+    }
+    void init() {
+        if (not is_init()) {
+            m_event_fn = m_runner.get_fn(m_name);
+        }
+        m_is_init = true;
+    }
+    int32_t on_event(const Object &o) const {
+        LLVM_BUILDER_ASSERT(is_init());
+        LLVM_BUILDER_ASSERT(not o.has_error());
+        LLVM_BUILDER_ASSERT(not ErrorContext::has_error());
+        LLVM_BUILDER_ASSERT(o.is_frozen());
+        // TODO{vibhanshu}: add check that struct type is compatible
+        //    with event
+        capture_in_place(o);
+        void* l_ctx = o.m_impl->begin_event();
+        const int32_t l_result = on_context(l_ctx);
+        o.m_impl->end_event();
+        return l_result;
+    }
+    // runs event on a raw context buffer, recording latency / counters if enabled
+    int32_t on_context(void* ctx) const {
+        const bool l_is_instrumented = m_is_instrumented.load(std::memory_order_acquire);
+        const bool l_has_perf_counters = m_has_perf_counters.load(std::memory_order_acquire);
+        if (l_is_instrumented or l_has_perf_counters) {
+            return M_on_event_instrumented(ctx, l_is_instrumented, l_has_perf_counters);
+        }
+        return m_event_fn(ctx);
+    }
+    int32_t on_columns(std::vector<void*>& columns, const std::vector<int64_t>& strides, uint64_t num_rows, uint64_t* num_processed) const {
+        LLVM_BUILDER_ASSERT(is_init());
+        LLVM_BUILDER_ASSERT(is_kernel());
+        LLVM_BUILDER_ASSERT(columns.size() == strides.size());
+        KernelArgs l_args{columns.data(), strides.data(), num_rows, 0};
+        const int32_t l_result = m_event_fn(&l_args);
+        if (num_processed != nullptr) {
+            *num_processed = l_args.num_processed;
+        }
+        return l_result;
+    }
+    void set_instrumented(bool value) {
+        m_is_instrumented.store(value, std::memory_order_release);
+    }
+    bool is_instrumented() const {
+        return m_is_instrumented.load(std::memory_order_acquire);
+    }
+    uint64_t call_count() const {
+        return m_latency.count();
+    }
+    LatencyHistogram latency_histogram() const {
+        return m_latency.snapshot();
+    }
+    LatencyHistogram reset_latency_histogram() {
+        LatencyHistogram l_result = m_latency.snapshot();
+        m_latency.reset();
+        return l_result;
+    }
+    bool enable_perf_counters(uint32_t sample_every) {
+        if (not PerfCounterGroup::thread_group().is_valid()) {
+            return false;
+        }
+        m_perf.set_sample_every(sample_every);
+        m_has_perf_counters.store(true, std::memory_order_release);
+        return true;
+    }
+    void disable_perf_counters() {
+        m_has_perf_counters.store(false, std::memory_order_release);
+    }
+    bool has_perf_counters() const {
+        return m_has_perf_counters.load(std::memory_order_acquire);
+    }
+    PerfCounters perf_counters() const {
+        return m_perf.snapshot();
+    }
+    PerfCounters reset_perf_counters() {
+        PerfCounters l_result = m_perf.snapshot();
+        m_perf.reset();
+        return l_result;
+    }
+private:
+    int32_t M_on_event_instrumented(void* ctx, bool is_instrumented, bool has_perf_counters) const {
+        // counters are read outside of the rdtsc window, so latency does not include read() syscall
+        PerfCounters::values_t l_start_counters;
+        PerfCounterGroup* l_group = nullptr;
+        if (has_perf_counters and m_perf.next_call()) {
+            l_group = &PerfCounterGroup::thread_group();
+            if (not l_group->read(l_start_counters)) {
+                l_group = nullptr;
+            }
+        }
+        const uint64_t l_start = is_instrumented ? Debug::rdtsc() : 0;
+        const int32_t l_result = m_event_fn(ctx);
+        if (is_instrumented) {
+            m_latency.record(Debug::rdtsc() - l_start);
+        }
+        if (l_group != nullptr) {
+            PerfCounters::values_t l_end_counters;
+            if (l_group->read(l_end_counters)) {
+                m_perf.record(l_start_counters, l_end_counters, l_group->available_mask());
+            }
+        }
+        return l_result;
+    }
+};
+
+//
+// EventFn
+//
+EventFn::EventFn() : BaseT{State::ERROR} {
+}
+
+EventFn::EventFn(JustInTimeRunner& runner, const std::string& name, const FieldAccess& field_access, construct_t)
+    : BaseT{State::VALID} {
+    m_impl = std::make_shared<Impl>(runner, name, field_access);
+}
+
+const std::string& EventFn::name() const {
+    if (has_error()) {
+        return StringManager::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->name();
+}
+
+const FieldAccess& EventFn::field_access() const {
+    static const FieldAccess s_empty{};
+    if (has_error()) {
+        return s_empty;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->field_access();
+}
+
+bool EventFn::is_init() const {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->is_init();
+}
+
+void EventFn::init() {
+    if (has_error()) {
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    m_impl->init();
+}
+
+int32_t EventFn::on_event(const Object& o) const {
+    if (has_error() or o.has_error()) {
+        return -1;
+    }
+    if (ErrorContext::has_error()) {
+        M_mark_error("can't run event when there are outstanding error");
+        return -1;
+    }
+    if (not o.is_frozen()) {
+        M_mark_error("can't use a object which is not frozen yet");
+        return -1;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->is_kernel()) {
+        M_mark_error("kernel can only be run with on_columns()");
+        return -1;
+    }
+    return m_impl->on_event(o);
+}
+
+std::vector<int32_t> EventFn::on_event_many(const std::vector<Object>& objects) const {
+    if (has_error()) {
+        return {};
+    }
+    if (ErrorContext::has_error()) {
+        M_mark_error("can't run event when there are outstanding error");
+        return {};
+    }
+    for (const Object& o : objects) {
+        if (o.has_error()) {
+            return {};
+        }
+        if (not o.is_frozen()) {
+            M_mark_error("can't use a object which is not frozen yet");
+            return {};
+        }
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->is_kernel()) {
+        M_mark_error("kernel can only be run with on_columns()");
+        return {};
+    }
+    std::vector<int32_t> l_results;
+    l_results.reserve(objects.size());
+    for (const Object& o : objects) {
+        l_results.emplace_back(m_impl->on_event(o));
+    }
+    return l_results;
+}
+
+int32_t EventFn::on_event_repeat(const Object& o, uint64_t n, uint64_t* num_processed) const {
+    if (num_processed != nullptr) {
+        *num_processed = 0;
+    }
+    if (has_error() or o.has_error()) {
+        return -1;
+    }
+    if (ErrorContext::has_error()) {
+        M_mark_error("can't run event when there are outstanding error");
+        return -1;
+    }
+    if (not o.is_frozen()) {
+        M_mark_error("can't use a object which is not frozen yet");
+        return -1;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->is_kernel()) {
+        M_mark_error("kernel can only be run with on_columns()");
+        return -1;
+    }
+    for (uint64_t i = 0; i != n; ++i) {
+        const int32_t l_result = m_impl->on_event(o);
+        if (l_result != 0) {
+            if (num_processed != nullptr) {
+                *num_processed = i;
+            }
+            return l_result;
+        }
+    }
+    if (num_processed != nullptr) {
+        *num_processed = n;
+    }
+    return 0;
+}
+
+int32_t EventFn::on_columns(const Object& state, const std::vector<Column>& columns, uint64_t num_rows, uint64_t* num_processed) const {
+    if (num_processed != nullptr) {
+        *num_processed = 0;
+    }
+    if (has_error() or state.has_error()) {
+        return -1;
+    }
+    if (ErrorContext::has_error()) {
+        M_mark_error("can't run event when there are outstanding error");
+        return -1;
+    }
+    if (not state.is_frozen()) {
+        M_mark_error("can't use a object which is not frozen yet");
+        return -1;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->is_kernel()) {
+        M_mark_error("event is not a kernel, generate one with Function::mk_kernel()");
+        return -1;
+    }
+    // TODO{vibhanshu}: add check that struct type is compatible
+    //    with kernel
+    const Struct l_struct = state.struct_def();
+    const std::vector<std::string>& l_field_names = l_struct.field_names();
+    std::vector<void*> l_data(l_field_names.size(), nullptr);
+    std::vector<int64_t> l_strides(l_field_names.size(), 0);
+    std::vector<bool> l_is_mapped(l_field_names.size(), false);
+    // columns are checked before begin_event(), which must be paired with end_event()
+    for (const Column& l_column : columns) {
+        const Field l_field = l_struct[l_column.field()];
+        if (l_field.has_error()) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "column field not found:" << l_column.field());
+            return -1;
+        }
+        if (l_field.is_struct_pointer() or l_field.is_array_pointer() or l_field.is_fn_pointer()) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "pointer field can't be mapped to column:" << l_column.field());
+            return -1;
+        }
+        if (l_field.type() != l_column.type()) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "column type mismatch for field:" << l_column.field());
+            return -1;
+        }
+        if (l_column.data() == nullptr and num_rows != 0) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "column has no data:" << l_column.field());
+            return -1;
+        }
+        const uint32_t l_idx = static_cast<uint32_t>(l_field.idx());
+        if (l_is_mapped[l_idx]) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "duplicate column for field:" << l_column.field());
+            return -1;
+        }
+        l_is_mapped[l_idx] = true;
+        l_data[l_idx] = l_column.data();
+        l_strides[l_idx] = l_column.stride();
+    }
+    capture_in_place(state);
+    uint8_t* l_state = static_cast<uint8_t*>(state.m_impl->begin_event());
+    for (const std::string& l_name : l_field_names) {
+        const Field l_field = l_struct[l_name];
+        const uint32_t l_idx = static_cast<uint32_t>(l_field.idx());
+        if (not l_is_mapped[l_idx]) {
+            l_data[l_idx] = l_state + l_field.offset();
+        }
+    }
+    const int32_t l_result = m_impl->on_columns(l_data, l_strides, num_rows, num_processed);
+    state.m_impl->end_event();
+    return l_result;
+}
+
+void EventFn::enable_instrumentation() {
+    if (has_error()) {
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    m_impl->set_instrumented(true);
+}
+
+void EventFn::disable_instrumentation() {
+    if (has_error()) {
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    m_impl->set_instrumented(false);
+}
+
+bool EventFn::is_instrumented() const {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->is_instrumented();
+}
+
+uint64_t EventFn::call_count() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->call_count();
+}
+
+LatencyHistogram EventFn::latency_histogram() const {
+    if (has_error()) {
+        return LatencyHistogram{};
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->latency_histogram();
+}
+
+LatencyHistogram EventFn::reset_latency_histogram() {
+    if (has_error()) {
+        return LatencyHistogram{};
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->reset_latency_histogram();
+}
+
+bool EventFn::enable_perf_counters(uint32_t sample_every) {
+    if (has_error()) {
+        return false;
+    }
+    if (sample_every == 0) {
+        M_mark_error("perf counter sampling interval can't be 0");
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->enable_perf_counters(sample_every);
+}
+
+void EventFn::disable_perf_counters() {
+    if (has_error()) {
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    m_impl->disable_perf_counters();
+}
+
+bool EventFn::has_perf_counters() const {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->has_perf_counters();
+}
+
+PerfCounters EventFn::perf_counters() const {
+    if (has_error()) {
+        return PerfCounters{};
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->perf_counters();
+}
+
+PerfCounters EventFn::reset_perf_counters() {
+    if (has_error()) {
+        return PerfCounters{};
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->reset_perf_counters();
+}
+
+bool EventFn::operator==(const EventFn &rhs) const {
+    if (has_error() and rhs.has_error()) {
+        return true;
+    }
+    return m_impl.get() == rhs.m_impl.get();
+}
+
+EventFn EventFn::null(const std::string& log) {
+    static EventFn s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    EventFn result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+//
+// EventGraph::Impl
+//
+class EventGraph::Impl : meta::noncopyable {
+    using mask_t = std::vector<uint64_t>;
+private:
+    const Namespace m_namespace;
+    const Struct m_context;
+    std::vector<std::string> m_fields;
+    std::vector<EventFn> m_events;
+    // ids of m_events in run order
+    std::vector<uint32_t> m_order;
+    // per field, positions in m_order of events downstream of it
+    std::vector<mask_t> m_field_mask;
+    bool m_is_bind = false;
+public:
+    explicit Impl(const Namespace& ns, const Struct& context)
+        : m_namespace{ns}, m_context{context}, m_fields{context.field_names()} {
+    }
+    ~Impl() = default;
+public:
+    const Struct& context() const {
+        return m_context;
+    }
+    bool is_bind() const {
+        return m_is_bind;
+    }
+    uint32_t num_events() const {
+        return static_cast<uint32_t>(m_events.size());
+    }
+    uint32_t num_fields() const {
+        return static_cast<uint32_t>(m_fields.size());
+    }
+    void add_event(const EventFn& fn) {
+        LLVM_BUILDER_ASSERT(not is_bind());
+        m_events.emplace_back(fn);
+    }
+    uint32_t field_id(const std::string& name) const {
+        auto it = std::find(m_fields.begin(), m_fields.end(), name);
+        if (it == m_fields.end()) {
+            return c_invalid_field;
+        }
+        return static_cast<uint32_t>(it - m_fields.begin());
+    }
+    // Kahn's algorithm, ready events are taken in order they were added
+    bool bind() {
+        LLVM_BUILDER_ASSERT(not is_bind());
+        const uint32_t l_num_events = num_events();
+        std::vector<std::vector<uint32_t>> l_next(l_num_events);
+        std::vector<uint32_t> l_num_prev(l_num_events, 0);
+        for (uint32_t a = 0; a != l_num_events; ++a) {
+            for (uint32_t b = 0; b != l_num_events; ++b) {
+                if (a != b and M_is_dependent(a, b)) {
+                    l_next[a].emplace_back(b);
+                    ++l_num_prev[b];
+                }
+            }
+        }
+        std::set<uint32_t> l_ready;
+        for (uint32_t i = 0; i != l_num_events; ++i) {
+            if (l_num_prev[i] == 0) {
+                l_ready.emplace(i);
+            }
+        }
+        while (not l_ready.empty()) {
+            const uint32_t l_id = *l_ready.begin();
+            l_ready.erase(l_ready.begin());
+            m_order.emplace_back(l_id);
+            for (uint32_t l_next_id : l_next[l_id]) {
+                if (--l_num_prev[l_next_id] == 0) {
+                    l_ready.emplace(l_next_id);
+                }
+            }
+        }
+        if (m_order.size() != l_num_events) {
+            m_order.clear();
+            return false;
+        }
+        // downstream of an event is known once events after it in run order are done
+        std::vector<mask_t> l_downstream(l_num_events, M_empty_mask());
+        for (uint32_t p = l_num_events; p != 0; --p) {
+            const uint32_t l_id = m_order[p - 1];
+            mask_t& l_mask = l_downstream[l_id];
+            M_set(l_mask, p - 1);
+            for (uint32_t l_next_id : l_next[l_id]) {
+                M_merge(l_mask, l_downstream[l_next_id]);
+            }
+        }
+        m_field_mask.assign(num_fields(), M_empty_mask());
+        for (uint32_t f = 0; f != num_fields(); ++f) {
+            for (uint32_t i = 0; i != l_num_events; ++i) {
+                if (m_events[i].field_access().is_read(m_fields[f])) {
+                    M_merge(m_field_mask[f], l_downstream[i]);
+                }
+            }
+        }
+        m_is_bind = true;
+        return true;
+    }
+    mask_t mask_of(const std::vector<uint32_t>& field_ids) const {
+        LLVM_BUILDER_ASSERT(is_bind());
+        mask_t l_mask = M_empty_mask();
+        for (uint32_t l_id : field_ids) {
+            LLVM_BUILDER_ASSERT(l_id < num_fields());
+            M_merge(l_mask, m_field_mask[l_id]);
+        }
+        return l_mask;
+    }
+    std::vector<std::string> affected_events(const mask_t& mask) const {
+        std::vector<std::string> l_names;
+        for (uint32_t p = 0; p != m_order.size(); ++p) {
+            if (M_test(mask, p)) {
+                l_names.emplace_back(m_events[m_order[p]].name());
+            }
+        }
+        return l_names;
+    }
+    int32_t run(const Object& o, const mask_t& mask) const {
+        LLVM_BUILDER_ASSERT(is_bind());
+        for (uint32_t w = 0; w != mask.size(); ++w) {
+            uint64_t l_bits = mask[w];
+            while (l_bits != 0) {
+                const uint32_t p = w * 64 + static_cast<uint32_t>(std::countr_zero(l_bits));
+                l_bits &= l_bits - 1;
+                const int32_t l_result = m_events[m_order[p]].m_impl->on_event(o);
+                if (l_result != 0) {
+                    return l_result;
+                }
+            }
+        }
+        return 0;
+    }
+    std::vector<std::string> trigger_fields(const std::string& event) const {
+        return m_namespace.trigger_fields(event);
+    }
+private:
+    // `b` reads a field `a` writes
+    bool M_is_dependent(uint32_t a, uint32_t b) const {
+        const FieldAccess& l_a = m_events[a].field_access();
+        const FieldAccess& l_b = m_events[b].field_access();
+        if (l_a.is_opaque() or l_b.is_opaque()) {
+            return true;
+        }
+        for (const std::string& l_field : l_a.writes()) {
+            if (l_b.is_read(l_field)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    mask_t M_empty_mask() const {
+        return mask_t((m_events.size() + 63) / 64, 0);
+    }
+    static void M_set(mask_t& mask, uint32_t p) {
+        mask[p / 64] |= uint64_t{1} << (p % 64);
+    }
+    static bool M_test(const mask_t& mask, uint32_t p) {
+        return (mask[p / 64] >> (p % 64)) & 1;
+    }
+    static void M_merge(mask_t& dst, const mask_t& src) {
+        LLVM_BUILDER_ASSERT(dst.size() == src.size());
+        for (size_t i = 0; i != dst.size(); ++i) {
+            dst[i] |= src[i];
+        }
+    }
+};
+
+//
+// EventGraph
+//
+EventGraph::EventGraph() : BaseT{State::ERROR} {
+}
+
+EventGraph::EventGraph(const Namespace& ns, const Struct& context)
+    : BaseT{State::VALID} {
+    if (ns.has_error() or context.has_error()) {
+        M_mark_error();
+    } else {
+        m_impl = std::make_shared<Impl>(ns, context);
+    }
+}
+
+bool EventGraph::add_event(const EventFn& fn) {
+    if (has_error() or fn.has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    LLVM_BUILDER_ASSERT(fn.m_impl);
+    if (m_impl->is_bind()) {
+        M_mark_error("can't add event to a bound event graph");
+        return false;
+    }
+    if (not fn.is_init() or fn.m_impl->is_kernel()) {
+        M_mark_error("event must be initialized and can't be a kernel");
+        return false;
+    }
+    m_impl->add_event(fn);
+    return true;
+}
+
+bool EventGraph::bind() {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->is_bind()) {
+        M_mark_error("event graph already bound");
+        return false;
+    }
+    if (not m_impl->bind()) {
+        M_mark_error("events of event graph depend on each other in a cycle");
+        return false;
+    }
+    return true;
+}
+
+bool EventGraph::is_bind() const {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->is_bind();
+}
+
+uint32_t EventGraph::num_events() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->num_events();
+}
+
+uint32_t EventGraph::field_id(const std::string& name) const {
+    if (has_error()) {
+        return c_invalid_field;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->field_id(name);
+}
+
+std::vector<std::string> EventGraph::affected_events(const std::vector<std::string>& fields) const {
+    if (has_error()) {
+        return {};
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->is_bind()) {
+        M_mark_error("event graph not bound yet");
+        return {};
+    }
+    std::vector<uint32_t> l_ids;
+    for (const std::string& l_field : fields) {
+        const uint32_t l_id = m_impl->field_id(l_field);
+        if (l_id == c_invalid_field) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "field:" << l_field << " not found in struct:" << m_impl->context().name());
+            return {};
+        }
+        l_ids.emplace_back(l_id);
+    }
+    return m_impl->affected_events(m_impl->mask_of(l_ids));
+}
+
+int32_t EventGraph::on_change(const Object& o, const std::vector<uint32_t>& field_ids) const {
+    if (has_error() or o.has_error()) {
+        return -1;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (ErrorContext::has_error()) {
+        M_mark_error("can't run event when there are outstanding error");
+        return -1;
+    }
+    if (not m_impl->is_bind()) {
+        M_mark_error("event graph not bound yet");
+        return -1;
+    }
+    if (not o.is_frozen() or not o.is_instance_of(m_impl->context())) {
+        M_mark_error("object must be a frozen object of event graph context struct");
+        return -1;
+    }
+    for (uint32_t l_id : field_ids) {
+        if (l_id >= m_impl->num_fields()) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "unknown field id:" << l_id);
+            return -1;
+        }
+    }
+    return m_impl->run(o, m_impl->mask_of(field_ids));
+}
+
+int32_t EventGraph::on_change(const Object& o, const std::vector<std::string>& fields) const {
+    if (has_error()) {
+        return -1;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    std::vector<uint32_t> l_ids;
+    for (const std::string& l_field : fields) {
+        const uint32_t l_id = m_impl->field_id(l_field);
+        if (l_id == c_invalid_field) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "field:" << l_field << " not found in struct:" << m_impl->context().name());
+            return -1;
+        }
+        l_ids.emplace_back(l_id);
+    }
+    return on_change(o, l_ids);
+}
+
+int32_t EventGraph::on_trigger(const Object& o, const std::string& event) const {
+    if (has_error()) {
+        return -1;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    const std::vector<std::string> l_fields = m_impl->trigger_fields(event);
+    if (l_fields.empty()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "event:" << event << " has no trigger fields");
+        return -1;
+    }
+    return on_change(o, l_fields);
+}
+
+bool EventGraph::operator == (const EventGraph& rhs) const {
+    if (has_error() and rhs.has_error()) {
+        return true;
+    }
+    return m_impl.get() == rhs.m_impl.get();
+}
+
+EventGraph EventGraph::null(const std::string& log) {
+    static EventGraph s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    EventGraph result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+//
+// EventRing
+//
+// Vyukov bounded queue of event records, slot `i` is free for position p when
+// its sequence is p and holds a record when it is p + 1. Record header and
+// payload share the slot, so a payload of up to 32 bytes is published with one
+// cache line write. Either side can be shared, a shared side claims positions
+// with a CAS, otherwise with a plain store
+namespace {
+
+class EventRing : meta::noncopyable {
+    struct SlotHeader {
+        std::atomic<uint64_t> m_seq;
+        uint32_t m_event_id;
+        uint64_t m_key;
+    };
+    enum : uint32_t {
+        c_cache_line = 64,
+        c_payload_offset = 32,
+    };
+    static_assert(sizeof(SlotHeader) <= c_payload_offset);
+private:
+    const uint32_t m_payload_size = 0;
+    const uint32_t m_slot_size = 0;
+    const uint32_t m_capacity = 0;
+    const bool m_multi_producer = true;
+    const bool m_multi_consumer = false;
+    char* m_slots = nullptr;
+    // producer and consumer side are on separate cache lines
+    alignas(c_cache_line) std::atomic<uint64_t> m_tail{0};
+    alignas(c_cache_line) std::atomic<uint64_t> m_head{0};
+public:
+    // capacity is rounded up to power of 2
+    explicit EventRing(uint32_t payload_size, uint32_t capacity, bool multi_producer, bool multi_consumer)
+        : m_payload_size{payload_size}
+        , m_slot_size{M_align(c_payload_offset + payload_size, c_cache_line)}
+        , m_capacity{std::bit_ceil(capacity)}
+        , m_multi_producer{multi_producer}
+        , m_multi_consumer{multi_consumer} {
+        LLVM_BUILDER_ASSERT(m_capacity > 0);
+        // aligned_alloc() wants a multiple of the alignment
+        const uint64_t l_num_bytes = (uint64_t{m_slot_size} * m_capacity + c_cache_line - 1) / c_cache_line * c_cache_line;
+        m_slots = static_cast<char*>(std::aligned_alloc(c_cache_line, l_num_bytes));
+        if (m_slots == nullptr) {
+            return;
+        }
+        std::memset(m_slots, 0, l_num_bytes);
+        for (uint32_t i = 0; i != m_capacity; ++i) {
+            new (&M_slot(i)) SlotHeader{};
+            M_slot(i).m_seq.store(i, std::memory_order_relaxed);
+        }
+    }
+    ~EventRing() {
+        std::free(m_slots);
+        m_slots = nullptr;
+    }
+public:
+    // false if slots could not be allocated, ring must not be used then
+    bool is_valid() const {
+        return m_slots != nullptr;
+    }
+    uint32_t capacity() const {
+        return m_capacity;
+    }
+    bool try_push(uint32_t event_id, uint64_t key, const void* payload) {
+        uint64_t l_pos = 0;
+        if (not M_claim(m_tail, 0, m_multi_producer, l_pos)) {
+            return false;
+        }
+        SlotHeader& l_slot = M_slot(l_pos);
+        l_slot.m_event_id = event_id;
+        l_slot.m_key = key;
+        std::memcpy(M_payload(l_slot), payload, m_payload_size);
+        l_slot.m_seq.store(l_pos + 1, std::memory_order_release);
+        return true;
+    }
+    // calls fn(event_id, key, payload) on the oldest record, slot is released once it returns
+    template <typename FnT>
+    bool try_pop(FnT&& fn) {
+        uint64_t l_pos = 0;
+        if (not M_claim(m_head, 1, m_multi_consumer, l_pos)) {
+            return false;
+        }
+        SlotHeader& l_slot = M_slot(l_pos);
+        fn(l_slot.m_event_id, l_slot.m_key, M_payload(l_slot));
+        l_slot.m_seq.store(l_pos + m_capacity, std::memory_order_release);
+        return true;
+    }
+private:
+    SlotHeader& M_slot(uint64_t pos) const {
+        return *reinterpret_cast<SlotHeader*>(m_slots + (pos & (m_capacity - 1)) * m_slot_size);
+    }
+    static void* M_payload(SlotHeader& slot) {
+        return reinterpret_cast<char*>(&slot) + c_payload_offset;
+    }
+    // slot at `counter` is ready once its sequence reaches position + `ready`
+    bool M_claim(std::atomic<uint64_t>& counter, uint64_t ready, bool is_shared, uint64_t& pos) const {
+        pos = counter.load(std::memory_order_relaxed);
+        if (not is_shared) {
+            if (M_slot(pos).m_seq.load(std::memory_order_acquire) != pos + ready) {
+                return false;
+            }
+            counter.store(pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+        while (true) {
+            const uint64_t l_seq = M_slot(pos).m_seq.load(std::memory_order_acquire);
+            const int64_t l_diff = static_cast<int64_t>(l_seq - (pos + ready));
+            if (l_diff == 0) {
+                if (counter.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    return true;
+                }
+            } else if (l_diff < 0) {
+                return false;
+            } else {
+                pos = counter.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    static uint32_t M_align(uint32_t v, uint32_t alignment) {
+        return (v + alignment - 1) / alignment * alignment;
+    }
+};
+
+bool pin_thread(std::thread& thread, int32_t cpu) {
+#if defined(__linux__)
+    cpu_set_t l_set;
+    CPU_ZERO(&l_set);
+    CPU_SET(static_cast<uint32_t>(cpu), &l_set);
+    return ::pthread_setaffinity_np(thread.native_handle(), sizeof(l_set), &l_set) == 0;
+#else
+    (void)thread;
+    (void)cpu;
+    return false;
+#endif
+}
+
+} // namespace
+
+//
+// EventQueue::Impl
+//
+class EventQueue::Impl : meta::noncopyable {
+private:
+    const Struct m_struct;
+    EventRing m_ring;
+    std::vector<EventFn> m_events;
+    alignas(64) std::atomic<uint64_t> m_num_dispatched{0};
+    std::atomic<uint64_t> m_num_failed{0};
+    std::atomic<bool> m_stop{false};
+    // read by producers, m_thread is only touched by the owner
+    std::atomic<bool> m_is_running{false};
+    std::thread m_thread;
+public:
+    explicit Impl(const Struct& context, uint32_t capacity, producer_t producer)
+        : m_struct{context}
+        , m_ring{static_cast<uint32_t>(context.size_in_bytes()), capacity, producer == producer_t::multi, false} {
+    }
+    ~Impl() {
+        stop();
+    }
+public:
+    const Struct& struct_def() const {
+        return m_struct;
+    }
+    bool is_valid() const {
+        return m_ring.is_valid();
+    }
+    uint32_t capacity() const {
+        return m_ring.capacity();
+    }
+    uint32_t num_events() const {
+        return static_cast<uint32_t>(m_events.size());
+    }
+    uint32_t add_event(const EventFn& fn) {
+        LLVM_BUILDER_ASSERT(fn.is_init());
+        LLVM_BUILDER_ASSERT(not is_running());
+        m_events.emplace_back(fn);
+        return num_events() - 1;
+    }
+    bool try_publish(uint32_t event_id, const void* payload) {
+        return m_ring.try_push(event_id, 0, payload);
+    }
+    uint64_t poll(uint64_t max_events) {
+        uint64_t l_count = 0;
+        while (l_count != max_events and M_dispatch_one()) {
+            ++l_count;
+        }
+        return l_count;
+    }
+    bool is_running() const {
+        return m_is_running.load(std::memory_order_acquire);
+    }
+    bool start(int32_t cpu) {
+        LLVM_BUILDER_ASSERT(not is_running());
+        m_stop.store(false, std::memory_order_relaxed);
+        m_is_running.store(true, std::memory_order_release);
+        m_thread = std::thread{[this] { M_run(); }};
+        if (cpu >= 0 and not pin_thread(m_thread, cpu)) {
+            stop();
+            return false;
+        }
+        return true;
+    }
+    void stop() {
+        if (m_thread.joinable()) {
+            m_stop.store(true, std::memory_order_release);
+            m_thread.join();
+        }
+        // cleared once the ring is drained, so spinning producers give up
+        m_is_running.store(false, std::memory_order_release);
+    }
+    uint64_t num_dispatched() const {
+        return m_num_dispatched.load(std::memory_order_relaxed);
+    }
+    uint64_t num_failed() const {
+        return m_num_failed.load(std::memory_order_relaxed);
+    }
+private:
+    bool M_dispatch_one() {
+        return m_ring.try_pop([this](uint32_t event_id, uint64_t, void* payload) {
+            if (m_events[event_id].m_impl->on_context(payload) != 0) {
+                m_num_failed.fetch_add(1, std::memory_order_relaxed);
+            }
+            m_num_dispatched.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+    void M_run() {
+        while (not m_stop.load(std::memory_order_acquire)) {
+            if (not M_dispatch_one()) {
+                Debug::cpu_relax();
+            }
+        }
+        // drain what was published before stop()
+        while (M_dispatch_one()) {
+        }
+    }
+};
+
+//
+// EventQueue
+//
+EventQueue::EventQueue() : BaseT{State::ERROR} {
+}
+
+EventQueue::EventQueue(const Struct& context, uint32_t capacity, producer_t producer)
+    : BaseT{State::VALID} {
+    if (context.has_error()) {
+        M_mark_error();
+    } else if (capacity == 0 or capacity > (1u << 31)) {
+        M_mark_error("event queue capacity must be in [1, 2^31]");
+    } else {
+        m_impl = std::make_shared<Impl>(context, capacity, producer);
+        if (not m_impl->is_valid()) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "can't allocate event queue of capacity:" << capacity);
+            m_impl.reset();
+        }
+    }
+}
+
+uint32_t EventQueue::capacity() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->capacity();
+}
+
+uint32_t EventQueue::add_event(const EventFn& fn) {
+    if (has_error() or fn.has_error()) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    LLVM_BUILDER_ASSERT(fn.m_impl);
+    if (m_impl->is_running()) {
+        M_mark_error("can't add event while dispatcher is running");
+        return std::numeric_limits<uint32_t>::max();
+    }
+    if (not fn.is_init() or fn.m_impl->is_kernel()) {
+        M_mark_error("event must be initialized and can't be a kernel");
+        return std::numeric_limits<uint32_t>::max();
+    }
+    return m_impl->add_event(fn);
+}
+
+bool EventQueue::try_publish(uint32_t event_id, const Object& payload) const {
+    if (has_error() or payload.has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (event_id >= m_impl->num_events()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "unknown event id:" << event_id);
+        return false;
+    }
+    if (not payload.is_frozen() or not payload.is_instance_of(m_impl->struct_def())) {
+        M_mark_error("payload must be a frozen object of queue context struct");
+        return false;
+    }
+    return m_impl->try_publish(event_id, payload.ref());
+}
+
+bool EventQueue::publish(uint32_t event_id, const Object& payload) const {
+    if (has_error() or payload.has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (event_id >= m_impl->num_events()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "unknown event id:" << event_id);
+        return false;
+    }
+    if (not payload.is_frozen() or not payload.is_instance_of(m_impl->struct_def())) {
+        M_mark_error("payload must be a frozen object of queue context struct");
+        return false;
+    }
+    void* l_payload = payload.ref();
+    while (not m_impl->try_publish(event_id, l_payload)) {
+        if (not m_impl->is_running()) {
+            M_mark_error("queue is full and dispatcher is not running");
+            return false;
+        }
+        Debug::cpu_relax();
+    }
+    return true;
+}
+
+uint64_t EventQueue::poll(uint64_t max_events) const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->is_running()) {
+        M_mark_error("can't poll while dispatcher is running");
+        return 0;
+    }
+    return m_impl->poll(max_events);
+}
+
+bool EventQueue::start(int32_t cpu) {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->is_running()) {
+        M_mark_error("dispatcher already running");
+        return false;
+    }
+    return m_impl->start(cpu);
+}
+
+void EventQueue::stop() {
+    if (has_error()) {
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    m_impl->stop();
+}
+
+bool EventQueue::is_running() const {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->is_running();
+}
+
+uint64_t EventQueue::num_dispatched() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->num_dispatched();
+}
+
+uint64_t EventQueue::num_failed() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->num_failed();
+}
+
+bool EventQueue::operator == (const EventQueue& rhs) const {
+    if (has_error() and rhs.has_error()) {
+        return true;
+    }
+    return m_impl.get() == rhs.m_impl.get();
+}
+
+EventQueue EventQueue::null(const std::string& log) {
+    static EventQueue s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    EventQueue result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+//
+// ShardedExecutor::Impl
+//
+// Each worker consumes its own keyed ring (many producers, one consumer) and
+// stateless ring (shared by all workers), when both are empty it steals from
+// stateless rings of other workers. Keyed events never leave their worker, so
+// state objects and the key map of a worker are only touched by its thread
+class ShardedExecutor::Impl : meta::noncopyable {
+    struct InputField {
+        uint32_t m_offset;
+        uint32_t m_size;
+    };
+    struct Worker : meta::noncopyable {
+        EventRing m_keyed;
+        EventRing m_stateless;
+        std::vector<Object> m_pool;
+        // buffers of m_pool, Object api is not used on worker thread
+        std::vector<void*> m_pool_bufs;
+        // key -> idx in m_pool
+        std::unordered_map<uint64_t, uint32_t> m_keys;
+        std::thread m_thread;
+        // written by worker thread only, kept off the lines producers touch
+        alignas(64) std::atomic<uint64_t> m_num_dispatched{0};
+        std::atomic<uint64_t> m_num_failed{0};
+        std::atomic<uint64_t> m_num_dropped{0};
+        std::atomic<uint64_t> m_num_stolen{0};
+    public:
+        explicit Worker(uint32_t payload_size, uint32_t capacity)
+            : m_keyed{payload_size, capacity, true, false}
+            , m_stateless{payload_size, capacity, true, true} {
+        }
+    };
+private:
+    const Struct m_struct;
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<EventFn> m_events;
+    std::vector<InputField> m_inputs;
+    alignas(64) std::atomic<uint64_t> m_num_submitted{0};
+    std::atomic<uint32_t> m_next_stateless{0};
+    std::atomic<bool> m_is_running{false};
+    std::atomic<bool> m_stop{false};
+public:
+    explicit Impl(const Struct& state, uint32_t num_workers, uint32_t queue_capacity)
+        : m_struct{state} {
+        const uint32_t l_payload_size = static_cast<uint32_t>(state.size_in_bytes());
+        for (uint32_t i = 0; i != num_workers; ++i) {
+            m_workers.emplace_back(std::make_unique<Worker>(l_payload_size, queue_capacity));
+        }
+    }
+    ~Impl() {
+        stop();
+    }
+public:
+    const Struct& struct_def() const {
+        return m_struct;
+    }
+    bool is_valid() const {
+        for (const std::unique_ptr<Worker>& l_worker : m_workers) {
+            if (not l_worker->m_keyed.is_valid() or not l_worker->m_stateless.is_valid()) {
+                return false;
+            }
+        }
+        return true;
+    }
+    uint32_t num_workers() const {
+        return static_cast<uint32_t>(m_workers.size());
+    }
+    uint32_t num_events() const {
+        return static_cast<uint32_t>(m_events.size());
+    }
+    void add_state(uint32_t worker, const Object& obj) {
+        m_workers[worker]->m_pool.emplace_back(obj);
+        m_workers[worker]->m_pool_bufs.emplace_back(obj.ref());
+    }
+    uint32_t add_event(const EventFn& fn) {
+        LLVM_BUILDER_ASSERT(fn.is_init());
+        LLVM_BUILDER_ASSERT(not is_running());
+        m_events.emplace_back(fn);
+        return num_events() - 1;
+    }
+    void add_input_field(uint32_t offset, uint32_t size) {
+        LLVM_BUILDER_ASSERT(not is_running());
+        m_inputs.emplace_back(InputField{offset, size});
+    }
+    uint32_t worker_of(uint64_t key) const {
+        return static_cast<uint32_t>(M_mix(key) % m_workers.size());
+    }
+    bool try_submit(uint64_t key, uint32_t event_id, const void* payload) {
+        if (not m_workers[worker_of(key)]->m_keyed.try_push(event_id, key, payload)) {
+            return false;
+        }
+        m_num_submitted.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    bool try_submit_stateless(uint32_t event_id, const void* payload) {
+        // round robin, stealing evens out what is left
+        const uint32_t l_worker = m_next_stateless.fetch_add(1, std::memory_order_relaxed) % num_workers();
+        if (not m_workers[l_worker]->m_stateless.try_push(event_id, 0, payload)) {
+            return false;
+        }
+        m_num_submitted.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    bool is_running() const {
+        return m_is_running.load(std::memory_order_acquire);
+    }
+    bool start(const std::vector<int32_t>& cpus) {
+        LLVM_BUILDER_ASSERT(not is_running());
+        m_stop.store(false, std::memory_order_relaxed);
+        m_is_running.store(true, std::memory_order_release);
+        bool l_is_pinned = true;
+        for (uint32_t i = 0; i != num_workers(); ++i) {
+            Worker& l_worker = *m_workers[i];
+            l_worker.m_thread = std::thread{[this, i] { M_run(i); }};
+            if (i < cpus.size() and cpus[i] >= 0) {
+                l_is_pinned = pin_thread(l_worker.m_thread, cpus[i]) and l_is_pinned;
+            }
+        }
+        if (not l_is_pinned) {
+            stop();
+            return false;
+        }
+        return true;
+    }
+    void drain() const {
+        const uint64_t l_num_submitted = m_num_submitted.load(std::memory_order_relaxed);
+        while (num_dispatched() + num_dropped() < l_num_submitted) {
+            Debug::cpu_relax();
+        }
+    }
+    void stop() {
+        if (not is_running()) {
+            return;
+        }
+        m_stop.store(true, std::memory_order_release);
+        for (std::unique_ptr<Worker>& l_worker : m_workers) {
+            l_worker->m_thread.join();
+        }
+        m_is_running.store(false, std::memory_order_release);
+    }
+    const Object* state(uint64_t key) const {
+        LLVM_BUILDER_ASSERT(not is_running());
+        const Worker& l_worker = *m_workers[worker_of(key)];
+        auto l_it = l_worker.m_keys.find(key);
+        if (l_it == l_worker.m_keys.end()) {
+            return nullptr;
+        }
+        return &l_worker.m_pool[l_it->second];
+    }
+    uint64_t num_keys() const {
+        LLVM_BUILDER_ASSERT(not is_running());
+        uint64_t l_count = 0;
+        for (const std::unique_ptr<Worker>& l_worker : m_workers) {
+            l_count += l_worker->m_keys.size();
+        }
+        return l_count;
+    }
+    uint64_t num_dispatched() const {
+        return M_sum(&Worker::m_num_dispatched);
+    }
+    uint64_t num_failed() const {
+        return M_sum(&Worker::m_num_failed);
+    }
+    uint64_t num_dropped() const {
+        return M_sum(&Worker::m_num_dropped);
+    }
+    uint64_t num_stolen() const {
+        return M_sum(&Worker::m_num_stolen);
+    }
+private:
+    void M_run_event(Worker& worker, uint32_t event_id, void* ctx) {
+        if (m_events[event_id].m_impl->on_context(ctx) != 0) {
+            worker.m_num_failed.fetch_add(1, std::memory_order_relaxed);
+        }
+        worker.m_num_dispatched.fetch_add(1, std::memory_order_relaxed);
+    }
+    void M_run_keyed(Worker& worker, uint32_t event_id, uint64_t key, const void* payload) {
+        auto l_it = worker.m_keys.find(key);
+        if (l_it == worker.m_keys.end()) {
+            if (worker.m_keys.size() == worker.m_pool.size()) {
+                worker.m_num_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            l_it = worker.m_keys.emplace(key, static_cast<uint32_t>(worker.m_keys.size())).first;
+        }
+        char* l_state = static_cast<char*>(worker.m_pool_bufs[l_it->second]);
+        const char* l_payload = static_cast<const char*>(payload);
+        for (const InputField& l_input : m_inputs) {
+            std::memcpy(l_state + l_input.m_offset, l_payload + l_input.m_offset, l_input.m_size);
+        }
+        M_run_event(worker, event_id, l_state);
+    }
+    bool M_run_one(uint32_t idx) {
+        Worker& l_worker = *m_workers[idx];
+        if (l_worker.m_keyed.try_pop([this, &l_worker](uint32_t event_id, uint64_t key, void* payload) {
+                M_run_keyed(l_worker, event_id, key, payload);
+            })) {
+            return true;
+        }
+        auto l_run_stateless = [this, &l_worker](uint32_t event_id, uint64_t, void* payload) {
+            M_run_event(l_worker, event_id, payload);
+        };
+        if (l_worker.m_stateless.try_pop(l_run_stateless)) {
+            return true;
+        }
+        for (uint32_t i = 1; i != num_workers(); ++i) {
+            Worker& l_victim = *m_workers[(idx + i) % num_workers()];
+            if (l_victim.m_stateless.try_pop(l_run_stateless)) {
+                l_worker.m_num_stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+    void M_run(uint32_t idx) {
+        while (not m_stop.load(std::memory_order_acquire)) {
+            if (not M_run_one(idx)) {
+                Debug::cpu_relax();
+            }
+        }
+        // drain what was submitted before stop()
+        while (M_run_one(idx)) {
+        }
+    }
+    uint64_t M_sum(std::atomic<uint64_t> Worker::* counter) const {
+        uint64_t l_sum = 0;
+        for (const std::unique_ptr<Worker>& l_worker : m_workers) {
+            l_sum += ((*l_worker).*counter).load(std::memory_order_relaxed);
+        }
+        return l_sum;
+    }
+    // murmur3 finalizer, spreads sequential keys over workers
+    static uint64_t M_mix(uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdull;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ull;
+        key ^= key >> 33;
+        return key;
+    }
+};
+
+//
+// ShardedExecutor
+//
+ShardedExecutor::ShardedExecutor() : BaseT{State::ERROR} {
+}
+
+ShardedExecutor::ShardedExecutor(const Struct& state, uint32_t num_workers, uint32_t keys_per_worker, uint32_t queue_capacity)
+    : BaseT{State::VALID} {
+    if (state.has_error()) {
+        M_mark_error();
+        return;
+    }
+    if (num_workers == 0 or keys_per_worker == 0) {
+        M_mark_error("executor needs at least one worker and one key per worker");
+        return;
+    }
+    if (queue_capacity == 0 or queue_capacity > (1u << 31)) {
+        M_mark_error("executor queue capacity must be in [1, 2^31]");
+        return;
+    }
+    // state objects are built and frozen up front, with nothing to link
+    for (const std::string& l_name : state.field_names()) {
+        const Field l_field = state[l_name];
+        if (l_field.is_struct_pointer() or l_field.is_array_pointer() or l_field.is_fn_pointer()) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "executor state can't have pointer fields:" << l_name);
+            return;
+        }
+    }
+    m_impl = std::make_shared<Impl>(state, num_workers, queue_capacity);
+    if (not m_impl->is_valid()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "can't allocate executor queues of capacity:" << queue_capacity);
+        m_impl.reset();
+        return;
+    }
+    // pool is filled here, workers never allocate objects
+    for (uint32_t i = 0; i != num_workers; ++i) {
+        for (uint32_t j = 0; j != keys_per_worker; ++j) {
+            Object l_obj = state.mk_object();
+            [[maybe_unused]] const bool l_is_frozen = l_obj.freeze();
+            LLVM_BUILDER_ASSERT(l_is_frozen);
+            m_impl->add_state(i, l_obj);
+        }
+    }
+}
+
+uint32_t ShardedExecutor::num_workers() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->num_workers();
+}
+
+uint32_t ShardedExecutor::add_event(const EventFn& fn) {
+    if (has_error() or fn.has_error()) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    LLVM_BUILDER_ASSERT(fn.m_impl);
+    if (m_impl->is_running()) {
+        M_mark_error("can't add event while workers are running");
+        return std::numeric_limits<uint32_t>::max();
+    }
+    if (not fn.is_init() or fn.m_impl->is_kernel()) {
+        M_mark_error("event must be initialized and can't be a kernel");
+        return std::numeric_limits<uint32_t>::max();
+    }
+    return m_impl->add_event(fn);
+}
+
+bool ShardedExecutor::add_input_field(const std::string& name) {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->is_running()) {
+        M_mark_error("can't add input field while workers are running");
+        return false;
+    }
+    const Field l_field = m_impl->struct_def()[name];
+    if (l_field.has_error()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "field not found:" << name);
+        return false;
+    }
+    m_impl->add_input_field(static_cast<uint32_t>(l_field.offset()), Array::Impl::size_of(l_field.type()));
+    return true;
+}
+
+uint32_t ShardedExecutor::worker_of(uint64_t key) const {
+    if (has_error()) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->worker_of(key);
+}
+
+bool ShardedExecutor::submit(uint64_t key, uint32_t event_id, const Object& payload) const {
+    if (has_error() or payload.has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (event_id >= m_impl->num_events()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "unknown event id:" << event_id);
+        return false;
+    }
+    if (not payload.is_frozen() or not payload.is_instance_of(m_impl->struct_def())) {
+        M_mark_error("payload must be a frozen object of executor state struct");
+        return false;
+    }
+    void* l_payload = payload.ref();
+    while (not m_impl->try_submit(key, event_id, l_payload)) {
+        if (not m_impl->is_running()) {
+            M_mark_error("queue is full and workers are stopped");
+            return false;
+        }
+        Debug::cpu_relax();
+    }
+    return true;
+}
+
+bool ShardedExecutor::submit_stateless(uint32_t event_id, const Object& payload) const {
+    if (has_error() or payload.has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (event_id >= m_impl->num_events()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "unknown event id:" << event_id);
+        return false;
+    }
+    if (not payload.is_frozen() or not payload.is_instance_of(m_impl->struct_def())) {
+        M_mark_error("payload must be a frozen object of executor state struct");
+        return false;
+    }
+    void* l_payload = payload.ref();
+    while (not m_impl->try_submit_stateless(event_id, l_payload)) {
+        if (not m_impl->is_running()) {
+            M_mark_error("queue is full and workers are stopped");
+            return false;
+        }
+        Debug::cpu_relax();
+    }
+    return true;
+}
+
+bool ShardedExecutor::start(const std::vector<int32_t>& cpus) {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->is_running()) {
+        M_mark_error("workers already running");
+        return false;
     }
-};
+    return m_impl->start(cpus);
+}
 
-//
-// Struct
-//
-Struct::Struct() : BaseT{State::ERROR} {
+void ShardedExecutor::drain() const {
+    if (has_error()) {
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->is_running()) {
+        M_mark_error("can't drain while workers are stopped");
+        return;
+    }
+    m_impl->drain();
 }
 
-Struct::Struct(const TypeInfo& type, construct_t)
-  : BaseT{State::VALID} {
-    if (not type.is_struct()) {
-        M_mark_error(LLVM_BUILDER_CONCAT << "Type not a struct:" << type.short_name());
-    } else {
-        m_impl = std::make_shared<Impl>(*this, type);
+void ShardedExecutor::stop() {
+    if (has_error()) {
+        return;
     }
+    LLVM_BUILDER_ASSERT(m_impl);
+    m_impl->stop();
 }
 
-const std::string& Struct::name() const {
+bool ShardedExecutor::is_running() const {
     if (has_error()) {
-        return StringManager::null();
+        return false;
     }
     LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->name();
+    return m_impl->is_running();
 }
 
-int32_t Struct::size_in_bytes() const {
+Object ShardedExecutor::state(uint64_t key) const {
     if (has_error()) {
-        return 0;
+        return Object::null();
     }
     LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->size_in_bytes();
+    if (m_impl->is_running()) {
+        return Object::null("state can't be read while workers are running");
+    }
+    const Object* l_state = m_impl->state(key);
+    if (l_state == nullptr) {
+        return Object::null(LLVM_BUILDER_CONCAT << "no state for key:" << key);
+    }
+    return *l_state;
 }
 
-int32_t Struct::num_fields() const {
+uint64_t ShardedExecutor::num_keys() const {
     if (has_error()) {
         return 0;
     }
     LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->num_fields();
+    if (m_impl->is_running()) {
+        M_mark_error("keys can't be counted while workers are running");
+        return 0;
+    }
+    return m_impl->num_keys();
 }
 
-const std::vector<std::string>& Struct::field_names() const {
+uint64_t ShardedExecutor::num_dispatched() const {
     if (has_error()) {
-        static const std::vector<std::string> l_null_vec{};
-        return l_null_vec;
+        return 0;
     }
     LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->field_names();
+    return m_impl->num_dispatched();
 }
 
-void Struct::log_values(std::ostream& os, void* data, uint32_t size) const {
+uint64_t ShardedExecutor::num_failed() const {
     if (has_error()) {
-        return;
+        return 0;
     }
     LLVM_BUILDER_ASSERT(m_impl);
-    m_impl->log_values(os, data, size);
+    return m_impl->num_failed();
 }
 
-
-Object Struct::mk_object() const {
+uint64_t ShardedExecutor::num_dropped() const {
     if (has_error()) {
-        return Object::null();
+        return 0;
     }
     LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->mk_object(*this);
+    return m_impl->num_dropped();
 }
 
-Field Struct::operator[] (const std::string& s) const {
+uint64_t ShardedExecutor::num_stolen() const {
     if (has_error()) {
-        return Field::null();
+        return 0;
     }
     LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->operator[](s);
+    return m_impl->num_stolen();
 }
 
-bool Struct::operator == (const Struct& rhs) const {
+bool ShardedExecutor::operator == (const ShardedExecutor& rhs) const {
     if (has_error() and rhs.has_error()) {
         return true;
     }
     return m_impl.get() == rhs.m_impl.get();
 }
 
-Struct Struct::null(const std::string& log) {
-    static Struct s_null{};
+ShardedExecutor ShardedExecutor::null(const std::string& log) {
+    static ShardedExecutor s_null{};
     LLVM_BUILDER_ASSERT(s_null.has_error());
-    Struct result = s_null;
+    ShardedExecutor result = s_null;
     result.M_mark_error(log);
     return result;
 }
 
 //
-// EventFn::Impl
+// Replay::Impl
 //
-class EventFn::Impl : meta::noncopyable {
-    JustInTimeRunner& m_runner;
-    const std::string m_name;
-    event_fn_t* m_event_fn = nullptr;
-    bool m_is_init = false;
+class Replay::Impl : meta::noncopyable {
+    // bytes of a record copied into state, pointer fields are left out
+    struct Range {
+        uint32_t m_offset = 0;
+        uint32_t m_size = 0;
+    };
+    struct ColumnInfo {
+        std::string m_field;
+        type_t m_type = type_t::unknown;
+        uint32_t m_offset = 0;
+        uint32_t m_size = 0;
+        const uint8_t* m_data = nullptr;
+    };
+    static constexpr uint32_t c_cache_line = 64;
+private:
+    const Struct m_record;
+    const layout_t m_layout;
+    MappedFile m_file;
+    uint32_t m_record_size = 0;
+    uint64_t m_num_records = 0;
+    bool m_has_pointer_fields = false;
+    std::vector<Range> m_ranges;
+    // non pointer fields, backed by the file only for columns layout
+    std::vector<ColumnInfo> m_columns;
+    uint32_t m_prefetch_distance = 0;
+    std::string m_error;
 public:
-    explicit Impl(JustInTimeRunner& runner, const std::string& name)
-        : m_runner{runner}, m_name{name} {
+    explicit Impl(const Struct& record, const std::string& path, layout_t layout)
+        : m_record{record}
+        , m_layout{layout}
+        , m_file{path, MappedFile::protection_t::read_only}
+        , m_record_size{static_cast<uint32_t>(record.size_in_bytes())} {
+        if (not m_file.is_valid()) {
+            m_error = m_file.error();
+            return;
+        }
+        // fields are laid out in idx order
+        uint32_t l_next = 0;
+        uint64_t l_row_size = 0;
+        for (const std::string& l_name : m_record.field_names()) {
+            const Field l_field = m_record[l_name];
+            const uint32_t l_offset = static_cast<uint32_t>(l_field.offset());
+            if (l_field.is_struct_pointer() or l_field.is_array_pointer() or l_field.is_fn_pointer()) {
+                m_has_pointer_fields = true;
+                if (l_offset > l_next) {
+                    m_ranges.emplace_back(Range{l_next, l_offset - l_next});
+                }
+                l_next = l_offset + static_cast<uint32_t>(sizeof(uint64_t));
+                continue;
+            }
+            const uint32_t l_size = Array::Impl::size_of(l_field.type());
+            if (l_size == std::numeric_limits<uint32_t>::max()) {
+                if (m_layout == layout_t::columns) {
+                    m_error = LLVM_BUILDER_CONCAT << "field can't be read from a column:" << l_name;
+                    return;
+                }
+                continue;
+            }
+            m_columns.emplace_back(ColumnInfo{l_name, l_field.type(), l_offset, l_size, nullptr});
+            l_row_size += l_size;
+        }
+        if (l_next < m_record_size) {
+            m_ranges.emplace_back(Range{l_next, m_record_size - l_next});
+        }
+        const uint64_t l_row = m_layout == layout_t::records ? m_record_size : l_row_size;
+        if (l_row == 0 or m_file.size() % l_row != 0) {
+            m_error = LLVM_BUILDER_CONCAT << "size of " << path << " is not a multiple of record size:" << l_row;
+            return;
+        }
+        m_num_records = m_file.size() / l_row;
+        if (m_layout == layout_t::columns) {
+            uint64_t l_offset = 0;
+            for (ColumnInfo& l_column : m_columns) {
+                l_column.m_data = static_cast<const uint8_t*>(m_file.at(l_offset, l_column.m_size * m_num_records));
+                l_offset += l_column.m_size * m_num_records;
+            }
+        }
+        // replay reads the file front to back
+        m_file.advise_sequential();
     }
     ~Impl() = default;
 public:
-    bool is_init() const {
-        return m_is_init;
+    bool is_valid() const {
+        return m_error.empty();
     }
-    void init() {
-        if (not is_init()) {
-            m_event_fn = m_runner.get_fn(m_name);
+    const std::string& error() const {
+        return m_error;
+    }
+    const Struct& record() const {
+        return m_record;
+    }
+    layout_t layout() const {
+        return m_layout;
+    }
+    uint64_t num_records() const {
+        return m_num_records;
+    }
+    bool has_pointer_fields() const {
+        return m_has_pointer_fields;
+    }
+    void set_prefetch_distance(uint32_t num_records) {
+        m_prefetch_distance = num_records;
+    }
+    // field of the file a kernel with `access` reads and writes, empty if there is none
+    std::string read_written_field(const FieldAccess& access) const {
+        for (const ColumnInfo& l_column : m_columns) {
+            if (access.is_read(l_column.m_field) and access.is_written(l_column.m_field)) {
+                return l_column.m_field;
+            }
         }
-        m_is_init = true;
+        return {};
+    }
+    // columns of a kernel for records [begin, ...), the mapping is read in place. It is
+    // read only, so fields the kernel writes get no column and live in state
+    std::vector<Column> kernel_columns(uint64_t begin, const FieldAccess& access) const {
+        std::vector<Column> l_result;
+        for (const ColumnInfo& l_column : m_columns) {
+            if (access.is_written(l_column.m_field)) {
+                continue;
+            }
+            if (m_layout == layout_t::records) {
+                uint8_t* l_data = M_record(begin) + l_column.m_offset;
+                l_result.emplace_back(l_column.m_field, l_column.m_type, l_data, static_cast<int64_t>(m_record_size));
+            } else {
+                uint8_t* l_data = const_cast<uint8_t*>(l_column.m_data) + begin * l_column.m_size;
+                l_result.emplace_back(l_column.m_field, l_column.m_type, l_data, static_cast<int64_t>(l_column.m_size));
+            }
+        }
+        return l_result;
     }
-    int32_t on_event(const Object &o) const {
-        LLVM_BUILDER_ASSERT(is_init());
-        LLVM_BUILDER_ASSERT(not o.has_error());
-        LLVM_BUILDER_ASSERT(not ErrorContext::has_error());
-        LLVM_BUILDER_ASSERT(o.is_frozen());
-        // TODO{vibhanshu}: add check that struct type is compatible
-        //    with event
-        return m_event_fn(o.m_impl->ref());
+    int32_t run(const EventFn::Impl& fn, const Object& state, uint64_t begin, uint64_t end, uint64_t* num_processed) const {
+        uint8_t* l_state = static_cast<uint8_t*>(state.ref());
+        for (uint64_t i = begin; i != end; ++i) {
+            if (m_prefetch_distance != 0 and end - i > m_prefetch_distance) {
+                M_prefetch(i + m_prefetch_distance);
+            }
+            M_load(i, l_state);
+            const int32_t l_result = fn.on_event(state);
+            if (l_result != 0) {
+                *num_processed = i - begin;
+                return l_result;
+            }
+        }
+        *num_processed = end - begin;
+        return 0;
+    }
+    int32_t run_in_place(EventFn::event_fn_t* fn, uint64_t begin, uint64_t end, uint64_t* num_processed) const {
+        LLVM_BUILDER_ASSERT(m_layout == layout_t::records);
+        for (uint64_t i = begin; i != end; ++i) {
+            if (m_prefetch_distance != 0 and end - i > m_prefetch_distance) {
+                M_prefetch(i + m_prefetch_distance);
+            }
+            const int32_t l_result = fn(M_record(i));
+            if (l_result != 0) {
+                *num_processed = i - begin;
+                return l_result;
+            }
+        }
+        *num_processed = end - begin;
+        return 0;
+    }
+private:
+    uint8_t* M_record(uint64_t i) const {
+        return static_cast<uint8_t*>(m_file.base()) + i * m_record_size;
+    }
+    void M_load(uint64_t i, uint8_t* state) const {
+        if (m_layout == layout_t::records) {
+            const uint8_t* l_record = M_record(i);
+            for (const Range& l_range : m_ranges) {
+                std::memcpy(state + l_range.m_offset, l_record + l_range.m_offset, l_range.m_size);
+            }
+        } else {
+            for (const ColumnInfo& l_column : m_columns) {
+                std::memcpy(state + l_column.m_offset, l_column.m_data + i * l_column.m_size, l_column.m_size);
+            }
+        }
+    }
+    void M_prefetch(uint64_t i) const {
+        if (m_layout == layout_t::records) {
+            const uint8_t* l_record = M_record(i);
+            for (uint32_t l_offset = 0; l_offset < m_record_size; l_offset += c_cache_line) {
+                __builtin_prefetch(l_record + l_offset);
+            }
+        } else {
+            for (const ColumnInfo& l_column : m_columns) {
+                __builtin_prefetch(l_column.m_data + i * l_column.m_size);
+            }
+        }
     }
 };
 
 //
-// EventFn
+// Replay
 //
-EventFn::EventFn() : BaseT{State::ERROR} {
+Replay::Replay() : BaseT{State::ERROR} {
 }
 
-EventFn::EventFn(JustInTimeRunner& runner, const std::string& name, construct_t)
+Replay::Replay(const Struct& record, const std::string& path, layout_t layout)
     : BaseT{State::VALID} {
-    m_impl = std::make_shared<Impl>(runner, name);
+    if (record.has_error()) {
+        M_mark_error();
+        return;
+    }
+    std::shared_ptr<Impl> l_impl = std::make_shared<Impl>(record, path, layout);
+    if (not l_impl->is_valid()) {
+        M_mark_error(l_impl->error());
+        return;
+    }
+    m_impl = std::move(l_impl);
 }
 
-bool EventFn::is_init() const {
+auto Replay::layout() const -> layout_t {
     if (has_error()) {
-        return false;
+        return layout_t::records;
     }
     LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->is_init();
+    return m_impl->layout();
 }
 
-void EventFn::init() {
+uint64_t Replay::num_records() const {
+    if (has_error()) {
+        return 0;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->num_records();
+}
+
+void Replay::set_prefetch_distance(uint32_t num_records) {
     if (has_error()) {
         return;
     }
     LLVM_BUILDER_ASSERT(m_impl);
-    m_impl->init();
+    m_impl->set_prefetch_distance(num_records);
 }
 
-int32_t EventFn::on_event(const Object& o) const {
-    if (has_error() or o.has_error()) {
+int32_t Replay::run(const EventFn& fn, const Object& state, uint64_t begin, uint64_t end, uint64_t* num_processed) const {
+    uint64_t l_num_processed = 0;
+    uint64_t* l_processed = num_processed != nullptr ? num_processed : &l_num_processed;
+    *l_processed = 0;
+    if (has_error() or fn.has_error() or state.has_error()) {
         return -1;
     }
-    if (ErrorContext::has_error()) {
-        M_mark_error("can't run event when there are outstanding error");
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not fn.is_init()) {
+        M_mark_error("event of replay is not initialized");
         return -1;
     }
-    if (not o.is_frozen()) {
+    if (not state.is_frozen()) {
         M_mark_error("can't use a object which is not frozen yet");
         return -1;
     }
+    if (not state.is_instance_of(m_impl->record())) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "replay state must be an object of struct:" << m_impl->record().name());
+        return -1;
+    }
+    if (begin > end or end > m_impl->num_records()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "replay range out of bounds:[" << begin << ", " << end << ")");
+        return -1;
+    }
+    if (fn.m_impl->is_kernel()) {
+        const FieldAccess& l_access = fn.m_impl->field_access();
+        if (const std::string l_field = m_impl->read_written_field(l_access); not l_field.empty()) {
+            M_mark_error(LLVM_BUILDER_CONCAT << "kernel reads and writes field of replay file:" << l_field
+                                             << ", replay the event instead");
+            return -1;
+        }
+        return fn.on_columns(state, m_impl->kernel_columns(begin, l_access), end - begin, l_processed);
+    }
+    return m_impl->run(*fn.m_impl, state, begin, end, l_processed);
+}
+
+int32_t Replay::run_in_place(const EventFn& fn, uint64_t begin, uint64_t end, uint64_t* num_processed) const {
+    uint64_t l_num_processed = 0;
+    uint64_t* l_processed = num_processed != nullptr ? num_processed : &l_num_processed;
+    *l_processed = 0;
+    if (has_error() or fn.has_error()) {
+        return -1;
+    }
     LLVM_BUILDER_ASSERT(m_impl);
-    return m_impl->on_event(o);
+    if (not fn.is_init()) {
+        M_mark_error("event of replay is not initialized");
+        return -1;
+    }
+    if (fn.m_impl->is_kernel()) {
+        M_mark_error("kernel can only be replayed with run()");
+        return -1;
+    }
+    if (m_impl->layout() != layout_t::records or m_impl->has_pointer_fields()) {
+        M_mark_error("only records of a struct without pointer fields can be replayed in place");
+        return -1;
+    }
+    if (fn.field_access().is_opaque() or not fn.field_access().writes().empty()) {
+        M_mark_error("replay file is mapped read only, event writing context can't be replayed in place");
+        return -1;
+    }
+    if (begin > end or end > m_impl->num_records()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "replay range out of bounds:[" << begin << ", " << end << ")");
+        return -1;
+    }
+    return m_impl->run_in_place(fn.m_impl->fn_ptr(), begin, end, l_processed);
 }
 
-bool EventFn::operator==(const EventFn &rhs) const {
+bool Replay::operator == (const Replay& rhs) const {
     if (has_error() and rhs.has_error()) {
         return true;
     }
     return m_impl.get() == rhs.m_impl.get();
 }
 
-EventFn EventFn::null(const std::string& log) {
-    static EventFn s_null{};
+Replay Replay::null(const std::string& log) {
+    static Replay s_null{};
     LLVM_BUILDER_ASSERT(s_null.has_error());
-    EventFn result = s_null;
+    Replay result = s_null;
     result.M_mark_error(log);
     return result;
 }
@@ -1404,6 +5396,7 @@ class Namespace::Impl : meta::noncopyable {
     const std::string m_namespace;
     std::unordered_map<std::string, Struct> m_structs;
     std::unordered_map<std::string, EventFn> m_event_fns;
+    std::unordered_map<std::string, std::vector<std::string>> m_triggers;
     bool m_is_bind = false;
     bool m_is_global = false;
 public :
@@ -1448,14 +5441,32 @@ public:
             return;
         }
     }
-    void add_event(const std::string &e) {
+    void add_event(const std::string &e, const FieldAccess& field_access) {
         LLVM_BUILDER_ASSERT(not e.empty())
         LLVM_BUILDER_ASSERT(not is_bind());
-        auto it = m_event_fns.try_emplace(e, m_runner, e, typename EventFn::construct_t{});
+        auto it = m_event_fns.try_emplace(e, m_runner, e, field_access, typename EventFn::construct_t{});
         if (not it.second) {
             // TODO{vibhanshu}: what to do in case of redifinition of event ?
         }
     }
+    void add_trigger(const std::string& event, const std::vector<std::string>& fields) {
+        LLVM_BUILDER_ASSERT(not event.empty())
+        LLVM_BUILDER_ASSERT(not is_bind());
+        std::vector<std::string>& l_fields = m_triggers[event];
+        for (const std::string& l_field : fields) {
+            if (std::find(l_fields.begin(), l_fields.end(), l_field) == l_fields.end()) {
+                l_fields.emplace_back(l_field);
+            }
+        }
+    }
+    std::vector<std::string> trigger_fields(const std::string& event) const {
+        auto it = m_triggers.find(event);
+        if (it != m_triggers.end()) {
+            return it->second;
+        } else {
+            return {};
+        }
+    }
     Struct struct_info(const std::string &name) const {
         LLVM_BUILDER_ASSERT(not name.empty())
         if (m_structs.contains(name)) {
@@ -1472,6 +5483,231 @@ public:
             return EventFn::null();
         }
     }
+    Object load_checkpoint(const std::string& path) const {
+        // restored objects are used in place and written by events
+        std::shared_ptr<MappedFile> l_file = std::make_shared<MappedFile>(path, MappedFile::protection_t::copy_on_write);
+        if (not l_file->is_valid()) {
+            return Object::null(l_file->error());
+        }
+        const auto* l_header = static_cast<const checkpoint::Header*>(l_file->at(0, sizeof(checkpoint::Header)));
+        if (l_header == nullptr or l_header->m_magic != checkpoint::c_magic) {
+            return Object::null(LLVM_BUILDER_CONCAT << "not a checkpoint file:" << path);
+        }
+        if (l_header->m_version != checkpoint::c_version) {
+            return Object::null(LLVM_BUILDER_CONCAT << "unsupported checkpoint version " << l_header->m_version << ":" << path);
+        }
+        if (l_header->m_file_size != l_file->size() or l_file->at(0, checkpoint::table_size(*l_header)) == nullptr) {
+            return Object::null(LLVM_BUILDER_CONCAT << "checkpoint file is truncated:" << path);
+        }
+        if (l_header->m_num_nodes == 0) {
+            return Object::null(LLVM_BUILDER_CONCAT << "checkpoint file has no root:" << path);
+        }
+        const char* l_tables = static_cast<const char*>(l_file->base()) + sizeof(checkpoint::Header);
+        CheckpointTables l_cp;
+        l_cp.m_structs = reinterpret_cast<const checkpoint::Struct*>(l_tables);
+        l_cp.m_fields = reinterpret_cast<const checkpoint::Field*>(l_cp.m_structs + l_header->m_num_structs);
+        l_cp.m_nodes = reinterpret_cast<const checkpoint::Node*>(l_cp.m_fields + l_header->m_num_fields);
+        l_cp.m_links = reinterpret_cast<const checkpoint::Link*>(l_cp.m_nodes + l_header->m_num_nodes);
+        std::string l_error;
+        std::vector<const Struct*> l_structs;
+        for (uint32_t i = 0; i != l_header->m_num_structs; ++i) {
+            const Struct* l_struct = M_check_struct(*l_header, l_cp, l_cp.m_structs[i], l_error);
+            if (l_struct == nullptr) {
+                return Object::null(LLVM_BUILDER_CONCAT << "checkpoint " << path << ":" << l_error);
+            }
+            l_structs.emplace_back(l_struct);
+        }
+        for (uint32_t i = 0; i != l_header->m_num_nodes; ++i) {
+            if (not M_check_node(*l_header, l_cp, *l_file, l_structs, l_cp.m_nodes[i], l_error)) {
+                return Object::null(LLVM_BUILDER_CONCAT << "checkpoint " << path << ": node " << i << ":" << l_error);
+            }
+        }
+        if (l_cp.m_nodes[0].m_kind != checkpoint::c_kind_object) {
+            return Object::null(LLVM_BUILDER_CONCAT << "checkpoint root is not an object:" << path);
+        }
+        Object l_root = M_restore(*l_header, l_cp, l_file, l_structs, l_error);
+        if (l_root.has_error()) {
+            return Object::null(LLVM_BUILDER_CONCAT << "checkpoint " << path << ":" << l_error);
+        }
+        return l_root;
+    }
+private:
+    struct CheckpointTables {
+        const checkpoint::Struct* m_structs = nullptr;
+        const checkpoint::Field* m_fields = nullptr;
+        const checkpoint::Node* m_nodes = nullptr;
+        const checkpoint::Link* m_links = nullptr;
+    };
+    enum : uint8_t {
+        c_not_restored = 0,
+        c_in_progress = 1,
+        c_restored = 2,
+    };
+    static bool M_is_name(const char (&name)[checkpoint::c_max_name]) {
+        return std::memchr(name, 0, sizeof(name)) != nullptr;
+    }
+    static type_t M_field_type(const checkpoint::Field* fields, const checkpoint::Struct& s, uint32_t slot) {
+        return static_cast<type_t>(fields[s.m_first_field + slot].m_type);
+    }
+    // struct of this namespace with same layout as `s`
+    const Struct* M_check_struct(const checkpoint::Header& header, const CheckpointTables& cp,
+                                 const checkpoint::Struct& s, std::string& error) const {
+        if (not M_is_name(s.m_name)) {
+            error = "corrupt struct name";
+            return nullptr;
+        }
+        auto l_it = m_structs.find(s.m_name);
+        if (l_it == m_structs.end()) {
+            error = LLVM_BUILDER_CONCAT << "struct not found:" << s.m_name;
+            return nullptr;
+        }
+        const Struct& l_struct = l_it->second;
+        if (s.m_first_field > header.m_num_fields or s.m_num_fields > header.m_num_fields - s.m_first_field) {
+            error = LLVM_BUILDER_CONCAT << "corrupt field table of struct:" << s.m_name;
+            return nullptr;
+        }
+        if (static_cast<int32_t>(s.m_size) != l_struct.size_in_bytes()
+              or static_cast<int32_t>(s.m_num_fields) != l_struct.num_fields()) {
+            error = LLVM_BUILDER_CONCAT << "layout of struct changed:" << s.m_name;
+            return nullptr;
+        }
+        for (uint32_t i = 0; i != s.m_num_fields; ++i) {
+            const checkpoint::Field& l_entry = cp.m_fields[s.m_first_field + i];
+            if (not M_is_name(l_entry.m_name)) {
+                error = LLVM_BUILDER_CONCAT << "corrupt field name of struct:" << s.m_name;
+                return nullptr;
+            }
+            const Field l_field = l_struct[l_entry.m_name];
+            if (l_field.has_error()
+                  or l_field.idx() != static_cast<int32_t>(i)
+                  or l_field.offset() != static_cast<int32_t>(l_entry.m_offset)
+                  or l_field.type() != static_cast<type_t>(l_entry.m_type)) {
+                error = LLVM_BUILDER_CONCAT << "layout of struct changed:" << s.m_name << "." << l_entry.m_name;
+                return nullptr;
+            }
+        }
+        return &l_struct;
+    }
+    static bool M_check_node(const checkpoint::Header& header, const CheckpointTables& cp, const MappedFile& file,
+                             const std::vector<const Struct*>& structs, const checkpoint::Node& node, std::string& error) {
+        if (node.m_offset % checkpoint::c_alignment != 0 or node.m_offset < header.m_data_offset
+              or file.at(node.m_offset, node.m_size) == nullptr) {
+            error = "data out of bounds";
+            return false;
+        }
+        if (node.m_first_link > header.m_num_links or node.m_num_links > header.m_num_links - node.m_first_link) {
+            error = "corrupt link table";
+            return false;
+        }
+        if (node.m_kind == checkpoint::c_kind_object) {
+            if (node.m_type >= header.m_num_structs
+                  or node.m_size != static_cast<uint64_t>(structs[node.m_type]->size_in_bytes())) {
+                error = "corrupt object";
+                return false;
+            }
+        } else if (node.m_kind == checkpoint::c_kind_array) {
+            const type_t l_type = static_cast<type_t>(node.m_type);
+            // element size of every type up to pointer_array is known, see Array::Impl
+            if (node.m_num_elements == 0 or l_type == type_t::unknown or node.m_type > static_cast<uint32_t>(type_t::pointer_array)) {
+                error = "corrupt array";
+                return false;
+            }
+        } else {
+            error = "unknown node kind";
+            return false;
+        }
+        for (uint32_t i = 0; i != node.m_num_links; ++i) {
+            const checkpoint::Link& l_link = cp.m_links[node.m_first_link + i];
+            if (l_link.m_child >= header.m_num_nodes) {
+                error = "link out of bounds";
+                return false;
+            }
+            const bool l_is_object = cp.m_nodes[l_link.m_child].m_kind == checkpoint::c_kind_object;
+            type_t l_slot_type = type_t::unknown;
+            if (node.m_kind == checkpoint::c_kind_object) {
+                const checkpoint::Struct& l_struct = cp.m_structs[node.m_type];
+                if (l_link.m_slot < l_struct.m_num_fields) {
+                    l_slot_type = M_field_type(cp.m_fields, l_struct, l_link.m_slot);
+                }
+            } else if (l_link.m_slot < node.m_num_elements) {
+                l_slot_type = static_cast<type_t>(node.m_type);
+            }
+            if (l_slot_type != (l_is_object ? type_t::pointer_struct : type_t::pointer_array)) {
+                error = "link doesn't match pointer type";
+                return false;
+            }
+        }
+        return true;
+    }
+    // depth first, children are restored first as only frozen objects/arrays can be linked.
+    // NOTE{vibhanshu}: explicit stack, a long linked list of objects must not overflow the call stack
+    static Object M_restore(const checkpoint::Header& header, const CheckpointTables& cp, const std::shared_ptr<MappedFile>& file,
+                            const std::vector<const Struct*>& structs, std::string& error) {
+        std::vector<Object> l_objects(header.m_num_nodes);
+        std::vector<Array> l_arrays(header.m_num_nodes);
+        std::vector<uint8_t> l_state(header.m_num_nodes, c_not_restored);
+        // node idx, next link to visit
+        std::vector<std::pair<uint32_t, uint32_t>> l_stack{{0, 0}};
+        l_state[0] = c_in_progress;
+        while (not l_stack.empty()) {
+            const uint32_t l_idx = l_stack.back().first;
+            const checkpoint::Node& l_node = cp.m_nodes[l_idx];
+            if (l_stack.back().second != l_node.m_num_links) {
+                const uint32_t l_child = cp.m_links[l_node.m_first_link + l_stack.back().second].m_child;
+                ++l_stack.back().second;
+                if (l_state[l_child] == c_in_progress) {
+                    error = "object graph has a cycle";
+                    return Object::null();
+                }
+                if (l_state[l_child] == c_not_restored) {
+                    l_state[l_child] = c_in_progress;
+                    l_stack.emplace_back(l_child, 0);
+                }
+                continue;
+            }
+            void* l_buf = file->at(l_node.m_offset, l_node.m_size);
+            if (l_node.m_kind == checkpoint::c_kind_object) {
+                const checkpoint::Struct& l_entry = cp.m_structs[l_node.m_type];
+                Object l_obj{*structs[l_node.m_type], file, l_buf, false};
+                for (uint32_t i = 0; i != l_node.m_num_links; ++i) {
+                    const checkpoint::Link& l_link = cp.m_links[l_node.m_first_link + i];
+                    const std::string l_name = cp.m_fields[l_entry.m_first_field + l_link.m_slot].m_name;
+                    if (M_field_type(cp.m_fields, l_entry, l_link.m_slot) == type_t::pointer_struct) {
+                        l_obj.set_object(l_name, l_objects[l_link.m_child]);
+                    } else {
+                        l_obj.set_array(l_name, l_arrays[l_link.m_child]);
+                    }
+                }
+                if (l_obj.has_error() or not l_obj.freeze()) {
+                    error = LLVM_BUILDER_CONCAT << "pointer field not linked in object of struct:" << l_entry.m_name;
+                    return Object::null();
+                }
+                l_objects[l_idx] = l_obj;
+            } else {
+                Array l_arr{static_cast<type_t>(l_node.m_type), l_node.m_num_elements, file, l_buf, false};
+                if (static_cast<uint64_t>(l_arr.element_size()) * l_node.m_num_elements != l_node.m_size) {
+                    error = "corrupt array";
+                    return Object::null();
+                }
+                for (uint32_t i = 0; i != l_node.m_num_links; ++i) {
+                    const checkpoint::Link& l_link = cp.m_links[l_node.m_first_link + i];
+                    if (l_arr.element_type() == type_t::pointer_struct) {
+                        l_arr.set_object(l_link.m_slot, l_objects[l_link.m_child]);
+                    } else {
+                        l_arr.set_array(l_link.m_slot, l_arrays[l_link.m_child]);
+                    }
+                }
+                if (l_arr.has_error() or not l_arr.freeze()) {
+                    error = "pointer element not linked in array";
+                    return Object::null();
+                }
+                l_arrays[l_idx] = l_arr;
+            }
+            l_state[l_idx] = c_restored;
+            l_stack.pop_back();
+        }
+        return l_objects[0];
+    }
 };
 
 //
@@ -1534,7 +5770,7 @@ void Namespace::add_struct(const TypeInfo& struct_type) {
     m_impl->add_struct(*this, struct_type);
 }
 
-void Namespace::add_event(const std::string &e) {
+void Namespace::add_event(const std::string &e, const FieldAccess& field_access) {
     if (has_error()) {
         return;
     }
@@ -1547,7 +5783,31 @@ void Namespace::add_event(const std::string &e) {
         return;
     }
     LLVM_BUILDER_ASSERT(m_impl);
-    m_impl->add_event(e);
+    m_impl->add_event(e, field_access);
+}
+
+void Namespace::add_trigger(const std::string& event, const std::vector<std::string>& fields) {
+    if (has_error()) {
+        return;
+    }
+    if (event.empty()) {
+        M_mark_error("can't add trigger of empty event name");
+        return;
+    }
+    if (m_impl->is_bind()) {
+        M_mark_error("Namespace already bound can't add more triggers");
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    m_impl->add_trigger(event, fields);
+}
+
+std::vector<std::string> Namespace::trigger_fields(const std::string& event) const {
+    if (has_error()) {
+        return {};
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->trigger_fields(event);
 }
 
 auto Namespace::struct_info(const std::string& name) const -> Struct {
@@ -1566,6 +5826,14 @@ auto Namespace::event_fn_info(const std::string& name) const -> EventFn {
     return m_impl->event_fn_info(name);
 }
 
+Object Namespace::load_checkpoint(const std::string& path) const {
+    if (has_error()) {
+        return Object::null();
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->load_checkpoint(path);
+}
+
 bool Namespace::operator == (const Namespace& rhs) const {
     if (has_error() and rhs.has_error()) {
         return true;
@@ -0,0 +1,49 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_LLVM_KERNEL_H_
+#define LLVM_BUILDER_LLVM_KERNEL_H_
+
+#include "llvm_builder/defines.h"
+
+#include <cstdint>
+#include <string>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// KernelArgs
+//
+// Argument block of a kernel generated by Function::mk_kernel(), passed in
+// place of the context pointer. `columns`/`strides` have one entry per context
+// field (by field idx), stride is in bytes and stride 0 keeps the field in
+// place, so it carries its value from one row to the next.
+// NOTE{vibhanshu}: layout is mirrored by M_mk_kernel_args_type() in function.cpp
+struct KernelArgs {
+    enum : uint32_t {
+        c_columns_idx = 0,
+        c_strides_idx = 1,
+        c_num_rows_idx = 2,
+        c_num_processed_idx = 3,
+    };
+    void** columns = nullptr;
+    const int64_t* strides = nullptr;
+    uint64_t num_rows = 0;
+    // rows done, on non-zero result it is index of the failing row
+    uint64_t num_processed = 0;
+};
+
+static constexpr const char* c_kernel_suffix = "__kernel";
+
+inline std::string kernel_name(const std::string& fn_name) {
+    return fn_name + c_kernel_suffix;
+}
+
+inline bool is_kernel_name(const std::string& name) {
+    return name.ends_with(c_kernel_suffix);
+}
+
+LLVM_BUILDER_NS_END
+
+#endif // LLVM_BUILDER_LLVM_KERNEL_H_
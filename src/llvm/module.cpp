@@ -5,6 +5,7 @@
 #include "llvm_builder/module.h"
 #include "llvm_builder/function.h"
 #include "context_impl.h"
+#include "debug_info.h"
 #include "llvm_builder/type.h"
 #include "llvm_builder/analyze.h"
 #include "ds/fixed_string.h"
@@ -14,6 +15,8 @@
 #include "ext_include.h"
 #include "llvm/TargetParser/Host.h"
 
+#include <algorithm>
+
 LLVM_BUILDER_NS_BEGIN
 
 class ModuleImpl {
@@ -59,6 +62,8 @@ FOR_EACH_LLVM_TYPE(DECL_MK_TYPE)
     std::vector<on_main_module_fn_t> m_main_mod_hook;
     bool m_is_bind = false;
     bool m_is_deleted = false;
+    bool m_debug_info = false;
+    bool m_changed_fields = false;
 public:
     explicit Impl(const std::string &name)
       : m_name{name}, m_ts_context{std::make_unique<llvm::LLVMContext>()},
@@ -77,6 +82,22 @@ public:
     bool is_valid() const {
         return not m_is_deleted;
     }
+    bool is_debug_info_enabled() const {
+        return m_debug_info;
+    }
+    void enable_debug_info() {
+        LLVM_BUILDER_ASSERT(is_valid());
+        LLVM_BUILDER_ASSERT(not is_bind_called());
+        m_debug_info = true;
+    }
+    bool is_changed_fields_enabled() const {
+        return m_changed_fields;
+    }
+    void enable_changed_fields() {
+        LLVM_BUILDER_ASSERT(is_valid());
+        LLVM_BUILDER_ASSERT(not is_bind_called());
+        m_changed_fields = true;
+    }
     void cleanup() {
         m_modules.clear();
         m_func_list.clear();
@@ -176,7 +197,20 @@ FOR_EACH_LLVM_TYPE(DECL_DEL_TYPE)
         LLVM_BUILDER_ASSERT(is_valid());
         LLVM_BUILDER_ASSERT(not is_bind_called());
         m_context_fields.emplace_back(name, type, false);
-        (void)event;
+        if (not event.has_error()) {
+            event.M_add_field(name);
+        }
+    }
+    std::vector<Event> events() {
+        LLVM_BUILDER_ASSERT(is_valid());
+        std::vector<Event> l_events;
+        for (auto& kv : m_event_map) {
+            l_events.emplace_back(kv.second);
+        }
+        std::sort(l_events.begin(), l_events.end(), [] (const Event& lhs, const Event& rhs) {
+            return lhs.name() < rhs.name();
+        });
+        return l_events;
     }
     size_t num_fields() const {
         return m_context_fields.size();
@@ -187,6 +221,10 @@ FOR_EACH_LLVM_TYPE(DECL_DEL_TYPE)
         LLVM_BUILDER_ASSERT(not is_bind_called());
         LLVM_BUILDER_ASSERT(not m_context_fields.empty());
         LLVM_BUILDER_ASSERT(not context_name.empty())
+        if (m_changed_fields) {
+            LLVM_BUILDER_ASSERT(m_context_fields.size() <= Cursor::c_max_changed_fields);
+            m_context_fields.emplace_back(Cursor::c_changed_fields_name, TypeInfo::mk_uint64(), false);
+        }
         m_ctx_type = TypeInfo::mk_struct(context_name, m_context_fields).mk_ptr();
         LLVM_BUILDER_ASSERT(not m_ctx_type.has_error());
         m_is_bind = true;
@@ -529,6 +567,14 @@ bool CursorPtr::is_bind_called() const {
     }
 }
 
+bool CursorPtr::is_debug_info_enabled() const {
+    if (std::shared_ptr<Impl> ptr = m_impl.lock()) {
+        return ptr->is_debug_info_enabled();
+    } else {
+        return false;
+    }
+}
+
 void CursorPtr::for_each_module(on_module_fn_t&& fn) {
     if (std::shared_ptr<Impl> ptr = m_impl.lock()) {
         if (ptr->is_bind_called()) {
@@ -631,15 +677,72 @@ bool Cursor::is_bind_called() {
     return m_impl->is_bind_called();
 }
 
+void Cursor::enable_debug_info() {
+    CODEGEN_FN
+    if (has_error()) {
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->is_bind_called()) {
+        CODEGEN_PUSH_ERROR(MODULE, "debug info can't be enabled after binding cursor:" << m_impl->name());
+        return;
+    }
+    m_impl->enable_debug_info();
+}
+
+bool Cursor::is_debug_info_enabled() {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->is_debug_info_enabled();
+}
+
+void Cursor::enable_changed_fields() {
+    CODEGEN_FN
+    if (has_error()) {
+        return;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (m_impl->is_bind_called()) {
+        CODEGEN_PUSH_ERROR(MODULE, "changed fields can't be enabled after binding cursor:" << m_impl->name());
+        return;
+    }
+    m_impl->enable_changed_fields();
+}
+
+bool Cursor::is_changed_fields_enabled() {
+    if (has_error()) {
+        return false;
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    return m_impl->is_changed_fields_enabled();
+}
+
 void Cursor::add_field(const std::string& name, TypeInfo type, Event event) {
     CODEGEN_FN
     if (has_error()) {
         return;
     }
     LLVM_BUILDER_ASSERT(m_impl);
+    if (name == c_changed_fields_name) {
+        CODEGEN_PUSH_ERROR(MODULE, "context field name is reserved:" << name);
+        return;
+    }
     m_impl->add_field(name, type, event);
 }
 
+std::vector<Event> Cursor::events() {
+    if (has_error()) {
+        return {};
+    }
+    LLVM_BUILDER_ASSERT(m_impl);
+    if (not m_impl->is_valid()) {
+        return {};
+    }
+    return m_impl->events();
+}
+
 void Cursor::bind(const std::string& context_name) {
     CODEGEN_FN
     if (has_error()) {
@@ -650,6 +753,10 @@ void Cursor::bind(const std::string& context_name) {
         CODEGEN_PUSH_ERROR(MODULE, "Can't bind cursor with 0 fields in context");
         return;
     }
+    if (m_impl->is_changed_fields_enabled() and m_impl->num_fields() > c_max_changed_fields) {
+        CODEGEN_PUSH_ERROR(MODULE, "changed fields mask supports at most " << c_max_changed_fields << " context fields, found:" << m_impl->num_fields());
+        return;
+    }
     m_impl->bind(std::weak_ptr<Impl>(m_impl), context_name);
 }
 
@@ -699,6 +806,7 @@ private:
     const std::string m_name;
     CursorPtr m_cursor_impl;
     std::unique_ptr<llvm::Module> m_raw_module;
+    std::unique_ptr<DebugInfoBuilder> m_debug_info;
     // TODO{vibhanshu}: add check that one {module_name}_{symbol_name} combination
     //                  should have a unique ctype, symbol_type
     std::vector<LinkSymbol> m_public_symbols;
@@ -741,6 +849,14 @@ public:
     llvm::Module *native_handle() const {
         return m_raw_module.get();
     }
+    DebugInfoBuilder* debug_info_builder() const {
+        return m_debug_info.get();
+    }
+    void finalize_debug_info() {
+        if (m_debug_info) {
+            m_debug_info->finalize();
+        }
+    }
     std::vector<std::string> exported_symbol_names() const {
         LLVM_BUILDER_ASSERT(is_init());
         return transformed_public_symbols([this] (const LinkSymbol& symbol) -> std::string {
@@ -791,6 +907,9 @@ public:
         m_raw_module->setTargetTriple(llvm::Triple{target_triple});
         m_raw_module->setPICLevel(llvm::PICLevel::BigPIC);
         m_raw_module->setPIELevel(llvm::PIELevel::Large);
+        if (m_cursor_impl.is_debug_info_enabled()) {
+            m_debug_info = std::make_unique<DebugInfoBuilder>(*m_raw_module);
+        }
         m_is_init = true;
     }
     Function get_function(Module& parent, const std::string &name) {
@@ -827,15 +946,23 @@ public:
         } ();
         llvm::Error l_err = llvm::writeToOutput(llvm::StringRef{stage_file_path}, [this] (llvm::raw_ostream& os) -> llvm::Error {
             LLVM_BUILDER_ASSERT(m_raw_module);
-            m_raw_module->print(os, nullptr);
+            M_print(os);
             return llvm::Error::success();
         });
         LLVM_BUILDER_ASSERT(not l_err);
     }
     void write_to_ostream() const {
         LLVM_BUILDER_ASSERT(m_raw_module);
-        // TODO{vibhanshu}: add assembly annotation for
-        m_raw_module->print(llvm::errs(), nullptr);
+        M_print(llvm::errs());
+    }
+    void M_print(llvm::raw_ostream& os) const {
+        // with debug info enabled, each instruction is annotated with its DSL value
+        if (m_debug_info) {
+            ValueAnnotationWriter l_writer{*m_debug_info};
+            m_raw_module->print(os, &l_writer);
+        } else {
+            m_raw_module->print(os, nullptr);
+        }
     }
 };
 
@@ -924,6 +1051,18 @@ llvm::Module* Module::native_handle() const {
     }
 }
 
+DebugInfoBuilder* Module::debug_info_builder() const {
+    if (has_error()) {
+        return nullptr;
+    }
+    if (std::shared_ptr<Impl> ptr = m_impl.lock()) {
+        return ptr->debug_info_builder();
+    } else {
+        M_mark_error();
+        return nullptr;
+    }
+}
+
 std::vector<std::string> Module::exported_symbol_names() const {
     if (has_error()) {
         return std::vector<std::string>{};
@@ -1059,6 +1198,7 @@ std::unique_ptr<llvm::orc::ThreadSafeModule> Module::take_thread_safe_module() {
         return nullptr;
     }
     if (std::shared_ptr<Impl> ptr = m_impl.lock()) {
+        ptr->finalize_debug_info();
         auto tsm = std::make_unique<llvm::orc::ThreadSafeModule>(
             std::move(ptr->m_raw_module), ptr->m_cursor_impl.thread_safe_context());
         ptr->m_is_init = false;
@@ -0,0 +1,447 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#include "llvm_builder/defines.h"
+#include "llvm_builder/rolling.h"
+#include "llvm_builder/function.h"
+#include "util/debug.h"
+
+LLVM_BUILDER_NS_BEGIN
+
+namespace {
+
+constexpr const char* c_value_field = "value";
+constexpr const char* c_is_seeded_field = "is_seeded";
+constexpr const char* c_sum_field = "sum";
+constexpr const char* c_mean_field = "mean";
+constexpr const char* c_m2_field = "m2";
+constexpr const char* c_prefix_field = "prefix";
+constexpr const char* c_sum_notional_field = "sum_notional";
+constexpr const char* c_sum_qty_field = "sum_qty";
+
+ValueInfo mk_constant(const TypeInfo& type, double v) {
+    if (type == TypeInfo::mk_float32()) {
+        return ValueInfo::from_constant(static_cast<float32_t>(v));
+    } else {
+        return ValueInfo::from_constant(v).cast(type);
+    }
+}
+
+bool has_field(const TypeInfo& struct_type, const std::string& name, const TypeInfo& type) {
+    const field_entry_t l_field = struct_type[name];
+    return not l_field.has_error() and l_field.type() == type;
+}
+
+std::vector<std::string> field_names(const std::string& prefix, uint32_t num) {
+    std::vector<std::string> l_names;
+    for (uint32_t i = 0; i != num; ++i) {
+        l_names.emplace_back(LLVM_BUILDER_CONCAT << prefix << i);
+    }
+    return l_names;
+}
+
+} // namespace
+
+//
+// Ewma
+//
+Ewma::Ewma() : BaseT{State::ERROR} {
+}
+
+Ewma::Ewma(const ValueInfo& base, uint32_t window)
+    : BaseT{State::VALID}
+    , m_base{base}
+    , m_window{window} {
+    if (base.has_error()) {
+        M_mark_error("can't build ewma over invalid value");
+        return;
+    }
+    if (not base.type().is_pointer() or not base.type().base_type().is_struct()) {
+        M_mark_error("ewma can be built only over a pointer to struct");
+        return;
+    }
+    const TypeInfo l_struct_type = base.type().base_type();
+    m_element_type = l_struct_type[c_value_field].type();
+    if (m_element_type.has_error() or not m_element_type.is_float()
+          or not has_field(l_struct_type, c_is_seeded_field, TypeInfo::mk_bool())) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "struct:" << l_struct_type.struct_name() << " not built by Ewma::mk_type()");
+    } else if (window == 0) {
+        M_mark_error("ewma can't be of window 0");
+    }
+}
+
+void Ewma::update(const ValueInfo& x) const {
+    CODEGEN_FN
+    if (has_error() or x.has_error()) {
+        return;
+    }
+    if (not x.equals_type(m_element_type)) {
+        CODEGEN_PUSH_ERROR(VALUE_ERROR, "can't update ewma of:" << m_element_type.short_name()
+                                        << " with value of type:" << x.type().short_name());
+        return;
+    }
+    const ValueInfo l_value = value();
+    const ValueInfo l_is_seeded = m_base.field(c_is_seeded_field).load();
+    const ValueInfo l_next = l_value + mk_constant(m_element_type, alpha()) * (x - l_value);
+    m_base.field(c_value_field).store(l_is_seeded.cond(l_next, x));
+    m_base.field(c_is_seeded_field).store(ValueInfo::from_constant(true));
+}
+
+ValueInfo Ewma::value() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    return m_base.field(c_value_field).load();
+}
+
+Ewma Ewma::null(const std::string& log) {
+    static Ewma s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    Ewma result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+TypeInfo Ewma::mk_type(const std::string& name, TypeInfo element_type) {
+    if (element_type.has_error()) {
+        return TypeInfo::null();
+    }
+    if (not element_type.is_float()) {
+        return TypeInfo::null(LLVM_BUILDER_CONCAT << "ewma can't be of type:" << element_type.short_name());
+    }
+    std::vector<field_entry_t> l_field_list;
+    l_field_list.emplace_back(c_value_field, element_type);
+    l_field_list.emplace_back(c_is_seeded_field, TypeInfo::mk_bool());
+    return TypeInfo::mk_struct(name, l_field_list, false);
+}
+
+//
+// RollingStats
+//
+RollingStats::RollingStats() : BaseT{State::ERROR} {
+}
+
+RollingStats::RollingStats(const ValueInfo& base)
+    : BaseT{State::VALID}
+    , m_ring{base} {
+    if (m_ring.has_error()) {
+        M_mark_error("rolling stats can be built only over a struct of RollingStats::mk_type()");
+        return;
+    }
+    const TypeInfo l_struct_type = base.type().base_type();
+    m_stat_type = stat_type(element_type());
+    if (not has_field(l_struct_type, c_sum_field, element_type())
+          or not has_field(l_struct_type, c_mean_field, m_stat_type)
+          or not has_field(l_struct_type, c_m2_field, m_stat_type)) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "struct:" << l_struct_type.struct_name() << " not built by RollingStats::mk_type()");
+    }
+}
+
+void RollingStats::update(const ValueInfo& x) const {
+    CODEGEN_FN
+    if (has_error() or x.has_error()) {
+        return;
+    }
+    if (not x.equals_type(element_type())) {
+        CODEGEN_PUSH_ERROR(VALUE_ERROR, "can't update rolling stats of:" << element_type().short_name()
+                                        << " with value of type:" << x.type().short_name());
+        return;
+    }
+    const ValueInfo& l_base = m_ring.base();
+    const ValueInfo l_is_full = m_ring.is_full();
+    const ValueInfo l_oldest = m_ring.oldest().load();
+    const ValueInfo l_zero = mk_constant(element_type(), 0.0);
+    l_base.field(c_sum_field).store(sum() + x - l_is_full.cond(l_oldest, l_zero));
+
+    const ValueInfo l_x = x.cast(m_stat_type);
+    const ValueInfo l_mean = mean();
+    const ValueInfo l_m2 = l_base.field(c_m2_field).load();
+    // window filling up, n -> n + 1
+    const ValueInfo l_count = (count() + ValueInfo::from_constant(static_cast<uint32_t>(1))).cast(m_stat_type);
+    const ValueInfo l_delta = l_x - l_mean;
+    const ValueInfo l_grow_mean = l_mean + l_delta / l_count;
+    const ValueInfo l_grow_m2 = l_m2 + l_delta * (l_x - l_grow_mean);
+    // full window, oldest value leaves as x enters
+    const ValueInfo l_y = l_oldest.cast(m_stat_type);
+    const ValueInfo l_diff = l_x - l_y;
+    const ValueInfo l_slide_mean = l_mean + l_diff * mk_constant(m_stat_type, 1.0 / window());
+    const ValueInfo l_slide_m2 = l_m2 + l_diff * (l_x - l_slide_mean + l_y - l_mean);
+    const ValueInfo l_next_m2 = l_is_full.cond(l_slide_m2, l_grow_m2);
+    const ValueInfo l_stat_zero = mk_constant(m_stat_type, 0.0);
+    l_base.field(c_mean_field).store(l_is_full.cond(l_slide_mean, l_grow_mean));
+    // rounding can take m2 of a constant window just below 0
+    l_base.field(c_m2_field).store((l_next_m2 < l_stat_zero).cond(l_stat_zero, l_next_m2));
+    m_ring.push(x);
+}
+
+ValueInfo RollingStats::count() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    return m_ring.size();
+}
+
+ValueInfo RollingStats::sum() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    return m_ring.base().field(c_sum_field).load();
+}
+
+ValueInfo RollingStats::mean() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    return m_ring.base().field(c_mean_field).load();
+}
+
+ValueInfo RollingStats::variance() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    const ValueInfo l_one = ValueInfo::from_constant(static_cast<uint32_t>(1));
+    const ValueInfo l_has_two = count() > l_one;
+    const ValueInfo l_dof = l_has_two.cond(count() - l_one, l_one).cast(m_stat_type);
+    const ValueInfo l_m2 = m_ring.base().field(c_m2_field).load();
+    return l_has_two.cond(l_m2 / l_dof, mk_constant(m_stat_type, 0.0));
+}
+
+RollingStats RollingStats::null(const std::string& log) {
+    static RollingStats s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    RollingStats result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+TypeInfo RollingStats::mk_type(const std::string& name, TypeInfo element_type, uint32_t window) {
+    if (element_type.has_error()) {
+        return TypeInfo::null();
+    }
+    if (not element_type.is_integer() and not element_type.is_float()) {
+        return TypeInfo::null(LLVM_BUILDER_CONCAT << "rolling stats can't be of type:" << element_type.short_name());
+    }
+    const TypeInfo l_stat_type = stat_type(element_type);
+    std::vector<field_entry_t> l_field_list;
+    l_field_list.emplace_back(c_sum_field, element_type);
+    l_field_list.emplace_back(c_mean_field, l_stat_type);
+    l_field_list.emplace_back(c_m2_field, l_stat_type);
+    return RingBuffer::mk_type(name, element_type, window, l_field_list);
+}
+
+TypeInfo RollingStats::stat_type(TypeInfo element_type) {
+    return element_type.is_float() ? element_type : TypeInfo::mk_float64();
+}
+
+//
+// RollingMinMax
+//
+RollingMinMax::RollingMinMax() : BaseT{State::ERROR} {
+}
+
+RollingMinMax::RollingMinMax(const ValueInfo& base, kind_t kind)
+    : BaseT{State::VALID}
+    , m_ring{base}
+    , m_kind{kind} {
+    if (m_ring.has_error()) {
+        M_mark_error("rolling min/max can be built only over a struct of RollingMinMax::mk_type()");
+        return;
+    }
+    const TypeInfo l_struct_type = base.type().base_type();
+    m_suffix = ArrayView::from_fields(base, field_names(c_suffix_prefix, window()));
+    if (m_suffix.has_error() or m_suffix.element_type() != element_type()
+          or not has_field(l_struct_type, c_value_field, element_type())
+          or not has_field(l_struct_type, c_prefix_field, element_type())) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "struct:" << l_struct_type.struct_name() << " not built by RollingMinMax::mk_type()");
+    }
+}
+
+void RollingMinMax::update(const ValueInfo& x) const {
+    CODEGEN_FN
+    if (has_error() or x.has_error()) {
+        return;
+    }
+    if (not x.equals_type(element_type())) {
+        CODEGEN_PUSH_ERROR(VALUE_ERROR, "can't update rolling min/max of:" << element_type().short_name()
+                                        << " with value of type:" << x.type().short_name());
+        return;
+    }
+    const ValueInfo& l_base = m_ring.base();
+    // position of x in its block
+    const ValueInfo l_pos = m_ring.head();
+    const ValueInfo l_zero = ValueInfo::from_constant(static_cast<uint32_t>(0));
+    const ValueInfo l_last = ValueInfo::from_constant(window() - 1);
+    const ValueInfo l_is_block_end = l_pos.equal(l_last);
+    const ValueInfo l_prefix = l_pos.equal(l_zero).cond(x, M_best(l_base.field(c_prefix_field).load(), x));
+    // suffix of previous block, not needed at end of block or while first block fills up
+    const ValueInfo l_suffix_idx = l_is_block_end.cond(l_zero, l_pos + ValueInfo::from_constant(static_cast<uint32_t>(1)));
+    const ValueInfo l_suffix = m_suffix.entry(l_suffix_idx).load();
+    const ValueInfo l_is_filling = m_ring.is_full().equal(ValueInfo::from_constant(false));
+    const ValueInfo l_prefix_only = l_is_block_end.cond(ValueInfo::from_constant(true), l_is_filling);
+    l_base.field(c_prefix_field).store(l_prefix);
+    l_base.field(c_value_field).store(l_prefix_only.cond(l_prefix, M_best(l_suffix, l_prefix)));
+    m_ring.push(x);
+    // block is complete, slot i holds its i-th value
+    IfElseCond l_block_end{"rolling_block_end", l_is_block_end};
+    l_block_end.then_branch([this] {
+        const ArrayView& l_slots = m_ring.slots();
+        const ValueInfo l_last_value = l_slots.entry(window() - 1).load();
+        m_suffix.entry(window() - 1).store(l_last_value);
+        if (window() == 1) {
+            return;
+        }
+        // suffix_i = best(slot_i, suffix_{i + 1}), emitted as a loop so code size doesn't grow with window
+        const ValueInfo l_one = ValueInfo::from_constant(static_cast<uint32_t>(1));
+        const ValueInfo l_idx = ValueInfo::mk_pointer(TypeInfo::mk_uint32());
+        const ValueInfo l_best = ValueInfo::mk_pointer(element_type());
+        l_idx.store(ValueInfo::from_constant(window() - 1));
+        l_best.store(l_last_value);
+        FunctionContext::do_while("rolling_suffix", [&] {
+            const ValueInfo l_i = l_idx.load() - l_one;
+            const ValueInfo l_next = M_best(l_slots.entry(l_i).load(), l_best.load());
+            m_suffix.entry(l_i).store(l_next);
+            l_best.store(l_next);
+            l_idx.store(l_i);
+            return l_i.not_equal(ValueInfo::from_constant(static_cast<uint32_t>(0)));
+        });
+    });
+    l_block_end.bind();
+}
+
+ValueInfo RollingMinMax::value() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    return m_ring.base().field(c_value_field).load();
+}
+
+ValueInfo RollingMinMax::M_best(const ValueInfo& a, const ValueInfo& b) const {
+    if (m_kind == kind_t::min) {
+        return (a < b).cond(a, b);
+    } else {
+        return (a > b).cond(a, b);
+    }
+}
+
+RollingMinMax RollingMinMax::null(const std::string& log) {
+    static RollingMinMax s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    RollingMinMax result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+TypeInfo RollingMinMax::mk_type(const std::string& name, TypeInfo element_type, uint32_t window) {
+    if (element_type.has_error()) {
+        return TypeInfo::null();
+    }
+    if (not element_type.is_integer() and not element_type.is_float()) {
+        return TypeInfo::null(LLVM_BUILDER_CONCAT << "rolling min/max can't be of type:" << element_type.short_name());
+    }
+    std::vector<field_entry_t> l_field_list;
+    l_field_list.emplace_back(c_value_field, element_type);
+    l_field_list.emplace_back(c_prefix_field, element_type);
+    for (const std::string& l_name : field_names(c_suffix_prefix, window)) {
+        l_field_list.emplace_back(l_name, element_type);
+    }
+    return RingBuffer::mk_type(name, element_type, window, l_field_list);
+}
+
+//
+// Vwap
+//
+Vwap::Vwap() : BaseT{State::ERROR} {
+}
+
+Vwap::Vwap(const ValueInfo& base)
+    : BaseT{State::VALID}
+    , m_ring{base} {
+    if (m_ring.has_error()) {
+        M_mark_error("vwap can be built only over a struct of Vwap::mk_type()");
+        return;
+    }
+    const TypeInfo l_struct_type = base.type().base_type();
+    m_qty = ArrayView::from_fields(base, field_names(c_qty_prefix, window()));
+    if (m_qty.has_error() or not price_type().is_float()
+          or not has_field(l_struct_type, c_sum_notional_field, price_type())
+          or not has_field(l_struct_type, c_sum_qty_field, qty_type())) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "struct:" << l_struct_type.struct_name() << " not built by Vwap::mk_type()");
+    }
+}
+
+void Vwap::update(const ValueInfo& price, const ValueInfo& qty) const {
+    CODEGEN_FN
+    if (has_error() or price.has_error() or qty.has_error()) {
+        return;
+    }
+    if (not price.equals_type(price_type()) or not qty.equals_type(qty_type())) {
+        CODEGEN_PUSH_ERROR(VALUE_ERROR, "can't update vwap of price:" << price_type().short_name()
+                                        << ", qty:" << qty_type().short_name() << " with price:"
+                                        << price.type().short_name() << ", qty:" << qty.type().short_name());
+        return;
+    }
+    const ValueInfo& l_base = m_ring.base();
+    const ValueInfo l_is_full = m_ring.is_full();
+    const ValueInfo l_oldest_slot = m_ring.oldest_slot();
+    const ValueInfo l_notional = price * qty.cast(price_type());
+    const ValueInfo l_old_notional = l_is_full.cond(m_ring.oldest().load(), mk_constant(price_type(), 0.0));
+    const ValueInfo l_old_qty = l_is_full.cond(m_qty.entry(l_oldest_slot).load(), mk_constant(qty_type(), 0.0));
+    l_base.field(c_sum_notional_field).store(l_base.field(c_sum_notional_field).load() + l_notional - l_old_notional);
+    l_base.field(c_sum_qty_field).store(sum_qty() + qty - l_old_qty);
+    m_qty.entry(m_ring.head()).store(qty);
+    m_ring.push(l_notional);
+}
+
+ValueInfo Vwap::value() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    const ValueInfo l_sum_qty = sum_qty().cast(price_type());
+    const ValueInfo l_zero = mk_constant(price_type(), 0.0);
+    const ValueInfo l_has_qty = l_sum_qty.not_equal(l_zero);
+    const ValueInfo l_sum_notional = m_ring.base().field(c_sum_notional_field).load();
+    return l_has_qty.cond(l_sum_notional / l_has_qty.cond(l_sum_qty, mk_constant(price_type(), 1.0)), l_zero);
+}
+
+ValueInfo Vwap::sum_qty() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    return m_ring.base().field(c_sum_qty_field).load();
+}
+
+Vwap Vwap::null(const std::string& log) {
+    static Vwap s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    Vwap result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+TypeInfo Vwap::mk_type(const std::string& name, TypeInfo price_type, TypeInfo qty_type, uint32_t window) {
+    if (price_type.has_error() or qty_type.has_error()) {
+        return TypeInfo::null();
+    }
+    if (not price_type.is_float() or (not qty_type.is_integer() and not qty_type.is_float())) {
+        return TypeInfo::null(LLVM_BUILDER_CONCAT << "vwap can't be of price:" << price_type.short_name()
+                                                  << ", qty:" << qty_type.short_name());
+    }
+    std::vector<field_entry_t> l_field_list;
+    for (const std::string& l_name : field_names(c_qty_prefix, window)) {
+        l_field_list.emplace_back(l_name, qty_type);
+    }
+    l_field_list.emplace_back(c_sum_notional_field, price_type);
+    l_field_list.emplace_back(c_sum_qty_field, qty_type);
+    return RingBuffer::mk_type(name, price_type, window, l_field_list);
+}
+
+LLVM_BUILDER_NS_END
@@ -774,6 +774,15 @@ public:
     BINARY_OP_IMPL_FN(mult, CreateMul, CreateMul, CreateFMul)
     BINARY_OP_IMPL_FN(div, CreateSDiv, CreateUDiv, CreateFDiv)
     BINARY_OP_IMPL_FN(remainder, CreateSRem, CreateURem, CreateFRem)
+    llvm::Value* bit_and(llvm::Value* lhs, llvm::Value* rhs) {
+        LLVM_BUILDER_ASSERT(lhs != nullptr)
+        LLVM_BUILDER_ASSERT(rhs != nullptr)
+        if (not is_integer_equiv() and not is_boolean_equiv()) {
+            CODEGEN_PUSH_ERROR(TYPE_ERROR, "bit_and not supported for type:" << short_name());
+            return nullptr;
+        }
+        return m_cursor_impl.builder().CreateAnd(lhs, rhs, "");
+    }
     BINARY_OP_IMPL_FN(less_than, CreateICmpSLT, CreateICmpULT, CreateFCmpOLT)
     BINARY_OP_IMPL_FN(less_than_equal, CreateICmpSLE, CreateICmpULE, CreateFCmpOLE)
     BINARY_OP_IMPL_FN(greater_than, CreateICmpSGT, CreateICmpUGT, CreateFCmpOGT)
@@ -7,6 +7,7 @@
 #include "llvm_builder/value.h"
 #include "llvm_builder/analyze.h"
 #include "llvm/context_impl.h"
+#include "llvm/debug_info.h"
 #include "llvm_builder/function.h"
 #include "llvm_builder/module.h"
 #include "util/debug.h"
@@ -66,22 +67,60 @@ TagInfo TagInfo::set_union(const TagInfo& o) const {
     return l_res;
 }
 
+void TagInfo::print(std::ostream& os) const {
+    separator_t sep{"|"};
+    for (const std::string& v : m_values) {
+        os << sep << v;
+    }
+}
+
 //
 // ValueInfo::Impl
 //
+namespace {
+
+const char* value_type_name(ValueInfo::value_type_t t) {
+    using value_type_t = ValueInfo::value_type_t;
+    switch (t) {
+    case value_type_t::null:               return "null";
+    case value_type_t::constant:           return "constant";
+    case value_type_t::context:            return "context";
+    case value_type_t::binary:             return "binary";
+    case value_type_t::conditional:        return "conditional";
+    case value_type_t::typecast:           return "typecast";
+    case value_type_t::inner_entry:        return "inner_entry";
+    case value_type_t::load:               return "load";
+    case value_type_t::store:              return "store";
+    case value_type_t::load_vector_entry:  return "load_vector_entry";
+    case value_type_t::store_vector_entry: return "store_vector_entry";
+    case value_type_t::valid_bit:          return "valid_bit";
+    case value_type_t::strided_entry:      return "strided_entry";
+    case value_type_t::mk_ptr:             return "mk_ptr";
+    case value_type_t::fn_call:            return "fn_call";
+    case value_type_t::fn_ptr_call:        return "fn_ptr_call";
+    }
+    return "unknown";
+}
+
+} // namespace
+
 class ValueInfo::Impl {
 private:
     value_type_t m_value_type = value_type_t::null;
     TypeInfo m_type_info;
     std::vector<ValueInfo> m_parent;
     TagInfo m_tag_info;
+    SourceLoc m_source_loc;
     llvm::Value* m_const_value_cache = nullptr;
     binary_op_fn_t m_binary_op = nullptr;
     TypeInfo m_parent_ptr_type;
     llvm::Function* m_fn_ptr = nullptr;
+    uint32_t m_byte_offset = 0;
+    uint32_t m_byte_stride = 0;
 public:
     explicit Impl(value_type_t value_type, const TypeInfo& type_info)
       : m_value_type{value_type} , m_type_info{type_info} {
+        SourceContext::peek_external(m_source_loc);
     }
     Impl(const Impl&) = delete;
     Impl(Impl&&) = delete;
@@ -101,6 +140,9 @@ public:
     void set_value_cache(llvm::Value* v) {
         m_const_value_cache = v;
     }
+    llvm::Value* const_value() const {
+        return m_const_value_cache;
+    }
     void set_fn_ptr(llvm::Function* fn) {
         m_fn_ptr = fn;
     }
@@ -110,6 +152,10 @@ public:
     void set_parent_ptr_type(const TypeInfo& t) {
         m_parent_ptr_type = t;
     }
+    void set_byte_stride(uint32_t offset, uint32_t stride) {
+        m_byte_offset = offset;
+        m_byte_stride = stride;
+    }
     value_type_t value_type() const {
         return m_value_type;
     }
@@ -127,9 +173,16 @@ public:
     const TagInfo& tag() const {
         return m_tag_info;
     }
+    const SourceLoc& source_loc() const {
+        return m_source_loc;
+    }
     bool has_tag(std::string_view v) const {
         return m_tag_info.contains(v);
     }
+    analysis::ValueAnnotation annotation() const {
+        std::string l_description = LLVM_BUILDER_CONCAT << value_type_name(m_value_type) << ":" << m_type_info.short_name();
+        return analysis::ValueAnnotation{l_description, m_tag_info, m_source_loc};
+    }
     bool operator == (const Impl& o) const {
         if (this == &o) {
             return true;
@@ -178,6 +231,11 @@ public:
             case value_type_t::store:      return true;       break;
             case value_type_t::load_vector_entry:   return true; break;
             case value_type_t::store_vector_entry:  return true; break;
+            case value_type_t::valid_bit:           return true; break;
+            case value_type_t::strided_entry: {
+                return m_byte_offset == o.m_byte_offset and m_byte_stride == o.m_byte_stride;
+                break;
+            }
             case value_type_t::mk_ptr:     return false;     break;
             case value_type_t::fn_call:    return false;    break;
             case value_type_t::fn_ptr_call:    return false;    break;
@@ -293,6 +351,50 @@ public:
             return nullptr;
         }
     }
+    llvm::Value* M_eval_valid_bit() {
+        LLVM_BUILDER_ASSERT(m_parent.size() == 2);
+        llvm::Value* l_bitmap = m_parent[0].M_eval();
+        llvm::Value* l_idx = m_parent[1].M_eval();
+        if (CursorContextImpl::has_value() and l_bitmap != nullptr and l_idx != nullptr) {
+            llvm::IRBuilder<>& l_cursor = CursorContextImpl::builder();
+            llvm::Type* l_i8_type = llvm::Type::getInt8Ty(CursorContextImpl::ctx());
+            llvm::Type* l_i64_type = llvm::Type::getInt64Ty(CursorContextImpl::ctx());
+            // byte idx / 8, then bit idx % 8 of it
+            llvm::Value* l_bit_idx = l_cursor.CreateZExtOrTrunc(l_idx, l_i64_type, "");
+            std::array<llvm::Value*, 2u> index_list;
+            index_list[0] = llvm::ConstantInt::get(l_i64_type, 0);
+            index_list[1] = l_cursor.CreateLShr(l_bit_idx, 3, "");
+            llvm::Value* l_byte_ptr = l_cursor.CreateGEP(m_parent[0].type().base_type().native_value(), l_bitmap, index_list, "_valid_byte");
+            llvm::Value* l_byte = l_cursor.CreateLoad(l_i8_type, l_byte_ptr, "");
+            llvm::Value* l_shift = l_cursor.CreateTrunc(l_cursor.CreateAnd(l_bit_idx, 7, ""), l_i8_type, "");
+            return l_cursor.CreateTrunc(l_cursor.CreateLShr(l_byte, l_shift, ""), m_type_info.native_value(), "");
+        } else {
+            return nullptr;
+        }
+    }
+    llvm::Value* M_eval_strided_entry() {
+        LLVM_BUILDER_ASSERT(m_parent.size() == 2);
+        llvm::Value* l_src = m_parent[0].M_eval();
+        llvm::Value* l_idx = m_parent[1].M_eval();
+        if (CursorContextImpl::has_value() and l_src != nullptr and l_idx != nullptr) {
+            llvm::IRBuilder<>& l_cursor = CursorContextImpl::builder();
+            llvm::Type* l_i8_type = llvm::Type::getInt8Ty(CursorContextImpl::ctx());
+            llvm::Type* l_i64_type = llvm::Type::getInt64Ty(CursorContextImpl::ctx());
+            // index is signed like in GEP of entry(), unless its type says otherwise
+            llvm::Value* l_idx_64 = nullptr;
+            if (m_parent[1].type().is_unsigned_integer()) {
+                l_idx_64 = l_cursor.CreateZExtOrTrunc(l_idx, l_i64_type, "");
+            } else {
+                l_idx_64 = l_cursor.CreateSExtOrTrunc(l_idx, l_i64_type, "");
+            }
+            llvm::Value* l_byte_idx = l_cursor.CreateAdd(l_cursor.CreateMul(l_idx_64, llvm::ConstantInt::get(l_i64_type, m_byte_stride), ""),
+                                                         llvm::ConstantInt::get(l_i64_type, m_byte_offset), "");
+            // pointers are opaque, byte GEP gives pointer of any entry type
+            return l_cursor.CreateGEP(l_i8_type, l_src, l_byte_idx, "_strided");
+        } else {
+            return nullptr;
+        }
+    }
     llvm::Value* M_eval_mk_ptr() {
         LLVM_BUILDER_ASSERT(m_parent.size() == 0);
         LLVM_BUILDER_ASSERT(m_const_value_cache != nullptr);
@@ -481,6 +583,20 @@ ValueInfo::ValueInfo(const ValueInfo& parent, const TypeInfo& entry_type, const
     object::Counter::singleton().on_new(object::Callback::object_t::VALUE, (uint64_t)this, "");
 }
 
+ValueInfo::ValueInfo(const ValueInfo& parent, const TypeInfo& entry_type, const ValueInfo& entry_idx,
+                     uint32_t offset, uint32_t stride, construct_strided_t)
+    : BaseT{State::VALID}
+    , m_impl{std::make_shared<Impl>(value_type_t::strided_entry, entry_type.mk_ptr())} {
+    LLVM_BUILDER_ASSERT(not parent.has_error());
+    LLVM_BUILDER_ASSERT(not entry_type.has_error());
+    LLVM_BUILDER_ASSERT(not entry_idx.has_error());
+    LLVM_BUILDER_ASSERT(parent.type().is_pointer());
+    m_impl->add_parent(std::vector<ValueInfo>{{parent, entry_idx}});
+    m_impl->set_byte_stride(offset, stride);
+    M_self_intern();
+    object::Counter::singleton().on_new(object::Callback::object_t::VALUE, (uint64_t)this, "");
+}
+
 ValueInfo::ValueInfo(const TypeInfo& res_type, const ValueInfo& v1, const ValueInfo& v2, binary_op_fn_t fn, construct_binary_op_t)
     : BaseT{State::VALID}
     , m_impl{std::make_shared<Impl>(value_type_t::binary, res_type)} {
@@ -537,6 +653,39 @@ const std::vector<ValueInfo>& ValueInfo::M_parents() const {
     return m_impl->parents();
 }
 
+uint32_t ValueInfo::M_context_field() const {
+    if (has_error()) {
+        return c_unknown_field;
+    }
+    LLVM_BUILDER_ASSERT(m_impl != nullptr);
+    const std::vector<ValueInfo>& l_parents = m_impl->parents();
+    switch (m_impl->value_type()) {
+    case value_type_t::inner_entry: {
+        LLVM_BUILDER_ASSERT(l_parents.size() == 2);
+        if (l_parents[0].value_type() != value_type_t::context) {
+            return l_parents[0].M_context_field();
+        }
+        llvm::Value* l_idx = l_parents[1].value_type() == value_type_t::constant
+                                ? l_parents[1].m_impl->const_value() : nullptr;
+        if (auto* l_const_idx = llvm::dyn_cast_or_null<llvm::ConstantInt>(l_idx)) {
+            return static_cast<uint32_t>(l_const_idx->getZExtValue());
+        }
+        return c_unknown_field;
+    }
+    case value_type_t::strided_entry:
+    case value_type_t::load:
+        LLVM_BUILDER_ASSERT(not l_parents.empty());
+        if (l_parents[0].value_type() == value_type_t::context) {
+            return c_unknown_field;
+        }
+        return l_parents[0].M_context_field();
+    case value_type_t::mk_ptr:
+        return c_local_field;
+    default:
+        return c_unknown_field;
+    }
+}
+
 TypeInfo ValueInfo::type() const {
     if (has_error()) {
         return TypeInfo::null();
@@ -582,6 +731,15 @@ void ValueInfo::M_set_const_value_cache(llvm::Value* v) {
     m_impl->set_value_cache(v);
 }
 
+const SourceLoc& ValueInfo::source_loc() const {
+    if (has_error()) {
+        static const SourceLoc l_source_loc;
+        return l_source_loc;
+    }
+    LLVM_BUILDER_ASSERT(m_impl != nullptr);
+    return m_impl->source_loc();
+}
+
 bool ValueInfo::has_tag(std::string_view v) const {
     if (has_error()) {
         return false;
@@ -755,6 +913,53 @@ ValueInfo ValueInfo::field(const std::string& s) const {
     return ValueInfo{*this, field_entry.type(), tgt_idx, construct_entry_t{}};
 }
 
+ValueInfo ValueInfo::is_valid_entry(const ValueInfo& i) const {
+    CODEGEN_FN
+    if (has_error() or i.has_error()) {
+        M_mark_error();
+        return ValueInfo::null();
+    }
+    if (not type().is_pointer() or not type().base_type().is_array()
+        or type().base_type().base_type() != TypeInfo::mk_uint8()) {
+        return ValueInfo::null("validity bitmap should be a pointer to uint8 array");
+    }
+    if (not i.type().is_integer()) {
+        return ValueInfo::null("validity bitmap index should be an integer");
+    }
+    ValueInfo v{value_type_t::valid_bit, TypeInfo::mk_bool(), std::vector<ValueInfo>{{*this, i}}};
+    v.add_tag(tag_info().set_union(i.tag_info()));
+    return v;
+}
+
+ValueInfo ValueInfo::entry_or(const ValueInfo& i, const ValueInfo& validity, const ValueInfo& fallback) const {
+    CODEGEN_FN
+    if (has_error() or i.has_error() or validity.has_error() or fallback.has_error()) {
+        M_mark_error();
+        return ValueInfo::null();
+    }
+    return validity.is_valid_entry(i).cond(entry(i).load(), fallback);
+}
+
+ValueInfo ValueInfo::strided_entry(const ValueInfo& i, TypeInfo entry_type, uint32_t offset, uint32_t stride) const {
+    CODEGEN_FN
+    if (has_error() or i.has_error() or entry_type.has_error()) {
+        M_mark_error();
+        return ValueInfo::null();
+    }
+    if (not type().is_pointer() or (not type().base_type().is_array() and not type().base_type().is_struct())) {
+        return ValueInfo::null("can't define strided-entry operation for non-array, non-struct pointer type");
+    }
+    if (not i.type().is_integer()) {
+        return ValueInfo::null("strided-entry index should be an integer");
+    }
+    if (not entry_type.is_scalar() and not entry_type.is_pointer()) {
+        return ValueInfo::null("strided-entry can be only of scalar type or of pointer");
+    }
+    ValueInfo v{*this, entry_type, i, offset, stride, construct_strided_t{}};
+    v.add_tag(tag_info().set_union(i.tag_info()));
+    return v;
+}
+
 ValueInfo ValueInfo::load_vector_entry(const ValueInfo& idx_v) const {
     CODEGEN_FN
     if (has_error() or idx_v.has_error()) {
@@ -912,6 +1117,13 @@ llvm::Value* ValueInfo::M_eval() {
     if (l_res != nullptr) {
         return l_res;
     }
+    Function l_fn = FunctionContext::function();
+    DebugInfoBuilder* l_debug_info = l_fn.parent_module().debug_info_builder();
+    uint32_t l_discriminator = 0;
+    if (l_debug_info != nullptr and l_fn.native_handle() != nullptr) {
+        l_discriminator = l_debug_info->add_annotation(l_fn.native_handle(), m_impl->annotation());
+    }
+    DebugLocGuard l_debug_loc{l_debug_info, l_fn.native_handle(), m_impl->source_loc(), l_discriminator};
 #define CASE_ENTRY(x)    case value_type_t::x:   l_res = m_impl->M_eval_##x(); break;
     switch (l_vtype) {
     CASE_ENTRY(null)
@@ -925,6 +1137,8 @@ llvm::Value* ValueInfo::M_eval() {
     CASE_ENTRY(store)
     CASE_ENTRY(load_vector_entry)
     CASE_ENTRY(store_vector_entry)
+    CASE_ENTRY(valid_bit)
+    CASE_ENTRY(strided_entry)
     CASE_ENTRY(mk_ptr)
     CASE_ENTRY(fn_call)
     CASE_ENTRY(fn_ptr_call)
@@ -934,6 +1148,459 @@ llvm::Value* ValueInfo::M_eval() {
     return l_res;
 }
 
+//
+// Collection
+//
+Collection::Collection() : BaseT{State::ERROR} {
+}
+
+Collection::Collection(const ValueInfo& buffer, TypeInfo element_type, uint32_t capacity, layout_t layout)
+    : BaseT{State::VALID}
+    , m_buffer{buffer}
+    , m_element_type{element_type}
+    , m_capacity{capacity}
+    , m_layout{layout} {
+    if (buffer.has_error() or element_type.has_error()) {
+        M_mark_error("can't build collection of invalid buffer or element type");
+    } else if (not M_layout(element_type, capacity, layout, m_field_offsets, m_field_strides, m_num_bytes)) {
+        M_mark_error("collection should be of struct type with non zero capacity, within 4GB");
+    } else if (not buffer.equals_type(buffer_type(element_type, capacity, layout))) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "collection buffer should be a pointer to uint8 array of "
+                     << m_num_bytes << " bytes, found:" << buffer.type().short_name());
+    }
+}
+
+uint32_t Collection::field_offset(const std::string& s) const {
+    if (has_error()) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    const field_entry_t l_field = m_element_type[s];
+    if (l_field.has_error()) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    return m_field_offsets[l_field.idx()];
+}
+
+uint32_t Collection::field_stride(const std::string& s) const {
+    if (has_error()) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    const field_entry_t l_field = m_element_type[s];
+    if (l_field.has_error()) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    return m_field_strides[l_field.idx()];
+}
+
+uint32_t Collection::byte_offset(uint32_t i, const std::string& s) const {
+    if (has_error() or i >= m_capacity) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    const uint32_t l_offset = field_offset(s);
+    if (l_offset == std::numeric_limits<uint32_t>::max()) {
+        return l_offset;
+    }
+    return l_offset + i * field_stride(s);
+}
+
+auto Collection::entry(uint32_t i) const -> Entry {
+    CODEGEN_FN
+    if (has_error()) {
+        return Entry{*this, ValueInfo::null()};
+    }
+    if (i >= m_capacity) {
+        return Entry{*this, ValueInfo::null(LLVM_BUILDER_CONCAT << "collection is of capacity: " << m_capacity << ", can't access element:" << i)};
+    }
+    return Entry{*this, ValueInfo::from_constant(i)};
+}
+
+auto Collection::entry(const ValueInfo& i) const -> Entry {
+    CODEGEN_FN
+    // TODO{vibhanshu}: like ValueInfo::entry(), runtime index is not bounds checked
+    return Entry{*this, i};
+}
+
+auto Collection::null(const std::string& log) -> Collection {
+    static Collection s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    Collection result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+TypeInfo Collection::buffer_type(TypeInfo element_type, uint32_t capacity, layout_t layout) {
+    CODEGEN_FN
+    const uint32_t l_num_bytes = buffer_size(element_type, capacity, layout);
+    if (l_num_bytes == 0) {
+        return TypeInfo::null("collection should be of struct type with non zero capacity, within 4GB");
+    }
+    return TypeInfo::mk_array(TypeInfo::mk_uint8(), l_num_bytes).mk_ptr();
+}
+
+uint32_t Collection::buffer_size(TypeInfo element_type, uint32_t capacity, layout_t layout) {
+    std::vector<uint32_t> l_offsets;
+    std::vector<uint32_t> l_strides;
+    uint32_t l_num_bytes = 0;
+    if (M_layout(element_type, capacity, layout, l_offsets, l_strides, l_num_bytes)) {
+        return l_num_bytes;
+    } else {
+        return 0;
+    }
+}
+
+bool Collection::M_layout(TypeInfo element_type, uint32_t capacity, layout_t layout,
+                          std::vector<uint32_t>& offsets, std::vector<uint32_t>& strides, uint32_t& num_bytes) {
+    if (element_type.has_error() or not element_type.is_struct() or capacity == 0) {
+        return false;
+    }
+    offsets.clear();
+    strides.clear();
+    const uint32_t l_num_fields = element_type.num_elements();
+    uint64_t l_end = 0;
+    for (uint32_t i = 0; i != l_num_fields; ++i) {
+        const field_entry_t l_field = element_type[i];
+        switch (layout) {
+        case layout_t::aos:
+            offsets.emplace_back(l_field.offset());
+            strides.emplace_back(element_type.size_in_bytes());
+            l_end = static_cast<uint64_t>(capacity) * element_type.size_in_bytes();
+            break;
+        case layout_t::soa: {
+            const uint64_t l_begin = (l_end + c_column_alignment - 1) / c_column_alignment * c_column_alignment;
+            const uint32_t l_size = l_field.type().size_in_bytes();
+            // truncation is caught by size check below
+            offsets.emplace_back(static_cast<uint32_t>(l_begin));
+            strides.emplace_back(l_size);
+            l_end = l_begin + static_cast<uint64_t>(capacity) * l_size;
+            break;
+        }
+        }
+    }
+    if (l_end == 0 or l_end > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    num_bytes = static_cast<uint32_t>(l_end);
+    return true;
+}
+
+//
+// Collection::Entry
+//
+Collection::Entry::Entry(const Collection& collection, const ValueInfo& idx)
+    : m_collection{collection}, m_idx{idx} {
+}
+
+ValueInfo Collection::Entry::field(const std::string& s) const {
+    CODEGEN_FN
+    if (m_collection.has_error() or m_idx.has_error()) {
+        return ValueInfo::null();
+    }
+    const field_entry_t l_field = m_collection.m_element_type[s];
+    if (l_field.has_error()) {
+        return ValueInfo::null(LLVM_BUILDER_CONCAT << "unable to find field:" << s << " in collection of:" << m_collection.m_element_type.short_name());
+    }
+    const uint32_t l_idx = l_field.idx();
+    return m_collection.m_buffer.strided_entry(m_idx, l_field.type(), m_collection.m_field_offsets[l_idx], m_collection.m_field_strides[l_idx]);
+}
+
+//
+// ArrayView
+//
+ArrayView::ArrayView() : BaseT{State::ERROR} {
+}
+
+ArrayView::ArrayView(const ValueInfo& base)
+    : ArrayView{base, 0, base.type().base_type().num_elements(), 1} {
+}
+
+ArrayView::ArrayView(const ValueInfo& base, uint32_t offset, uint32_t length, uint32_t stride)
+    : BaseT{State::VALID}
+    , m_base{base}
+    , m_length{length} {
+    if (base.has_error()) {
+        M_mark_error("can't build view of invalid value");
+        return;
+    }
+    const TypeInfo l_type = base.type();
+    if (not l_type.is_pointer() or not l_type.base_type().is_array()) {
+        M_mark_error("view can be built only over a pointer to array");
+        return;
+    }
+    const TypeInfo l_array_type = l_type.base_type();
+    if (length == 0 or stride == 0) {
+        M_mark_error("view can't be empty or of stride 0");
+        return;
+    }
+    const uint64_t l_last = offset + static_cast<uint64_t>(length - 1) * stride;
+    if (l_last >= l_array_type.num_elements()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "view entry:" << l_last << " out of array of size:" << l_array_type.num_elements());
+        return;
+    }
+    m_element_type = l_array_type.base_type();
+    const uint32_t l_element_size = m_element_type.size_in_bytes();
+    m_byte_offset = offset * l_element_size;
+    m_byte_stride = stride * l_element_size;
+}
+
+ArrayView::ArrayView(const ValueInfo& base, TypeInfo element_type, uint32_t byte_offset, uint32_t byte_stride, uint32_t length)
+    : BaseT{State::VALID}
+    , m_base{base}
+    , m_element_type{element_type}
+    , m_byte_offset{byte_offset}
+    , m_byte_stride{byte_stride}
+    , m_length{length} {
+}
+
+ValueInfo ArrayView::entry(uint32_t i) const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    if (i >= m_length) {
+        return ValueInfo::null(LLVM_BUILDER_CONCAT << "view is of length: " << m_length << ", can't access element:" << i);
+    }
+    return m_base.strided_entry(ValueInfo::from_constant(i), m_element_type, m_byte_offset, m_byte_stride);
+}
+
+ValueInfo ArrayView::entry(const ValueInfo& i) const {
+    CODEGEN_FN
+    if (has_error() or i.has_error()) {
+        return ValueInfo::null();
+    }
+    // TODO{vibhanshu}: like ValueInfo::entry(), runtime index is not bounds checked
+    return m_base.strided_entry(i, m_element_type, m_byte_offset, m_byte_stride);
+}
+
+ArrayView ArrayView::slice(uint32_t begin, uint32_t length, uint32_t step) const {
+    if (has_error()) {
+        return ArrayView::null();
+    }
+    if (length == 0 or step == 0) {
+        return ArrayView::null("view can't be empty or of stride 0");
+    }
+    const uint64_t l_last = begin + static_cast<uint64_t>(length - 1) * step;
+    if (l_last >= m_length) {
+        return ArrayView::null(LLVM_BUILDER_CONCAT << "slice entry:" << l_last << " out of view of length:" << m_length);
+    }
+    return ArrayView{m_base, m_element_type, m_byte_offset + begin * m_byte_stride, m_byte_stride * step, length};
+}
+
+ArrayView ArrayView::null(const std::string& log) {
+    static ArrayView s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    ArrayView result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+ArrayView ArrayView::from_fields(const ValueInfo& base, const std::vector<std::string>& names) {
+    if (base.has_error()) {
+        return ArrayView::null();
+    }
+    if (not base.type().is_pointer() or not base.type().base_type().is_struct()) {
+        return ArrayView::null("view of fields can be built only over a pointer to struct");
+    }
+    if (names.empty()) {
+        return ArrayView::null("view of fields can't be empty");
+    }
+    const TypeInfo l_struct_type = base.type().base_type();
+    std::vector<field_entry_t> l_fields;
+    for (const std::string& l_name : names) {
+        field_entry_t l_field = l_struct_type[l_name];
+        if (l_field.has_error()) {
+            return ArrayView::null(LLVM_BUILDER_CONCAT << "unable to find field:" << l_name << " in struct:" << l_struct_type.struct_name());
+        }
+        l_fields.emplace_back(l_field);
+    }
+    const TypeInfo l_element_type = l_fields[0].type();
+    uint32_t l_byte_stride = l_element_type.size_in_bytes();
+    if (l_fields.size() > 1) {
+        if (l_fields[1].offset() <= l_fields[0].offset()) {
+            return ArrayView::null("fields of a view should be in increasing order of offset");
+        }
+        l_byte_stride = l_fields[1].offset() - l_fields[0].offset();
+    }
+    for (uint32_t i = 0; i != l_fields.size(); ++i) {
+        if (l_fields[i].type() != l_element_type) {
+            return ArrayView::null(LLVM_BUILDER_CONCAT << "field:" << l_fields[i].name() << " of view is not of type:" << l_element_type.short_name());
+        }
+        if (l_fields[i].offset() != l_fields[0].offset() + i * l_byte_stride) {
+            return ArrayView::null(LLVM_BUILDER_CONCAT << "field:" << l_fields[i].name() << " of view is not evenly spaced");
+        }
+    }
+    return ArrayView{base, l_element_type, l_fields[0].offset(), l_byte_stride, static_cast<uint32_t>(l_fields.size())};
+}
+
+//
+// RingBuffer
+//
+RingBuffer::RingBuffer() : BaseT{State::ERROR} {
+}
+
+RingBuffer::RingBuffer(const ValueInfo& base)
+    : BaseT{State::VALID}
+    , m_base{base} {
+    if (base.has_error()) {
+        M_mark_error("can't build ring buffer over invalid value");
+        return;
+    }
+    if (not base.type().is_pointer() or not base.type().base_type().is_struct()) {
+        M_mark_error("ring buffer can be built only over a pointer to struct");
+        return;
+    }
+    const TypeInfo l_struct_type = base.type().base_type();
+    const uint32_t l_num_fields = l_struct_type.num_elements();
+    const TypeInfo l_uint32_type = TypeInfo::mk_uint32();
+    if (l_num_fields < 3
+          or l_struct_type[0].name() != c_head_field or l_struct_type[0].type() != l_uint32_type
+          or l_struct_type[1].name() != c_size_field or l_struct_type[1].type() != l_uint32_type) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "struct:" << l_struct_type.struct_name() << " not built by RingBuffer::mk_type()");
+        return;
+    }
+    std::vector<std::string> l_slot_names;
+    for (uint32_t i = 2; i != l_num_fields and l_struct_type[i].name() == slot_name(i - 2); ++i) {
+        l_slot_names.emplace_back(l_struct_type[i].name());
+    }
+    m_slots = ArrayView::from_fields(base, l_slot_names);
+    if (m_slots.has_error()) {
+        M_mark_error(LLVM_BUILDER_CONCAT << "slots of struct:" << l_struct_type.struct_name() << " not laid out as a ring buffer");
+    }
+}
+
+void RingBuffer::push(const ValueInfo& v) const {
+    CODEGEN_FN
+    if (has_error() or v.has_error()) {
+        return;
+    }
+    if (not v.equals_type(element_type())) {
+        CODEGEN_PUSH_ERROR(VALUE_ERROR, "can't push value of type:" << v.type().short_name()
+                                        << " into ring buffer of:" << element_type().short_name());
+        return;
+    }
+    const ValueInfo l_head = head();
+    const ValueInfo l_size = size();
+    const ValueInfo l_one = ValueInfo::from_constant(static_cast<uint32_t>(1));
+    m_slots.entry(l_head).store(v);
+    m_base.field(c_head_field).store(M_wrap(l_head + l_one));
+    m_base.field(c_size_field).store(l_size + (l_size < ValueInfo::from_constant(capacity())).cast(TypeInfo::mk_uint32()));
+}
+
+ValueInfo RingBuffer::at(uint32_t i) const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    if (i >= capacity()) {
+        return ValueInfo::null(LLVM_BUILDER_CONCAT << "ring buffer is of capacity: " << capacity() << ", can't access element:" << i);
+    }
+    return m_slots.entry(M_wrap(head() + ValueInfo::from_constant(capacity() - 1 - i)));
+}
+
+ValueInfo RingBuffer::at(const ValueInfo& i) const {
+    CODEGEN_FN
+    if (has_error() or i.has_error()) {
+        return ValueInfo::null();
+    }
+    if (not i.type().is_integer()) {
+        return ValueInfo::null("ring buffer can be indexed only by an integer");
+    }
+    const ValueInfo l_last = ValueInfo::from_constant(capacity() - 1);
+    ValueInfo l_idx = i.cast(TypeInfo::mk_uint32());
+    if (not is_pow2()) {
+        // keeps head + capacity - 1 - i in [0, 2 * capacity) for M_wrap()
+        l_idx = (l_idx < l_last).cond(l_idx, l_last);
+    }
+    return m_slots.entry(M_wrap(head() + l_last - l_idx));
+}
+
+ValueInfo RingBuffer::newest() const {
+    return at(0);
+}
+
+ValueInfo RingBuffer::oldest() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    return m_slots.entry(oldest_slot());
+}
+
+ValueInfo RingBuffer::size() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    return m_base.field(c_size_field).load();
+}
+
+ValueInfo RingBuffer::head() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    return m_base.field(c_head_field).load();
+}
+
+ValueInfo RingBuffer::oldest_slot() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    // head + capacity - size, slot 0 until buffer is full and head after that
+    return M_wrap(head() + ValueInfo::from_constant(capacity()) - size());
+}
+
+ValueInfo RingBuffer::is_full() const {
+    CODEGEN_FN
+    if (has_error()) {
+        return ValueInfo::null();
+    }
+    return size().equal(ValueInfo::from_constant(capacity()));
+}
+
+ValueInfo RingBuffer::M_wrap(const ValueInfo& slot) const {
+    if (is_pow2()) {
+        return slot & ValueInfo::from_constant(capacity() - 1);
+    }
+    const ValueInfo l_capacity = ValueInfo::from_constant(capacity());
+    return (slot < l_capacity).cond(slot, slot - l_capacity);
+}
+
+RingBuffer RingBuffer::null(const std::string& log) {
+    static RingBuffer s_null{};
+    LLVM_BUILDER_ASSERT(s_null.has_error());
+    RingBuffer result = s_null;
+    result.M_mark_error(log);
+    return result;
+}
+
+TypeInfo RingBuffer::mk_type(const std::string& name, TypeInfo element_type, uint32_t capacity,
+                             const std::vector<field_entry_t>& extra_fields) {
+    if (element_type.has_error()) {
+        return TypeInfo::null();
+    }
+    if (not element_type.is_valid_struct_field()) {
+        return TypeInfo::null(LLVM_BUILDER_CONCAT << "ring buffer can't hold values of type:" << element_type.short_name());
+    }
+    if (capacity == 0) {
+        return TypeInfo::null("ring buffer can't be of capacity 0");
+    }
+    std::vector<field_entry_t> l_field_list;
+    l_field_list.emplace_back(c_head_field, TypeInfo::mk_uint32());
+    l_field_list.emplace_back(c_size_field, TypeInfo::mk_uint32());
+    for (uint32_t i = 0; i != capacity; ++i) {
+        l_field_list.emplace_back(slot_name(i), element_type);
+    }
+    for (const field_entry_t& l_field : extra_fields) {
+        l_field_list.emplace_back(l_field.name(), l_field.type(), l_field.is_readonly());
+    }
+    return TypeInfo::mk_struct(name, l_field_list, false);
+}
+
+std::string RingBuffer::slot_name(uint32_t i) {
+    return LLVM_BUILDER_CONCAT << "slot_" << i;
+}
+
 //
 // IfElseCond::BranchSection::Impl
 //
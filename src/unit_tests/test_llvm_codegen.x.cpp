@@ -12,6 +12,7 @@
 #include "llvm_builder/type.h"
 #include "llvm_builder/jit.h"
 #include "llvm_builder/function.h"
+#include "llvm_builder/analyze.h"
 
 #include "common_llvm_test.h"
 
@@ -1304,3 +1305,48 @@ TEST(LLVM_CODEGEN, resilient_api) {
         LLVM_BUILDER_ALWAYS_ASSERT_EQ(i, fn4_fn.on_event(l_args_obj));
     }
 }
+
+TEST(LLVM_CODEGEN, cost_model) {
+    CODEGEN_LINE(Cursor l_cursor{"cost_model"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int32_type = TypeInfo::mk_int32())
+    CODEGEN_LINE(l_cursor.add_field("arg1", int32_type))
+    CODEGEN_LINE(l_cursor.add_field("arg2", int32_type))
+    CODEGEN_LINE(l_cursor.add_field("res", int32_type))
+    CODEGEN_LINE(l_cursor.bind("cost_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("cost_fn"))
+        CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+        CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+        CODEGEN_LINE(ValueInfo arg1 = ctx.field("arg1").load())
+        CODEGEN_LINE(ValueInfo arg2 = ctx.field("arg2").load())
+        CODEGEN_LINE(ValueInfo res = (arg1 + arg2) / (arg2 + ValueInfo::from_constant(1)))
+        CODEGEN_LINE(ctx.field("res").store(res))
+        CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+    }
+    INIT_MODULE(l_module)
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    analysis::ModuleAnalysis l_analysis{l_module};
+    bool l_found = false;
+    for (const analysis::FunctionAnalysis& l_fn : l_analysis.functions()) {
+        if (l_fn.name() != "cost_fn") {
+            continue;
+        }
+        l_found = true;
+        const analysis::FunctionCost l_cost = l_fn.cost();
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_cost.cpu_name().empty());
+        // values are evaluated once per use, so a reused load may be emitted more than once
+        LLVM_BUILDER_ALWAYS_ASSERT(l_cost.num_loads() >= 2u);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_cost.num_stores(), 1u);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_cost.num_divides(), 1u);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_cost.bytes_loaded(), l_cost.num_loads() * sizeof(int32_t));
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_cost.bytes_stored(), sizeof(int32_t));
+        LLVM_BUILDER_ALWAYS_ASSERT(l_cost.critical_path_cycles() > 0);
+        LLVM_BUILDER_ALWAYS_ASSERT(l_cost.critical_path_cycles() <= l_cost.latency_cycles());
+        LLVM_BUILDER_ALWAYS_ASSERT(l_cost.estimated_cycles() >= l_cost.critical_path_cycles());
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT(l_found);
+}
@@ -3,7 +3,16 @@
 //
 
 #include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#include <sys/mman.h>
+#include <unistd.h>
 #include "util/debug.h"
 #include "llvm_builder/defines.h"
 
@@ -11,6 +20,7 @@
 #include "llvm_builder/type.h"
 #include "llvm_builder/jit.h"
 #include "llvm_builder/function.h"
+#include "llvm_builder/rolling.h"
 
 #include "common_llvm_test.h"
 
@@ -608,3 +618,2245 @@ TEST(LLVM_CODEGEN_JIT_API, fn_pointer) {
         }
     }
 }
+
+TEST(LLVM_CODEGEN_JIT_API, debug_info) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_debug_info"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int32_type = TypeInfo::mk_int32())
+    CODEGEN_LINE(l_cursor.add_field("field_1", int32_type))
+    CODEGEN_LINE(l_cursor.add_field("field_2", int32_type))
+    CODEGEN_LINE(l_cursor.enable_debug_info())
+    LLVM_BUILDER_ALWAYS_ASSERT(l_cursor.is_debug_info_enabled());
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(jit_runner.enable_gdb_listener())
+    LLVM_BUILDER_ALWAYS_ASSERT(jit_runner.enable_disassembly());
+    CODEGEN_LINE(l_cursor.bind("debug_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    LLVM_BUILDER_ALWAYS_ASSERT(l_module.debug_info_builder() != nullptr);
+    // declaration only, gets no DISubprogram
+    CODEGEN_LINE(Function l_ext_fn("debug_ext_fn", true))
+    LLVM_BUILDER_ALWAYS_ASSERT(not l_ext_fn.has_error());
+    uint32_t l_load_line = 0;
+    {
+        CODEGEN_LINE(Function fn("debug_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            l_load_line = __LINE__ + 1;
+            CODEGEN_LINE(ValueInfo l_value = ctx.field("field_1").load() + ValueInfo::from_constant(7))
+            LLVM_BUILDER_ALWAYS_ASSERT(l_value.source_loc().is_valid());
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_value.source_loc().line_num(), l_load_line);
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_value.source_loc().file_name(), std::string{__FILE__});
+            CODEGEN_LINE(ctx.field("field_2").store(l_value))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        CODEGEN_LINE(jit_runner.process_module_fn(fn))
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    {
+        const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+        const runtime::Struct& l_args = l_runtime_module.struct_info("debug_args");
+        const runtime::EventFn& debug_fn = l_runtime_module.event_fn_info("debug_fn");
+        LLVM_BUILDER_ALWAYS_ASSERT(not debug_fn.has_error())
+        for (int32_t i = 0; i != 10; ++i) {
+            CODEGEN_LINE(runtime::Object l_args_obj = l_args.mk_object())
+            CODEGEN_LINE(l_args_obj.set<int32_t>("field_1", i))
+            CODEGEN_LINE(l_args_obj.freeze())
+            CODEGEN_LINE(debug_fn.on_event(l_args_obj))
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_args_obj.get<int32_t>("field_2"), i + 7);
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    }
+    {
+        // line table of emitted object maps machine code back to CODEGEN_LINE locations
+        const analysis::Disassembly l_asm = jit_runner.disassemble("debug_fn");
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_asm.empty());
+        bool l_has_load_line = false;
+        for (const analysis::AsmInst& l_inst : l_asm.insts()) {
+            if (l_inst.line().is_valid() and l_inst.line().line_num() == l_load_line) {
+                // DWARF path is absolute, __FILE__ may not be
+                LLVM_BUILDER_ALWAYS_ASSERT(l_inst.line().file_name().ends_with("test_llvm_jit_api.x.cpp"));
+                l_has_load_line = true;
+            }
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT(l_has_load_line);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    }
+}
+
+TEST(LLVM_CODEGEN_JIT_API, perf_listener) {
+    // jitdump file goes under JITDUMPDIR, keep it out of $HOME
+    const std::string l_dump_dir = LLVM_BUILDER_CONCAT << "/tmp/llvm_builder_jitdump_" << ::getpid();
+    std::filesystem::create_directories(l_dump_dir);
+    ::setenv("JITDUMPDIR", l_dump_dir.c_str(), 1);
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_perf_listener"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int32_type = TypeInfo::mk_int32())
+    CODEGEN_LINE(l_cursor.add_field("field_1", int32_type))
+    CODEGEN_LINE(l_cursor.add_field("field_2", int32_type))
+    CODEGEN_LINE(l_cursor.enable_debug_info())
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    LLVM_BUILDER_ALWAYS_ASSERT(jit_runner.enable_perf_listener());
+    // enabling again is a no-op
+    LLVM_BUILDER_ALWAYS_ASSERT(jit_runner.enable_perf_listener());
+    CODEGEN_LINE(l_cursor.bind("perf_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("perf_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("field_2").store(ctx.field("field_1").load() + ValueInfo::from_constant(7)))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        CODEGEN_LINE(jit_runner.process_module_fn(fn))
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    {
+        const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+        const runtime::Struct& l_args = l_runtime_module.struct_info("perf_args");
+        const runtime::EventFn& perf_fn = l_runtime_module.event_fn_info("perf_fn");
+        LLVM_BUILDER_ALWAYS_ASSERT(not perf_fn.has_error())
+        CODEGEN_LINE(runtime::Object l_args_obj = l_args.mk_object())
+        CODEGEN_LINE(l_args_obj.set<int32_t>("field_1", 3))
+        CODEGEN_LINE(l_args_obj.freeze())
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(perf_fn.on_event(l_args_obj), 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_args_obj.get<int32_t>("field_2"), 10);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    }
+    // listeners can't be added once bound, runner is marked as failed
+    LLVM_BUILDER_ALWAYS_ASSERT(not jit_runner.enable_gdb_listener());
+    LLVM_BUILDER_ALWAYS_ASSERT(jit_runner.has_error());
+    ErrorContext::clear_error();
+    ::unsetenv("JITDUMPDIR");
+    std::filesystem::remove_all(l_dump_dir);
+}
+
+TEST(LLVM_CODEGEN_JIT_API, latency_instrumentation) {
+    for (uint64_t v : {0ul, 1ul, 15ul, 16ul, 17ul, 31ul, 32ul, 1000ul, 123456789ul, ~0ul}) {
+        const uint32_t l_idx = LatencyHistogram::bucket_index(v);
+        LLVM_BUILDER_ALWAYS_ASSERT(l_idx < LatencyHistogram::c_num_buckets);
+        LLVM_BUILDER_ALWAYS_ASSERT(LatencyHistogram::bucket_lower_bound(l_idx) <= v);
+        LLVM_BUILDER_ALWAYS_ASSERT(v <= LatencyHistogram::bucket_upper_bound(l_idx));
+    }
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_latency"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int32_type = TypeInfo::mk_int32())
+    CODEGEN_LINE(l_cursor.add_field("field_1", int32_type))
+    CODEGEN_LINE(l_cursor.add_field("field_2", int32_type))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("latency_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("latency_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("field_2").store(ctx.field("field_1").load() * ValueInfo::from_constant(3)))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        CODEGEN_LINE(jit_runner.process_module_fn(fn))
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    LLVM_BUILDER_ALWAYS_ASSERT(jit_runner.lookup_latency().count() > 0);
+    {
+        const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+        const runtime::Struct& l_args = l_runtime_module.struct_info("latency_args");
+        runtime::EventFn latency_fn = l_runtime_module.event_fn_info("latency_fn");
+        LLVM_BUILDER_ALWAYS_ASSERT(not latency_fn.has_error())
+        LLVM_BUILDER_ALWAYS_ASSERT(not latency_fn.is_instrumented());
+        CODEGEN_LINE(runtime::Object l_args_obj = l_args.mk_object())
+        CODEGEN_LINE(l_args_obj.set<int32_t>("field_1", 5))
+        CODEGEN_LINE(l_args_obj.freeze())
+        CODEGEN_LINE(latency_fn.on_event(l_args_obj))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(latency_fn.call_count(), 0ul);
+
+        CODEGEN_LINE(latency_fn.enable_instrumentation())
+        // instrumentation state is shared by all handles of the event
+        LLVM_BUILDER_ALWAYS_ASSERT(l_runtime_module.event_fn_info("latency_fn").is_instrumented());
+        for (int32_t i = 0; i != 100; ++i) {
+            CODEGEN_LINE(latency_fn.on_event(l_args_obj))
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_args_obj.get<int32_t>("field_2"), 15);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(latency_fn.call_count(), 100ul);
+        const LatencyHistogram l_hist = latency_fn.latency_histogram();
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_hist.count(), 100ul);
+        LLVM_BUILDER_ALWAYS_ASSERT(l_hist.min() <= l_hist.percentile(50.0));
+        LLVM_BUILDER_ALWAYS_ASSERT(l_hist.percentile(50.0) <= l_hist.percentile(99.0));
+        LLVM_BUILDER_ALWAYS_ASSERT(l_hist.percentile(99.0) <= l_hist.max());
+
+        const LatencyHistogram l_interval = latency_fn.reset_latency_histogram();
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_interval.count(), 100ul);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(latency_fn.call_count(), 0ul);
+        LLVM_BUILDER_ALWAYS_ASSERT(latency_fn.latency_histogram().empty());
+
+        CODEGEN_LINE(latency_fn.disable_instrumentation())
+        CODEGEN_LINE(latency_fn.on_event(l_args_obj))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(latency_fn.call_count(), 0ul);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    }
+}
+
+TEST(LLVM_CODEGEN_JIT_API, perf_counters) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_perf_counters"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int32_type = TypeInfo::mk_int32())
+    CODEGEN_LINE(l_cursor.add_field("field_1", int32_type))
+    CODEGEN_LINE(l_cursor.add_field("field_2", int32_type))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("perf_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("perf_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("field_2").store(ctx.field("field_1").load() + ValueInfo::from_constant(1)))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        CODEGEN_LINE(jit_runner.process_module_fn(fn))
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    {
+        const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+        const runtime::Struct& l_args = l_runtime_module.struct_info("perf_args");
+        runtime::EventFn perf_fn = l_runtime_module.event_fn_info("perf_fn");
+        LLVM_BUILDER_ALWAYS_ASSERT(not perf_fn.has_error())
+        CODEGEN_LINE(runtime::Object l_args_obj = l_args.mk_object())
+        CODEGEN_LINE(l_args_obj.set<int32_t>("field_1", 1))
+        CODEGEN_LINE(l_args_obj.freeze())
+        // hosts without PMU access (containers, some VMs) can't open counters
+        if (not perf_fn.enable_perf_counters(4)) {
+            LLVM_BUILDER_ALWAYS_ASSERT(not perf_fn.has_perf_counters());
+            LLVM_BUILDER_ALWAYS_ASSERT(not perf_fn.has_error());
+            return;
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT(perf_fn.has_perf_counters());
+        for (int32_t i = 0; i != 100; ++i) {
+            CODEGEN_LINE(perf_fn.on_event(l_args_obj))
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_args_obj.get<int32_t>("field_2"), 2);
+        const PerfCounters l_counters = perf_fn.reset_perf_counters();
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_counters.num_calls(), 100ul);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_counters.num_samples(), 25ul);
+        LLVM_BUILDER_ALWAYS_ASSERT(l_counters.is_available(PerfCounters::counter_t::cycles));
+        LLVM_BUILDER_ALWAYS_ASSERT(l_counters.cycles() > 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(perf_fn.perf_counters().num_calls(), 0ul);
+
+        CODEGEN_LINE(perf_fn.disable_perf_counters())
+        CODEGEN_LINE(perf_fn.on_event(l_args_obj))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(perf_fn.perf_counters().num_calls(), 0ul);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    }
+}
+
+TEST(LLVM_CODEGEN_JIT_API, disassembly) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_disassembly"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int32_type = TypeInfo::mk_int32())
+    CODEGEN_LINE(l_cursor.add_field("field_1", int32_type))
+    CODEGEN_LINE(l_cursor.add_field("field_2", int32_type))
+    CODEGEN_LINE(l_cursor.enable_debug_info())
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    LLVM_BUILDER_ALWAYS_ASSERT(jit_runner.enable_disassembly());
+    CODEGEN_LINE(l_cursor.bind("disassembly_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    uint32_t l_value_line = 0;
+    {
+        CODEGEN_LINE(Function fn("disassembly_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            l_value_line = __LINE__ + 1;
+            CODEGEN_LINE(ValueInfo l_value = ctx.field("field_1").load() * ValueInfo::from_constant(5))
+            CODEGEN_LINE(l_value.add_tag("scaled"))
+            CODEGEN_LINE(ctx.field("field_2").store(l_value))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    {
+        const analysis::Disassembly l_asm = jit_runner.disassemble("disassembly_fn");
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_asm.empty());
+        LLVM_BUILDER_ALWAYS_ASSERT(l_asm.code_size() > 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_asm.address(), reinterpret_cast<uint64_t>(jit_runner.get_fn("disassembly_fn")));
+        uint64_t l_total_size = 0;
+        bool l_has_tagged_inst = false;
+        for (const analysis::AsmInst& l_inst : l_asm.insts()) {
+            LLVM_BUILDER_ALWAYS_ASSERT(not l_inst.text().empty());
+            l_total_size += l_inst.size();
+            if (l_inst.value().tags().contains("scaled")) {
+                l_has_tagged_inst = true;
+                LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_inst.line().line_num(), l_value_line);
+                LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_inst.value().source_loc().line_num(), l_value_line);
+            }
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_total_size, l_asm.code_size());
+        LLVM_BUILDER_ALWAYS_ASSERT(l_has_tagged_inst);
+        std::ostringstream l_os;
+        l_os << l_asm;
+        LLVM_BUILDER_ALWAYS_ASSERT(l_os.str().find("scaled") != std::string::npos);
+    }
+    {
+        // symbol which doesn't exist
+        const analysis::Disassembly l_asm = jit_runner.disassemble("missing_fn");
+        LLVM_BUILDER_ALWAYS_ASSERT(l_asm.empty());
+        ErrorContext::clear_error();
+    }
+}
+
+TEST(LLVM_CODEGEN_JIT_API, array_bool_float) {
+    CODEGEN_LINE(runtime::Array l_bool_arr = runtime::Array::from(runtime::type_t::boolean, 4))
+    CODEGEN_LINE(runtime::Array l_f32_arr = runtime::Array::from(runtime::type_t::float32, 4))
+    CODEGEN_LINE(runtime::Array l_f64_arr = runtime::Array::from(runtime::type_t::float64, 4))
+    for (uint32_t i = 0; i != 4; ++i) {
+        CODEGEN_LINE(l_bool_arr.set<bool>(i, i % 2 == 0))
+        CODEGEN_LINE(l_f32_arr.set<float>(i, static_cast<float>(i) * 0.5f))
+        CODEGEN_LINE(l_f64_arr.set<double>(i, static_cast<double>(i) * 0.25))
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    for (uint32_t i = 0; i != 4; ++i) {
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_bool_arr.get<bool>(i), (i % 2 == 0));
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_f32_arr.get<float>(i), static_cast<float>(i) * 0.5f);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_f64_arr.get<double>(i), static_cast<double>(i) * 0.25);
+        // values are stored densely in ref(), as seen by jit'ed code and buffer views
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(static_cast<const float*>(l_f32_arr.ref())[i], static_cast<float>(i) * 0.5f);
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+}
+
+TEST(LLVM_CODEGEN_JIT_API, event_batch) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_event_batch"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int32_type = TypeInfo::mk_int32())
+    CODEGEN_LINE(l_cursor.add_field("field_1", int32_type))
+    CODEGEN_LINE(l_cursor.add_field("field_2", int32_type))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("batch_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("batch_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            // accumulates field_1 into field_2 on every call
+            CODEGEN_LINE(ctx.field("field_2").store(ctx.field("field_2").load() + ctx.field("field_1").load()))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        CODEGEN_LINE(Function limit_fn("batch_limit_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{limit_fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            // counts calls in field_2, fails once count is above 5
+            CODEGEN_LINE(ValueInfo l_count = ctx.field("field_2").load() + ValueInfo::from_constant(1))
+            CODEGEN_LINE(ctx.field("field_2").store(l_count))
+            CODEGEN_LINE(FunctionContext::set_return_value((l_count > ValueInfo::from_constant(5)).cond(ValueInfo::from_constant(1),
+                                                                                                         ValueInfo::from_constant(0))))
+        }
+        limit_fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    {
+        const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+        const runtime::Struct& l_args = l_runtime_module.struct_info("batch_args");
+        runtime::EventFn batch_fn = l_runtime_module.event_fn_info("batch_fn");
+        LLVM_BUILDER_ALWAYS_ASSERT(not batch_fn.has_error())
+        std::vector<runtime::Object> l_objects;
+        for (int32_t i = 0; i != 8; ++i) {
+            CODEGEN_LINE(runtime::Object l_args_obj = l_args.mk_object())
+            CODEGEN_LINE(l_args_obj.set<int32_t>("field_1", i))
+            CODEGEN_LINE(l_args_obj.freeze())
+            l_objects.emplace_back(l_args_obj);
+        }
+        CODEGEN_LINE(std::vector<int32_t> l_results = batch_fn.on_event_many(l_objects))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_results.size(), l_objects.size());
+        for (int32_t i = 0; i != 8; ++i) {
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_results[i], 0);
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_objects[i].get<int32_t>("field_2"), i);
+        }
+        CODEGEN_LINE(batch_fn.enable_instrumentation())
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(batch_fn.on_event_repeat(l_objects[3], 100), 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_objects[3].get<int32_t>("field_2"), 3 + 3 * 100);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(batch_fn.call_count(), 100ul);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+        // repeat stops at the first failing call
+        runtime::EventFn limit_fn = l_runtime_module.event_fn_info("batch_limit_fn");
+        LLVM_BUILDER_ALWAYS_ASSERT(not limit_fn.has_error())
+        CODEGEN_LINE(runtime::Object l_limit_obj = l_args.mk_object())
+        CODEGEN_LINE(l_limit_obj.freeze())
+        uint64_t l_num_processed = 0;
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(limit_fn.on_event_repeat(l_limit_obj, 100, &l_num_processed), 1);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_num_processed, 5ul);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_limit_obj.get<int32_t>("field_2"), 6);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+        // whole batch is rejected if any object is not frozen
+        CODEGEN_LINE(l_objects.emplace_back(l_args.mk_object()))
+        LLVM_BUILDER_ALWAYS_ASSERT(batch_fn.on_event_many(l_objects).empty());
+        ErrorContext::clear_error();
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_objects[0].get<int32_t>("field_2"), 0);
+    }
+}
+
+TEST(LLVM_CODEGEN_JIT_API, kernel_columns) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_kernel_columns"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(l_cursor.add_field("x", TypeInfo::mk_float64()))
+    CODEGEN_LINE(l_cursor.add_field("y", TypeInfo::mk_float64()))
+    CODEGEN_LINE(l_cursor.add_field("count", TypeInfo::mk_int32()))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("kernel_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("scale_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("y").store(ctx.field("x").load() + ctx.field("x").load()))
+            CODEGEN_LINE(ctx.field("count").store(ctx.field("count").load() + ValueInfo::from_constant(1)))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        CODEGEN_LINE(Function kernel = fn.mk_kernel())
+        LLVM_BUILDER_ALWAYS_ASSERT(not kernel.has_error());
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(kernel.name(), "scale_fn__kernel");
+        kernel.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    {
+        const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+        const runtime::Struct& l_args = l_runtime_module.struct_info("kernel_args");
+        runtime::EventFn kernel_fn = l_runtime_module.event_fn_info("scale_fn__kernel");
+        LLVM_BUILDER_ALWAYS_ASSERT(not kernel_fn.has_error())
+        CODEGEN_LINE(runtime::Object l_state = l_args.mk_object())
+        CODEGEN_LINE(l_state.freeze())
+        double l_x[4] = {1.0, 2.0, 3.0, 4.0};
+        // y is written to every other slot
+        double l_y[8] = {};
+        const std::vector<runtime::Column> l_columns{
+            runtime::Column{"x", runtime::type_t::float64, l_x, sizeof(double)},
+            runtime::Column{"y", runtime::type_t::float64, l_y, 2 * sizeof(double)},
+        };
+        uint64_t l_num_processed = 0;
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(kernel_fn.on_columns(l_state, l_columns, 4, &l_num_processed), 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_num_processed, 4ul);
+        for (uint32_t i = 0; i != 4; ++i) {
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_y[2 * i], 2.0 * l_x[i]);
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_y[2 * i + 1], 0.0);
+        }
+        // unmapped field stays in state and carries over rows
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_state.get<int32_t>("count"), 4);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_state.get<float64_t>("x"), 0.0);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+        // kernel can't be run as plain event
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(kernel_fn.on_event(l_state), -1);
+        ErrorContext::clear_error();
+    }
+    {
+        const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+        const runtime::Struct& l_args = l_runtime_module.struct_info("kernel_args");
+        runtime::EventFn kernel_fn = l_runtime_module.event_fn_info("scale_fn__kernel");
+        CODEGEN_LINE(runtime::Object l_state = l_args.mk_object())
+        LLVM_BUILDER_ALWAYS_ASSERT(l_state.enable_double_buffer());
+        CODEGEN_LINE(l_state.freeze())
+        int32_t l_count[2] = {};
+        const std::vector<runtime::Column> l_columns{
+            runtime::Column{"count", runtime::type_t::int64, l_count, sizeof(int64_t)},
+        };
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(kernel_fn.on_columns(l_state, l_columns, 2), -1);
+        ErrorContext::clear_error();
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_count[0], 0);
+        // rejected columns leave no publish open, readers don't spin
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_state.version(), 0ul);
+        CODEGEN_LINE(runtime::Object l_copy = l_args.mk_object())
+        LLVM_BUILDER_ALWAYS_ASSERT(l_state.read_consistent(l_copy));
+    }
+}
+
+TEST(LLVM_CODEGEN_JIT_API, shared_region) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_shared_region"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int32_type = TypeInfo::mk_int32())
+    CODEGEN_LINE(l_cursor.add_field("field_1", int32_type))
+    CODEGEN_LINE(l_cursor.add_field("field_2", int32_type))
+    {
+        std::vector<field_entry_t> l_field_list;
+        CODEGEN_LINE(l_field_list.emplace_back("value", TypeInfo::mk_int64()))
+        CODEGEN_LINE(TypeInfo l_leaf = TypeInfo::mk_struct("region_leaf", l_field_list, false))
+        l_field_list.clear();
+        CODEGEN_LINE(l_field_list.emplace_back("leaf", l_leaf.mk_ptr()))
+        CODEGEN_LINE(TypeInfo::mk_struct("region_linked", l_field_list, false))
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("region_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("region_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("field_2").store(ctx.field("field_1").load() + ValueInfo::from_constant(1)))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("region_args");
+    runtime::EventFn region_fn = l_runtime_module.event_fn_info("region_fn");
+    const runtime::Struct& l_leaf = l_runtime_module.struct_info("region_leaf");
+    const runtime::Struct& l_linked = l_runtime_module.struct_info("region_linked");
+    const std::string l_path = LLVM_BUILDER_CONCAT << "/tmp/llvm_builder_region_" << ::getpid();
+    void* l_base = nullptr;
+    {
+        CODEGEN_LINE(runtime::SharedRegion l_region = runtime::SharedRegion::create_file(l_path, 1 << 16))
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_region.has_error());
+        CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object(l_region, "tick"))
+        CODEGEN_LINE(l_obj.set<int32_t>("field_1", 41))
+        CODEGEN_LINE(l_obj.freeze())
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(region_fn.on_event(l_obj), 0);
+        CODEGEN_LINE(runtime::Array l_arr = runtime::Array::from(runtime::type_t::int64, 4, l_region, "prices"))
+        CODEGEN_LINE(l_arr.set<int64_t>(3, 7))
+        CODEGEN_LINE(l_arr.freeze())
+        LLVM_BUILDER_ALWAYS_ASSERT(l_region.contains("tick"));
+        LLVM_BUILDER_ALWAYS_ASSERT(l_region.used_bytes() < l_region.size_in_bytes());
+        // name is taken
+        LLVM_BUILDER_ALWAYS_ASSERT(l_args.mk_object(l_region, "tick").has_error());
+        ErrorContext::clear_error();
+        // same process shares the mapping, so writes are visible in place
+        CODEGEN_LINE(runtime::Object l_view = l_args.find_object(runtime::SharedRegion::open_file(l_path), "tick"))
+        LLVM_BUILDER_ALWAYS_ASSERT(l_view.is_frozen());
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_view.ref(), l_obj.ref());
+        // links out of the region are rejected, links inside it are recorded as offsets
+        CODEGEN_LINE(runtime::Object l_heap_leaf = l_leaf.mk_object())
+        CODEGEN_LINE(l_heap_leaf.freeze())
+        CODEGEN_LINE(runtime::Object l_heap_link = l_linked.mk_object(l_region, "heap_link"))
+        CODEGEN_LINE(l_heap_link.set_object("leaf", l_heap_leaf))
+        LLVM_BUILDER_ALWAYS_ASSERT(l_heap_link.has_error());
+        ErrorContext::clear_error();
+        CODEGEN_LINE(runtime::Object l_region_leaf = l_leaf.mk_object(l_region, "leaf"))
+        CODEGEN_LINE(l_region_leaf.set<int64_t>("value", 5))
+        CODEGEN_LINE(l_region_leaf.freeze())
+        CODEGEN_LINE(runtime::Object l_region_link = l_linked.mk_object(l_region, "link"))
+        CODEGEN_LINE(l_region_link.set_object("leaf", l_region_leaf))
+        LLVM_BUILDER_ALWAYS_ASSERT(l_region_link.freeze());
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+        l_base = l_region.ref();
+    }
+    {
+        // creator's address is taken, region is mapped elsewhere
+        const long l_page_size = ::sysconf(_SC_PAGESIZE);
+        void* l_blocker = ::mmap(l_base, static_cast<size_t>(l_page_size), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_blocker, l_base);
+        CODEGEN_LINE(runtime::SharedRegion l_region = runtime::SharedRegion::open_file(l_path))
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_region.has_error());
+        LLVM_BUILDER_ALWAYS_ASSERT(l_region.ref() != l_base);
+        CODEGEN_LINE(runtime::Object l_obj = l_args.find_object(l_region, "tick"))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int32_t>("field_2"), 42);
+        CODEGEN_LINE(runtime::Array l_arr = runtime::Array::find(l_region, "prices"))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_arr.get<int64_t>(3), 7);
+        CODEGEN_LINE(runtime::Object l_region_leaf = l_leaf.find_object(l_region, "leaf"))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_region_leaf.get<int64_t>("value"), 5);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+        // its pointer field holds the creator's address
+        LLVM_BUILDER_ALWAYS_ASSERT(l_linked.find_object(l_region, "link").has_error());
+        ErrorContext::clear_error();
+        ::munmap(l_blocker, static_cast<size_t>(l_page_size));
+    }
+    {
+        // all handles dropped, file is mapped again at the creator's address
+        CODEGEN_LINE(runtime::SharedRegion l_region = runtime::SharedRegion::open_file(l_path))
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_region.has_error());
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_region.ref(), l_base);
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_linked.find_object(l_region, "link").has_error());
+        CODEGEN_LINE(runtime::Object l_obj = l_args.find_object(l_region, "tick"))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int32_t>("field_2"), 42);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(region_fn.on_event(l_obj), 0);
+        CODEGEN_LINE(runtime::Array l_arr = runtime::Array::find(l_region, "prices"))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_arr.num_elements(), 4u);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_arr.get<int64_t>(3), 7);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+        // type of allocation is checked
+        LLVM_BUILDER_ALWAYS_ASSERT(l_args.find_object(l_region, "prices").has_error());
+        ErrorContext::clear_error();
+        LLVM_BUILDER_ALWAYS_ASSERT(l_region.unlink());
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT(runtime::SharedRegion::open_file(l_path).has_error());
+    ErrorContext::clear_error();
+}
+
+TEST(LLVM_CODEGEN_JIT_API, event_queue) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_event_queue"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int32_type = TypeInfo::mk_int32())
+    CODEGEN_LINE(l_cursor.add_field("field_1", int32_type))
+    CODEGEN_LINE(l_cursor.add_field("field_2", int32_type))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("queue_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("queue_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            // runs on a copy of the payload, this write is not seen by the producer
+            CODEGEN_LINE(ctx.field("field_2").store(ValueInfo::from_constant(static_cast<int32_t>(1))))
+            // non-zero field_1 is reported as failure
+            CODEGEN_LINE(FunctionContext::set_return_value(ctx.field("field_1").load()))
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("queue_args");
+    runtime::EventFn queue_fn = l_runtime_module.event_fn_info("queue_fn");
+    CODEGEN_LINE(runtime::Object l_payload = l_args.mk_object())
+    CODEGEN_LINE(l_payload.freeze())
+    {
+        CODEGEN_LINE(runtime::EventQueue l_queue{l_args, 3, runtime::EventQueue::producer_t::single})
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_queue.capacity(), 4u);
+        CODEGEN_LINE(const uint32_t l_id = l_queue.add_event(queue_fn))
+        for (int32_t i = 0; i != 4; ++i) {
+            CODEGEN_LINE(l_payload.set<int32_t>("field_1", i % 2))
+            LLVM_BUILDER_ALWAYS_ASSERT(l_queue.try_publish(l_id, l_payload));
+        }
+        // queue is full
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_queue.try_publish(l_id, l_payload));
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_queue.poll(3), 3ul);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_queue.poll(10), 1ul);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_queue.num_dispatched(), 4ul);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_queue.num_failed(), 2ul);
+        // payload is read only input
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_payload.get<int32_t>("field_2"), 0);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_queue.try_publish(l_id + 1, l_payload));
+        ErrorContext::clear_error();
+    }
+    {
+        CODEGEN_LINE(runtime::EventQueue l_queue{l_args, 8})
+        CODEGEN_LINE(const uint32_t l_id = l_queue.add_event(queue_fn))
+        LLVM_BUILDER_ALWAYS_ASSERT(l_queue.start());
+        LLVM_BUILDER_ALWAYS_ASSERT(l_queue.is_running());
+        // ErrorContext is not thread safe, payloads are built on main thread
+        std::vector<runtime::Object> l_objects;
+        for (int32_t t = 0; t != 2; ++t) {
+            CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+            CODEGEN_LINE(l_obj.set<int32_t>("field_1", t))
+            CODEGEN_LINE(l_obj.freeze())
+            l_objects.emplace_back(l_obj);
+        }
+        std::vector<std::thread> l_producers;
+        for (const runtime::Object& l_obj : l_objects) {
+            l_producers.emplace_back([&l_queue, &l_obj, l_id] {
+                for (uint32_t i = 0; i != 1000; ++i) {
+                    l_queue.publish(l_id, l_obj);
+                }
+            });
+        }
+        for (std::thread& l_producer : l_producers) {
+            l_producer.join();
+        }
+        CODEGEN_LINE(l_queue.stop())
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_queue.is_running());
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_queue.num_dispatched(), 2000ul);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_queue.num_failed(), 1000ul);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    }
+    {
+        // nothing drains a full queue without a dispatcher, publish gives up
+        CODEGEN_LINE(runtime::EventQueue l_queue{l_args, 1})
+        CODEGEN_LINE(const uint32_t l_id = l_queue.add_event(queue_fn))
+        LLVM_BUILDER_ALWAYS_ASSERT(l_queue.publish(l_id, l_payload));
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_queue.publish(l_id, l_payload));
+        LLVM_BUILDER_ALWAYS_ASSERT(l_queue.has_error());
+        ErrorContext::clear_error();
+    }
+}
+
+TEST(LLVM_CODEGEN_JIT_API, sharded_executor) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_sharded_executor"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(l_cursor.add_field("price", TypeInfo::mk_int64()))
+    CODEGEN_LINE(l_cursor.add_field("sum", TypeInfo::mk_int64()))
+    CODEGEN_LINE(l_cursor.add_field("last", TypeInfo::mk_int64()))
+    CODEGEN_LINE(l_cursor.add_field("flag", TypeInfo::mk_int32()))
+    {
+        // state with a pointer field, rejected by executor
+        std::vector<field_entry_t> l_field_list;
+        CODEGEN_LINE(l_field_list.emplace_back("value", TypeInfo::mk_int64()))
+        CODEGEN_LINE(TypeInfo l_leaf = TypeInfo::mk_struct("executor_leaf", l_field_list, false))
+        l_field_list.clear();
+        CODEGEN_LINE(l_field_list.emplace_back("leaf", l_leaf.mk_ptr()))
+        CODEGEN_LINE(TypeInfo::mk_struct("executor_linked", l_field_list, false))
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("executor_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("keyed_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("sum").store(ctx.field("sum").load() + ctx.field("price").load()))
+            CODEGEN_LINE(ctx.field("last").store(ctx.field("price").load()))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+    }
+    {
+        CODEGEN_LINE(Function fn("stateless_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(FunctionContext::set_return_value(ctx.field("flag").load()))
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("executor_args");
+    constexpr uint64_t c_num_keys = 16;
+    constexpr int64_t c_num_ticks = 200;
+    CODEGEN_LINE(runtime::ShardedExecutor l_executor(l_args, 4, c_num_keys, 64))
+    LLVM_BUILDER_ALWAYS_ASSERT(not l_executor.has_error());
+    CODEGEN_LINE(const uint32_t l_keyed_id = l_executor.add_event(l_runtime_module.event_fn_info("keyed_fn")))
+    CODEGEN_LINE(const uint32_t l_stateless_id = l_executor.add_event(l_runtime_module.event_fn_info("stateless_fn")))
+    LLVM_BUILDER_ALWAYS_ASSERT(l_executor.add_input_field("price"));
+    std::vector<runtime::Object> l_ticks;
+    for (int64_t i = 0; i != c_num_ticks; ++i) {
+        CODEGEN_LINE(runtime::Object l_tick = l_args.mk_object())
+        CODEGEN_LINE(l_tick.set<int64_t>("price", i))
+        // not an input, must not overwrite state
+        CODEGEN_LINE(l_tick.set<int64_t>("sum", -1))
+        CODEGEN_LINE(l_tick.set<int32_t>("flag", static_cast<int32_t>(i % 2)))
+        CODEGEN_LINE(l_tick.freeze())
+        l_ticks.emplace_back(l_tick);
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT(l_executor.start());
+    for (const runtime::Object& l_tick : l_ticks) {
+        for (uint64_t k = 0; k != c_num_keys; ++k) {
+            LLVM_BUILDER_ALWAYS_ASSERT(l_executor.submit(k, l_keyed_id, l_tick));
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT(l_executor.submit_stateless(l_stateless_id, l_tick));
+    }
+    CODEGEN_LINE(l_executor.drain())
+    const uint64_t l_num_events = c_num_ticks * (c_num_keys + 1);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_executor.num_dispatched(), l_num_events);
+    CODEGEN_LINE(l_executor.stop())
+    LLVM_BUILDER_ALWAYS_ASSERT(not l_executor.is_running());
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_executor.num_failed(), static_cast<uint64_t>(c_num_ticks / 2));
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_executor.num_dropped(), 0ul);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_executor.num_keys(), c_num_keys);
+    for (uint64_t k = 0; k != c_num_keys; ++k) {
+        CODEGEN_LINE(runtime::Object l_state = l_executor.state(k))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_state.get<int64_t>("sum"), c_num_ticks * (c_num_ticks - 1) / 2);
+        // events of a key run in submit order
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_state.get<int64_t>("last"), c_num_ticks - 1);
+        LLVM_BUILDER_ALWAYS_ASSERT(l_executor.worker_of(k) < l_executor.num_workers());
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    LLVM_BUILDER_ALWAYS_ASSERT(l_executor.state(c_num_keys).has_error());
+    ErrorContext::clear_error();
+    // marks executor as failed, so it is checked last
+    LLVM_BUILDER_ALWAYS_ASSERT(not l_executor.add_input_field("volume"));
+    ErrorContext::clear_error();
+    {
+        // keys past keys_per_worker get no state, their events are dropped
+        CODEGEN_LINE(runtime::ShardedExecutor l_small(l_args, 1, 2, 16))
+        CODEGEN_LINE(const uint32_t l_id = l_small.add_event(l_runtime_module.event_fn_info("keyed_fn")))
+        LLVM_BUILDER_ALWAYS_ASSERT(l_small.start());
+        for (uint64_t k = 0; k != 4; ++k) {
+            LLVM_BUILDER_ALWAYS_ASSERT(l_small.submit(k, l_id, l_ticks[1]));
+        }
+        CODEGEN_LINE(l_small.drain())
+        CODEGEN_LINE(l_small.stop())
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_small.num_dispatched(), 2ul);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_small.num_dropped(), 2ul);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_small.num_keys(), 2ul);
+        LLVM_BUILDER_ALWAYS_ASSERT(l_small.state(3).has_error());
+        ErrorContext::clear_error();
+    }
+    {
+        CODEGEN_LINE(runtime::ShardedExecutor l_linked(l_runtime_module.struct_info("executor_linked"), 1, 1, 16))
+        LLVM_BUILDER_ALWAYS_ASSERT(l_linked.has_error());
+        LLVM_BUILDER_ALWAYS_ASSERT(l_linked.error_log().find("leaf") != std::string::npos);
+        ErrorContext::clear_error();
+    }
+}
+
+TEST(LLVM_CODEGEN_JIT_API, double_buffer) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_double_buffer"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(l_cursor.add_field("field_1", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("field_2", int64_type))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("double_buffer_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("double_buffer_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            // field_1 == field_2 holds before and after the event, not in between
+            CODEGEN_LINE(ctx.field("field_1").store(ctx.field("field_1").load() + ValueInfo::from_constant(1)))
+            CODEGEN_LINE(ctx.field("field_2").store(ctx.field("field_2").load() + ValueInfo::from_constant(1)))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("double_buffer_args");
+    runtime::EventFn double_buffer_fn = l_runtime_module.event_fn_info("double_buffer_fn");
+    CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+    LLVM_BUILDER_ALWAYS_ASSERT(l_obj.enable_double_buffer());
+    CODEGEN_LINE(l_obj.freeze())
+    LLVM_BUILDER_ALWAYS_ASSERT(l_obj.is_double_buffered());
+    CODEGEN_LINE(runtime::Object l_copy = l_args.mk_object())
+    constexpr int64_t c_num_events = 100000;
+    std::atomic<bool> l_done{false};
+    std::atomic<uint64_t> l_num_torn{0};
+    std::thread l_reader{[&] {
+        while (not l_done.load(std::memory_order_acquire)) {
+            l_obj.read_consistent(l_copy);
+            if (l_copy.get<int64_t>("field_1") != l_copy.get<int64_t>("field_2")) {
+                l_num_torn.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }};
+    for (int64_t i = 0; i != c_num_events; ++i) {
+        double_buffer_fn.on_event(l_obj);
+    }
+    l_done.store(true, std::memory_order_release);
+    l_reader.join();
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_num_torn.load(), 0ul);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.version(), static_cast<uint64_t>(2 * c_num_events));
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("field_1"), c_num_events);
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    // host writes to the published buffer are picked up by next event
+    CODEGEN_LINE(l_obj.set<int64_t>("field_2", 0))
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(double_buffer_fn.on_event(l_obj), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("field_2"), 1);
+    // mode can't be enabled once frozen
+    CODEGEN_LINE(runtime::Object l_frozen = l_args.mk_object())
+    CODEGEN_LINE(l_frozen.freeze())
+    LLVM_BUILDER_ALWAYS_ASSERT(not l_frozen.enable_double_buffer());
+    ErrorContext::clear_error();
+    // only double buffered objects can be read consistently
+    LLVM_BUILDER_ALWAYS_ASSERT(not l_copy.read_consistent(l_args.mk_object()));
+    ErrorContext::clear_error();
+}
+
+TEST(LLVM_CODEGEN_JIT_API, object_snapshot) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_object_snapshot"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(TypeInfo l_inner_struct)
+    {
+        std::vector<field_entry_t> l_field_list;
+        CODEGEN_LINE(l_field_list.emplace_back("value", int64_type))
+        CODEGEN_LINE(l_inner_struct = TypeInfo::mk_struct("snapshot_inner", l_field_list, false))
+    }
+    CODEGEN_LINE(l_cursor.add_field("count", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("inner", l_inner_struct.mk_ptr()))
+    CODEGEN_LINE(l_cursor.add_field("prices", TypeInfo::mk_array(int64_type, 4).mk_ptr()))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("snapshot_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("snapshot_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ValueInfo l_one = ValueInfo::from_constant(static_cast<int64_t>(1)))
+            CODEGEN_LINE(ctx.field("count").store(ctx.field("count").load() + l_one))
+            CODEGEN_LINE(ValueInfo l_inner = ctx.field("inner").load())
+            CODEGEN_LINE(l_inner.field("value").store(l_inner.field("value").load() + l_one))
+            CODEGEN_LINE(ValueInfo l_prices = ctx.field("prices").load())
+            CODEGEN_LINE(l_prices.entry(0).store(l_prices.entry(0).load() + l_one))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("snapshot_args");
+    const runtime::Struct& l_inner = l_runtime_module.struct_info("snapshot_inner");
+    runtime::EventFn snapshot_fn = l_runtime_module.event_fn_info("snapshot_fn");
+    CODEGEN_LINE(runtime::Object l_inner_obj = l_inner.mk_object())
+    CODEGEN_LINE(l_inner_obj.freeze())
+    CODEGEN_LINE(runtime::Array l_prices = runtime::Array::from(runtime::type_t::int64, 4))
+    CODEGEN_LINE(l_prices.freeze())
+    CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+    CODEGEN_LINE(l_obj.set_object("inner", l_inner_obj))
+    CODEGEN_LINE(l_obj.set_array("prices", l_prices))
+    // root is saved on publish, inner object and array before the next event writes them
+    LLVM_BUILDER_ALWAYS_ASSERT(l_obj.enable_double_buffer());
+    CODEGEN_LINE(l_obj.freeze())
+    for (uint32_t i = 0; i != 3; ++i) {
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(snapshot_fn.on_event(l_obj), 0);
+    }
+    CODEGEN_LINE(runtime::Snapshot l_snapshot = l_obj.snapshot())
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_snapshot.num_nodes(), 3u);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_snapshot.num_bytes_copied(), 0u);
+    // second snapshot is read back before any event, nothing is saved for it
+    CODEGEN_LINE(runtime::Snapshot l_snapshot_2 = l_obj.snapshot())
+    CODEGEN_LINE(runtime::Object l_root_2 = l_snapshot_2.root())
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_snapshot_2.num_bytes_copied(), 0u);
+    for (uint32_t i = 0; i != 2; ++i) {
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(snapshot_fn.on_event(l_obj), 0);
+    }
+    // each node is saved once, by the first event
+    const uint64_t l_saved_bytes = static_cast<uint64_t>(l_args.size_in_bytes() + l_inner.size_in_bytes()) + 4 * sizeof(int64_t);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_snapshot.num_bytes_copied(), l_saved_bytes);
+    CODEGEN_LINE(runtime::Object l_root = l_snapshot.root())
+    LLVM_BUILDER_ALWAYS_ASSERT(l_root.is_frozen());
+    LLVM_BUILDER_ALWAYS_ASSERT(l_root.ref() != l_obj.ref());
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_root.get<int64_t>("count"), 3);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_root.get_object("inner").get<int64_t>("value"), 3);
+    LLVM_BUILDER_ALWAYS_ASSERT(l_root.get_object("inner").ref() != l_inner_obj.ref());
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_root.get_array("prices").get<int64_t>(0), 3);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_root_2.get<int64_t>("count"), 3);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_root_2.get_object("inner").get<int64_t>("value"), 3);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_root_2.get_array("prices").get<int64_t>(0), 3);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("count"), 5);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_inner_obj.get<int64_t>("value"), 5);
+    // events on the copy don't touch live graph
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(snapshot_fn.on_event(l_root), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_prices.get<int64_t>(0), 5);
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    LLVM_BUILDER_ALWAYS_ASSERT(l_args.mk_object().snapshot().has_error());
+    ErrorContext::clear_error();
+}
+
+TEST(LLVM_CODEGEN_JIT_API, object_checkpoint) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_object_checkpoint"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(TypeInfo l_inner_struct)
+    {
+        std::vector<field_entry_t> l_field_list;
+        CODEGEN_LINE(l_field_list.emplace_back("value", int64_type))
+        CODEGEN_LINE(l_inner_struct = TypeInfo::mk_struct("checkpoint_inner", l_field_list, false))
+    }
+    CODEGEN_LINE(l_cursor.add_field("count", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("inner", l_inner_struct.mk_ptr()))
+    CODEGEN_LINE(l_cursor.add_field("prices", TypeInfo::mk_array(int64_type, 4).mk_ptr()))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("checkpoint_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("checkpoint_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ValueInfo l_one = ValueInfo::from_constant(static_cast<int64_t>(1)))
+            CODEGEN_LINE(ctx.field("count").store(ctx.field("count").load() + l_one))
+            CODEGEN_LINE(ValueInfo l_inner = ctx.field("inner").load())
+            CODEGEN_LINE(l_inner.field("value").store(l_inner.field("value").load() + l_one))
+            CODEGEN_LINE(ValueInfo l_prices = ctx.field("prices").load())
+            CODEGEN_LINE(l_prices.entry(3).store(l_prices.entry(3).load() + l_one))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("checkpoint_args");
+    const runtime::Struct& l_inner = l_runtime_module.struct_info("checkpoint_inner");
+    runtime::EventFn checkpoint_fn = l_runtime_module.event_fn_info("checkpoint_fn");
+    const std::string l_path = LLVM_BUILDER_CONCAT << "/tmp/llvm_builder_checkpoint_" << ::getpid();
+    {
+        CODEGEN_LINE(runtime::Object l_inner_obj = l_inner.mk_object())
+        CODEGEN_LINE(l_inner_obj.freeze())
+        CODEGEN_LINE(runtime::Array l_prices = runtime::Array::from(runtime::type_t::int64, 4))
+        CODEGEN_LINE(l_prices.set<int64_t>(0, 100))
+        CODEGEN_LINE(l_prices.freeze())
+        CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+        CODEGEN_LINE(l_obj.set_object("inner", l_inner_obj))
+        CODEGEN_LINE(l_obj.set_array("prices", l_prices))
+        CODEGEN_LINE(l_obj.freeze())
+        for (uint32_t i = 0; i != 3; ++i) {
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(checkpoint_fn.on_event(l_obj), 0);
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT(l_obj.write_checkpoint(l_path));
+        // written state is not changed by later events
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(checkpoint_fn.on_event(l_obj), 0);
+    }
+    {
+        CODEGEN_LINE(runtime::Object l_root = l_runtime_module.load_checkpoint(l_path))
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_root.has_error());
+        LLVM_BUILDER_ALWAYS_ASSERT(l_root.is_frozen());
+        LLVM_BUILDER_ALWAYS_ASSERT(l_root.is_instance_of(l_args));
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_root.get<int64_t>("count"), 3);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_root.get_object("inner").get<int64_t>("value"), 3);
+        CODEGEN_LINE(runtime::Array l_prices = l_root.get_array("prices"))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_prices.get<int64_t>(0), 100);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_prices.get<int64_t>(3), 3);
+        // pointer fields are patched, events run on the mapped buffers
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(checkpoint_fn.on_event(l_root), 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_root.get_object("inner").get<int64_t>("value"), 4);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_prices.get<int64_t>(3), 4);
+    }
+    {
+        // mapping is private, file is not written by events
+        CODEGEN_LINE(runtime::Object l_root = l_runtime_module.load_checkpoint(l_path))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_root.get<int64_t>("count"), 3);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(::unlink(l_path.c_str()), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT(l_runtime_module.load_checkpoint(l_path).has_error());
+    ErrorContext::clear_error();
+    // only a frozen graph can be written
+    LLVM_BUILDER_ALWAYS_ASSERT(not l_args.mk_object().write_checkpoint(l_path));
+    ErrorContext::clear_error();
+}
+
+TEST(LLVM_CODEGEN_JIT_API, wrap_external_buffer) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_wrap_external_buffer"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(l_cursor.add_field("total", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("prices", TypeInfo::mk_array(int64_type, 4).mk_ptr()))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("wrap_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("wrap_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ValueInfo l_prices = ctx.field("prices").load())
+            CODEGEN_LINE(ctx.field("total").store(l_prices.entry(0).load() + l_prices.entry(3).load()))
+            CODEGEN_LINE(l_prices.entry(1).store(ctx.field("total").load()))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("wrap_args");
+    runtime::EventFn wrap_fn = l_runtime_module.event_fn_info("wrap_fn");
+    alignas(8) int64_t l_column[5] = {10, 0, 0, 32, 0};
+    alignas(8) uint8_t l_ctx_buf[64] = {};
+    LLVM_BUILDER_ALWAYS_ASSERT(static_cast<uint32_t>(l_args.size_in_bytes()) <= sizeof(l_ctx_buf));
+    uint32_t l_num_deleted = 0;
+    {
+        CODEGEN_LINE(runtime::Array l_prices = runtime::Array::wrap(runtime::type_t::int64, 4, l_column,
+                                                                    [&l_num_deleted](void*) { ++l_num_deleted; }))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_prices.ref(), static_cast<void*>(l_column));
+        CODEGEN_LINE(l_prices.freeze())
+        CODEGEN_LINE(runtime::Object l_obj = l_args.wrap(l_ctx_buf))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.ref(), static_cast<void*>(l_ctx_buf));
+        CODEGEN_LINE(l_obj.set_array("prices", l_prices))
+        CODEGEN_LINE(l_obj.freeze())
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(wrap_fn.on_event(l_obj), 0);
+        // jit'ed code reads and writes the external buffers in place
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("total"), 42);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_column[1], 42);
+        l_column[3] = 0;
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(wrap_fn.on_event(l_obj), 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("total"), 10);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_num_deleted, 0u);
+    }
+    // object linking the array kept it alive until now
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_num_deleted, 1u);
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    // without a deleter buffer stays with the caller
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(runtime::Array::wrap(runtime::type_t::int64, 2, l_column).num_elements(), 2u);
+    // misaligned/null buffers are rejected and not deleted
+    uint8_t* l_misaligned = reinterpret_cast<uint8_t*>(l_column) + 4;
+    LLVM_BUILDER_ALWAYS_ASSERT(runtime::Array::wrap(runtime::type_t::int64, 2, l_misaligned,
+                                                    [&l_num_deleted](void*) { ++l_num_deleted; }).has_error());
+    ErrorContext::clear_error();
+    LLVM_BUILDER_ALWAYS_ASSERT(l_args.wrap(l_misaligned).has_error());
+    ErrorContext::clear_error();
+    LLVM_BUILDER_ALWAYS_ASSERT(runtime::Array::wrap(runtime::type_t::int64, 2, nullptr).has_error());
+    ErrorContext::clear_error();
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_num_deleted, 1u);
+}
+
+TEST(LLVM_CODEGEN_JIT_API, tick_replay) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_tick_replay"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(l_cursor.add_field("price", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("qty", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("notional", int64_type))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("tick_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("tick_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("notional").store(ctx.field("price").load() * ctx.field("qty").load()))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        CODEGEN_LINE(Function kernel = fn.mk_kernel())
+        kernel.verify();
+        CODEGEN_LINE(Function check_fn("tick_check_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{check_fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            // only reads context, fails from price 40 on
+            CODEGEN_LINE(ValueInfo l_is_high = ctx.field("price").load() >= ValueInfo::from_constant<int64_t>(40))
+            CODEGEN_LINE(FunctionContext::set_return_value(l_is_high.cond(ValueInfo::from_constant(1), ValueInfo::from_constant(0))))
+        }
+        check_fn.verify();
+        CODEGEN_LINE(Function sum_fn("tick_sum_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{sum_fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("qty").store(ctx.field("qty").load() + ctx.field("price").load()))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        sum_fn.verify();
+        CODEGEN_LINE(Function sum_kernel = sum_fn.mk_kernel())
+        sum_kernel.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("tick_args");
+    runtime::EventFn tick_fn = l_runtime_module.event_fn_info("tick_fn");
+    runtime::EventFn tick_kernel = l_runtime_module.event_fn_info("tick_fn__kernel");
+    runtime::EventFn check_fn = l_runtime_module.event_fn_info("tick_check_fn");
+    runtime::EventFn sum_kernel = l_runtime_module.event_fn_info("tick_sum_fn__kernel");
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_args.size_in_bytes(), 3 * static_cast<int32_t>(sizeof(int64_t)));
+    constexpr uint64_t c_num_ticks = 64;
+    // tick i: price i, qty 2
+    int64_t l_records[c_num_ticks][3] = {};
+    int64_t l_columns[3][c_num_ticks] = {};
+    for (uint64_t i = 0; i != c_num_ticks; ++i) {
+        l_records[i][0] = l_columns[0][i] = static_cast<int64_t>(i);
+        l_records[i][1] = l_columns[1][i] = 2;
+    }
+    const std::string l_records_path = LLVM_BUILDER_CONCAT << "/tmp/llvm_builder_ticks_" << ::getpid();
+    const std::string l_columns_path = LLVM_BUILDER_CONCAT << "/tmp/llvm_builder_tick_columns_" << ::getpid();
+    for (const auto& [l_path, l_data] : {std::make_pair(l_records_path, static_cast<const void*>(l_records)),
+                                         std::make_pair(l_columns_path, static_cast<const void*>(l_columns))}) {
+        std::FILE* l_file = std::fopen(l_path.c_str(), "wb");
+        LLVM_BUILDER_ALWAYS_ASSERT(l_file != nullptr);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(std::fwrite(l_data, sizeof(l_records), 1, l_file), 1u);
+        std::fclose(l_file);
+    }
+    CODEGEN_LINE(runtime::Object l_state = l_args.mk_object())
+    CODEGEN_LINE(l_state.freeze())
+    uint64_t l_num_processed = 0;
+    for (runtime::Replay::layout_t l_layout : {runtime::Replay::layout_t::records, runtime::Replay::layout_t::columns}) {
+        const std::string& l_path = l_layout == runtime::Replay::layout_t::records ? l_records_path : l_columns_path;
+        CODEGEN_LINE(runtime::Replay l_replay{l_args, l_path, l_layout})
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_replay.has_error());
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_replay.num_records(), c_num_ticks);
+        CODEGEN_LINE(l_replay.set_prefetch_distance(4))
+        // every record is copied into state, state ends up with the last one
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_replay.run(tick_fn, l_state, 0, c_num_ticks, &l_num_processed), 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_num_processed, c_num_ticks);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_state.get<int64_t>("notional"), 2 * static_cast<int64_t>(c_num_ticks - 1));
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_replay.run(tick_fn, l_state, 10, 20, &l_num_processed), 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_num_processed, 10u);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_state.get<int64_t>("price"), 19);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_state.get<int64_t>("notional"), 38);
+        // kernel reads the mapping in place, the field it writes lives in state
+        CODEGEN_LINE(l_state.set<int64_t>("notional", 0))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_replay.run(tick_kernel, l_state, 0, c_num_ticks, &l_num_processed), 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_num_processed, c_num_ticks);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_state.get<int64_t>("notional"), 2 * static_cast<int64_t>(c_num_ticks - 1));
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_state.get<int64_t>("price"), 19);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+        // mapping is read only, a kernel can't write a field it reads from the file
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_replay.run(sum_kernel, l_state, 0, c_num_ticks), -1);
+        ErrorContext::clear_error();
+    }
+    {
+        // context points at each mapped record
+        CODEGEN_LINE(runtime::Replay l_replay{l_args, l_records_path})
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_replay.run_in_place(check_fn, 0, 40, &l_num_processed), 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_num_processed, 40u);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_replay.run_in_place(check_fn, 0, c_num_ticks, &l_num_processed), 1);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_num_processed, 40u);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+        // mapping is read only
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_replay.run_in_place(tick_fn, 0, c_num_ticks), -1);
+        ErrorContext::clear_error();
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_replay.run(tick_fn, l_state, 0, c_num_ticks + 1), -1);
+        ErrorContext::clear_error();
+    }
+    {
+        CODEGEN_LINE(runtime::Replay l_replay{l_args, l_columns_path, runtime::Replay::layout_t::columns})
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_replay.run_in_place(tick_fn, 0, c_num_ticks), -1);
+        ErrorContext::clear_error();
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(::unlink(l_records_path.c_str()), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(::unlink(l_columns_path.c_str()), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT(runtime::Replay(l_args, l_records_path).has_error());
+    ErrorContext::clear_error();
+}
+
+TEST(LLVM_CODEGEN_JIT_API, arrow_c_data) {
+    constexpr uint32_t c_num_rows = 10;
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_arrow_c_data"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo float64_type = TypeInfo::mk_float64())
+    CODEGEN_LINE(l_cursor.add_field("sum", float64_type))
+    CODEGEN_LINE(l_cursor.add_field("px", TypeInfo::mk_array(float64_type, c_num_rows).mk_ptr()))
+    CODEGEN_LINE(l_cursor.add_field("px_valid", TypeInfo::mk_array(TypeInfo::mk_uint8(), (c_num_rows + 7) / 8).mk_ptr()))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("arrow_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("arrow_sum_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ValueInfo l_px = ctx.field("px").load())
+            CODEGEN_LINE(ValueInfo l_px_valid = ctx.field("px_valid").load())
+            CODEGEN_LINE(ValueInfo l_sum = ValueInfo::from_constant(0.0))
+            for (uint32_t i = 0; i != c_num_rows; ++i) {
+                CODEGEN_LINE(l_sum = l_sum + l_px.entry_or(ValueInfo::from_constant(i), l_px_valid, ValueInfo::from_constant(0.0)))
+            }
+            CODEGEN_LINE(ctx.field("sum").store(l_sum))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("arrow_args");
+    runtime::EventFn sum_fn = l_runtime_module.event_fn_info("arrow_sum_fn");
+    {
+        CODEGEN_LINE(runtime::Array l_px = runtime::Array::from(runtime::type_t::float64, c_num_rows))
+        for (uint32_t i = 0; i != c_num_rows; ++i) {
+            l_px.set<float64_t>(i, i + 1.0);
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(reinterpret_cast<uintptr_t>(l_px.ref()) % 64, 0u);
+        CODEGEN_LINE(l_px.enable_validity())
+        CODEGEN_LINE(l_px.set_null(3, true))
+        CODEGEN_LINE(l_px.set_null(8, true))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_px.null_count(), 2u);
+        CODEGEN_LINE(l_px.freeze())
+        // list column, row i holds values [offsets[i], offsets[i + 1])
+        CODEGEN_LINE(runtime::Array l_offsets = runtime::Array::from(runtime::type_t::int32, c_num_rows + 1))
+        for (uint32_t i = 0; i != c_num_rows + 1; ++i) {
+            l_offsets.set<int32_t>(i, static_cast<int32_t>(i * 6 / c_num_rows));
+        }
+        CODEGEN_LINE(l_offsets.freeze())
+        CODEGEN_LINE(runtime::Array l_values = runtime::Array::from(runtime::type_t::int32, 6))
+        CODEGEN_LINE(l_values.freeze())
+        CODEGEN_LINE(runtime::Array l_qty = runtime::Array::from_list(l_offsets, l_values))
+        LLVM_BUILDER_ALWAYS_ASSERT(l_qty.is_list());
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_qty.num_elements(), c_num_rows);
+        CODEGEN_LINE(runtime::Table l_table{c_num_rows})
+        LLVM_BUILDER_ALWAYS_ASSERT(l_table.add_column("px", l_px));
+        LLVM_BUILDER_ALWAYS_ASSERT(l_table.add_column("qty", l_qty));
+
+        ArrowArray l_arrow;
+        ArrowSchema l_schema;
+        LLVM_BUILDER_ALWAYS_ASSERT(l_table.export_arrow(&l_arrow, &l_schema));
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(std::string{l_schema.format}, "+s");
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_schema.n_children, 2);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(std::string{l_schema.children[0]->name}, "px");
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(std::string{l_schema.children[0]->format}, "g");
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_schema.children[0]->flags, ARROW_FLAG_NULLABLE);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(std::string{l_schema.children[1]->format}, "+l");
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(std::string{l_schema.children[1]->children[0]->format}, "i");
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_arrow.length, c_num_rows);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_arrow.children[0]->null_count, 2);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_arrow.children[0]->buffers[1], l_px.ref());
+
+        // import moves the array out and uses its buffers in place
+        CODEGEN_LINE(runtime::Table l_imported = runtime::Table::import_arrow(&l_arrow, &l_schema))
+        LLVM_BUILDER_ALWAYS_ASSERT(l_arrow.release == nullptr);
+        l_schema.release(&l_schema);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_imported.num_rows(), c_num_rows);
+        CODEGEN_LINE(runtime::Array l_px_in = l_imported.column("px"))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_px_in.ref(), l_px.ref());
+        LLVM_BUILDER_ALWAYS_ASSERT(l_px_in.is_frozen());
+        LLVM_BUILDER_ALWAYS_ASSERT(l_px_in.is_null(3));
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_px_in.is_null(4));
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_px_in.null_count(), 2u);
+        CODEGEN_LINE(runtime::Array l_qty_in = l_imported.column("qty"))
+        LLVM_BUILDER_ALWAYS_ASSERT(l_qty_in.is_list());
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_qty_in.values().ref(), l_values.ref());
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_qty_in.offsets().get<int32_t>(c_num_rows), 6);
+        // list columns don't feed kernels
+        const std::vector<runtime::Column> l_columns = l_imported.kernel_columns();
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_columns.size(), 1u);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_columns[0].field(), "px");
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_columns[0].stride(), static_cast<int64_t>(sizeof(float64_t)));
+
+        // null entries read as 0.0 through the validity bitmap
+        CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+        CODEGEN_LINE(l_obj.set_array("px", l_px_in))
+        CODEGEN_LINE(l_obj.set_array("px_valid", l_px_in.validity()))
+        CODEGEN_LINE(l_obj.freeze())
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(sum_fn.on_event(l_obj), 0);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<float64_t>("sum"), 55.0 - 4.0 - 9.0);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    }
+    {
+        // utf8 is imported as a list of uint8
+        static uint32_t s_num_released = 0;
+        const int32_t l_offsets[3] = {0, 3, 5};
+        const char l_data[] = "abcde";
+        const void* l_buffers[3] = {nullptr, l_offsets, l_data};
+        ArrowSchema l_schema{"u", "name", nullptr, 0, 0, nullptr, nullptr,
+                             [](ArrowSchema* s) { s->release = nullptr; }, nullptr};
+        ArrowArray l_arrow{2, 0, 0, 3, 0, l_buffers, nullptr, nullptr,
+                           [](ArrowArray* a) { ++s_num_released; a->release = nullptr; }, nullptr};
+        {
+            CODEGEN_LINE(runtime::Array l_names = runtime::Array::import_arrow(&l_arrow, &l_schema))
+            LLVM_BUILDER_ALWAYS_ASSERT(l_names.is_list());
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_names.values().element_type(), runtime::type_t::uint8);
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_names.values().num_elements(), 5u);
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_names.values().ref(), static_cast<const void*>(l_data));
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(s_num_released, 0u);
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(s_num_released, 1u);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+        // bitmap of a slice not starting at a byte boundary is rejected, array is still released
+        const uint8_t l_validity[1] = {0xfd};
+        const int64_t l_ints[8] = {};
+        const void* l_int_buffers[2] = {l_validity, l_ints};
+        l_schema.format = "l";
+        l_arrow = ArrowArray{4, 1, 3, 2, 0, l_int_buffers, nullptr, nullptr,
+                             [](ArrowArray* a) { ++s_num_released; a->release = nullptr; }, nullptr};
+        LLVM_BUILDER_ALWAYS_ASSERT(runtime::Array::import_arrow(&l_arrow, &l_schema).has_error());
+        ErrorContext::clear_error();
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(s_num_released, 2u);
+    }
+    {
+        // only frozen non boolean arrays have an arrow equivalent
+        ArrowArray l_arrow;
+        ArrowSchema l_schema;
+        CODEGEN_LINE(runtime::Array l_ints = runtime::Array::from(runtime::type_t::int64, 4))
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_ints.export_arrow(&l_arrow, &l_schema));
+        ErrorContext::clear_error();
+        CODEGEN_LINE(runtime::Array l_flags = runtime::Array::from(runtime::type_t::boolean, 4))
+        CODEGEN_LINE(l_flags.freeze())
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_flags.export_arrow(&l_arrow, &l_schema));
+        ErrorContext::clear_error();
+        CODEGEN_LINE(runtime::Table l_table{4})
+        CODEGEN_LINE(runtime::Array l_short = runtime::Array::from(runtime::type_t::int64, 3))
+        CODEGEN_LINE(l_short.freeze())
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_table.add_column("short", l_short));
+        ErrorContext::clear_error();
+    }
+}
+
+TEST(LLVM_CODEGEN_JIT_API, collection_layout) {
+    constexpr uint32_t c_capacity = 8;
+    for (Collection::layout_t l_layout : {Collection::layout_t::aos, Collection::layout_t::soa}) {
+        const bool l_is_soa = (l_layout == Collection::layout_t::soa);
+        CODEGEN_LINE(Cursor l_cursor{l_is_soa ? "jit_api_collection_soa" : "jit_api_collection_aos"})
+        CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+        CODEGEN_LINE(TypeInfo float64_type = TypeInfo::mk_float64())
+        CODEGEN_LINE(TypeInfo l_order_type)
+        {
+            std::vector<field_entry_t> l_field_list;
+            CODEGEN_LINE(l_field_list.emplace_back("px", float64_type))
+            CODEGEN_LINE(l_field_list.emplace_back("qty", TypeInfo::mk_int32()))
+            CODEGEN_LINE(l_field_list.emplace_back("side", TypeInfo::mk_int8()))
+            CODEGEN_LINE(l_order_type = TypeInfo::mk_struct("collection_order", l_field_list, false))
+        }
+        CODEGEN_LINE(l_cursor.add_field("notional", float64_type))
+        CODEGEN_LINE(l_cursor.add_field("idx", TypeInfo::mk_int32()))
+        CODEGEN_LINE(l_cursor.add_field("orders", Collection::buffer_type(l_order_type, c_capacity, l_layout)))
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+        CODEGEN_LINE(JustInTimeRunner jit_runner)
+        CODEGEN_LINE(l_cursor.bind("collection_args"))
+        CODEGEN_LINE(Module l_module = l_cursor.main_module())
+        CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+        CODEGEN_LINE(Collection l_orders)
+        {
+            CODEGEN_LINE(Function fn("collection_fn"))
+            {
+                CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+                CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+                CODEGEN_LINE(l_orders = Collection(ctx.field("orders").load(), l_order_type, c_capacity, l_layout))
+                LLVM_BUILDER_ALWAYS_ASSERT(not l_orders.has_error());
+                // kernel below is same for both layouts
+                CODEGEN_LINE(ValueInfo l_notional = ValueInfo::from_constant(0.0))
+                for (uint32_t i = 0; i != c_capacity; ++i) {
+                    CODEGEN_LINE(Collection::Entry l_order = l_orders.entry(i))
+                    CODEGEN_LINE(ValueInfo l_qty = l_order.field("qty").load().cast(float64_type))
+                    CODEGEN_LINE(l_notional = l_notional + l_order.field("px").load() * l_qty)
+                }
+                CODEGEN_LINE(ctx.field("notional").store(l_notional))
+                CODEGEN_LINE(ValueInfo l_qty_ptr = l_orders.entry(ctx.field("idx").load()).field("qty"))
+                CODEGEN_LINE(l_qty_ptr.store(l_qty_ptr.load() + ValueInfo::from_constant(static_cast<int32_t>(1))))
+                CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+            }
+            fn.verify();
+            INIT_MODULE(l_module)
+            FunctionContext::function().assert_no_context();
+        }
+        jit_runner.add_module(l_cursor);
+        jit_runner.bind();
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+        // columns are contiguous with soa, records are with aos
+        if (l_is_soa) {
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_orders.field_stride("px"), sizeof(float64_t));
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_orders.field_stride("qty"), sizeof(int32_t));
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_orders.field_offset("qty") % Collection::c_column_alignment, 0u);
+        } else {
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_orders.field_stride("px"), l_order_type.size_in_bytes());
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_orders.field_offset("qty"), l_order_type["qty"].offset());
+        }
+        const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+        const runtime::Struct& l_args = l_runtime_module.struct_info("collection_args");
+        runtime::EventFn collection_fn = l_runtime_module.event_fn_info("collection_fn");
+        CODEGEN_LINE(runtime::Array l_buffer = runtime::Array::from(runtime::type_t::uint8, l_orders.num_bytes()))
+        char* l_raw = static_cast<char*>(l_buffer.ref());
+        for (uint32_t i = 0; i != c_capacity; ++i) {
+            const float64_t l_px = 100.0 + i;
+            const int32_t l_qty = static_cast<int32_t>(i + 1);
+            std::memcpy(l_raw + l_orders.byte_offset(i, "px"), &l_px, sizeof(l_px));
+            std::memcpy(l_raw + l_orders.byte_offset(i, "qty"), &l_qty, sizeof(l_qty));
+        }
+        CODEGEN_LINE(l_buffer.freeze())
+        CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+        CODEGEN_LINE(l_obj.set<int32_t>("idx", 5))
+        CODEGEN_LINE(l_obj.set_array("orders", l_buffer))
+        CODEGEN_LINE(l_obj.freeze())
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(collection_fn.on_event(l_obj), 0);
+        float64_t l_expected = 0.0;
+        for (uint32_t i = 0; i != c_capacity; ++i) {
+            l_expected += (100.0 + i) * (i + 1);
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<float64_t>("notional"), l_expected);
+        int32_t l_qty_5 = 0;
+        std::memcpy(&l_qty_5, l_raw + l_orders.byte_offset(5, "qty"), sizeof(l_qty_5));
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_qty_5, 7);
+        LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+        // out of capacity and unknown fields
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_orders.byte_offset(c_capacity, "px"), std::numeric_limits<uint32_t>::max());
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_orders.field_offset("unknown"), std::numeric_limits<uint32_t>::max());
+        ErrorContext::clear_error();
+    }
+}
+
+TEST(LLVM_CODEGEN_JIT_API, array_view) {
+    constexpr uint32_t c_num_rows = 4;
+    constexpr uint32_t c_num_cols = 3;
+    constexpr uint32_t c_num_px = 10;
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_array_view"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo float64_type = TypeInfo::mk_float64())
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(l_cursor.add_field("col_sum", float64_type))
+    CODEGEN_LINE(l_cursor.add_field("window_sum", float64_type))
+    CODEGEN_LINE(l_cursor.add_field("arg_sum", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("row", TypeInfo::mk_int32()))
+    for (uint32_t i = 0; i != 4; ++i) {
+        CODEGEN_LINE(l_cursor.add_field(LLVM_BUILDER_CONCAT << "arg_" << i, int64_type))
+    }
+    CODEGEN_LINE(l_cursor.add_field("matrix", TypeInfo::mk_array(float64_type, c_num_rows * c_num_cols).mk_ptr()))
+    CODEGEN_LINE(l_cursor.add_field("px", TypeInfo::mk_array(float64_type, c_num_px).mk_ptr()))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("array_view_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("array_view_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            // column 1 of row major matrix
+            CODEGEN_LINE(ValueInfo l_matrix = ctx.field("matrix").load())
+            CODEGEN_LINE(ArrayView l_col_1{l_matrix, 1, c_num_rows, c_num_cols})
+            CODEGEN_LINE(ValueInfo l_col_sum = ValueInfo::from_constant(0.0))
+            for (uint32_t i = 0; i != c_num_rows; ++i) {
+                CODEGEN_LINE(l_col_sum = l_col_sum + l_col_1.entry(i).load())
+            }
+            CODEGEN_LINE(ctx.field("col_sum").store(l_col_sum))
+            // write through a view with runtime index
+            CODEGEN_LINE(ArrayView l_col_2{l_matrix, 2, c_num_rows, c_num_cols})
+            CODEGEN_LINE(l_col_2.entry(ctx.field("row").load()).store(l_col_sum))
+            // last 4 entries, every other one
+            CODEGEN_LINE(ArrayView l_window = ArrayView{ctx.field("px").load()}.slice(c_num_px - 4, 2, 2))
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_window.length(), 2u);
+            CODEGEN_LINE(ctx.field("window_sum").store(l_window.entry(0).load() + l_window.entry(1).load()))
+            // group of context fields as an array
+            CODEGEN_LINE(ArrayView l_args = ArrayView::from_fields(ctx, {"arg_0", "arg_1", "arg_2", "arg_3"}))
+            LLVM_BUILDER_ALWAYS_ASSERT(not l_args.has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_args.byte_stride(), sizeof(int64_t));
+            CODEGEN_LINE(ValueInfo l_arg_sum = l_args.entry(0).load())
+            for (uint32_t i = 1; i != l_args.length(); ++i) {
+                CODEGEN_LINE(l_arg_sum = l_arg_sum + l_args.entry(i).load())
+            }
+            CODEGEN_LINE(ctx.field("arg_sum").store(l_arg_sum))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+            // out of range views
+            LLVM_BUILDER_ALWAYS_ASSERT(ArrayView(l_matrix, 2, c_num_rows + 1, c_num_cols).has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT(l_col_1.slice(1, 2, 3).has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT(l_col_1.entry(c_num_rows).has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT(ArrayView::from_fields(ctx, {"arg_0", "arg_2", "arg_3"}).has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT(ArrayView::from_fields(ctx, {"arg_3", "col_sum"}).has_error());
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("array_view_args");
+    runtime::EventFn view_fn = l_runtime_module.event_fn_info("array_view_fn");
+    CODEGEN_LINE(runtime::Array l_matrix = runtime::Array::from(runtime::type_t::float64, c_num_rows * c_num_cols))
+    for (uint32_t i = 0; i != c_num_rows * c_num_cols; ++i) {
+        l_matrix.set<float64_t>(i, i);
+    }
+    CODEGEN_LINE(l_matrix.freeze())
+    CODEGEN_LINE(runtime::Array l_px = runtime::Array::from(runtime::type_t::float64, c_num_px))
+    for (uint32_t i = 0; i != c_num_px; ++i) {
+        l_px.set<float64_t>(i, 10.0 * i);
+    }
+    CODEGEN_LINE(l_px.freeze())
+    CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+    for (uint32_t i = 0; i != 4; ++i) {
+        CODEGEN_LINE(l_obj.set<int64_t>(LLVM_BUILDER_CONCAT << "arg_" << i, i + 1))
+    }
+    CODEGEN_LINE(l_obj.set<int32_t>("row", 3))
+    CODEGEN_LINE(l_obj.set_array("matrix", l_matrix))
+    CODEGEN_LINE(l_obj.set_array("px", l_px))
+    CODEGEN_LINE(l_obj.freeze())
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(view_fn.on_event(l_obj), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<float64_t>("col_sum"), 1.0 + 4.0 + 7.0 + 10.0);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<float64_t>("window_sum"), 60.0 + 80.0);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("arg_sum"), 10);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_matrix.get<float64_t>(3 * c_num_cols + 2), 22.0);
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    // runtime views alias the array
+    CODEGEN_LINE(runtime::ArrayView l_col_1{l_matrix, 1, c_num_rows, c_num_cols})
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_col_1.get<float64_t>(2), 7.0);
+    CODEGEN_LINE(l_col_1.set<float64_t>(2, -7.0))
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_matrix.get<float64_t>(7), -7.0);
+    const runtime::Column l_column = l_col_1.column("px");
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_column.stride(), static_cast<int64_t>(c_num_cols * sizeof(float64_t)));
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_column.data(), static_cast<void*>(static_cast<float64_t*>(l_matrix.ref()) + 1));
+    CODEGEN_LINE(runtime::ArrayView l_row_1 = runtime::ArrayView{l_matrix}.slice(c_num_cols, c_num_cols))
+    LLVM_BUILDER_ALWAYS_ASSERT(l_row_1.is_contiguous());
+    CODEGEN_LINE(runtime::Array l_row_1_arr = l_row_1.to_array())
+    LLVM_BUILDER_ALWAYS_ASSERT(l_row_1_arr.is_frozen());
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_row_1_arr.num_elements(), c_num_cols);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_row_1_arr.ref(), static_cast<void*>(static_cast<float64_t*>(l_matrix.ref()) + c_num_cols));
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    // strided views have no array equivalent
+    LLVM_BUILDER_ALWAYS_ASSERT(l_col_1.to_array().has_error());
+    ErrorContext::clear_error();
+    LLVM_BUILDER_ALWAYS_ASSERT(runtime::ArrayView(l_matrix, 1, c_num_rows + 1, c_num_cols).has_error());
+    ErrorContext::clear_error();
+}
+
+TEST(LLVM_CODEGEN_JIT_API, ring_buffer) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_ring_buffer"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(TypeInfo float64_type = TypeInfo::mk_float64())
+    CODEGEN_LINE(TypeInfo l_ring_4_type = RingBuffer::mk_type("ring_4", int64_type, 4))
+    CODEGEN_LINE(TypeInfo l_ring_3_type = RingBuffer::mk_type("ring_3", float64_type, 3))
+    CODEGEN_LINE(l_cursor.add_field("px", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("idx", TypeInfo::mk_int32()))
+    CODEGEN_LINE(l_cursor.add_field("newest", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("oldest", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("picked", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("size", TypeInfo::mk_uint32()))
+    CODEGEN_LINE(l_cursor.add_field("oldest_3", float64_type))
+    CODEGEN_LINE(l_cursor.add_field("ring", l_ring_4_type.mk_ptr()))
+    CODEGEN_LINE(l_cursor.add_field("ring_3", l_ring_3_type.mk_ptr()))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("ring_buffer_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("ring_buffer_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(RingBuffer l_ring{ctx.field("ring").load()})
+            CODEGEN_LINE(RingBuffer l_ring_3{ctx.field("ring_3").load()})
+            LLVM_BUILDER_ALWAYS_ASSERT(not l_ring.has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT(l_ring.is_pow2());
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_ring.capacity(), 4u);
+            LLVM_BUILDER_ALWAYS_ASSERT(not l_ring_3.is_pow2());
+            // reads see the buffers as they were before this event
+            CODEGEN_LINE(ctx.field("newest").store(l_ring.newest().load()))
+            CODEGEN_LINE(ctx.field("oldest").store(l_ring.oldest().load()))
+            CODEGEN_LINE(ctx.field("picked").store(l_ring.at(ctx.field("idx").load()).load()))
+            CODEGEN_LINE(ctx.field("size").store(l_ring.size()))
+            CODEGEN_LINE(ctx.field("oldest_3").store(l_ring_3.oldest().load()))
+            CODEGEN_LINE(l_ring.push(ctx.field("px").load()))
+            CODEGEN_LINE(l_ring_3.push(ctx.field("px").load().cast(float64_type)))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+            LLVM_BUILDER_ALWAYS_ASSERT(l_ring.at(4).has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT(RingBuffer(ctx).has_error());
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("ring_buffer_args");
+    runtime::EventFn ring_fn = l_runtime_module.event_fn_info("ring_buffer_fn");
+    CODEGEN_LINE(runtime::Object l_ring_obj = l_runtime_module.struct_info("ring_4").mk_object())
+    CODEGEN_LINE(runtime::Object l_ring_3_obj = l_runtime_module.struct_info("ring_3").mk_object())
+    CODEGEN_LINE(l_ring_obj.freeze())
+    CODEGEN_LINE(l_ring_3_obj.freeze())
+    CODEGEN_LINE(runtime::RingBuffer l_ring{l_ring_obj})
+    CODEGEN_LINE(runtime::RingBuffer l_ring_3{l_ring_3_obj})
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_ring.capacity(), 4u);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_ring_3.capacity(), 3u);
+    CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+    CODEGEN_LINE(l_obj.set_object("ring", l_ring_obj))
+    CODEGEN_LINE(l_obj.set_object("ring_3", l_ring_3_obj))
+    CODEGEN_LINE(l_obj.freeze())
+    for (int64_t k = 1; k != 10; ++k) {
+        CODEGEN_LINE(l_obj.set<int64_t>("px", k))
+        CODEGEN_LINE(l_obj.set<int32_t>("idx", 1))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(ring_fn.on_event(l_obj), 0);
+        const int64_t l_size = std::min<int64_t>(k, 4);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_ring.size(), static_cast<uint32_t>(l_size));
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_ring.at<int64_t>(0), k);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_ring.oldest<int64_t>(), k - l_size + 1);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_ring_3.oldest<float64_t>(), static_cast<float64_t>(k - std::min<int64_t>(k, 3) + 1));
+        if (k > 2) {
+            // state seen by event k is after push k - 1
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("newest"), k - 1);
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("picked"), k - 2);
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("oldest"), k - 1 - std::min<int64_t>(k - 1, 4) + 1);
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<uint32_t>("size"), static_cast<uint32_t>(std::min<int64_t>(k - 1, 4)));
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<float64_t>("oldest_3"), static_cast<float64_t>(k - 1 - std::min<int64_t>(k - 1, 3) + 1));
+        }
+    }
+    // host pushes are seen by the next event, out of range runtime index stays in buffer
+    CODEGEN_LINE(l_ring.push<int64_t>(100))
+    CODEGEN_LINE(l_obj.set<int32_t>("idx", 7))
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(ring_fn.on_event(l_obj), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("newest"), 100);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_ring.at<int64_t>(1), 100);
+    CODEGEN_LINE(l_ring.clear())
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_ring.size(), 0u);
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    CODEGEN_LINE(l_ring.at<int64_t>(0))
+    LLVM_BUILDER_ALWAYS_ASSERT(l_ring.has_error());
+    ErrorContext::clear_error();
+    LLVM_BUILDER_ALWAYS_ASSERT(runtime::RingBuffer{l_obj}.has_error());
+    ErrorContext::clear_error();
+    LLVM_BUILDER_ALWAYS_ASSERT(RingBuffer::mk_type("ring_0", int64_type, 0).has_error());
+    ErrorContext::clear_error();
+}
+
+TEST(LLVM_CODEGEN_JIT_API, rolling_stats) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_rolling_stats"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(TypeInfo float64_type = TypeInfo::mk_float64())
+    CODEGEN_LINE(TypeInfo l_ewma_type = Ewma::mk_type("ewma", float64_type))
+    CODEGEN_LINE(TypeInfo l_stats_type = RollingStats::mk_type("stats_3", int64_type, 3))
+    CODEGEN_LINE(TypeInfo l_max_type = RollingMinMax::mk_type("max_3", int64_type, 3))
+    CODEGEN_LINE(TypeInfo l_min_type = RollingMinMax::mk_type("min_4", int64_type, 4))
+    CODEGEN_LINE(TypeInfo l_vwap_type = Vwap::mk_type("vwap_3", float64_type, int64_type, 3))
+    CODEGEN_LINE(l_cursor.add_field("px", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("qty", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("ewma_value", float64_type))
+    CODEGEN_LINE(l_cursor.add_field("sum", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("mean", float64_type))
+    CODEGEN_LINE(l_cursor.add_field("variance", float64_type))
+    CODEGEN_LINE(l_cursor.add_field("max", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("min", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("vwap", float64_type))
+    CODEGEN_LINE(l_cursor.add_field("ewma", l_ewma_type.mk_ptr()))
+    CODEGEN_LINE(l_cursor.add_field("stats_3", l_stats_type.mk_ptr()))
+    CODEGEN_LINE(l_cursor.add_field("max_3", l_max_type.mk_ptr()))
+    CODEGEN_LINE(l_cursor.add_field("min_4", l_min_type.mk_ptr()))
+    CODEGEN_LINE(l_cursor.add_field("vwap_3", l_vwap_type.mk_ptr()))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("rolling_stats_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("rolling_stats_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(Ewma l_ewma(ctx.field("ewma").load(), 3))
+            CODEGEN_LINE(RollingStats l_stats{ctx.field("stats_3").load()})
+            CODEGEN_LINE(RollingMinMax l_max(ctx.field("max_3").load(), RollingMinMax::kind_t::max))
+            CODEGEN_LINE(RollingMinMax l_min(ctx.field("min_4").load(), RollingMinMax::kind_t::min))
+            CODEGEN_LINE(Vwap l_vwap{ctx.field("vwap_3").load()})
+            LLVM_BUILDER_ALWAYS_ASSERT(not l_ewma.has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT(not l_stats.has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT(not l_max.has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT(not l_min.has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT(not l_vwap.has_error());
+            LLVM_BUILDER_ALWAYS_ASSERT(l_stats.stat_type() == float64_type);
+            CODEGEN_LINE(ValueInfo l_px = ctx.field("px").load())
+            CODEGEN_LINE(l_ewma.update(l_px.cast(float64_type)))
+            CODEGEN_LINE(l_stats.update(l_px))
+            CODEGEN_LINE(l_max.update(l_px))
+            CODEGEN_LINE(l_min.update(l_px))
+            CODEGEN_LINE(l_vwap.update(l_px.cast(float64_type), ctx.field("qty").load()))
+            // statistics of this event are visible after a section break
+            CODEGEN_LINE(FunctionContext::section_break("read_stats"))
+            CODEGEN_LINE(ctx.field("ewma_value").store(l_ewma.value()))
+            CODEGEN_LINE(ctx.field("sum").store(l_stats.sum()))
+            CODEGEN_LINE(ctx.field("mean").store(l_stats.mean()))
+            CODEGEN_LINE(ctx.field("variance").store(l_stats.variance()))
+            CODEGEN_LINE(ctx.field("max").store(l_max.value()))
+            CODEGEN_LINE(ctx.field("min").store(l_min.value()))
+            CODEGEN_LINE(ctx.field("vwap").store(l_vwap.value()))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+            LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+            CODEGEN_LINE(l_stats.update(l_px.cast(float64_type)))
+            LLVM_BUILDER_ALWAYS_ASSERT(ErrorContext::has_error());
+            ErrorContext::clear_error();
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("rolling_stats_args");
+    runtime::EventFn rolling_fn = l_runtime_module.event_fn_info("rolling_stats_fn");
+    CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+    for (const char* l_name : {"ewma", "stats_3", "max_3", "min_4", "vwap_3"}) {
+        CODEGEN_LINE(runtime::Object l_state = l_runtime_module.struct_info(l_name).mk_object())
+        CODEGEN_LINE(l_state.freeze())
+        CODEGEN_LINE(l_obj.set_object(l_name, l_state))
+    }
+    CODEGEN_LINE(l_obj.freeze())
+    const std::vector<int64_t> l_prices{5, 3, 8, 1, 9, 2, 7, 7, 4, 6, 0, 10, -3, 5};
+    std::vector<int64_t> l_qtys;
+    double l_ewma = 0;
+    for (size_t k = 0; k != l_prices.size(); ++k) {
+        const int64_t l_px = l_prices[k];
+        l_qtys.push_back(static_cast<int64_t>(k % 3) + 1);
+        CODEGEN_LINE(l_obj.set<int64_t>("px", l_px))
+        CODEGEN_LINE(l_obj.set<int64_t>("qty", l_qtys.back()))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(rolling_fn.on_event(l_obj), 0);
+        l_ewma = k == 0 ? static_cast<double>(l_px) : l_ewma + 0.5 * (static_cast<double>(l_px) - l_ewma);
+        LLVM_BUILDER_ALWAYS_ASSERT(std::abs(l_obj.get<float64_t>("ewma_value") - l_ewma) < 1e-9);
+        // window of 3
+        const size_t l_begin_3 = k < 2 ? 0 : k - 2;
+        int64_t l_sum = 0;
+        int64_t l_max = l_prices[l_begin_3];
+        double l_notional = 0;
+        int64_t l_qty = 0;
+        for (size_t i = l_begin_3; i <= k; ++i) {
+            l_sum += l_prices[i];
+            l_max = std::max(l_max, l_prices[i]);
+            l_notional += static_cast<double>(l_prices[i] * l_qtys[i]);
+            l_qty += l_qtys[i];
+        }
+        const double l_count = static_cast<double>(k - l_begin_3 + 1);
+        const double l_mean = static_cast<double>(l_sum) / l_count;
+        double l_m2 = 0;
+        for (size_t i = l_begin_3; i <= k; ++i) {
+            l_m2 += (static_cast<double>(l_prices[i]) - l_mean) * (static_cast<double>(l_prices[i]) - l_mean);
+        }
+        const double l_variance = l_count > 1 ? l_m2 / (l_count - 1) : 0;
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("sum"), l_sum);
+        LLVM_BUILDER_ALWAYS_ASSERT(std::abs(l_obj.get<float64_t>("mean") - l_mean) < 1e-9);
+        LLVM_BUILDER_ALWAYS_ASSERT(std::abs(l_obj.get<float64_t>("variance") - l_variance) < 1e-9);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("max"), l_max);
+        LLVM_BUILDER_ALWAYS_ASSERT(std::abs(l_obj.get<float64_t>("vwap") - l_notional / static_cast<double>(l_qty)) < 1e-9);
+        // window of 4
+        const size_t l_begin_4 = k < 3 ? 0 : k - 3;
+        const int64_t l_min = *std::min_element(l_prices.begin() + static_cast<std::ptrdiff_t>(l_begin_4),
+                                                l_prices.begin() + static_cast<std::ptrdiff_t>(k + 1));
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("min"), l_min);
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    LLVM_BUILDER_ALWAYS_ASSERT(RollingStats::mk_type("stats_bool", TypeInfo::mk_bool(), 3).has_error());
+    ErrorContext::clear_error();
+    LLVM_BUILDER_ALWAYS_ASSERT(Ewma::mk_type("ewma_int", int64_type).has_error());
+    ErrorContext::clear_error();
+    LLVM_BUILDER_ALWAYS_ASSERT(Vwap::mk_type("vwap_int", int64_type, int64_type, 3).has_error());
+    ErrorContext::clear_error();
+}
+
+TEST(LLVM_CODEGEN_JIT_API, do_while) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_do_while"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo uint32_type = TypeInfo::mk_uint32())
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(l_cursor.add_field("n", uint32_type))
+    CODEGEN_LINE(l_cursor.add_field("sum", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("num_iter", uint32_type))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("do_while_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    {
+        CODEGEN_LINE(Function fn("do_while_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ValueInfo l_one = ValueInfo::from_constant(static_cast<uint32_t>(1)))
+            CODEGEN_LINE(ctx.field("sum").store(ValueInfo::from_constant(static_cast<int64_t>(0))))
+            CODEGEN_LINE(ctx.field("num_iter").store(ValueInfo::from_constant(static_cast<uint32_t>(0))))
+            // sum of 1 .. n, body runs once for n = 0
+            CODEGEN_LINE(FunctionContext::do_while("sum_loop", [&] {
+                const ValueInfo l_iter = ctx.field("num_iter").load() + l_one;
+                ctx.field("sum").store(ctx.field("sum").load() + l_iter.cast(int64_type));
+                ctx.field("num_iter").store(l_iter);
+                return l_iter < ctx.field("n").load();
+            }))
+            CODEGEN_LINE(FunctionContext::do_while("", {}))
+            LLVM_BUILDER_ALWAYS_ASSERT(ErrorContext::has_error());
+            ErrorContext::clear_error();
+            // state on loop exit
+            CODEGEN_LINE(ctx.field("sum").store(ctx.field("sum").load() * ValueInfo::from_constant(static_cast<int64_t>(2))))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+            LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+        }
+        fn.verify();
+        INIT_MODULE(l_module)
+        FunctionContext::function().assert_no_context();
+    }
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("do_while_args");
+    runtime::EventFn do_while_fn = l_runtime_module.event_fn_info("do_while_fn");
+    CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+    CODEGEN_LINE(l_obj.freeze())
+    for (uint32_t n : {0u, 1u, 5u, 100u}) {
+        CODEGEN_LINE(l_obj.set<uint32_t>("n", n))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(do_while_fn.on_event(l_obj), 0);
+        const uint32_t l_num_iter = std::max(n, 1u);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<uint32_t>("num_iter"), l_num_iter);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("sum"), static_cast<int64_t>(l_num_iter) * (l_num_iter + 1));
+    }
+}
+
+TEST(LLVM_CODEGEN_JIT_API, event_graph) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_event_graph"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(l_cursor.add_field("px", int64_type, Event::from_name("book")))
+    CODEGEN_LINE(l_cursor.add_field("qty", int64_type, Event::from_name("trade")))
+    CODEGEN_LINE(l_cursor.add_field("sig", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("risk", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("volume", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("num_signal", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("num_risk", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("num_volume", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("ping", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("pong", int64_type))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    CODEGEN_LINE(std::vector<Event> l_events = l_cursor.events())
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_events.size(), 2u);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_events[0].name(), "book");
+    LLVM_BUILDER_ALWAYS_ASSERT(l_events[0].fields() == std::vector<std::string>{"px"});
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("event_graph_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    auto mk_fn = [] (const std::string& name, const std::string& src, const std::string& dst, const std::string& counter) {
+        CODEGEN_LINE(Function fn(name))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field(dst).store(ctx.field(src).load() + ValueInfo::from_constant<int64_t>(1)))
+            if (not counter.empty()) {
+                CODEGEN_LINE(ctx.field(counter).store(ctx.field(counter).load() + ValueInfo::from_constant<int64_t>(1)))
+            }
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        return fn;
+    };
+    CODEGEN_LINE(Function l_risk_fn = mk_fn("risk_fn", "sig", "risk", "num_risk"))
+    CODEGEN_LINE(Function l_volume_fn = mk_fn("volume_fn", "qty", "volume", "num_volume"))
+    CODEGEN_LINE(Function l_signal_fn = mk_fn("signal_fn", "px", "sig", "num_signal"))
+    CODEGEN_LINE(mk_fn("ping_fn", "pong", "ping", ""))
+    CODEGEN_LINE(mk_fn("pong_fn", "ping", "pong", ""))
+    {
+        CODEGEN_LINE(FieldAccess l_access = l_signal_fn.field_access())
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_access.is_opaque());
+        LLVM_BUILDER_ALWAYS_ASSERT((l_access.reads() == std::vector<std::string>{"num_signal", "px"}));
+        LLVM_BUILDER_ALWAYS_ASSERT((l_access.writes() == std::vector<std::string>{"num_signal", "sig"}));
+        LLVM_BUILDER_ALWAYS_ASSERT(not l_access.is_read("qty"));
+        LLVM_BUILDER_ALWAYS_ASSERT(l_access.is_written("sig"));
+    }
+    INIT_MODULE(l_module)
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("event_graph_args");
+    LLVM_BUILDER_ALWAYS_ASSERT(l_runtime_module.trigger_fields("trade") == std::vector<std::string>{"qty"});
+    LLVM_BUILDER_ALWAYS_ASSERT(l_runtime_module.event_fn_info("risk_fn").field_access().is_read("sig"));
+
+    // added out of order, run order follows sig: signal_fn -> risk_fn
+    CODEGEN_LINE(runtime::EventGraph l_graph{l_runtime_module, l_args})
+    for (const char* l_name : {"risk_fn", "volume_fn", "signal_fn"}) {
+        LLVM_BUILDER_ALWAYS_ASSERT(l_graph.add_event(l_runtime_module.event_fn_info(l_name)));
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT(l_graph.bind());
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_graph.num_events(), 3u);
+    LLVM_BUILDER_ALWAYS_ASSERT((l_graph.affected_events({"px"}) == std::vector<std::string>{"signal_fn", "risk_fn"}));
+    LLVM_BUILDER_ALWAYS_ASSERT((l_graph.affected_events({"sig"}) == std::vector<std::string>{"risk_fn"}));
+    LLVM_BUILDER_ALWAYS_ASSERT((l_graph.affected_events({"qty"}) == std::vector<std::string>{"volume_fn"}));
+    LLVM_BUILDER_ALWAYS_ASSERT(l_graph.affected_events({"risk"}).empty());
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_graph.field_id("unknown"), runtime::EventGraph::c_invalid_field);
+
+    CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+    CODEGEN_LINE(l_obj.freeze())
+    CODEGEN_LINE(l_obj.set<int64_t>("px", 10))
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_graph.on_trigger(l_obj, "book"), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("sig"), 11);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("risk"), 12);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("num_signal"), 1);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("num_risk"), 1);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("num_volume"), 0);
+    CODEGEN_LINE(l_obj.set<int64_t>("qty", 5))
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_graph.on_change(l_obj, std::vector<uint32_t>{l_graph.field_id("qty")}), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("volume"), 6);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("num_volume"), 1);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("num_signal"), 1);
+    CODEGEN_LINE(l_obj.set<int64_t>("sig", 20))
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_graph.on_change(l_obj, std::vector<std::string>{"sig"}), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("risk"), 21);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("num_risk"), 2);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("num_signal"), 1);
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_graph.on_trigger(l_obj, "unknown"), -1);
+    ErrorContext::clear_error();
+    CODEGEN_LINE(runtime::EventGraph l_cyclic{l_runtime_module, l_args})
+    LLVM_BUILDER_ALWAYS_ASSERT(l_cyclic.add_event(l_runtime_module.event_fn_info("ping_fn")));
+    LLVM_BUILDER_ALWAYS_ASSERT(l_cyclic.add_event(l_runtime_module.event_fn_info("pong_fn")));
+    LLVM_BUILDER_ALWAYS_ASSERT(not l_cyclic.bind());
+    LLVM_BUILDER_ALWAYS_ASSERT(l_cyclic.has_error());
+    ErrorContext::clear_error();
+}
+
+TEST(LLVM_CODEGEN_JIT_API, fused_event) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_fused_event"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(l_cursor.add_field("px", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("sig", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("risk", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("quote", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("limit_breach", TypeInfo::mk_int32()))
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("fused_event_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    std::vector<Function> l_stages;
+    {
+        CODEGEN_LINE(Function fn("signal_stage"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("sig").store(ctx.field("px").load() * ValueInfo::from_constant<int64_t>(2)))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        l_stages.emplace_back(fn);
+    }
+    {
+        CODEGEN_LINE(Function fn("risk_stage"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("risk").store(ctx.field("sig").load() + ValueInfo::from_constant<int64_t>(1)))
+            CODEGEN_LINE(FunctionContext::set_return_value(ctx.field("limit_breach").load()))
+        }
+        fn.verify();
+        l_stages.emplace_back(fn);
+    }
+    {
+        CODEGEN_LINE(Function fn("quote_stage"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("quote").store(ctx.field("risk").load() + ctx.field("sig").load()))
+            CODEGEN_LINE(ctx.field("sig").store(ValueInfo::from_constant<int64_t>(0)))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        l_stages.emplace_back(fn);
+    }
+    CODEGEN_LINE(Function l_fused = Function::mk_fused("fused_fn", l_stages))
+    LLVM_BUILDER_ALWAYS_ASSERT(not l_fused.has_error());
+    l_fused.verify();
+    {
+        CODEGEN_LINE(FieldAccess l_access = l_fused.field_access())
+        LLVM_BUILDER_ALWAYS_ASSERT((l_access.reads() == std::vector<std::string>{"limit_breach", "px", "risk", "sig"}));
+        LLVM_BUILDER_ALWAYS_ASSERT((l_access.writes() == std::vector<std::string>{"quote", "risk", "sig"}));
+    }
+    LLVM_BUILDER_ALWAYS_ASSERT(Function::mk_fused("empty_fused_fn", {}).has_error());
+    ErrorContext::clear_error();
+    INIT_MODULE(l_module)
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("fused_event_args");
+    runtime::EventFn fused_fn = l_runtime_module.event_fn_info("fused_fn");
+    CODEGEN_LINE(runtime::Object l_fused_obj = l_args.mk_object())
+    CODEGEN_LINE(runtime::Object l_staged_obj = l_args.mk_object())
+    CODEGEN_LINE(l_fused_obj.freeze())
+    CODEGEN_LINE(l_staged_obj.freeze())
+    // same result as running stages back to back
+    for (int64_t px : {3, 7, -5}) {
+        CODEGEN_LINE(l_fused_obj.set<int64_t>("px", px))
+        CODEGEN_LINE(l_staged_obj.set<int64_t>("px", px))
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(fused_fn.on_event(l_fused_obj), 0);
+        for (const char* l_stage : {"signal_stage", "risk_stage", "quote_stage"}) {
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_runtime_module.event_fn_info(l_stage).on_event(l_staged_obj), 0);
+        }
+        for (const char* l_field : {"sig", "risk", "quote"}) {
+            LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_fused_obj.get<int64_t>(l_field), l_staged_obj.get<int64_t>(l_field));
+        }
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_fused_obj.get<int64_t>("quote"), 4 * px + 1);
+        LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_fused_obj.get<int64_t>("sig"), 0);
+    }
+    // failing stage stops the pipeline, stores of earlier stages are kept
+    CODEGEN_LINE(l_fused_obj.set<int64_t>("px", 10))
+    CODEGEN_LINE(l_fused_obj.set<int32_t>("limit_breach", 3))
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(fused_fn.on_event(l_fused_obj), 3);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_fused_obj.get<int64_t>("sig"), 20);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_fused_obj.get<int64_t>("risk"), 21);
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_fused_obj.get<int64_t>("quote"), 4 * -5 + 1);
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+}
+
+TEST(LLVM_CODEGEN_JIT_API, changed_fields) {
+    CODEGEN_LINE(Cursor l_cursor{"jit_api_changed_fields"})
+    CODEGEN_LINE(Cursor::Context l_cursor_ctx{l_cursor})
+    CODEGEN_LINE(TypeInfo int64_type = TypeInfo::mk_int64())
+    CODEGEN_LINE(l_cursor.enable_changed_fields())
+    CODEGEN_LINE(l_cursor.add_field("qty", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("px", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("bid", TypeInfo::mk_float64()))
+    CODEGEN_LINE(l_cursor.add_field("count", int64_type))
+    CODEGEN_LINE(l_cursor.add_field("total", int64_type))
+    LLVM_BUILDER_ALWAYS_ASSERT(l_cursor.is_changed_fields_enabled());
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    CODEGEN_LINE(l_cursor.add_field(Cursor::c_changed_fields_name, int64_type))
+    LLVM_BUILDER_ALWAYS_ASSERT(ErrorContext::has_error());
+    ErrorContext::clear_error();
+
+    CODEGEN_LINE(JustInTimeRunner jit_runner)
+    CODEGEN_LINE(l_cursor.bind("changed_fields_args"))
+    CODEGEN_LINE(Module l_module = l_cursor.main_module())
+    CODEGEN_LINE(Module::Context l_module_ctx{l_module})
+    std::vector<Function> l_stages;
+    {
+        CODEGEN_LINE(Function fn("changed_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            // px and bid are always stored, marked only when their value changes
+            CODEGEN_LINE(ctx.field("px").store(ctx.field("qty").load()))
+            CODEGEN_LINE(ctx.field("bid").store(ctx.field("bid").load()))
+            CODEGEN_LINE(ValueInfo l_is_large = ctx.field("qty").load() > ValueInfo::from_constant<int64_t>(100))
+            CODEGEN_LINE(IfElseCond l_large{"large_qty", l_is_large})
+            l_large.then_branch([&ctx] {
+                ctx.field("count").store(ctx.field("count").load() + ValueInfo::from_constant<int64_t>(1));
+            });
+            CODEGEN_LINE(l_large.bind())
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        l_stages.emplace_back(fn);
+    }
+    {
+        CODEGEN_LINE(Function fn("total_fn"))
+        {
+            CODEGEN_LINE(FunctionContext l_fn_ctx{fn})
+            CODEGEN_LINE(ValueInfo ctx = ValueInfo::from_context())
+            CODEGEN_LINE(ctx.field("total").store(ctx.field("total").load() + ctx.field("qty").load()))
+            CODEGEN_LINE(FunctionContext::set_return_value(ValueInfo::from_constant(0)))
+        }
+        fn.verify();
+        l_stages.emplace_back(fn);
+    }
+    CODEGEN_LINE(Function l_fused = Function::mk_fused("changed_fused_fn", l_stages))
+    l_fused.verify();
+    INIT_MODULE(l_module)
+    jit_runner.add_module(l_cursor);
+    jit_runner.bind();
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+    const runtime::Namespace& l_runtime_module = jit_runner.get_global_namespace();
+    const runtime::Struct& l_args = l_runtime_module.struct_info("changed_fields_args");
+    runtime::EventFn changed_fn = l_runtime_module.event_fn_info("changed_fn");
+    runtime::EventFn fused_fn = l_runtime_module.event_fn_info("changed_fused_fn");
+    auto changed_names = [] (const runtime::Object& o) {
+        std::vector<std::string> l_names;
+        for (const runtime::Field& l_field : o.changed_fields()) {
+            l_names.emplace_back(l_field.name());
+        }
+        return l_names;
+    };
+    CODEGEN_LINE(runtime::Object l_obj = l_args.mk_object())
+    CODEGEN_LINE(l_obj.freeze())
+    CODEGEN_LINE(l_obj.set<int64_t>("qty", 5))
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(changed_fn.on_event(l_obj), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT((changed_names(l_obj) == std::vector<std::string>{"px"}));
+    // same qty leaves px unchanged, mask is reset by every event
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(changed_fn.on_event(l_obj), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT(changed_names(l_obj).empty());
+    CODEGEN_LINE(l_obj.set<int64_t>("qty", 500))
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(changed_fn.on_event(l_obj), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT((changed_names(l_obj) == std::vector<std::string>{"px", "count"}));
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("count"), 1);
+    // fused function reports fields changed by any stage
+    CODEGEN_LINE(l_obj.set<int64_t>("qty", 7))
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(fused_fn.on_event(l_obj), 0);
+    LLVM_BUILDER_ALWAYS_ASSERT((changed_names(l_obj) == std::vector<std::string>{"px", "total"}));
+    LLVM_BUILDER_ALWAYS_ASSERT_EQ(l_obj.get<int64_t>("total"), 7);
+    LLVM_BUILDER_ALWAYS_ASSERT(not ErrorContext::has_error());
+}
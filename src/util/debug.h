@@ -143,6 +143,12 @@ class Debug {
         return (rdx << 32u) + rax;
     }
 
+    // spin-wait hint, frees pipeline resources for the sibling hyper-thread while busy polling
+    LLVM_BUILDER_INLINE_ART
+    static void cpu_relax() {
+        __builtin_ia32_pause();
+    }
+
   private:
     [[noreturn]] [[gnu::noinline]] [[gnu::cold]] static void M_abort(const char* msg);
 
@@ -70,6 +70,38 @@ bool SourceContext::peek(SourceLoc& val) {
     }
 }
 
+bool SourceContext::peek_external(SourceLoc& val) {
+    static const std::string s_internal_root = [] () -> std::string {
+        const std::string l_self{__FILE__};
+        const std::string l_suffix{"util/error.cpp"};
+        if (l_self.size() > l_suffix.size()
+              and l_self.compare(l_self.size() - l_suffix.size(), l_suffix.size(), l_suffix) == 0) {
+            return l_self.substr(0, l_self.size() - l_suffix.size());
+        } else {
+            return std::string{};
+        }
+    } ();
+    auto is_internal = [] (const SourceLoc& loc) -> bool {
+        if (s_internal_root.empty()) {
+            return false;
+        }
+        const std::string& l_file = loc.file_name();
+        if (l_file.compare(0, s_internal_root.size(), s_internal_root) != 0) {
+            return false;
+        }
+        return l_file.compare(s_internal_root.size(), 5, "llvm/") == 0
+          or l_file.compare(s_internal_root.size(), 5, "util/") == 0;
+    };
+    const vec_t& l_vec = s_stack;
+    for (auto it = l_vec.rbegin(); it != l_vec.rend(); ++it) {
+        if (it->is_valid() and not is_internal(*it)) {
+            val = *it;
+            return true;
+        }
+    }
+    return false;
+}
+
 SourceLoc SourceContext::pop() {
     vec_t& l_vec = s_stack;
     SourceLoc l_ret{};
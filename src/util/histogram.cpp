@@ -0,0 +1,139 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#include "util/histogram_recorder.h"
+#include "util/debug.h"
+
+#include <algorithm>
+#include <cmath>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// LatencyHistogram
+//
+LatencyHistogram::LatencyHistogram() : m_counts(c_num_buckets, 0) {
+}
+
+LatencyHistogram::LatencyHistogram(std::vector<uint64_t>&& counts, uint64_t count, uint64_t sum, uint64_t min, uint64_t max)
+  : m_counts{std::move(counts)}, m_count{count}, m_sum{sum}, m_min{min}, m_max{max} {
+    LLVM_BUILDER_ASSERT(m_counts.size() == c_num_buckets);
+}
+
+double LatencyHistogram::mean() const {
+    if (empty()) {
+        return 0.0;
+    }
+    return static_cast<double>(m_sum) / static_cast<double>(m_count);
+}
+
+// returns upper bound of the bucket containing the p-th percentile (p in [0, 100]),
+// clamped to the observed [min, max] range
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (empty()) {
+        return 0;
+    }
+    if (p <= 0.0) {
+        return m_min;
+    }
+    if (p >= 100.0) {
+        return m_max;
+    }
+    const double l_rank = std::ceil(p / 100.0 * static_cast<double>(m_count));
+    const uint64_t l_target = std::max<uint64_t>(1, static_cast<uint64_t>(l_rank));
+    uint64_t l_cumulative = 0;
+    for (uint32_t i = 0; i != c_num_buckets; ++i) {
+        l_cumulative += m_counts[i];
+        if (l_cumulative >= l_target) {
+            return std::clamp(bucket_upper_bound(i), m_min, m_max);
+        }
+    }
+    return m_max;
+}
+
+uint64_t LatencyHistogram::bucket_count(uint32_t idx) const {
+    if (idx >= c_num_buckets) {
+        return 0;
+    }
+    return m_counts[idx];
+}
+
+void LatencyHistogram::print(std::ostream& os) const {
+    os << "{count:" << m_count;
+    if (not empty()) {
+        os << ", min:" << m_min
+           << ", mean:" << mean()
+           << ", p50:" << percentile(50.0)
+           << ", p90:" << percentile(90.0)
+           << ", p99:" << percentile(99.0)
+           << ", p99.9:" << percentile(99.9)
+           << ", max:" << m_max;
+    }
+    os << "}";
+}
+
+uint32_t LatencyHistogram::bucket_index(uint64_t value) {
+    if (value < c_num_sub_buckets) {
+        return static_cast<uint32_t>(value);
+    }
+    const uint32_t l_msb = 63u - static_cast<uint32_t>(__builtin_clzll(value));
+    const uint32_t l_shift = l_msb - c_sub_bucket_bits;
+    const uint32_t l_sub = static_cast<uint32_t>(value >> l_shift) & (c_num_sub_buckets - 1);
+    return (l_shift + 1) * c_num_sub_buckets + l_sub;
+}
+
+uint64_t LatencyHistogram::bucket_lower_bound(uint32_t idx) {
+    LLVM_BUILDER_ASSERT(idx < c_num_buckets);
+    if (idx < c_num_sub_buckets) {
+        return idx;
+    }
+    const uint32_t l_shift = idx / c_num_sub_buckets - 1;
+    const uint64_t l_sub = idx % c_num_sub_buckets;
+    return (c_num_sub_buckets + l_sub) << l_shift;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(uint32_t idx) {
+    LLVM_BUILDER_ASSERT(idx < c_num_buckets);
+    if (idx < c_num_sub_buckets) {
+        return idx;
+    }
+    const uint32_t l_shift = idx / c_num_sub_buckets - 1;
+    return bucket_lower_bound(idx) + ((uint64_t{1} << l_shift) - 1);
+}
+
+//
+// LatencyRecorder
+//
+LatencyHistogram LatencyRecorder::snapshot() const {
+    std::vector<uint64_t> l_counts(LatencyHistogram::c_num_buckets, 0);
+    uint64_t l_count = 0;
+    for (uint32_t i = 0; i != LatencyHistogram::c_num_buckets; ++i) {
+        l_counts[i] = m_counts[i].load(std::memory_order_relaxed);
+        l_count += l_counts[i];
+    }
+    // derive count from the buckets, so percentiles are consistent even if
+    // a record() is in flight while the snapshot is taken
+    const uint64_t l_sum = m_sum.load(std::memory_order_relaxed);
+    uint64_t l_min = m_min.load(std::memory_order_relaxed);
+    uint64_t l_max = m_max.load(std::memory_order_relaxed);
+    if (l_count == 0) {
+        l_min = 0;
+        l_max = 0;
+    } else if (l_min > l_max) {
+        l_min = l_max;
+    }
+    return LatencyHistogram{std::move(l_counts), l_count, l_sum, l_min, l_max};
+}
+
+void LatencyRecorder::reset() {
+    for (counter_t& v : m_counts) {
+        v.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+LLVM_BUILDER_NS_END
@@ -0,0 +1,59 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_UTIL_HISTOGRAM_RECORDER_H_
+#define LLVM_BUILDER_UTIL_HISTOGRAM_RECORDER_H_
+
+#include "llvm_builder/defines.h"
+#include "llvm_builder/util/histogram.h"
+#include "meta/noncopyable.h"
+
+#include <array>
+#include <atomic>
+#include <limits>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// LatencyRecorder
+//
+// lock-free recording side of LatencyHistogram, record() is wait-free and
+// only issues relaxed atomic updates, so concurrent snapshot()/reset() from a
+// monitoring thread never blocks the recording thread.
+// NOTE{vibhanshu}: a reset() racing with record() may drop that single sample,
+//                  which is acceptable for per-interval reporting
+class LatencyRecorder : meta::noncopyable {
+    using counter_t = std::atomic<uint64_t>;
+private:
+    std::array<counter_t, LatencyHistogram::c_num_buckets> m_counts{};
+    counter_t m_count{0};
+    counter_t m_sum{0};
+    counter_t m_min{std::numeric_limits<uint64_t>::max()};
+    counter_t m_max{0};
+public:
+    explicit LatencyRecorder() = default;
+    ~LatencyRecorder() = default;
+public:
+    void record(uint64_t value) {
+        m_counts[LatencyHistogram::bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(value, std::memory_order_relaxed);
+        // single writer in the common case, so the loops below almost never retry
+        uint64_t l_min = m_min.load(std::memory_order_relaxed);
+        while (value < l_min and not m_min.compare_exchange_weak(l_min, value, std::memory_order_relaxed)) {
+        }
+        uint64_t l_max = m_max.load(std::memory_order_relaxed);
+        while (value > l_max and not m_max.compare_exchange_weak(l_max, value, std::memory_order_relaxed)) {
+        }
+    }
+    uint64_t count() const {
+        return m_count.load(std::memory_order_relaxed);
+    }
+    LatencyHistogram snapshot() const;
+    void reset();
+};
+
+LLVM_BUILDER_NS_END
+
+#endif // LLVM_BUILDER_UTIL_HISTOGRAM_RECORDER_H_
@@ -0,0 +1,139 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#include "util/mapped_file.h"
+#include "util/debug.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// MappedFile
+//
+MappedFile::MappedFile(const std::string& path, protection_t protection)
+  : m_path{path} {
+    const int l_fd = ::open(m_path.c_str(), O_RDONLY);
+    if (l_fd < 0) {
+        m_error = LLVM_BUILDER_CONCAT << "can't open file " << m_path << ":" << std::strerror(errno);
+        return;
+    }
+    struct stat l_stat;
+    if (::fstat(l_fd, &l_stat) != 0 or l_stat.st_size == 0) {
+        m_error = LLVM_BUILDER_CONCAT << "file is empty:" << m_path;
+        ::close(l_fd);
+        return;
+    }
+    const uint64_t l_size = static_cast<uint64_t>(l_stat.st_size);
+    const int l_prot = protection == protection_t::read_only ? PROT_READ : (PROT_READ | PROT_WRITE);
+    void* l_addr = ::mmap(nullptr, l_size, l_prot, MAP_PRIVATE, l_fd, 0);
+    // mapping holds its own reference to the file
+    ::close(l_fd);
+    if (l_addr == MAP_FAILED) {
+        m_error = LLVM_BUILDER_CONCAT << "mmap failed:" << std::strerror(errno);
+        return;
+    }
+    m_base = l_addr;
+    m_size = l_size;
+}
+
+MappedFile::~MappedFile() {
+    if (m_base != nullptr) {
+        ::munmap(m_base, m_size);
+        m_base = nullptr;
+    }
+}
+
+void* MappedFile::at(uint64_t offset, uint64_t size) const {
+    LLVM_BUILDER_ASSERT(is_valid());
+    if (offset > m_size or size > m_size - offset) {
+        return nullptr;
+    }
+    return static_cast<char*>(m_base) + offset;
+}
+
+bool MappedFile::advise_sequential() const {
+    LLVM_BUILDER_ASSERT(is_valid());
+    return ::madvise(m_base, m_size, MADV_SEQUENTIAL) == 0;
+}
+
+//
+// FileWriter
+//
+FileWriter::FileWriter(const std::string& path)
+  : m_path{path}, m_tmp_path{path + ".tmp"} {
+    m_fd = ::open(m_tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0) {
+        m_error = LLVM_BUILDER_CONCAT << "can't create file " << m_tmp_path << ":" << std::strerror(errno);
+    }
+}
+
+FileWriter::~FileWriter() {
+    if (is_valid()) {
+        M_close();
+        ::unlink(m_tmp_path.c_str());
+    }
+}
+
+bool FileWriter::write(const void* data, uint64_t size) {
+    LLVM_BUILDER_ASSERT(is_valid());
+    const char* l_data = static_cast<const char*>(data);
+    while (size != 0) {
+        const ssize_t l_written = ::write(m_fd, l_data, size);
+        if (l_written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            m_error = LLVM_BUILDER_CONCAT << "write failed:" << std::strerror(errno);
+            return false;
+        }
+        l_data += l_written;
+        size -= static_cast<uint64_t>(l_written);
+        m_offset += static_cast<uint64_t>(l_written);
+    }
+    return true;
+}
+
+bool FileWriter::pad(uint64_t alignment) {
+    static const char s_zeros[64] = {};
+    uint64_t l_remaining = (alignment - m_offset % alignment) % alignment;
+    while (l_remaining != 0) {
+        const uint64_t l_size = std::min<uint64_t>(l_remaining, sizeof(s_zeros));
+        if (not write(s_zeros, l_size)) {
+            return false;
+        }
+        l_remaining -= l_size;
+    }
+    return true;
+}
+
+bool FileWriter::commit() {
+    LLVM_BUILDER_ASSERT(is_valid());
+    if (::fsync(m_fd) != 0) {
+        m_error = LLVM_BUILDER_CONCAT << "fsync failed:" << std::strerror(errno);
+        return false;
+    }
+    M_close();
+    if (std::rename(m_tmp_path.c_str(), m_path.c_str()) != 0) {
+        m_error = LLVM_BUILDER_CONCAT << "can't rename " << m_tmp_path << " to " << m_path << ":" << std::strerror(errno);
+        ::unlink(m_tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+void FileWriter::M_close() {
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+LLVM_BUILDER_NS_END
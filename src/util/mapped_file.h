@@ -0,0 +1,94 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_UTIL_MAPPED_FILE_H_
+#define LLVM_BUILDER_UTIL_MAPPED_FILE_H_
+
+#include "llvm_builder/defines.h"
+#include "meta/noncopyable.h"
+
+#include <cstdint>
+#include <string>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// MappedFile
+//
+// MAP_PRIVATE mapping of a whole file, pages are read lazily on first touch.
+// A copy_on_write mapping can be written, writes go to private copies of the
+// touched pages. The file itself is never modified
+class MappedFile : meta::noncopyable {
+public:
+    enum class protection_t : uint8_t {
+        read_only,
+        copy_on_write,
+    };
+private:
+    const std::string m_path;
+    void* m_base = nullptr;
+    uint64_t m_size = 0;
+    std::string m_error;
+public:
+    explicit MappedFile(const std::string& path, protection_t protection);
+    ~MappedFile();
+public:
+    bool is_valid() const {
+        return m_base != nullptr;
+    }
+    const std::string& error() const {
+        return m_error;
+    }
+    const std::string& path() const {
+        return m_path;
+    }
+    void* base() const {
+        return m_base;
+    }
+    uint64_t size() const {
+        return m_size;
+    }
+    // nullptr if [offset, offset + size) is not inside the file
+    void* at(uint64_t offset, uint64_t size) const;
+    // hint that pages are read in order, kernel reads ahead aggressively and drops pages behind
+    bool advise_sequential() const;
+};
+
+//
+// FileWriter
+//
+// Sequential writer into `path`.tmp which is renamed over `path` by commit(), so
+// readers never see a partially written file. Dropped without commit() the
+// temporary file is removed
+class FileWriter : meta::noncopyable {
+    const std::string m_path;
+    const std::string m_tmp_path;
+    int m_fd = -1;
+    uint64_t m_offset = 0;
+    std::string m_error;
+public:
+    explicit FileWriter(const std::string& path);
+    ~FileWriter();
+public:
+    bool is_valid() const {
+        return m_fd >= 0;
+    }
+    const std::string& error() const {
+        return m_error;
+    }
+    uint64_t offset() const {
+        return m_offset;
+    }
+    bool write(const void* data, uint64_t size);
+    // zero fill up to next multiple of `alignment`
+    bool pad(uint64_t alignment);
+    // flushes file to disk and renames it to `path`
+    bool commit();
+private:
+    void M_close();
+};
+
+LLVM_BUILDER_NS_END
+
+#endif // LLVM_BUILDER_UTIL_MAPPED_FILE_H_
@@ -0,0 +1,214 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#include "util/perf_counter_group.h"
+#include "util/debug.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// PerfCounters
+//
+PerfCounters::PerfCounters(const values_t& values, uint64_t num_calls, uint64_t num_samples, uint32_t available_mask)
+  : m_values{values}, m_num_calls{num_calls}, m_num_samples{num_samples}, m_available_mask{available_mask} {
+}
+
+double PerfCounters::ipc() const {
+    if (cycles() == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(instructions()) / static_cast<double>(cycles());
+}
+
+double PerfCounters::per_sample(counter_t c) const {
+    if (m_num_samples == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(value(c)) / static_cast<double>(m_num_samples);
+}
+
+void PerfCounters::print(std::ostream& os) const {
+    os << "{calls:" << m_num_calls << ", samples:" << m_num_samples;
+    for (uint32_t i = 0; i != c_num_counters; ++i) {
+        const counter_t c = static_cast<counter_t>(i);
+        if (is_available(c)) {
+            os << ", " << counter_name(c) << ":" << value(c);
+        }
+    }
+    if (is_available(counter_t::cycles) and is_available(counter_t::instructions)) {
+        os << ", ipc:" << ipc();
+    }
+    os << "}";
+}
+
+const char* PerfCounters::counter_name(counter_t c) {
+    switch (c) {
+    case counter_t::cycles:
+        return "cycles";
+    case counter_t::instructions:
+        return "instructions";
+    case counter_t::branch_misses:
+        return "branch_misses";
+    case counter_t::l1d_misses:
+        return "l1d_misses";
+    case counter_t::llc_misses:
+        return "llc_misses";
+    }
+    return "unknown";
+}
+
+//
+// PerfCounterGroup
+//
+#if defined(__linux__)
+namespace {
+
+int perf_event_open(const PerfCounters::counter_t c, int group_fd) {
+    using counter_t = PerfCounters::counter_t;
+    perf_event_attr l_attr;
+    std::memset(&l_attr, 0, sizeof(l_attr));
+    l_attr.size = sizeof(l_attr);
+    if (group_fd < 0) {
+        // leader starts disabled, whole group is enabled once all members are attached
+        l_attr.disabled = 1;
+    }
+    l_attr.exclude_kernel = 1;
+    l_attr.exclude_hv = 1;
+    l_attr.read_format = PERF_FORMAT_GROUP;
+    constexpr uint64_t c_read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    switch (c) {
+    case counter_t::cycles:
+        l_attr.type = PERF_TYPE_HARDWARE;
+        l_attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case counter_t::instructions:
+        l_attr.type = PERF_TYPE_HARDWARE;
+        l_attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case counter_t::branch_misses:
+        l_attr.type = PERF_TYPE_HARDWARE;
+        l_attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    case counter_t::l1d_misses:
+        l_attr.type = PERF_TYPE_HW_CACHE;
+        l_attr.config = PERF_COUNT_HW_CACHE_L1D | c_read_miss;
+        break;
+    case counter_t::llc_misses:
+        l_attr.type = PERF_TYPE_HW_CACHE;
+        l_attr.config = PERF_COUNT_HW_CACHE_LL | c_read_miss;
+        break;
+    }
+    // calling thread, any cpu
+    return static_cast<int>(::syscall(SYS_perf_event_open, &l_attr, 0, -1, group_fd, 0));
+}
+
+} // namespace
+#endif
+
+PerfCounterGroup::PerfCounterGroup() {
+    m_fds.fill(-1);
+    m_slots.fill(PerfCounters::c_num_counters);
+#if defined(__linux__)
+    for (uint32_t i = 0; i != PerfCounters::c_num_counters; ++i) {
+        const int l_fd = perf_event_open(static_cast<counter_t>(i), m_leader_fd);
+        if (l_fd < 0) {
+            if (i == 0) {
+                // no cycles counter, rest of the group is meaningless
+                return;
+            }
+            continue;
+        }
+        if (i == 0) {
+            m_leader_fd = l_fd;
+        }
+        m_fds[i] = l_fd;
+        m_slots[i] = m_num_open++;
+        m_available_mask |= 1u << i;
+    }
+    ::ioctl(m_leader_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ::ioctl(m_leader_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+#if defined(__linux__)
+    for (int l_fd : m_fds) {
+        if (l_fd >= 0) {
+            ::close(l_fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounterGroup::read(values_t& values) const {
+#if defined(__linux__)
+    if (not is_valid()) {
+        return false;
+    }
+    // PERF_FORMAT_GROUP layout: { nr, value[nr] }
+    uint64_t l_buffer[1 + PerfCounters::c_num_counters];
+    const ssize_t l_size = ::read(m_leader_fd, l_buffer, sizeof(l_buffer));
+    if (l_size < static_cast<ssize_t>(sizeof(uint64_t) * (1 + m_num_open))) {
+        return false;
+    }
+    for (uint32_t i = 0; i != PerfCounters::c_num_counters; ++i) {
+        values[i] = m_slots[i] < m_num_open ? l_buffer[1 + m_slots[i]] : 0;
+    }
+    return true;
+#else
+    (void)values;
+    return false;
+#endif
+}
+
+PerfCounterGroup& PerfCounterGroup::thread_group() {
+    // counters follow the thread that opened them, so each thread needs its own group
+    static thread_local PerfCounterGroup s_group;
+    return s_group;
+}
+
+//
+// PerfCounterRecorder
+//
+PerfCounterRecorder::PerfCounterRecorder(uint32_t sample_every)
+  : m_sample_every{sample_every == 0 ? 1 : sample_every} {
+}
+
+void PerfCounterRecorder::record(const values_t& start, const values_t& end, uint32_t available_mask) {
+    for (uint32_t i = 0; i != PerfCounters::c_num_counters; ++i) {
+        m_values[i].fetch_add(end[i] - start[i], std::memory_order_relaxed);
+    }
+    m_num_samples.fetch_add(1, std::memory_order_relaxed);
+    m_available_mask.fetch_or(available_mask, std::memory_order_relaxed);
+}
+
+PerfCounters PerfCounterRecorder::snapshot() const {
+    values_t l_values{};
+    for (uint32_t i = 0; i != PerfCounters::c_num_counters; ++i) {
+        l_values[i] = m_values[i].load(std::memory_order_relaxed);
+    }
+    return PerfCounters{l_values,
+                        m_num_calls.load(std::memory_order_relaxed),
+                        m_num_samples.load(std::memory_order_relaxed),
+                        m_available_mask.load(std::memory_order_relaxed)};
+}
+
+void PerfCounterRecorder::reset() {
+    for (counter_t& v : m_values) {
+        v.store(0, std::memory_order_relaxed);
+    }
+    m_num_calls.store(0, std::memory_order_relaxed);
+    m_num_samples.store(0, std::memory_order_relaxed);
+}
+
+LLVM_BUILDER_NS_END
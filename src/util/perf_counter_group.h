@@ -0,0 +1,82 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_UTIL_PERF_COUNTER_GROUP_H_
+#define LLVM_BUILDER_UTIL_PERF_COUNTER_GROUP_H_
+
+#include "llvm_builder/defines.h"
+#include "llvm_builder/util/perf_counter.h"
+#include "meta/noncopyable.h"
+
+#include <array>
+#include <atomic>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// PerfCounterGroup
+//
+// one perf_event_open group per thread, counting user space only, with
+// cycles as group leader so all members are scheduled on the PMU together
+class PerfCounterGroup : meta::noncopyable {
+    using counter_t = PerfCounters::counter_t;
+    using values_t = PerfCounters::values_t;
+private:
+    int m_leader_fd = -1;
+    std::array<int, PerfCounters::c_num_counters> m_fds;
+    // position of each counter in the group read buffer, c_num_counters if not open
+    std::array<uint32_t, PerfCounters::c_num_counters> m_slots;
+    uint32_t m_num_open = 0;
+    uint32_t m_available_mask = 0;
+public:
+    explicit PerfCounterGroup();
+    ~PerfCounterGroup();
+public:
+    bool is_valid() const {
+        return m_leader_fd >= 0;
+    }
+    uint32_t available_mask() const {
+        return m_available_mask;
+    }
+    bool read(values_t& values) const;
+    static PerfCounterGroup& thread_group();
+};
+
+//
+// PerfCounterRecorder
+//
+// accumulates counter deltas of every Nth call, updates are relaxed atomics
+// so a monitoring thread can snapshot()/reset() without locking
+class PerfCounterRecorder : meta::noncopyable {
+    using values_t = PerfCounters::values_t;
+    using counter_t = std::atomic<uint64_t>;
+private:
+    std::atomic<uint32_t> m_sample_every;
+    std::array<counter_t, PerfCounters::c_num_counters> m_values{};
+    counter_t m_num_calls{0};
+    counter_t m_num_samples{0};
+    std::atomic<uint32_t> m_available_mask{0};
+public:
+    explicit PerfCounterRecorder(uint32_t sample_every);
+    ~PerfCounterRecorder() = default;
+public:
+    uint32_t sample_every() const {
+        return m_sample_every.load(std::memory_order_relaxed);
+    }
+    // may be called while another thread is recording
+    void set_sample_every(uint32_t sample_every) {
+        m_sample_every.store(sample_every == 0 ? 1 : sample_every, std::memory_order_relaxed);
+    }
+    // counts the call, true if this call should be measured
+    bool next_call() {
+        return m_num_calls.fetch_add(1, std::memory_order_relaxed) % sample_every() == 0;
+    }
+    void record(const values_t& start, const values_t& end, uint32_t available_mask);
+    PerfCounters snapshot() const;
+    void reset();
+};
+
+LLVM_BUILDER_NS_END
+
+#endif // LLVM_BUILDER_UTIL_PERF_COUNTER_GROUP_H_
@@ -0,0 +1,284 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#include "util/shared_memory.h"
+#include "util/debug.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+LLVM_BUILDER_NS_BEGIN
+
+namespace {
+
+uint64_t align_up(uint64_t v, uint64_t alignment) {
+    return (v + alignment - 1) / alignment * alignment;
+}
+
+std::string shm_name(const std::string& name) {
+    // posix shm names are a single path component starting with '/'
+    if (not name.empty() and name.front() == '/') {
+        return name;
+    }
+    return "/" + name;
+}
+
+bool copy_name(char (&dst)[SharedMemory::c_max_name], const std::string& src) {
+    if (src.size() >= SharedMemory::c_max_name) {
+        return false;
+    }
+    std::memset(dst, 0, sizeof(dst));
+    std::memcpy(dst, src.data(), src.size());
+    return true;
+}
+
+} // namespace
+
+//
+// SharedMemory
+//
+SharedMemory::SharedMemory(backing_t backing, const std::string& name, uint64_t size)
+  : m_backing{backing}, m_name{name} {
+    m_size = align_up(std::max(size, header_size() + c_alignment), static_cast<uint64_t>(::sysconf(_SC_PAGESIZE)));
+    if (not M_open(true)) {
+        return;
+    }
+    if (::ftruncate(m_fd, static_cast<off_t>(m_size)) != 0) {
+        m_error = LLVM_BUILDER_CONCAT << "ftruncate failed:" << std::strerror(errno);
+        return;
+    }
+    if (not M_map(nullptr, m_size)) {
+        return;
+    }
+    m_header->m_base = reinterpret_cast<uint64_t>(m_header);
+    m_header->m_size = m_size;
+    pthread_mutexattr_t l_attr;
+    ::pthread_mutexattr_init(&l_attr);
+    ::pthread_mutexattr_setpshared(&l_attr, PTHREAD_PROCESS_SHARED);
+    ::pthread_mutexattr_setrobust(&l_attr, PTHREAD_MUTEX_ROBUST);
+    const int l_err = ::pthread_mutex_init(&m_header->m_lock, &l_attr);
+    ::pthread_mutexattr_destroy(&l_attr);
+    if (l_err != 0) {
+        m_error = LLVM_BUILDER_CONCAT << "can't init segment lock:" << std::strerror(l_err);
+        ::munmap(m_header, m_size);
+        m_header = nullptr;
+        return;
+    }
+    m_header->m_num_entries.store(0, std::memory_order_relaxed);
+    m_header->m_num_links.store(0, std::memory_order_relaxed);
+    m_header->m_used.store(header_size(), std::memory_order_relaxed);
+    // magic is written last, open() rejects a segment which is still being set up
+    std::atomic_ref<uint64_t>{m_header->m_magic}.store(c_magic, std::memory_order_release);
+}
+
+SharedMemory::SharedMemory(backing_t backing, const std::string& name)
+  : m_backing{backing}, m_name{name} {
+    if (not M_open(false)) {
+        return;
+    }
+    struct stat l_stat;
+    if (::fstat(m_fd, &l_stat) != 0 or static_cast<uint64_t>(l_stat.st_size) < header_size()) {
+        m_error = "segment is too small to hold a header";
+        return;
+    }
+    // peek at header for address and size of the creator's mapping
+    void* l_peek = ::mmap(nullptr, sizeof(Header), PROT_READ, MAP_SHARED, m_fd, 0);
+    if (l_peek == MAP_FAILED) {
+        m_error = LLVM_BUILDER_CONCAT << "mmap failed:" << std::strerror(errno);
+        return;
+    }
+    Header* l_header = static_cast<Header*>(l_peek);
+    // pairs with the release store of the creator, base and size are complete once magic is seen
+    const uint64_t l_magic = std::atomic_ref<uint64_t>{l_header->m_magic}.load(std::memory_order_acquire);
+    const uint64_t l_base = l_header->m_base;
+    const uint64_t l_size = l_header->m_size;
+    ::munmap(l_peek, sizeof(Header));
+    if (l_magic != c_magic) {
+        m_error = "segment header not found";
+        return;
+    }
+    m_size = l_size;
+    M_map(reinterpret_cast<void*>(l_base), l_size);
+}
+
+SharedMemory::~SharedMemory() {
+    if (m_header != nullptr) {
+        ::munmap(m_header, m_size);
+        m_header = nullptr;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+uint64_t SharedMemory::used() const {
+    LLVM_BUILDER_ASSERT(is_valid());
+    return m_header->m_used.load(std::memory_order_relaxed);
+}
+
+bool SharedMemory::is_at_creator_base() const {
+    LLVM_BUILDER_ASSERT(is_valid());
+    return m_header->m_base == reinterpret_cast<uint64_t>(m_header);
+}
+
+bool SharedMemory::contains(const void* ptr, uint64_t size) const {
+    LLVM_BUILDER_ASSERT(is_valid());
+    const uint64_t l_begin = reinterpret_cast<uint64_t>(m_header) + header_size();
+    const uint64_t l_ptr = reinterpret_cast<uint64_t>(ptr);
+    return l_ptr >= l_begin and size <= m_size - header_size() and l_ptr - l_begin <= m_size - header_size() - size;
+}
+
+void* SharedMemory::allocate(const std::string& name, const std::string& type_name, uint64_t size,
+                             uint32_t kind, uint32_t type, uint32_t num_elements) {
+    LLVM_BUILDER_ASSERT(is_valid());
+    Entry l_entry;
+    if (not copy_name(l_entry.m_name, name) or not copy_name(l_entry.m_type_name, type_name)) {
+        return nullptr;
+    }
+    l_entry.m_size = size;
+    l_entry.m_kind = kind;
+    l_entry.m_type = type;
+    l_entry.m_num_elements = num_elements;
+    void* l_result = nullptr;
+    if (not M_lock()) {
+        return nullptr;
+    }
+    const uint32_t l_num_entries = m_header->m_num_entries.load(std::memory_order_relaxed);
+    const uint64_t l_offset = align_up(m_header->m_used.load(std::memory_order_relaxed), c_alignment);
+    if (find(name) == nullptr and l_num_entries != c_max_entries and l_offset + size <= m_size) {
+        l_entry.m_offset = l_offset;
+        m_header->m_entries[l_num_entries] = l_entry;
+        m_header->m_used.store(l_offset + size, std::memory_order_relaxed);
+        l_result = at(l_offset);
+        std::memset(l_result, 0, size);
+        // entry is visible to find() only once it is complete
+        m_header->m_num_entries.store(l_num_entries + 1, std::memory_order_release);
+    }
+    M_unlock();
+    return l_result;
+}
+
+auto SharedMemory::find(const std::string& name) const -> const Entry* {
+    LLVM_BUILDER_ASSERT(is_valid());
+    const uint32_t l_num_entries = m_header->m_num_entries.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i != l_num_entries; ++i) {
+        const Entry& l_entry = m_header->m_entries[i];
+        if (name == l_entry.m_name) {
+            return &l_entry;
+        }
+    }
+    return nullptr;
+}
+
+void* SharedMemory::at(uint64_t offset) const {
+    LLVM_BUILDER_ASSERT(is_valid());
+    if (offset >= m_size) {
+        return nullptr;
+    }
+    return reinterpret_cast<char*>(m_header) + offset;
+}
+
+bool SharedMemory::add_link(const void* field, const void* target) {
+    LLVM_BUILDER_ASSERT(is_valid());
+    if (not contains(field, sizeof(uint64_t)) or not contains(target, 1)) {
+        return false;
+    }
+    const uint64_t l_base = reinterpret_cast<uint64_t>(m_header);
+    const Link l_link{reinterpret_cast<uint64_t>(field) - l_base, reinterpret_cast<uint64_t>(target) - l_base};
+    if (not M_lock()) {
+        return false;
+    }
+    const uint32_t l_num_links = m_header->m_num_links.load(std::memory_order_relaxed);
+    bool l_result = false;
+    if (l_num_links != c_max_links) {
+        m_header->m_links[l_num_links] = l_link;
+        m_header->m_num_links.store(l_num_links + 1, std::memory_order_release);
+        l_result = true;
+    }
+    M_unlock();
+    return l_result;
+}
+
+bool SharedMemory::has_links(uint64_t offset, uint64_t size) const {
+    LLVM_BUILDER_ASSERT(is_valid());
+    const uint32_t l_num_links = m_header->m_num_links.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i != l_num_links; ++i) {
+        const uint64_t l_field = m_header->m_links[i].m_field;
+        if (l_field >= offset and l_field - offset < size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SharedMemory::unlink() {
+    switch (m_backing) {
+    case backing_t::shm:
+        return ::shm_unlink(shm_name(m_name).c_str()) == 0;
+    case backing_t::file:
+        return ::unlink(m_name.c_str()) == 0;
+    }
+    return false;
+}
+
+bool SharedMemory::M_open(bool create) {
+    const int l_flags = create ? (O_RDWR | O_CREAT | O_EXCL) : O_RDWR;
+    switch (m_backing) {
+    case backing_t::shm:
+        m_fd = ::shm_open(shm_name(m_name).c_str(), l_flags, 0600);
+        break;
+    case backing_t::file:
+        m_fd = ::open(m_name.c_str(), l_flags, 0600);
+        break;
+    }
+    if (m_fd < 0) {
+        m_error = LLVM_BUILDER_CONCAT << "can't open segment " << m_name << ":" << std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+bool SharedMemory::M_map(void* hint, uint64_t size) {
+    // `hint` is the creator's address, pointers stored in the segment are valid there,
+    // if it is taken the segment is mapped elsewhere and only its offsets are usable
+    void* l_addr = ::mmap(hint, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (l_addr == MAP_FAILED) {
+        m_error = LLVM_BUILDER_CONCAT << "mmap failed:" << std::strerror(errno);
+        return false;
+    }
+    m_header = static_cast<Header*>(l_addr);
+    return true;
+}
+
+bool SharedMemory::M_lock() {
+    const int l_err = ::pthread_mutex_lock(&m_header->m_lock);
+    if (l_err == EOWNERDEAD) {
+        // previous owner died inside allocate(), an entry is published only once complete,
+        // so the directory is consistent and at most the space it reserved is lost
+        ::pthread_mutex_consistent(&m_header->m_lock);
+        return true;
+    }
+    if (l_err != 0) {
+        m_error = LLVM_BUILDER_CONCAT << "can't lock segment:" << std::strerror(l_err);
+        return false;
+    }
+    return true;
+}
+
+void SharedMemory::M_unlock() {
+    ::pthread_mutex_unlock(&m_header->m_lock);
+}
+
+uint64_t SharedMemory::header_size() {
+    return align_up(sizeof(Header), c_alignment);
+}
+
+LLVM_BUILDER_NS_END
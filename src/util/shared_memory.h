@@ -0,0 +1,127 @@
+//
+// Created by vibhanshu on 2026-10-18
+//
+
+#ifndef LLVM_BUILDER_UTIL_SHARED_MEMORY_H_
+#define LLVM_BUILDER_UTIL_SHARED_MEMORY_H_
+
+#include "llvm_builder/defines.h"
+#include "meta/noncopyable.h"
+
+#include <pthread.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+LLVM_BUILDER_NS_BEGIN
+
+//
+// SharedMemory
+//
+// MAP_SHARED mapping of a named posix shm segment or of a file, laid out as
+//     [ Header | Entry x c_max_entries | Link x c_max_links | allocations ... ]
+// Allocations are found by name, the directory stores their offsets relative to
+// the base of the segment, so open() maps it at any address. Creator records its
+// mapping address and open() asks for the same one, raw pointers stored inside
+// the segment are valid only where is_at_creator_base(), links record them as offsets
+class SharedMemory : meta::noncopyable {
+public:
+    enum class backing_t : uint8_t {
+        shm,
+        file,
+    };
+    enum : uint32_t {
+        c_max_name = 64,
+        c_max_entries = 256,
+        c_max_links = 256,
+        c_alignment = 128,
+    };
+    static constexpr uint64_t c_magic = 0x4c4c564d53484d32; // "LLVMSHM2"
+    struct Entry {
+        char m_name[c_max_name];
+        // struct name for objects
+        char m_type_name[c_max_name];
+        uint64_t m_offset;
+        uint64_t m_size;
+        uint32_t m_kind;
+        // element type, number of elements for arrays
+        uint32_t m_type;
+        uint32_t m_num_elements;
+    };
+    // pointer stored at m_field pointing to m_target, both relative to base
+    struct Link {
+        uint64_t m_field;
+        uint64_t m_target;
+    };
+    struct Header {
+        uint64_t m_magic;
+        uint64_t m_base;
+        uint64_t m_size;
+        // guards allocation, robust so a process dying inside allocate() can't wedge the others
+        pthread_mutex_t m_lock;
+        std::atomic<uint32_t> m_num_entries;
+        std::atomic<uint64_t> m_used;
+        std::atomic<uint32_t> m_num_links;
+        Entry m_entries[c_max_entries];
+        Link m_links[c_max_links];
+    };
+private:
+    const backing_t m_backing;
+    const std::string m_name;
+    int m_fd = -1;
+    Header* m_header = nullptr;
+    uint64_t m_size = 0;
+    std::string m_error;
+public:
+    // creates a new segment of `size` bytes, fails if it already exists
+    explicit SharedMemory(backing_t backing, const std::string& name, uint64_t size);
+    // maps an existing segment
+    explicit SharedMemory(backing_t backing, const std::string& name);
+    ~SharedMemory();
+public:
+    bool is_valid() const {
+        return m_header != nullptr;
+    }
+    const std::string& error() const {
+        return m_error;
+    }
+    backing_t backing() const {
+        return m_backing;
+    }
+    const std::string& name() const {
+        return m_name;
+    }
+    void* base() const {
+        return m_header;
+    }
+    uint64_t size() const {
+        return m_size;
+    }
+    uint64_t used() const;
+    // mapped at the address of the creator, so raw pointers stored inside are valid
+    bool is_at_creator_base() const;
+    bool contains(const void* ptr, uint64_t size) const;
+    // returns nullptr if name is taken/too long or segment is full, memory is zeroed
+    void* allocate(const std::string& name, const std::string& type_name, uint64_t size,
+                   uint32_t kind, uint32_t type, uint32_t num_elements);
+    const Entry* find(const std::string& name) const;
+    void* at(uint64_t offset) const;
+    // records that pointer at `field` refers to `target`, both inside the segment
+    bool add_link(const void* field, const void* target);
+    // any pointer recorded by add_link() stored in [offset, offset + size)
+    bool has_links(uint64_t offset, uint64_t size) const;
+    // removes name of the segment, existing mappings stay valid
+    bool unlink();
+private:
+    bool M_open(bool create);
+    bool M_map(void* hint, uint64_t size);
+    bool M_lock();
+    void M_unlock();
+public:
+    static uint64_t header_size();
+};
+
+LLVM_BUILDER_NS_END
+
+#endif // LLVM_BUILDER_UTIL_SHARED_MEMORY_H_